@@ -0,0 +1,301 @@
+#include "ambient_occlusion.h"
+
+#include "disk_cache.h"
+#include "frame_jobs.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numbers>
+
+namespace // Anonymous namespace holding BVH types and tracing helpers
+{
+constexpr std::size_t kMaxLeafTriangles = 4; // Leaves stop splitting at this size
+constexpr std::size_t kTraversalStackSize = 64; // Median splits keep the depth near log2(triangles)
+constexpr std::size_t kMinVerticesPerJob = 256; // Below this a job costs more to schedule than to trace
+constexpr float kRayOffset = 1e-4f; // Origin offset along the normal, relative to the bounding-box diagonal
+constexpr DiskCache kAmbientOcclusionCache{"ambient_occlusion", ".ao", {'A', 'O', 'C', '2'}, 2, "ambient occlusion"}; // Bump the version when the bake changes
+
+struct Triangle // Precomputed edges for the ray test
+{
+    glm::vec3 v0{};
+    glm::vec3 edge1{};
+    glm::vec3 edge2{};
+};
+
+struct BvhNode // Depth-first layout: the left child follows its parent, the right child is stored explicitly
+{
+    glm::vec3 bounds_min{std::numeric_limits<float>::max()};
+    std::uint32_t first = 0; // Leaf: first triangle; inner node: index of the right child
+    glm::vec3 bounds_max{std::numeric_limits<float>::lowest()};
+    std::uint32_t count = 0; // Leaf: triangle count; 0 marks an inner node
+};
+
+struct BuildTriangle // Triangle with the bounds used while splitting
+{
+    glm::vec3 bounds_min{};
+    glm::vec3 bounds_max{};
+    glm::vec3 centroid{};
+    Triangle triangle;
+};
+
+struct Bvh
+{
+    std::vector<BvhNode> nodes;
+    std::vector<Triangle> triangles; // Reordered so every leaf covers a contiguous range
+};
+
+void build_node(Bvh &bvh, std::vector<BuildTriangle> &build, const std::size_t node_index, const std::size_t begin, const std::size_t end)
+{
+    BvhNode node;
+    glm::vec3 centroid_min(std::numeric_limits<float>::max());
+    glm::vec3 centroid_max(std::numeric_limits<float>::lowest());
+    for (std::size_t i(begin); i < end; i++)
+    {
+        node.bounds_min = glm::min(node.bounds_min, build[i].bounds_min);
+        node.bounds_max = glm::max(node.bounds_max, build[i].bounds_max);
+        centroid_min = glm::min(centroid_min, build[i].centroid);
+        centroid_max = glm::max(centroid_max, build[i].centroid);
+    }
+
+    const glm::vec3 spread = centroid_max - centroid_min;
+    const int axis = spread.x >= spread.y && spread.x >= spread.z ? 0 : (spread.y >= spread.z ? 1 : 2); // Longest centroid axis
+    if (end - begin <= kMaxLeafTriangles || spread[axis] <= 0.0f) // Small or unsplittable (coincident centroids)
+    {
+        node.first = static_cast<std::uint32_t>(begin);
+        node.count = static_cast<std::uint32_t>(end - begin);
+        bvh.nodes[node_index] = node;
+        return;
+    }
+
+    const std::size_t middle = begin + (end - begin) / 2; // Median split keeps the tree balanced
+    std::nth_element(build.begin() + static_cast<std::ptrdiff_t>(begin), build.begin() + static_cast<std::ptrdiff_t>(middle),
+                     build.begin() + static_cast<std::ptrdiff_t>(end),
+                     [axis](const BuildTriangle &a, const BuildTriangle &b) { return a.centroid[axis] < b.centroid[axis]; });
+
+    bvh.nodes.emplace_back(); // Left child directly follows its parent
+    build_node(bvh, build, node_index + 1, begin, middle);
+    node.first = static_cast<std::uint32_t>(bvh.nodes.size()); // Right child after the whole left subtree
+    bvh.nodes.emplace_back();
+    build_node(bvh, build, node.first, middle, end);
+    bvh.nodes[node_index] = node; // Written last: emplace_back may have moved the array
+}
+
+Bvh build_bvh(const std::span<const MeshVertex> vertices, const std::span<const std::uint32_t> indices)
+{
+    std::vector<BuildTriangle> build; // Sorted in place while splitting
+    build.reserve(indices.size() / 3);
+    for (std::size_t i(0); i + 2 < indices.size(); i += 3)
+    {
+        const glm::vec3 &a = vertices[indices[i]].position;
+        const glm::vec3 &b = vertices[indices[i + 1]].position;
+        const glm::vec3 &c = vertices[indices[i + 2]].position;
+        build.push_back({glm::min(a, glm::min(b, c)), glm::max(a, glm::max(b, c)), (a + b + c) / 3.0f, {a, b - a, c - a}});
+    }
+
+    Bvh bvh;
+    if (build.empty()) return bvh;
+    bvh.nodes.reserve(2 * build.size() / kMaxLeafTriangles + 1);
+    bvh.nodes.emplace_back();
+    build_node(bvh, build, 0, 0, build.size());
+
+    bvh.triangles.reserve(build.size());
+    for (const auto &triangle : build) bvh.triangles.push_back(triangle.triangle); // Leaf order
+    return bvh;
+}
+
+bool hits_box(const BvhNode &node, const glm::vec3 &origin, const glm::vec3 &inverse_direction, const float max_distance)
+{
+    const glm::vec3 t0 = (node.bounds_min - origin) * inverse_direction; // Slab test; infinities handle axis-parallel rays
+    const glm::vec3 t1 = (node.bounds_max - origin) * inverse_direction;
+    const glm::vec3 near = glm::min(t0, t1);
+    const glm::vec3 far = glm::max(t0, t1);
+    const float enter = std::max({near.x, near.y, near.z, 0.0f});
+    const float exit = std::min({far.x, far.y, far.z, max_distance});
+    return enter <= exit;
+}
+
+bool hits_triangle(const Triangle &triangle, const glm::vec3 &origin, const glm::vec3 &direction, const float min_distance,
+                   const float max_distance)
+{
+    const glm::vec3 p = glm::cross(direction, triangle.edge2); // Moller-Trumbore, both faces count as occluders
+    const float determinant = glm::dot(triangle.edge1, p);
+    if (std::abs(determinant) < 1e-12f) return false;
+    const float inverse_determinant = 1.0f / determinant;
+    const glm::vec3 t = origin - triangle.v0;
+    const float u = glm::dot(t, p) * inverse_determinant;
+    if (u < 0.0f || u > 1.0f) return false;
+    const glm::vec3 q = glm::cross(t, triangle.edge1);
+    const float v = glm::dot(direction, q) * inverse_determinant;
+    if (v < 0.0f || u + v > 1.0f) return false;
+    const float distance = glm::dot(triangle.edge2, q) * inverse_determinant;
+    return distance > min_distance && distance < max_distance;
+}
+
+// Any-hit query: occlusion only needs to know whether something lies within max_distance
+bool occluded(const Bvh &bvh, const glm::vec3 &origin, const glm::vec3 &direction, const float min_distance, const float max_distance)
+{
+    const glm::vec3 inverse_direction = 1.0f / direction;
+    std::array<std::uint32_t, kTraversalStackSize> stack{};
+    std::size_t depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0)
+    {
+        const BvhNode &node = bvh.nodes[stack[--depth]];
+        if (!hits_box(node, origin, inverse_direction, max_distance)) continue;
+        if (node.count > 0)
+        {
+            for (std::uint32_t i(node.first); i < node.first + node.count; i++)
+            {
+                if (hits_triangle(bvh.triangles[i], origin, direction, min_distance, max_distance)) return true;
+            }
+            continue;
+        }
+        if (depth + 2 > stack.size()) return false; // Unreachable for median splits; treat as open rather than overflow
+        stack[depth++] = node.first; // Right child
+        stack[depth++] = static_cast<std::uint32_t>(&node - bvh.nodes.data()) + 1; // Left child (visited first)
+    }
+    return false;
+}
+
+float radical_inverse(std::uint32_t bits) // Van der Corput sequence in base 2
+{
+    bits = (bits << 16u) | (bits >> 16u);
+    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+    return static_cast<float>(bits) * 2.3283064365386963e-10f;
+}
+
+float vertex_rotation(std::uint32_t vertex) // Per-vertex angle that decorrelates the shared sample pattern
+{
+    vertex ^= vertex >> 16u;
+    vertex *= 0x7FEB352Du;
+    vertex ^= vertex >> 15u;
+    vertex *= 0x846CA68Bu;
+    vertex ^= vertex >> 16u;
+    return static_cast<float>(vertex) * 2.3283064365386963e-10f * 2.0f * std::numbers::pi_v<float>;
+}
+
+std::uint8_t quantize_occlusion(const float value)
+{
+    return static_cast<std::uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+}
+
+AmbientOcclusionBake bake_ambient_occlusion(const std::span<const MeshVertex> vertices, const std::span<const std::uint32_t> indices,
+                                            const AmbientOcclusionSettings &settings)
+{
+    using Clock = std::chrono::steady_clock;
+    AmbientOcclusionBake bake;
+    bake.occlusion.assign(vertices.size(), 1.0f);
+    if (vertices.empty() || indices.size() < 3 || settings.samples == 0) return bake;
+
+    const auto build_start = Clock::now();
+    const Bvh bvh = build_bvh(vertices, indices);
+    const auto trace_start = Clock::now();
+    bake.build_ms = std::chrono::duration<double, std::milli>(trace_start - build_start).count();
+
+    const glm::vec3 extent = bvh.nodes.front().bounds_max - bvh.nodes.front().bounds_min;
+    const float diagonal = std::max(glm::length(extent), 1e-6f);
+    const float max_distance = diagonal * settings.distance_fraction;
+    const float offset = diagonal * kRayOffset;
+
+    std::vector<glm::vec3> pattern(settings.samples); // Cosine-weighted Hammersley directions around +Z, shared by all vertices
+    for (std::uint32_t i(0); i < settings.samples; i++)
+    {
+        const float u = (static_cast<float>(i) + 0.5f) / static_cast<float>(settings.samples);
+        const float phi = 2.0f * std::numbers::pi_v<float> * radical_inverse(i);
+        const float radius = std::sqrt(u);
+        pattern[i] = {radius * std::cos(phi), radius * std::sin(phi), std::sqrt(std::max(0.0f, 1.0f - u))};
+    }
+
+    bake.jobs = frame_job_count(vertices.size(), kMinVerticesPerJob);
+    run_background_jobs(bake.jobs, vertices.size(), [&](std::size_t, const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t vertex(begin); vertex < end; vertex++) // Each job writes only its own range
+        {
+            const float normal_length = glm::length(vertices[vertex].normal);
+            if (normal_length < 1e-6f) continue; // No hemisphere to sample; stays open
+            const glm::vec3 normal = vertices[vertex].normal / normal_length;
+
+            const float sign = std::copysign(1.0f, normal.z); // Branchless orthonormal basis (Duff et al.)
+            const float a = -1.0f / (sign + normal.z);
+            const float b = normal.x * normal.y * a;
+            const glm::vec3 tangent(1.0f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x);
+            const glm::vec3 bitangent(b, sign + normal.y * normal.y * a, -normal.y);
+
+            const float rotation = vertex_rotation(static_cast<std::uint32_t>(vertex));
+            const float cos_rotation = std::cos(rotation);
+            const float sin_rotation = std::sin(rotation);
+            const glm::vec3 origin = vertices[vertex].position + normal * offset; // Leave the surface the vertex lies on
+
+            std::uint32_t blocked = 0;
+            for (const glm::vec3 &sample : pattern)
+            {
+                const float x = sample.x * cos_rotation - sample.y * sin_rotation;
+                const float y = sample.x * sin_rotation + sample.y * cos_rotation;
+                const glm::vec3 direction = tangent * x + bitangent * y + normal * sample.z;
+                if (occluded(bvh, origin, direction, offset, max_distance)) blocked++;
+            }
+            bake.occlusion[vertex] = 1.0f - static_cast<float>(blocked) / static_cast<float>(settings.samples);
+        }
+    });
+
+    bake.trace_ms = std::chrono::duration<double, std::milli>(Clock::now() - trace_start).count();
+    bake.rays = static_cast<std::uint64_t>(vertices.size()) * settings.samples;
+    return bake;
+}
+
+QByteArray ambient_occlusion_cache_key(const QString &source_path, const std::size_t vertex_count, const std::size_t index_count,
+                                       const AmbientOcclusionSettings &settings)
+{
+    const QFileInfo info(source_path);
+    QCryptographicHash hash(QCryptographicHash::Sha1); // Identity of the source file and every input of the bake
+    hash.addData(info.absoluteFilePath().toUtf8());
+    for (const qint64 value : {info.size(), info.lastModified().toMSecsSinceEpoch(), static_cast<qint64>(vertex_count),
+                               static_cast<qint64>(index_count), static_cast<qint64>(settings.samples),
+                               static_cast<qint64>(settings.distance_fraction * 1e6f), static_cast<qint64>(kAmbientOcclusionCache.version)})
+    {
+        hash.addData(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    return hash.result().toHex();
+}
+
+std::optional<std::vector<float>> load_cached_ambient_occlusion(const QByteArray &key, const std::size_t vertex_count)
+{
+    const auto payload = load_disk_cache_entry(kAmbientOcclusionCache, key);
+    if (!payload) return std::nullopt; // Not baked yet (or damaged)
+
+    std::uint32_t stored_count = 0;
+    if (payload->size() != static_cast<qsizetype>(sizeof(stored_count) + vertex_count))
+    {
+        warn_damaged_disk_cache_entry(kAmbientOcclusionCache, key);
+        return std::nullopt;
+    }
+    std::memcpy(&stored_count, payload->constData(), sizeof(stored_count));
+    if (stored_count != vertex_count) return std::nullopt;
+
+    std::vector<float> occlusion(vertex_count);
+    const auto *bytes = reinterpret_cast<const std::uint8_t*>(payload->constData() + sizeof(stored_count));
+    for (std::size_t i(0); i < vertex_count; i++) occlusion[i] = static_cast<float>(bytes[i]) / 255.0f;
+    return occlusion;
+}
+
+void store_cached_ambient_occlusion(const QByteArray &key, const std::span<const float> occlusion)
+{
+    QByteArray payload(static_cast<qsizetype>(sizeof(std::uint32_t) + occlusion.size()), '\0'); // Vertex count, one byte per vertex
+    const auto count = static_cast<std::uint32_t>(occlusion.size());
+    std::memcpy(payload.data(), &count, sizeof(count));
+    std::ranges::transform(occlusion, payload.data() + sizeof(count),
+                           [](const float value) { return static_cast<char>(quantize_occlusion(value)); });
+    store_disk_cache_entry(kAmbientOcclusionCache, key, payload);
+}
@@ -0,0 +1,47 @@
+#ifndef AMBIENT_OCCLUSION_H // Guard against multiple inclusion
+#define AMBIENT_OCCLUSION_H // Begin include guard
+
+#include "mesh_encoding.h" // MeshVertex staging type
+
+#include <QByteArray> // Cache keys
+#include <QString> // Source file paths
+
+#include <cstdint> // Index type shared with the index pool
+#include <optional> // Cache misses
+#include <span> // Non-owning views over mesh data
+#include <vector> // Owning container for the baked values
+
+struct AmbientOcclusionSettings // Parameters of the import-time bake (part of the cache key)
+{
+    std::uint32_t samples = 64; // Cosine-weighted hemisphere rays per vertex
+    float distance_fraction = 0.25f; // Ray length relative to the mesh bounding-box diagonal
+};
+
+struct AmbientOcclusionBake // Result of one bake (or cache hit) plus its throughput
+{
+    std::vector<float> occlusion; // Per-vertex visibility in [0, 1] (1: nothing blocks the hemisphere)
+    std::uint64_t rays = 0; // Rays traced (0 on a cache hit)
+    double build_ms = 0.0; // BVH construction time
+    double trace_ms = 0.0; // Ray casting time over all jobs (wall clock)
+    std::size_t jobs = 1; // Jobs the vertices were split into
+    bool from_cache = false; // Loaded from the disk cache instead of baked
+
+    [[nodiscard]] double rays_per_second() const { return trace_ms > 0.0 ? static_cast<double>(rays) * 1000.0 / trace_ms : 0.0; }
+};
+
+// Cast settings.samples rays per vertex over the hemisphere of its normal against a BVH of the mesh's own triangles and
+// return the fraction that escapes. Vertices are split into contiguous ranges traced in parallel by the frame job pool.
+[[nodiscard]] AmbientOcclusionBake bake_ambient_occlusion(std::span<const MeshVertex> vertices,
+                                                          std::span<const std::uint32_t> indices,
+                                                          const AmbientOcclusionSettings &settings);
+
+// Key of a bake: source file identity (path, size, modification time), mesh size and settings
+[[nodiscard]] QByteArray ambient_occlusion_cache_key(const QString &source_path, std::size_t vertex_count,
+                                                     std::size_t index_count, const AmbientOcclusionSettings &settings);
+
+// Disk cache of baked values (8 bits per vertex, the precision the shaders read) under the application cache location
+[[nodiscard]] std::optional<std::vector<float>> load_cached_ambient_occlusion(const QByteArray &key, std::size_t vertex_count);
+void store_cached_ambient_occlusion(const QByteArray &key, std::span<const float> occlusion);
+
+
+#endif //AMBIENT_OCCLUSION_H // End include guard
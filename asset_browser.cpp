@@ -0,0 +1,88 @@
+#include "asset_browser.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QIcon>
+#include <QLocale>
+#include <QMetaObject>
+#include <QPixmap>
+#include <QStringList>
+#include <QThread>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+AssetBrowser::AssetBrowser(QWidget *parent) : QWidget(parent)
+{
+    directory_label_ = new QLabel(QString(), this);
+    directory_label_->setWordWrap(true);
+
+    list_widget_ = new QListWidget(this);
+    list_widget_->setViewMode(QListWidget::IconMode);
+    list_widget_->setIconSize(QSize(kThumbnailSize, kThumbnailSize));
+    list_widget_->setGridSize(QSize(kThumbnailSize + 24, kThumbnailSize + 36)); // Room for the name below the icon
+    list_widget_->setResizeMode(QListWidget::Adjust); // Reflow the grid when the panel is resized
+    list_widget_->setMovement(QListWidget::Static);
+    list_widget_->setUniformItemSizes(true); // Entries without a thumbnail yet keep the same cell
+    connect(list_widget_, &QListWidget::itemActivated, this, [this](const QListWidgetItem *item)
+    {
+        emit asset_activated(item->data(Qt::UserRole).toString());
+    });
+
+    auto *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(directory_label_);
+    layout->addWidget(list_widget_);
+
+    thumbnail_pool_.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1)); // Leave a core to the GUI and render threads
+}
+
+AssetBrowser::~AssetBrowser()
+{
+    thumbnail_pool_.clear();
+    thumbnail_pool_.waitForDone(); // Running jobs reference this widget
+}
+
+void AssetBrowser::set_directory(const QString &directory)
+{
+    thumbnail_pool_.clear(); // Files of the previous directory that did not start yet
+    const std::uint64_t generation = ++generation_;
+    const QDir dir(directory);
+    directory_ = dir.absolutePath();
+    directory_label_->setText(directory_);
+    list_widget_->clear();
+
+    const QStringList files = dir.entryList({QStringLiteral("*.obj")}, QDir::Files, QDir::Name);
+    for (int row(0); row < files.size(); row++)
+    {
+        const QString path = dir.filePath(files[row]);
+        auto *item = new QListWidgetItem(QFileInfo(path).completeBaseName(), list_widget_);
+        item->setData(Qt::UserRole, path);
+        item->setToolTip(path);
+
+        thumbnail_pool_.start([this, generation, row, path]
+        {
+            AssetThumbnail thumbnail = make_asset_thumbnail(path);
+            QMetaObject::invokeMethod(this, [this, generation, row, thumbnail = std::move(thumbnail)]
+            {
+                set_thumbnail(generation, row, thumbnail);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void AssetBrowser::set_thumbnail(const std::uint64_t generation, const int row, const AssetThumbnail &thumbnail)
+{
+    if (generation != generation_ || row >= list_widget_->count()) return; // Finished after the directory changed
+    QListWidgetItem *item = list_widget_->item(row);
+    const QString path = item->data(Qt::UserRole).toString();
+    if (thumbnail.image.isNull())
+    {
+        item->setToolTip(path + QStringLiteral("\nNo preview (point cloud or no triangles)"));
+        return;
+    }
+    item->setIcon(QIcon(QPixmap::fromImage(thumbnail.image)));
+    item->setToolTip(path + (thumbnail.from_cache
+        ? QStringLiteral("\nThumbnail from cache")
+        : QStringLiteral("\nThumbnail rendered in %1 ms").arg(QLocale::c().toString(thumbnail.render_ms, 'f', 1))));
+}
@@ -0,0 +1,42 @@
+#ifndef ASSET_BROWSER_H // Guard against multiple inclusion
+#define ASSET_BROWSER_H // Begin include guard
+
+#include "asset_thumbnails.h" // Rendered or cached previews
+
+#include <QLabel> // Directory shown
+#include <QListWidget> // Icon grid of the OBJ files
+#include <QString> // Paths
+#include <QThreadPool> // Thumbnail jobs of the shown directory
+#include <QWidget> // Base class; placed next to the viewports
+
+#include <cstdint> // Directory generation
+
+// Side panel listing the OBJ files of one directory with a thumbnail each. Files appear immediately with their name;
+// thumbnails are made on a pool of worker threads (one file per thread) and fill in as they finish, so a directory of
+// large meshes never blocks the GUI. Activating an entry emits asset_activated() with its path.
+class AssetBrowser final : public QWidget
+{
+    Q_OBJECT // Enable signals/slots
+
+public:
+    explicit AssetBrowser(QWidget *parent = nullptr);
+    ~AssetBrowser() override; // Waits for running thumbnail jobs (they post their results to this widget)
+
+    void set_directory(const QString &directory); // List the directory and queue its thumbnails
+    [[nodiscard]] QString directory() const { return directory_; }
+
+signals:
+    void asset_activated(const QString &path); // Double click or Enter on an entry
+
+private:
+    void set_thumbnail(std::uint64_t generation, int row, const AssetThumbnail &thumbnail); // GUI thread
+
+    QLabel *directory_label_{nullptr};
+    QListWidget *list_widget_{nullptr};
+    QThreadPool thumbnail_pool_; // Cleared when the directory changes, so stale files are not rendered
+    QString directory_; // Absolute path of the listed directory
+    std::uint64_t generation_ = 0; // Bumped by set_directory; results of an older listing are dropped
+};
+
+
+#endif //ASSET_BROWSER_H // End include guard
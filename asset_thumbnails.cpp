@@ -0,0 +1,168 @@
+#include "asset_thumbnails.h"
+
+#include "disk_cache.h"
+#include "point_cloud.h"
+#include "software_rasterizer.h"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFile>
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace // Anonymous namespace holding the canonical camera and the cache format
+{
+constexpr DiskCache kThumbnailCache{"thumbnails", ".thumb", {'T', 'H', 'M', '2'}, 2, "thumbnail"}; // PNG payload; bump the version when the camera or the shading changes
+constexpr float kFieldOfView = 30.0f; // Degrees; narrow, so the framing hardly distorts the silhouette
+constexpr float kFramingMargin = 1.08f; // Bounding sphere radius multiplier (keeps the silhouette off the border)
+constexpr int kLitColorMode = 5; // View::ColorMode::Lit: sun and ambient, the look of a freshly imported mesh
+const glm::vec3 kViewDirection = glm::normalize(glm::vec3(0.55f, 0.45f, 1.0f)); // Target to camera: front right, from above
+
+QByteArray thumbnail_cache_key(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return {};
+    QCryptographicHash hash(QCryptographicHash::Sha1); // Mesh content, so renamed or copied files still hit
+    if (!hash.addData(&file)) return {};
+    for (const qint64 value : {static_cast<qint64>(kThumbnailSize), static_cast<qint64>(kThumbnailCache.version)})
+    {
+        hash.addData(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    return hash.result().toHex();
+}
+
+std::optional<QImage> load_cached_thumbnail(const QByteArray &key)
+{
+    const auto payload = load_disk_cache_entry(kThumbnailCache, key);
+    if (!payload) return std::nullopt; // Not rendered yet (or damaged)
+
+    QImage image;
+    if (!image.loadFromData(*payload, "PNG") || image.width() != kThumbnailSize || image.height() != kThumbnailSize)
+    {
+        warn_damaged_disk_cache_entry(kThumbnailCache, key);
+        return std::nullopt;
+    }
+    return image;
+}
+
+void store_cached_thumbnail(const QByteArray &key, const QImage &image)
+{
+    QByteArray png;
+    QBuffer buffer(&png);
+    if (!buffer.open(QIODevice::WriteOnly) || !image.save(&buffer, "PNG"))
+    {
+        qWarning() << "Cannot encode the thumbnail for cache entry" << disk_cache_path(kThumbnailCache, key);
+        return;
+    }
+    store_disk_cache_entry(kThumbnailCache, key, png);
+}
+
+// Same import as View::load_object (first mesh, fan-triangulated faces), without the recentering: the camera frames the bounds
+std::optional<SoftwareMesh> import_thumbnail_mesh(const QString &path, glm::vec3 &bounds_min, glm::vec3 &bounds_max)
+{
+    Assimp::Importer importer; // One per call: importers are not shared between threads
+    const aiScene *scene = importer.ReadFile(path.toStdString(), aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_GenSmoothNormals);
+    if (!scene || !scene->HasMeshes() || !scene->mMeshes[0] || !scene->mMeshes[0]->HasPositions())
+    {
+        qWarning() << "No thumbnail for" << path << ':' << QString::fromStdString(importer.GetErrorString());
+        return std::nullopt;
+    }
+
+    const aiMesh *mesh = scene->mMeshes[0];
+    std::vector<MeshVertex> vertices(mesh->mNumVertices);
+    for (unsigned int vertex_index(0); vertex_index < mesh->mNumVertices; vertex_index++)
+    {
+        const aiVector3D &vertex = mesh->mVertices[vertex_index];
+        vertices[vertex_index].position = {vertex.x, vertex.y, vertex.z};
+        if (mesh->HasNormals())
+        {
+            const aiVector3D &normal = mesh->mNormals[vertex_index];
+            vertices[vertex_index].normal = {normal.x, normal.y, normal.z};
+        }
+    }
+
+    std::vector<std::uint32_t> indices;
+    indices.reserve(static_cast<std::size_t>(mesh->mNumFaces) * 3);
+    bounds_min = glm::vec3(std::numeric_limits<float>::max());
+    bounds_max = glm::vec3(std::numeric_limits<float>::lowest());
+    for (unsigned int face_index(0); face_index < mesh->mNumFaces; face_index++)
+    {
+        const aiFace &face = mesh->mFaces[face_index];
+        if (face.mNumIndices < 3) continue;
+        if (!std::all_of(face.mIndices, face.mIndices + face.mNumIndices,
+                         [&](const unsigned int index) { return index < mesh->mNumVertices; })) continue;
+
+        for (unsigned int i(1); i + 1 < face.mNumIndices; i++)
+        {
+            for (const unsigned int vertex_index : {face.mIndices[0], face.mIndices[i], face.mIndices[i + 1]})
+            {
+                indices.push_back(vertex_index);
+                bounds_min = glm::min(bounds_min, vertices[vertex_index].position);
+                bounds_max = glm::max(bounds_max, vertices[vertex_index].position);
+            }
+        }
+    }
+    if (indices.empty()) return std::nullopt; // Lines or points only
+
+    return make_software_mesh(vertices, std::move(indices), {});
+}
+
+QImage render_thumbnail(const SoftwareMesh &mesh, const glm::vec3 &bounds_min, const glm::vec3 &bounds_max)
+{
+    const glm::vec3 center = 0.5f * (bounds_min + bounds_max);
+    const float radius = std::max(0.5f * glm::length(bounds_max - bounds_min) * kFramingMargin, 1e-4f);
+    const float distance = radius / std::sin(glm::radians(kFieldOfView) * 0.5f); // Bounding sphere touches the frustum
+
+    SoftwareFrame frame;
+    frame.draws.push_back({&mesh, glm::mat4(1.0f), glm::vec4(1.0f), kLitColorMode, false});
+    frame.eye = center + kViewDirection * distance;
+    frame.view = glm::lookAt(frame.eye, center, glm::vec3(0.0f, 1.0f, 0.0f));
+    frame.near_plane = std::max(distance - radius, distance * 1e-3f);
+    frame.far_plane = distance + radius;
+    frame.projection = glm::perspective(glm::radians(kFieldOfView), 1.0f, frame.near_plane, frame.far_plane);
+    frame.max_jobs = 1; // Parallelism comes from rendering several files at once
+
+    SoftwareRasterizer rasterizer; // Scratch buffers are per call, so concurrent thumbnails share nothing
+    SoftwareFrameStats stats;
+    QImage image(kThumbnailSize, kThumbnailSize, QImage::Format_RGB32);
+    rasterizer.render(frame, image, stats);
+    return image;
+}
+}
+
+AssetThumbnail make_asset_thumbnail(const QString &path)
+{
+    const auto start = std::chrono::steady_clock::now();
+    AssetThumbnail thumbnail;
+    if (obj_may_be_point_cloud(path)) return thumbnail; // Scans would need the whole octree import; the browser shows their name only
+
+    const QByteArray key = thumbnail_cache_key(path);
+    if (key.isEmpty()) return thumbnail; // Unreadable
+    if (auto cached = load_cached_thumbnail(key))
+    {
+        thumbnail.image = std::move(*cached);
+        thumbnail.from_cache = true;
+        return thumbnail;
+    }
+
+    glm::vec3 bounds_min{0.0f}, bounds_max{0.0f};
+    const std::optional<SoftwareMesh> mesh = import_thumbnail_mesh(path, bounds_min, bounds_max);
+    if (!mesh) return thumbnail;
+
+    thumbnail.image = render_thumbnail(*mesh, bounds_min, bounds_max);
+    thumbnail.render_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    store_cached_thumbnail(key, thumbnail.image);
+    return thumbnail;
+}
@@ -0,0 +1,24 @@
+#ifndef ASSET_THUMBNAILS_H // Guard against multiple inclusion
+#define ASSET_THUMBNAILS_H // Begin include guard
+
+#include <QImage> // Rendered previews
+#include <QString> // Source file paths
+
+// Previews of OBJ meshes for the asset browser. A thumbnail is the mesh the importer would load, framed by a fixed
+// three-quarter camera and drawn by the software rasterizer with one job, so a worker pool renders several files side by
+// side without touching GL. Results are stored as PNG files in the application cache, keyed by the file content.
+
+constexpr int kThumbnailSize = 128; // Pixels per side (part of the cache key)
+
+struct AssetThumbnail // Result of one request (or cache hit)
+{
+    QImage image; // kThumbnailSize square; null when the file is a point cloud, has no triangles or cannot be read
+    double render_ms = 0.0; // Import and rasterization (0 on a cache hit)
+    bool from_cache = false; // Loaded from the disk cache instead of rendered
+};
+
+// Cached or freshly rendered thumbnail of an OBJ file. Touches no GL or GUI state, so it may run on any thread.
+[[nodiscard]] AssetThumbnail make_asset_thumbnail(const QString &path);
+
+
+#endif //ASSET_THUMBNAILS_H // End include guard
@@ -0,0 +1,178 @@
+#include "backend_benchmark.h"
+
+#include "view_3D.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QEventLoop>
+#include <QKeyEvent>
+#include <QSurfaceFormat>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <utility>
+
+namespace // Anonymous namespace holding benchmark settings and statistics helpers
+{
+constexpr int kWarmupFrames = 60; // Shader compilation, first uploads and the resolution governor settle first
+constexpr int kStallTimeoutMs = 10000; // A run without frames for this long is reported as it is
+
+double mean(const std::vector<double> &values)
+{
+    return values.empty() ? 0.0 : std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+}
+
+double percentile_95(std::vector<double> values) // By value: nth_element reorders
+{
+    if (values.empty()) return 0.0;
+    const auto nth = values.begin() + static_cast<std::ptrdiff_t>((values.size() - 1) * 95 / 100);
+    std::nth_element(values.begin(), nth, values.end());
+    return *nth;
+}
+}
+
+BackendBenchmark::BackendBenchmark(View *view, QString label, const int frames) : view_(view), label_(std::move(label)), target_frames_(frames)
+{
+    watchdog_.setSingleShot(true);
+    watchdog_.setInterval(kStallTimeoutMs);
+    connect(&watchdog_, &QTimer::timeout, this, &BackendBenchmark::finish);
+    connect(view_, &View::framePresented, this, &BackendBenchmark::on_frame_presented);
+}
+
+void BackendBenchmark::start(const QStringList &models)
+{
+    models_ = models;
+    phase_ = Phase::WaitingForGl;
+    warmup_left_ = kWarmupFrames;
+    frame_ms_.clear();
+    latency_ms_.clear();
+    frame_ms_.reserve(static_cast<std::size_t>(target_frames_));
+    latency_ms_.reserve(static_cast<std::size_t>(target_frames_));
+    view_->set_animation_fixed_step(true); // Rigged models pose the same frames in every run and backend
+    watchdog_.start();
+}
+
+void BackendBenchmark::on_frame_presented(const double latency_ms)
+{
+    if (phase_ == Phase::Done) return;
+    watchdog_.start(); // Still presenting
+    if (latency_ms >= 0.0) input_pending_ = false;
+
+    switch (phase_)
+    {
+        case Phase::WaitingForGl: // First frame: the context exists, so meshes can be uploaded
+            phase_ = Phase::WarmingUp;
+            QMetaObject::invokeMethod(this, [this]
+            {
+                for (const QString &model : std::as_const(models_))
+                {
+                    if (!view_->load_object(model)) qWarning() << "Benchmark: could not load" << model;
+                }
+                post_input();
+            }, Qt::QueuedConnection); // Not from inside the frameSwapped emission
+            return;
+
+        case Phase::WarmingUp:
+            if (!view_->occlusion_bakes_pending() && --warmup_left_ <= 0) // Measure the finished scene only
+            {
+                phase_ = Phase::Measuring;
+                view_->restart_animation(); // Measured frames start from the same pose
+                interval_timer_.start();
+            }
+            break;
+
+        case Phase::Measuring:
+            frame_ms_.push_back(static_cast<double>(interval_timer_.nsecsElapsed()) / 1.0e6);
+            interval_timer_.start();
+            if (latency_ms >= 0.0) latency_ms_.push_back(latency_ms);
+            if (static_cast<int>(frame_ms_.size()) >= target_frames_)
+            {
+                finish();
+                return;
+            }
+            break;
+
+        case Phase::Done:
+            return;
+    }
+    if (!input_pending_) post_input(); // Frames without input (HUD catch-up) still wait for the outstanding press
+}
+
+void BackendBenchmark::post_input()
+{
+    input_pending_ = true;
+    QCoreApplication::postEvent(view_, new QKeyEvent(QEvent::KeyPress, Qt::Key_J, Qt::NoModifier)); // Yaw by a fixed step
+}
+
+void BackendBenchmark::finish()
+{
+    if (phase_ == Phase::Done) return;
+    phase_ = Phase::Done;
+    watchdog_.stop();
+    emit finished();
+}
+
+BackendBenchmarkResult BackendBenchmark::result() const
+{
+    BackendBenchmarkResult result;
+    result.label = label_;
+    result.frames = static_cast<int>(frame_ms_.size());
+    result.mean_frame_ms = mean(frame_ms_);
+    result.p95_frame_ms = percentile_95(frame_ms_);
+    result.mean_latency_ms = mean(latency_ms_);
+    result.p95_latency_ms = percentile_95(latency_ms_);
+    return result;
+}
+
+int run_backend_benchmark(const int frames, const QStringList &models)
+{
+    struct Run // One configuration under test
+    {
+        const char *label;
+        View::Backend backend;
+        bool threaded;
+    };
+    constexpr std::array runs{
+        Run{"widget, GUI thread", View::Backend::Widget, false},
+        Run{"widget, render thread", View::Backend::Widget, true},
+        Run{"native window", View::Backend::Window, false},
+        Run{"software rasterizer", View::Backend::Software, false}
+    };
+
+    std::vector<BackendBenchmarkResult> results;
+    for (const Run &run : runs)
+    {
+        // Without OpenGL 4.5 (main.cpp switched the default) the GL runs would never present a frame
+        if (View::default_backend() == View::Backend::Software && run.backend != View::Backend::Software) continue;
+        View view(nullptr, run.backend); // Top-level, same size for every run
+        view.setWindowTitle(QStringLiteral("Backend benchmark: %1").arg(QString::fromLatin1(run.label)));
+        view.resize(1250, 720);
+        view.set_threaded_rendering(run.threaded); // Started by initializeGL
+        view.show();
+
+        BackendBenchmark benchmark(&view, QString::fromLatin1(run.label), frames);
+        QEventLoop loop;
+        QObject::connect(&benchmark, &BackendBenchmark::finished, &loop, &QEventLoop::quit);
+        benchmark.start(models);
+        loop.exec();
+        results.push_back(benchmark.result());
+    }
+
+    qInfo().noquote() << QStringLiteral("Backend benchmark: %1 frames, %2 model(s), swap interval %3")
+                             .arg(frames).arg(static_cast<int>(models.size())).arg(QSurfaceFormat::defaultFormat().swapInterval());
+    qInfo().noquote() << QStringLiteral("%1 %2 %3 %4 %5 %6")
+                             .arg(QStringLiteral("backend"), -24).arg(QStringLiteral("frames"), 7)
+                             .arg(QStringLiteral("frame ms"), 9).arg(QStringLiteral("p95"), 7)
+                             .arg(QStringLiteral("latency ms"), 11).arg(QStringLiteral("p95"), 7);
+    bool complete = true;
+    for (const BackendBenchmarkResult &result : results)
+    {
+        qInfo().noquote() << QStringLiteral("%1 %2 %3 %4 %5 %6")
+                                 .arg(result.label, -24).arg(result.frames, 7)
+                                 .arg(result.mean_frame_ms, 9, 'f', 2).arg(result.p95_frame_ms, 7, 'f', 2)
+                                 .arg(result.mean_latency_ms, 11, 'f', 2).arg(result.p95_latency_ms, 7, 'f', 2);
+        complete = complete && result.frames >= frames;
+    }
+    return complete ? 0 : 1; // A stalled run is reported, but fails the process
+}
@@ -0,0 +1,63 @@
+#ifndef BACKEND_BENCHMARK_H // Guard against multiple inclusion
+#define BACKEND_BENCHMARK_H // Begin include guard
+
+#include <QElapsedTimer> // Present-to-present intervals
+#include <QObject> // Base class; reacts to View::framePresented
+#include <QString> // Run label
+#include <QStringList> // OBJ files of the benchmark scene
+#include <QTimer> // Gives up on a view that stops presenting
+
+#include <vector> // Per-frame samples
+
+class View; // View under test
+
+struct BackendBenchmarkResult // Summary of one run
+{
+    QString label; // Backend (and rendering thread) of the run
+    int frames = 0; // Frames measured (fewer than requested if the view stalled)
+    double mean_frame_ms = 0.0; // Average present-to-present interval
+    double p95_frame_ms = 0.0; // 95th percentile of the interval
+    double mean_latency_ms = 0.0; // Average input-to-frame latency (input handler to frameSwapped)
+    double p95_latency_ms = 0.0; // 95th percentile of the latency
+};
+
+// Drives a shown View with one synthetic yaw key press per presented frame, so every frame carries input and
+// its latency is measured by the view itself. Frames are counted from View::framePresented.
+class BackendBenchmark final : public QObject
+{
+    Q_OBJECT // Enable signals/slots
+
+public:
+    BackendBenchmark(View *view, QString label, int frames); // The view must outlive the benchmark
+    void start(const QStringList &models); // Wait for the first frame, load the models, warm up, then measure
+    [[nodiscard]] BackendBenchmarkResult result() const; // Valid after finished()
+
+signals:
+    void finished(); // All frames measured, or no frame for a while
+
+private:
+    enum class Phase { WaitingForGl, WarmingUp, Measuring, Done };
+
+    void on_frame_presented(double latency_ms); // Record one frame and post the next input
+    void post_input(); // Queue a yaw key press to the view
+    void finish(); // Stop measuring and report
+
+    View *view_ = nullptr; // View under test
+    QString label_; // Copied into the result
+    int target_frames_ = 0; // Frames to measure after the warm-up
+    int warmup_left_ = 0; // Frames still ignored
+    Phase phase_ = Phase::WaitingForGl; // Progress of the run
+    QStringList models_; // Loaded once the GL context exists
+    bool input_pending_ = false; // A posted key press has not been presented yet
+    QElapsedTimer interval_timer_; // Restarted on every measured frame
+    QTimer watchdog_; // Fires if no frame arrives for a while (e.g. the window is not exposed)
+    std::vector<double> frame_ms_; // Present-to-present intervals
+    std::vector<double> latency_ms_; // Input-to-frame latencies
+};
+
+// Run the same scene on the widget backend (GUI and render thread) and the native window backend, print a
+// comparison table and return the process exit code
+int run_backend_benchmark(int frames, const QStringList &models);
+
+
+#endif //BACKEND_BENCHMARK_H // End include guard
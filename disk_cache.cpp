@@ -0,0 +1,76 @@
+#include "disk_cache.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <cstring>
+
+namespace // Anonymous namespace holding the header layout
+{
+constexpr auto kHeaderSize = static_cast<qsizetype>(sizeof(DiskCache::magic) + 2 * sizeof(std::uint32_t)); // Magic, version, payload size
+}
+
+QString disk_cache_path(const DiskCache &cache, const QByteArray &key)
+{
+    const QDir directory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/") + QString::fromLatin1(cache.directory));
+    return directory.filePath(QString::fromLatin1(key) + QString::fromLatin1(cache.suffix));
+}
+
+std::optional<QByteArray> load_disk_cache_entry(const DiskCache &cache, const QByteArray &key)
+{
+    QFile file(disk_cache_path(cache, key));
+    if (!file.open(QIODevice::ReadOnly)) return std::nullopt; // Not produced yet
+
+    const QByteArray data = file.readAll();
+    std::uint32_t version = 0;
+    std::uint32_t size = 0;
+    if (data.size() >= kHeaderSize)
+    {
+        std::memcpy(&version, data.constData() + cache.magic.size(), sizeof(version));
+        std::memcpy(&size, data.constData() + cache.magic.size() + sizeof(version), sizeof(size));
+    }
+    if (data.size() < kHeaderSize || !std::equal(cache.magic.begin(), cache.magic.end(), data.constData()) ||
+        version != cache.version || data.size() != kHeaderSize + static_cast<qsizetype>(size))
+    {
+        warn_damaged_disk_cache_entry(cache, key);
+        return std::nullopt;
+    }
+    return data.mid(kHeaderSize);
+}
+
+void store_disk_cache_entry(const DiskCache &cache, const QByteArray &key, const QByteArray &payload)
+{
+    const QString path = disk_cache_path(cache, key);
+    if (!QDir().mkpath(QFileInfo(path).absolutePath()))
+    {
+        qWarning() << "Cannot create the" << cache.name << "cache directory for" << path;
+        return;
+    }
+
+    QByteArray data(cache.magic.data(), static_cast<qsizetype>(cache.magic.size()));
+    const auto size = static_cast<std::uint32_t>(payload.size());
+    data.append(reinterpret_cast<const char*>(&cache.version), sizeof(cache.version));
+    data.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    data.append(payload);
+
+    QSaveFile file(path); // Atomic replace: a crash never leaves a truncated entry behind
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+    {
+        qWarning() << "Cannot write the" << cache.name << "cache entry" << path;
+    }
+}
+
+void remove_disk_cache_entry(const DiskCache &cache, const QByteArray &key)
+{
+    QFile::remove(disk_cache_path(cache, key));
+}
+
+void warn_damaged_disk_cache_entry(const DiskCache &cache, const QByteArray &key)
+{
+    qWarning() << "Ignoring damaged" << cache.name << "cache entry" << disk_cache_path(cache, key);
+}
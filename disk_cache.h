@@ -0,0 +1,36 @@
+#ifndef DISK_CACHE_H // Guard against multiple inclusion
+#define DISK_CACHE_H // Begin include guard
+
+#include <QByteArray> // Keys and payloads
+#include <QString> // Entry paths
+
+#include <array> // File signature
+#include <cstdint> // Versions and sizes as stored on disk
+#include <optional> // Cache misses
+
+// Shared on-disk cache of the importers and the program binaries. Entries live under
+// <CacheLocation>/<directory>/<key><suffix> and start with a header (signature, version, payload size, 32-bit little
+// endian) followed by the payload. Writes go through QSaveFile, so a crash never leaves a truncated entry behind; an entry
+// whose header does not match is reported once when read and treated as a miss. Callers only supply keys and payloads.
+
+struct DiskCache // Static description of one cache
+{
+    const char *directory; // Subdirectory of the application cache location
+    const char *suffix; // File extension of the entries
+    std::array<char, 4> magic; // File signature; its last character is the version digit, so bump both together
+    std::uint32_t version; // Bump when the producer or the payload layout changes (callers also hash it into their keys)
+    const char *name; // Used in warnings ("program", "texture", ...)
+};
+
+[[nodiscard]] QString disk_cache_path(const DiskCache &cache, const QByteArray &key);
+
+// Payload of an entry; std::nullopt when it does not exist or its header is damaged (with a warning)
+[[nodiscard]] std::optional<QByteArray> load_disk_cache_entry(const DiskCache &cache, const QByteArray &key);
+void store_disk_cache_entry(const DiskCache &cache, const QByteArray &key, const QByteArray &payload); // Warns on failure
+void remove_disk_cache_entry(const DiskCache &cache, const QByteArray &key);
+
+// For payloads the caller rejects after a valid header (wrong counts, truncated levels, undecodable images)
+void warn_damaged_disk_cache_entry(const DiskCache &cache, const QByteArray &key);
+
+
+#endif //DISK_CACHE_H // End include guard
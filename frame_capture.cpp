@@ -0,0 +1,95 @@
+#include "frame_capture.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QImage>
+#include <QSaveFile>
+#include <QThread>
+
+#include <algorithm>
+#include <cstring>
+
+namespace // Anonymous namespace holding the encoder side
+{
+constexpr int kImageQuality = 90; // QImage quality: a light zlib level for PNG, so the encoders keep up with a recording
+
+// The only copy of a frame: flipped to top-down rows with opaque alpha (the scene target's alpha is not meaningful)
+QImage top_down_image(const std::uint8_t *pixels, const int width, const int height)
+{
+    QImage image(width, height, QImage::Format_RGB32); // 0xAARRGGBB words, i.e. BGRA bytes on little-endian hosts
+    const auto row_bytes = static_cast<std::size_t>(width) * 4;
+    for (int y(0); y < height; y++)
+    {
+        auto *row = reinterpret_cast<std::uint32_t*>(image.scanLine(y));
+        std::memcpy(row, pixels + static_cast<std::size_t>(height - 1 - y) * row_bytes, row_bytes);
+        for (int x(0); x < width; x++) row[x] |= 0xFF000000u;
+    }
+    return image;
+}
+
+bool write_capture_file(const QImage &image, const CaptureTarget &target)
+{
+    QSaveFile file(target.path); // Atomic replace: an interrupted recording never leaves a truncated frame behind
+    bool written = file.open(QIODevice::WriteOnly);
+    if (written && target.format == CaptureFormat::Raw)
+    {
+        written = file.write(reinterpret_cast<const char*>(image.constBits()), image.sizeInBytes()) == image.sizeInBytes();
+    }
+    else if (written)
+    {
+        const QByteArray suffix = QFileInfo(target.path).suffix().toLower().toLatin1(); // QImage cannot guess it from a QSaveFile
+        written = image.save(&file, suffix.isEmpty() ? "png" : suffix.constData(), kImageQuality);
+    }
+    if (!written || !file.commit())
+    {
+        qWarning() << "Cannot write captured frame" << target.path;
+        return false;
+    }
+    return true;
+}
+}
+
+QString capture_frame_path(const QString &directory, const std::uint64_t index, const int width, const int height, const CaptureFormat format)
+{
+    const QString name = QStringLiteral("frame_%1").arg(static_cast<qulonglong>(index), 6, 10, QLatin1Char('0'));
+    if (format == CaptureFormat::Raw) return QDir(directory).filePath(name + QStringLiteral("_%1x%2.bgra").arg(width).arg(height));
+    return QDir(directory).filePath(name + QStringLiteral(".png"));
+}
+
+CaptureTarget capture_target(const QString &path)
+{
+    const bool raw = QFileInfo(path).suffix().compare(QStringLiteral("bgra"), Qt::CaseInsensitive) == 0;
+    return {path, raw ? CaptureFormat::Raw : CaptureFormat::Image};
+}
+
+CaptureWriter::CaptureWriter()
+{
+    pool_.setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2)); // The render thread and the frame jobs keep the rest
+}
+
+CaptureWriter::~CaptureWriter()
+{
+    wait();
+}
+
+void CaptureWriter::write(const std::uint8_t *pixels, const int width, const int height, std::vector<CaptureTarget> targets,
+                          std::atomic<bool> &in_use)
+{
+    active_.fetch_add(1, std::memory_order_relaxed);
+    pool_.start([this, pixels, width, height, targets = std::move(targets), &in_use]
+    {
+        const QImage image = top_down_image(pixels, width, height);
+        in_use.store(false, std::memory_order_release); // The ring may read the next frame into the slot while this one encodes
+        for (const CaptureTarget &target : targets)
+        {
+            (write_capture_file(image, target) ? written_ : failed_).fetch_add(1, std::memory_order_relaxed);
+        }
+        active_.fetch_sub(1, std::memory_order_relaxed);
+    });
+}
+
+void CaptureWriter::wait()
+{
+    pool_.waitForDone();
+}
@@ -0,0 +1,66 @@
+#ifndef FRAME_CAPTURE_H // Guard against multiple inclusion
+#define FRAME_CAPTURE_H // Begin include guard
+
+#include <QString> // Output paths
+#include <QThreadPool> // Encoder threads
+
+#include <atomic> // Slot release and counters shared with the encoders
+#include <cstdint> // Pixels and frame counts
+#include <vector> // Files written from one frame
+
+// Screenshots and frame sequences. The view reads a frame into one slot of a ring of pixel pack buffers and fences it;
+// once the fence has signaled a later frame hands the mapped slot to a CaptureWriter, whose threads flip, encode and
+// write it while the ring keeps going. Neither the readback nor the encoding waits on the render thread.
+
+enum class CaptureFormat : int
+{
+    Image = 0, // Encoded by QImage from the file suffix (PNG for frame sequences)
+    Raw = 1, // Top-down BGRA8 rows with no header (the size is part of the file name)
+};
+
+struct CaptureTarget // One file written from a captured frame
+{
+    QString path;
+    CaptureFormat format = CaptureFormat::Image;
+};
+
+struct CaptureRequest // What the GUI asked for; published with every snapshot
+{
+    bool recording = false; // Capture every rendered frame
+    QString directory; // Where the frames of the recording go
+    CaptureFormat format = CaptureFormat::Image; // Of the recorded frames
+    std::uint64_t session = 0; // Bumped by every start of a recording (restarts the frame numbers)
+    std::vector<CaptureTarget> screenshots; // Single frames requested since the last consumed snapshot
+};
+
+// Path of frame index of a recording: <directory>/frame_000042.png, or frame_000042_1920x1080.bgra for raw frames (so
+// "cat *.bgra | ffmpeg -f rawvideo -pixel_format bgra -video_size 1920x1080 -i - out.mp4" needs nothing else)
+[[nodiscard]] QString capture_frame_path(const QString &directory, std::uint64_t index, int width, int height, CaptureFormat format);
+
+// Screenshot target from a file name chosen by the user (".bgra" selects raw pixels)
+[[nodiscard]] CaptureTarget capture_target(const QString &path);
+
+class CaptureWriter // Encoder pool of one view; write() is called from the render thread, the counters from any thread
+{
+public:
+    CaptureWriter();
+    ~CaptureWriter(); // Waits for the running encodes
+
+    // Encode pixels (bottom-up BGRA rows, as read by glReadPixels) into every target on an encoder thread, then clear
+    // in_use. pixels must stay valid until then: it points into a mapped pack buffer owned by the caller.
+    void write(const std::uint8_t *pixels, int width, int height, std::vector<CaptureTarget> targets, std::atomic<bool> &in_use);
+    void wait(); // Until every encode finished (before the caller unmaps its buffers)
+
+    [[nodiscard]] std::uint64_t written() const { return written_.load(std::memory_order_relaxed); } // Files written
+    [[nodiscard]] std::uint64_t failed() const { return failed_.load(std::memory_order_relaxed); } // Files that could not be written
+    [[nodiscard]] int active() const { return active_.load(std::memory_order_relaxed); } // Frames being encoded
+
+private:
+    QThreadPool pool_;
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> failed_{0};
+    std::atomic<int> active_{0};
+};
+
+
+#endif //FRAME_CAPTURE_H // End include guard
@@ -0,0 +1,75 @@
+#include "frame_jobs.h"
+
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <latch>
+
+namespace // Anonymous namespace holding the shared worker pools
+{
+QThreadPool &frame_job_pool()
+{
+    static QThreadPool pool; // Separate from the global pool, which Qt uses for its own work
+    static const bool configured = [] // Calling threads take job 0, so one worker fewer than hardware threads
+    {
+        pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+        pool.setExpiryTimeout(-1); // Workers stay alive between frames
+        return true;
+    }();
+    static_cast<void>(configured);
+    return pool;
+}
+
+QThreadPool &background_job_pool()
+{
+    static QThreadPool pool; // Never shared with frame jobs: its jobs may run for seconds
+    static const bool configured = []
+    {
+        pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+        pool.setThreadPriority(QThread::LowPriority); // Frame jobs and the render thread keep their cores
+        return true;
+    }();
+    static_cast<void>(configured);
+    return pool;
+}
+
+void run_jobs(QThreadPool &pool, const std::size_t jobs, const std::size_t items, const FrameJobWork &work)
+{
+    const auto range_begin = [jobs, items](const std::size_t job) { return items * job / jobs; };
+    if (jobs <= 1)
+    {
+        work(0, 0, items);
+        return;
+    }
+
+    std::latch done(static_cast<std::ptrdiff_t>(jobs - 1)); // Workers only; job 0 finishes before waiting
+    for (std::size_t job = 1; job < jobs; job++)
+    {
+        pool.start([&work, &done, &range_begin, job]
+        {
+            work(job, range_begin(job), range_begin(job + 1));
+            done.count_down();
+        });
+    }
+    work(0, 0, range_begin(1));
+    done.wait();
+}
+}
+
+std::size_t frame_job_count(const std::size_t items, const std::size_t min_items_per_job)
+{
+    const auto threads = static_cast<std::size_t>(std::max(1, QThread::idealThreadCount()));
+    const std::size_t by_size = items / std::max<std::size_t>(1, min_items_per_job); // Small loops stay on the caller
+    return std::clamp<std::size_t>(by_size, 1, threads);
+}
+
+void run_frame_jobs(const std::size_t jobs, const std::size_t items, const FrameJobWork &work)
+{
+    run_jobs(frame_job_pool(), jobs, items, work);
+}
+
+void run_background_jobs(const std::size_t jobs, const std::size_t items, const FrameJobWork &work)
+{
+    run_jobs(background_job_pool(), jobs, items, work);
+}
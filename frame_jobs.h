@@ -0,0 +1,25 @@
+#ifndef FRAME_JOBS_H // Guard against multiple inclusion
+#define FRAME_JOBS_H // Begin include guard
+
+#include <cstddef> // Item counts and job indices
+#include <functional> // Work callback
+
+// Frame preparation splits per-object loops into contiguous ranges, one per job. Job j covers
+// [items * j / jobs, items * (j + 1) / jobs), so callers can keep one output list per job and merge them in job order:
+// the merged result is the same as a serial loop over all items, whatever the number of jobs.
+using FrameJobWork = std::function<void(std::size_t job, std::size_t begin, std::size_t end)>;
+
+// Jobs used for a loop over items: one per hardware thread, but never fewer than min_items_per_job items each (at least 1)
+[[nodiscard]] std::size_t frame_job_count(std::size_t items, std::size_t min_items_per_job);
+
+// Run work over every range and return once all of them finished. Job 0 runs on the calling thread, the others on a
+// process-wide pool shared by all views (jobs never wait for each other, so concurrent callers cannot deadlock).
+// Frame-critical work only: the caller blocks until every job ran, so nothing long may queue ahead of it.
+void run_frame_jobs(std::size_t jobs, std::size_t items, const FrameJobWork &work);
+
+// Same ranges and guarantees for bulk work off the frame path (imports, bakes, texture encoding). Jobs run on a second,
+// low-priority pool, so a long import never delays the jobs of a frame.
+void run_background_jobs(std::size_t jobs, std::size_t items, const FrameJobWork &work);
+
+
+#endif //FRAME_JOBS_H // End include guard
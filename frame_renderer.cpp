@@ -0,0 +1,69 @@
+#include "frame_renderer.h"
+
+#include "render_surface.h"
+#include "view_3D.h"
+
+#include <QGuiApplication>
+#include <QOpenGLContext>
+#include <QThread>
+
+FrameRenderer::FrameRenderer(View *view) : view_(view)
+{
+}
+
+void FrameRenderer::lock_with_context(QOpenGLContext *context)
+{
+    for (;;)
+    {
+        render_mutex_.lock();
+        if (context->thread() == QThread::currentThread()) return; // Home and no frame can take it until unlock()
+        render_mutex_.unlock(); // Moved over for a frame that still needs render_mutex_ to start; let it finish
+        QThread::yieldCurrentThread();
+    }
+}
+
+void FrameRenderer::grab_context(QOpenGLContext *context)
+{
+    QMutexLocker lock(&grab_mutex_);
+    if (exiting_ || !context_wanted_ || context_ready_) return; // Stale request: nobody would hand the context back
+    context->moveToThread(thread());
+    context_ready_ = true;
+    grab_condition_.wakeAll();
+}
+
+void FrameRenderer::prepare_exit()
+{
+    QMutexLocker lock(&grab_mutex_);
+    exiting_ = true;
+    grab_condition_.wakeAll();
+}
+
+void FrameRenderer::render()
+{
+    QOpenGLContext *context = view_->surface_->gl_context();
+    if (!exiting_ && context)
+    {
+        grab_mutex_.lock();
+        context_wanted_ = true;
+        context_ready_ = false;
+        emit contextWanted(); // The GUI thread answers through grab_context()
+        while (!context_ready_ && !exiting_) grab_condition_.wait(&grab_mutex_);
+        const bool owns_context = context_ready_;
+        context_wanted_ = false;
+        context_ready_ = false;
+        grab_mutex_.unlock();
+
+        if (owns_context)
+        {
+            QMutexLocker lock(&render_mutex_);
+            if (!exiting_)
+            {
+                view_->surface_->make_current(); // Binds the widget framebuffer on this thread
+                view_->render_frame();
+                view_->surface_->done_current();
+            }
+            context->moveToThread(qGuiApp->thread()); // Composition, resizes and uploads need it on the GUI thread
+        }
+    }
+    emit frameRendered();
+}
@@ -0,0 +1,47 @@
+#ifndef FRAME_RENDERER_H // Guard against multiple inclusion
+#define FRAME_RENDERER_H // Begin include guard
+
+#include <QMutex> // Serializes frames against composition, resizes and GUI-side uploads
+#include <QObject> // Base class; the renderer lives in the render thread and receives queued requests
+#include <QWaitCondition> // Hand-over of the GL context from the GUI thread
+
+#include <atomic> // Exit flag read by both threads
+
+class QOpenGLContext; // Context of the widget, moved between the threads
+class View; // Widget whose frames are rendered (owns all GL state)
+
+// Draws View frames on a dedicated thread. Only the thread owning a QOpenGLContext may move it, so every frame
+// asks the GUI thread to push the widget context over, renders the latest snapshot and pushes it back. Between
+// frames the GUI thread composes, resizes and uploads with the same context under render_mutex_.
+class FrameRenderer final : public QObject
+{
+    Q_OBJECT // Enable queued signals/slots across the two threads
+
+public:
+    explicit FrameRenderer(View *view); // No parent: the object is moved to the render thread
+
+    void lock() { render_mutex_.lock(); } // GUI thread: wait for the frame in progress and hold off the next one
+    void unlock() { render_mutex_.unlock(); } // GUI thread: counterpart of lock() and lock_with_context()
+    void lock_with_context(QOpenGLContext *context); // GUI thread: lock() once the context is back on the GUI thread
+    void grab_context(QOpenGLContext *context); // GUI thread: move the context to the render thread if a frame waits for it
+    void prepare_exit(); // GUI thread: a frame waiting for the context gives up; later frames do nothing
+
+public slots:
+    void render(); // Render thread: borrow the context, draw one frame, give the context back
+
+signals:
+    void contextWanted(); // Queued to the GUI thread, which owns the context between frames
+    void frameRendered(); // Frame finished (or skipped); the GUI thread composes it
+
+private:
+    View *view_ = nullptr; // Widget rendered into
+    QMutex render_mutex_; // Held for the whole frame
+    QMutex grab_mutex_; // Guards the hand-over flags below
+    QWaitCondition grab_condition_; // Signalled when the context arrived or on exit
+    bool context_wanted_ = false; // render() is waiting for the context
+    bool context_ready_ = false; // Context was moved to the render thread for this frame
+    std::atomic<bool> exiting_{false}; // Set once before the thread is stopped
+};
+
+
+#endif //FRAME_RENDERER_H // End include guard
@@ -0,0 +1,130 @@
+#include "light_clusters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace // Anonymous namespace holding binning helpers
+{
+// Tile holding an NDC coordinate along one axis
+std::uint32_t ndc_to_tile(const float ndc, const std::uint32_t tiles)
+{
+    const float tile = std::floor((ndc * 0.5f + 0.5f) * static_cast<float>(tiles));
+    return static_cast<std::uint32_t>(std::clamp(tile, 0.0f, static_cast<float>(tiles - 1)));
+}
+
+// Conservative NDC interval of a view-space sphere along one axis (x or y), for a sphere fully in front of the near plane
+glm::vec2 projected_interval(const float center, const float radius, const float depth, const float projection_scale)
+{
+    const float high = center + radius; // Largest coordinate; largest ratio at the nearest depth when positive
+    const float low = center - radius;
+    const float near_depth = depth - radius;
+    const float far_depth = depth + radius;
+    return {projection_scale * low / (low < 0.0f ? near_depth : far_depth),
+            projection_scale * high / (high > 0.0f ? near_depth : far_depth)};
+}
+}
+
+glm::vec2 cluster_depth_scale_bias(const float near_plane, const float far_plane)
+{
+    const float scale = static_cast<float>(kClusterGridZ) / std::log(far_plane / near_plane);
+    return {scale, std::log(near_plane) * scale};
+}
+
+void build_light_clusters(const std::vector<ClusterLight> &lights, const glm::mat4 &view, const glm::mat4 &projection,
+                          const float near_plane, const float far_plane, LightClusters &clusters)
+{
+    const glm::vec2 depth_scale_bias = cluster_depth_scale_bias(near_plane, far_plane);
+    const auto slice_of = [&depth_scale_bias](const float depth)
+    {
+        const float slice = std::floor(std::log(depth) * depth_scale_bias.x - depth_scale_bias.y);
+        return static_cast<std::uint32_t>(std::clamp(slice, 0.0f, static_cast<float>(kClusterGridZ - 1)));
+    };
+
+    clusters.ranges.assign(kClusterCount, glm::uvec2(0u));
+    clusters.bounds.resize(lights.size());
+    clusters.visible_lights = 0;
+
+    // Pass 1: cluster box of every light, and the light count per cluster
+    for (std::size_t i(0); i < lights.size(); i++)
+    {
+        std::array<std::uint32_t, 6> &box = clusters.bounds[i];
+        box = {1, 0, 0, 0, 0, 0}; // Empty (x0 > x1) unless the light reaches the frustum
+        const glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(lights[i].position_range), 1.0f));
+        const float radius = lights[i].position_range.w;
+        const float depth = -center.z; // Distance along the view axis
+        if (depth + radius < near_plane || depth - radius > far_plane) continue; // Behind the camera or beyond the far plane
+
+        std::uint32_t x0 = 0, x1 = kClusterGridX - 1, y0 = 0, y1 = kClusterGridY - 1;
+        if (depth - radius > near_plane) // Otherwise the sphere can cover any part of the screen
+        {
+            const glm::vec2 x = projected_interval(center.x, radius, depth, projection[0][0]);
+            const glm::vec2 y = projected_interval(center.y, radius, depth, projection[1][1]);
+            if (x.y < -1.0f || x.x > 1.0f || y.y < -1.0f || y.x > 1.0f) continue; // Outside the side planes
+            x0 = ndc_to_tile(x.x, kClusterGridX);
+            x1 = ndc_to_tile(x.y, kClusterGridX);
+            y0 = ndc_to_tile(y.x, kClusterGridY);
+            y1 = ndc_to_tile(y.y, kClusterGridY);
+        }
+        box = {x0, x1, y0, y1, slice_of(std::max(depth - radius, near_plane)), slice_of(std::min(depth + radius, far_plane))};
+        clusters.visible_lights++;
+
+        for (std::uint32_t z = box[4]; z <= box[5]; z++)
+            for (std::uint32_t y = y0; y <= y1; y++)
+                for (std::uint32_t x = x0; x <= x1; x++) clusters.ranges[(z * kClusterGridY + y) * kClusterGridX + x].y++;
+    }
+
+    // Offsets by prefix sum, then pass 2 fills the lists in light order (deterministic)
+    std::uint32_t offset = 0;
+    clusters.occupied_clusters = 0;
+    clusters.max_lights_per_cluster = 0;
+    for (glm::uvec2 &range : clusters.ranges)
+    {
+        range.x = offset;
+        offset += range.y;
+        clusters.occupied_clusters += range.y > 0;
+        clusters.max_lights_per_cluster = std::max<std::size_t>(clusters.max_lights_per_cluster, range.y);
+        range.y = 0; // Refilled below
+    }
+    clusters.indices.resize(std::max<std::uint32_t>(offset, 1)); // Never empty: the buffer is bound even without lights
+    for (std::size_t i(0); i < lights.size(); i++)
+    {
+        const std::array<std::uint32_t, 6> &box = clusters.bounds[i];
+        if (box[0] > box[1]) continue;
+        for (std::uint32_t z = box[4]; z <= box[5]; z++)
+            for (std::uint32_t y = box[2]; y <= box[3]; y++)
+                for (std::uint32_t x = box[0]; x <= box[1]; x++)
+                {
+                    glm::uvec2 &range = clusters.ranges[(z * kClusterGridY + y) * kClusterGridX + x];
+                    clusters.indices[range.x + range.y++] = static_cast<std::uint32_t>(i);
+                }
+    }
+}
+
+std::vector<ClusterLight> make_demo_lights(const std::size_t count, const float extent, const float ground_height)
+{
+    std::vector<ClusterLight> lights(count);
+    const float golden_angle = std::numbers::pi_v<float> * (3.0f - std::sqrt(5.0f));
+    const float range = std::clamp(2.4f * extent / std::sqrt(static_cast<float>(std::max<std::size_t>(count, 1))), 1.5f, 10.0f);
+    for (std::size_t i(0); i < count; i++)
+    {
+        const float t = (static_cast<float>(i) + 0.5f) / static_cast<float>(count); // Uniform area coverage of the disc
+        const float angle = golden_angle * static_cast<float>(i);
+        const float distance = extent * std::sqrt(t);
+        const float height = ground_height + 0.6f + 1.8f * std::fmod(static_cast<float>(i) * 0.618034f, 1.0f);
+        const float hue = std::fmod(static_cast<float>(i) * 0.137f, 1.0f) * 6.0f; // Spread hues around the color wheel
+        const glm::vec3 color = glm::clamp(glm::vec3(std::abs(hue - 3.0f) - 1.0f, 2.0f - std::abs(hue - 2.0f), 2.0f - std::abs(hue - 4.0f)),
+                                           glm::vec3(0.0f), glm::vec3(1.0f));
+
+        ClusterLight &light = lights[i];
+        light.position_range = glm::vec4(distance * std::cos(angle), height, distance * std::sin(angle), range);
+        light.color_intensity = glm::vec4(glm::mix(color, glm::vec3(1.0f), 0.3f), 3.0f);
+        if (i % 4 == 3) // Spot light aimed at the ground below it
+        {
+            light.position_range.w = range * 1.5f; // Cones reach further to make up for their smaller footprint
+            light.direction_cos_outer = glm::vec4(0.0f, -1.0f, 0.0f, std::cos(glm::radians(35.0f)));
+            light.cos_inner = glm::vec4(std::cos(glm::radians(25.0f)));
+        }
+    }
+    return lights;
+}
@@ -0,0 +1,51 @@
+#ifndef LIGHT_CLUSTERS_H // Guard against multiple inclusion
+#define LIGHT_CLUSTERS_H // Begin include guard
+
+#include <glm/glm.hpp> // Light positions and camera matrices
+
+#include <array> // Per-light cluster bounds
+#include <cstddef> // Counts
+#include <cstdint> // Index list entries mirrored by the shader
+#include <vector> // Lights and binning output
+
+// Clustered forward lighting: the view frustum is split into a grid of clusters (screen tiles x exponential depth
+// slices), every light is binned into the clusters its range overlaps, and a fragment only loops over the lights
+// of its own cluster. The grid size must match kClusterGrid in the lit shading source (view_3D.cpp).
+constexpr std::uint32_t kClusterGridX = 16; // Tiles across the render area
+constexpr std::uint32_t kClusterGridY = 9; // Tiles down the render area
+constexpr std::uint32_t kClusterGridZ = 24; // Depth slices between the near and far planes
+constexpr std::size_t kClusterCount = std::size_t{kClusterGridX} * kClusterGridY * kClusterGridZ;
+
+struct alignas(16) ClusterLight // std430 mirror of one light read by the lit shading
+{
+    glm::vec4 position_range{0.0f, 0.0f, 0.0f, 1.0f}; // xyz: world position, w: range (no contribution beyond it)
+    glm::vec4 color_intensity{1.0f}; // rgb: color, a: intensity
+    glm::vec4 direction_cos_outer{0.0f, -1.0f, 0.0f, -2.0f}; // xyz: spot direction, w: cosine of the outer cone (-2: point light)
+    glm::vec4 cos_inner{1.0f}; // x: cosine of the inner cone (full intensity inside)
+};
+static_assert(sizeof(ClusterLight) == 64, "ClusterLight must match the std430 layout in the lit shading");
+
+struct LightClusters // Binning result of one frame; buffers are reused between frames
+{
+    std::vector<glm::uvec2> ranges; // Per cluster: first entry in indices, light count
+    std::vector<std::uint32_t> indices; // Light indices, cluster after cluster (ascending within a cluster)
+    std::vector<std::array<std::uint32_t, 6>> bounds; // Scratch: cluster box of each light (x0, x1, y0, y1, z0, z1), empty if culled
+    std::size_t visible_lights = 0; // Lights overlapping the frustum
+    std::size_t occupied_clusters = 0; // Clusters with at least one light
+    std::size_t max_lights_per_cluster = 0; // Longest light loop a fragment can run
+};
+
+// Depth slice of a view-space distance d is log(d) * x - y (exponential slices keep clusters roughly cubic)
+[[nodiscard]] glm::vec2 cluster_depth_scale_bias(float near_plane, float far_plane);
+
+// Bin lights into the grid for a perspective camera. Bounds are conservative: a sphere's screen rectangle comes from
+// its view-space box at the nearest depth, and lights reaching the near plane cover every tile of their slices.
+void build_light_clusters(const std::vector<ClusterLight> &lights, const glm::mat4 &view, const glm::mat4 &projection,
+                          float near_plane, float far_plane, LightClusters &clusters);
+
+// Deterministic demo rig over the ground: point lights on a spiral, every fourth one a downward spot light.
+// The range shrinks as the count grows, so the lights per cluster stay roughly constant.
+[[nodiscard]] std::vector<ClusterLight> make_demo_lights(std::size_t count, float extent, float ground_height);
+
+
+#endif //LIGHT_CLUSTERS_H // End include guard
@@ -1,10 +1,46 @@
 #include "main_window.h"    // Main window class declaration/definition
+#include "backend_benchmark.h" // --benchmark: compare the presentation backends
+#include "view_3D.h" // Presentation backend selection
 
 #include <QApplication> // Qt application runtime (event loop, rendering integration)
+#include <QCommandLineParser> // --backend, --swap-interval and --benchmark options
+#include <QDebug> // Warnings about invalid options
+#include <QEventLoop> // --render waits for the occlusion bakes
+#include <QOffscreenSurface> // OpenGL probe without a window
+#include <QOpenGLContext> // OpenGL probe: the software backend takes over below 4.5
 #include <QSurfaceFormat>   // Request an OpenGL context format (version/profile/buffers)
 
 #include <QIcon>
 
+#include <algorithm>
+
+namespace // Anonymous namespace holding start-up helpers
+{
+// The GL backends need OpenGL 4.5 core entry points; VMs and remote sessions often offer less, and the view would stay blank
+bool opengl_available()
+{
+    QOpenGLContext context;
+    context.setFormat(QSurfaceFormat::defaultFormat());
+    if (!context.create()) return false;
+    QOffscreenSurface surface;
+    surface.setFormat(context.format());
+    surface.create();
+    if (!context.makeCurrent(&surface)) return false;
+    const QSurfaceFormat format = context.format(); // What the driver granted, not what was asked for
+    const bool available = (format.majorVersion() > 4 || (format.majorVersion() == 4 && format.minorVersion() >= 5)) &&
+                           format.profile() == QSurfaceFormat::CoreProfile;
+    context.doneCurrent();
+    return available;
+}
+
+// --size WxH of --render
+QSize parse_size(const QString &text)
+{
+    const QStringList parts = text.split(QLatin1Char('x'));
+    if (parts.size() != 2) return {};
+    return {parts[0].toInt(), parts[1].toInt()};
+}
+}
 
 int main(int argc, char *argv[])    // Standard Qt/desktop app entry point
 {
@@ -14,11 +50,98 @@ int main(int argc, char *argv[])    // Standard Qt/desktop app entry point
     surface_format.setVersion(4, 6);    // Request OpenGL version 4.6 (major=4, minor=6) — not guaranteed
     surface_format.setProfile(QSurfaceFormat::CoreProfile); // Ask for a Core profile (no deprecated fixed-function pipeline)
     surface_format.setDepthBufferSize(24);  // Ask for a 24-bit depth buffer (useful when doing 3D)
-    surface_format.setSamples(8);   // Anti-aliasing; 8 samples per pixel
+    surface_format.setSamples(0);   // No MSAA on the widget itself; the view renders into its own (scaled, multisampled) target
     QSurfaceFormat::setDefaultFormat(surface_format);   // Make this the default for all windows/contexts created afterward
 
     QApplication::setAttribute(Qt::AA_UseDesktopOpenGL);    // Force desktop OpenGL
+    QApplication::setAttribute(Qt::AA_ShareOpenGLContexts);    // Viewports of one scene draw from the same geometry pools
     QApplication app(argc, argv);   // Construct the Qt application (now picks up the default GL format)
+
+    QCommandLineParser parser; // Optional presentation settings; no arguments starts the editor on the widget backend
+    parser.setApplicationDescription(QStringLiteral("3D Objects"));
+    parser.addHelpOption();
+    const QCommandLineOption backend_option(QStringLiteral("backend"),
+                                            QStringLiteral("Presentation backend: widget (composited, default), window (native) or software (CPU, no OpenGL)."),
+                                            QStringLiteral("widget|window|software"), QStringLiteral("widget"));
+    const QCommandLineOption swap_interval_option(QStringLiteral("swap-interval"),
+                                                  QStringLiteral("Buffer swaps per vertical refresh; 0 disables vsync."),
+                                                  QStringLiteral("n"), QStringLiteral("1"));
+    const QCommandLineOption benchmark_option(QStringLiteral("benchmark"),
+                                              QStringLiteral("Measure frame time and input latency of every backend, then exit."));
+    const QCommandLineOption frames_option(QStringLiteral("frames"), QStringLiteral("Frames measured per benchmark run."),
+                                           QStringLiteral("n"), QStringLiteral("600"));
+    const QCommandLineOption shader_dir_option(QStringLiteral("shader-dir"),
+                                               QStringLiteral("Directory of GLSL snippets, recompiled whenever a file changes."),
+                                               QStringLiteral("dir"));
+    const QCommandLineOption render_option(QStringLiteral("render"),
+                                           QStringLiteral("Draw the models with the software rasterizer into an image file, then exit (headless with -platform offscreen)."),
+                                           QStringLiteral("file"));
+    const QCommandLineOption size_option(QStringLiteral("size"), QStringLiteral("Image size of --render."), QStringLiteral("WxH"),
+                                         QStringLiteral("1280x720"));
+    const QCommandLineOption color_mode_option(QStringLiteral("color-mode"), QStringLiteral("Color mode of --render (0 uniform ... 6 ambient occlusion)."),
+                                               QStringLiteral("n"), QStringLiteral("0"));
+    parser.addOption(backend_option);
+    parser.addOption(swap_interval_option);
+    parser.addOption(benchmark_option);
+    parser.addOption(frames_option);
+    parser.addOption(shader_dir_option);
+    parser.addOption(render_option);
+    parser.addOption(size_option);
+    parser.addOption(color_mode_option);
+    parser.addPositionalArgument(QStringLiteral("models"), QStringLiteral("OBJ files of the benchmark or --render scene."), QStringLiteral("[models...]"));
+    parser.process(app);
+
+    bool swap_interval_ok = false;
+    const int swap_interval = parser.value(swap_interval_option).toInt(&swap_interval_ok);
+    if (swap_interval_ok && swap_interval >= 0) // Both backends: the widget's top-level window swaps with the default format too
+    {
+        surface_format.setSwapInterval(swap_interval);
+        QSurfaceFormat::setDefaultFormat(surface_format); // No window exists yet
+    }
+    else qWarning() << "Ignoring invalid --swap-interval" << parser.value(swap_interval_option);
+
+    if (parser.isSet(render_option)) // Image tests: no window, no OpenGL
+    {
+        const QSize size = parse_size(parser.value(size_option));
+        if (size.isEmpty())
+        {
+            qWarning() << "Invalid --size" << parser.value(size_option);
+            return 1;
+        }
+        View view(nullptr, View::Backend::Software);
+        view.set_hud_visible(false);
+        view.set_color_mode(static_cast<View::ColorMode>(std::clamp(parser.value(color_mode_option).toInt(), 0, View::kColorModeCount - 1)));
+        for (const QString &model : parser.positionalArguments())
+        {
+            if (!view.load_object(model)) qWarning() << "Could not load" << model;
+        }
+        while (view.occlusion_bakes_pending()) QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents); // Results arrive as queued calls
+        const QString file = parser.value(render_option);
+        if (!view.render_image(size).save(file))
+        {
+            qWarning() << "Could not write" << file;
+            return 1;
+        }
+        return 0;
+    }
+
+    const QString backend = parser.value(backend_option);
+    if (backend == QStringLiteral("window")) View::set_default_backend(View::Backend::Window);
+    else if (backend == QStringLiteral("software")) View::set_default_backend(View::Backend::Software);
+    else if (backend != QStringLiteral("widget")) qWarning() << "Unknown --backend" << backend << "- using widget";
+    if (View::default_backend() != View::Backend::Software && !opengl_available())
+    {
+        qWarning() << "OpenGL 4.5 core is unavailable - using the software backend";
+        View::set_default_backend(View::Backend::Software);
+    }
+    if (parser.isSet(shader_dir_option)) View::set_shader_directory(parser.value(shader_dir_option)); // Before any view exists
+
+    if (parser.isSet(benchmark_option))
+    {
+        const int frames = std::max(1, parser.value(frames_option).toInt());
+        return run_backend_benchmark(frames, parser.positionalArguments());
+    }
+
     QApplication::setWindowIcon(QIcon(":/icons/Icon/Icon.png"));
     MainWindow w;   // Create main window
     w.setWindowIcon(QIcon(":/icons/Icon/Icon.png"));
@@ -1,19 +1,25 @@
 #include "main_window.h"    // Header for this class (declaration of MainWindow)
 #include "ui_main_window.h" // Auto-generated header from MainWindow.ui (defines Ui::MainWindow)
-#include "view_3D.h"   // OpenGL widget class (QOpenGLWidget subclass)
+#include "view_3D.h"   // 3D viewport widget (hosts the GL surface)
+#include "asset_browser.h" // OBJ thumbnails of a directory, left of the viewports
 
 #include <QToolBar>
 #include <QAction>
 #include <QLabel>
 #include <QLineEdit>
 #include <QComboBox>
+#include <QCheckBox>
+#include <QDoubleSpinBox>
 #include <QString>
 #include <QDoubleValidator>
 #include <QLocale>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QPushButton>
 #include <QSizePolicy>
 #include <QSignalBlocker>
+#include <QSpinBox>
+#include <QSplitter>
 
 #include <limits>
 #include <memory>
@@ -24,9 +30,13 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
 {
     ui->setupUi(this);
 
-    // GL scene widget into your layout
-    auto *scene = new View(this);
-    ui->verticalLayout->addWidget(scene);
+    // GL scene widget into your layout; the optional top/front viewports are added to the right of it, the asset browser to the left
+    content_splitter_ = new QSplitter(Qt::Horizontal, this);
+    viewport_splitter_ = new QSplitter(Qt::Horizontal, content_splitter_);
+    auto *scene = new View(viewport_splitter_);
+    viewport_splitter_->addWidget(scene);
+    content_splitter_->addWidget(viewport_splitter_);
+    ui->verticalLayout->addWidget(content_splitter_);
 
     // Toolbar 1: Controls
     QToolBar* tool_bar = addToolBar("Controls");
@@ -92,11 +102,15 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
         camera_rotation_y_line_edit_->setText("15");
         camera_rotation_z_line_edit_->setText("0");
 
-        if (color_mode_combo_box_)
+        if (color_mode_combo_box_) // Not blocked: the side views reset their color mode through connect_render_options
         {
-            const QSignalBlocker blocker(color_mode_combo_box_);
             color_mode_combo_box_->setCurrentIndex(static_cast<int>(View::ColorMode::Uniform));
         }
+        if (depth_prepass_combo_box_)
+        {
+            const QSignalBlocker blocker(depth_prepass_combo_box_);
+            depth_prepass_combo_box_->setCurrentIndex(static_cast<int>(scene->depth_prepass(View::ColorMode::Uniform)));
+        }
     });
 
     tool_bar->addSeparator();
@@ -201,19 +215,44 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
             "}"
         );
     }
-    connect(object_import, &QAction::triggered, this, [this, scene]
+    const auto import_object = [this, scene](const QString &file_path)
+    {
+        if (!scene->load_object(file_path))
+        {
+            QMessageBox::warning(this, tr("Import failed"), tr("Unable to load the selected model file."));
+        }
+    };
+    connect(object_import, &QAction::triggered, this, [this, import_object]
     {
         const QString file_path = QFileDialog::getOpenFileName(
             this,
-            tr("Import OBJ"),
+            tr("Import model"),
             QString(),
-            tr("OBJ Files (*.obj)")
+            tr("Models (*.obj *.fbx *.gltf *.glb *.dae);;OBJ Files (*.obj)") // Rigged formats bring their skeleton and clips
         );
         if (file_path.isEmpty()) return;
-        if (!scene->load_object(file_path))
+        import_object(file_path);
+    });
+
+    const QAction *asset_browse = tool_bar->addAction("Assets");
+    connect(asset_browse, &QAction::triggered, this, [this, import_object]
+    {
+        const QString directory = QFileDialog::getExistingDirectory(
+            this,
+            tr("Browse OBJ assets"),
+            asset_browser_ ? asset_browser_->directory() : QString()
+        );
+        if (directory.isEmpty()) return;
+        if (!asset_browser_) // Created on first use, left of the viewports
         {
-            QMessageBox::warning(this, tr("Import failed"), tr("Unable to load the selected OBJ file."));
+            asset_browser_ = new AssetBrowser(content_splitter_);
+            asset_browser_->setMinimumWidth(kThumbnailSize + 48);
+            content_splitter_->insertWidget(0, asset_browser_);
+            content_splitter_->setStretchFactor(1, 1); // Window resizes go to the viewports
+            connect(asset_browser_, &AssetBrowser::asset_activated, this, import_object);
         }
+        asset_browser_->set_directory(directory); // Thumbnails fill in as the workers finish them
+        asset_browser_->show();
     });
 
     // Toolbar 2: Help (full-width below)
@@ -237,15 +276,21 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
                                      QStringLiteral("Position"),
                                      QStringLiteral("Normal"),
                                      QStringLiteral("UV"),
-                                     QStringLiteral("Position + Normal")});
+                                     QStringLiteral("Position + Normal"),
+                                     QStringLiteral("Lit"),
+                                     QStringLiteral("Ambient occlusion")});
     color_mode_combo_box_->setCurrentIndex(static_cast<int>(View::ColorMode::Uniform));
     color_mode_combo_box_->setFixedWidth(140);
     help_tool_bar->addWidget(color_mode_combo_box_);
     connect(color_mode_combo_box_, qOverload<int>(&QComboBox::currentIndexChanged), this,
-            [scene](const int index)
+            [this, scene](const int index)
             {
-                const int clamped = std::clamp(index, 0, 4);
-                scene->set_color_mode(static_cast<View::ColorMode>(clamped));
+                const int clamped = std::clamp(index, 0, View::kColorModeCount - 1); // The views apply it through connect_render_options
+                if (depth_prepass_combo_box_) // Show the pre-pass setting of the newly selected mode
+                {
+                    const QSignalBlocker blocker(depth_prepass_combo_box_);
+                    depth_prepass_combo_box_->setCurrentIndex(static_cast<int>(scene->depth_prepass(static_cast<View::ColorMode>(clamped))));
+                }
             });
 
     help_tool_bar->addSeparator();
@@ -267,6 +312,294 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
     help_label_->setStyleSheet("padding:6px 8px;");
 
     help_tool_bar->addWidget(help_label_);
+
+    // Toolbar 3: Rendering options (full-width below)
+    addToolBarBreak();  // Place next toolbar on a new row
+
+    QToolBar* render_tool_bar = addToolBar("Rendering");
+    render_tool_bar->setMovable(false);
+    render_tool_bar->setStyleSheet("QToolBar { spacing: 10px; padding-left: 16px; }");
+
+    gpu_culling_check_box_ = new QCheckBox(QStringLiteral("GPU culling"), render_tool_bar);
+    gpu_culling_check_box_->setChecked(scene->gpu_culling());
+    gpu_culling_check_box_->setToolTip(QStringLiteral("Frustum culling, LOD selection and draw generation in a compute shader"));
+    render_tool_bar->addWidget(gpu_culling_check_box_);
+
+    sort_draws_check_box_ = new QCheckBox(QStringLiteral("Sort draws"), render_tool_bar);
+    sort_draws_check_box_->setChecked(scene->sort_draws());
+    sort_draws_check_box_->setToolTip(QStringLiteral("Radix-sort the draws by vertex format and front-to-back depth.\n"
+                                                     "With GPU culling the objects are sorted and keep one command slot each."));
+    render_tool_bar->addWidget(sort_draws_check_box_);
+
+    render_tool_bar->addSeparator();
+    render_tool_bar->addWidget(new QLabel(QStringLiteral("Render path:"), render_tool_bar));
+    render_path_combo_box_ = new QComboBox(render_tool_bar);
+    render_path_combo_box_->addItems({QStringLiteral("Forward"),
+                                      QStringLiteral("Visibility buffer")});
+    render_path_combo_box_->setCurrentIndex(static_cast<int>(scene->render_path()));
+    render_path_combo_box_->setToolTip(QStringLiteral("Visibility buffer: rasterize draw/triangle ids, then shade each pixel once"));
+    render_tool_bar->addWidget(render_path_combo_box_);
+
+    render_tool_bar->addWidget(new QLabel(QStringLiteral("Depth pre-pass:"), render_tool_bar));
+    depth_prepass_combo_box_ = new QComboBox(render_tool_bar);
+    depth_prepass_combo_box_->addItems({QStringLiteral("Off"),
+                                        QStringLiteral("Auto"),
+                                        QStringLiteral("On")});
+    depth_prepass_combo_box_->setCurrentIndex(static_cast<int>(scene->depth_prepass(View::ColorMode::Uniform)));
+    depth_prepass_combo_box_->setToolTip(QStringLiteral("Forward path, current color mode: lay down depth from positions only, then shade with GL_EQUAL.\n"
+                                                        "Auto enables it while the measured overdraw is high."));
+    render_tool_bar->addWidget(depth_prepass_combo_box_);
+
+    render_tool_bar->addSeparator();
+    dynamic_resolution_check_box_ = new QCheckBox(QStringLiteral("Dynamic resolution"), render_tool_bar);
+    dynamic_resolution_check_box_->setChecked(scene->dynamic_resolution());
+    dynamic_resolution_check_box_->setToolTip(QStringLiteral("Scale the offscreen render resolution to keep the GPU frame time inside the budget, then upscale"));
+    render_tool_bar->addWidget(dynamic_resolution_check_box_);
+
+    render_tool_bar->addWidget(new QLabel(QStringLiteral("Budget:"), render_tool_bar));
+    frame_budget_spin_box_ = new QDoubleSpinBox(render_tool_bar);
+    frame_budget_spin_box_->setRange(4.0, 100.0);
+    frame_budget_spin_box_->setDecimals(1);
+    frame_budget_spin_box_->setSingleStep(1.0);
+    frame_budget_spin_box_->setSuffix(QStringLiteral(" ms"));
+    frame_budget_spin_box_->setValue(scene->frame_budget_ms());
+    frame_budget_spin_box_->setToolTip(QStringLiteral("GPU frame-time budget (16.7 ms = 60 fps, 33.3 ms = 30 fps)"));
+    render_tool_bar->addWidget(frame_budget_spin_box_);
+
+    adaptive_msaa_check_box_ = new QCheckBox(QStringLiteral("Adapt MSAA"), render_tool_bar);
+    adaptive_msaa_check_box_->setChecked(scene->adaptive_msaa());
+    adaptive_msaa_check_box_->setToolTip(QStringLiteral("Lower the MSAA level once the resolution scale is at its minimum"));
+    render_tool_bar->addWidget(adaptive_msaa_check_box_);
+
+    render_tool_bar->addWidget(new QLabel(QStringLiteral("Anti-aliasing:"), render_tool_bar));
+    anti_aliasing_combo_box_ = new QComboBox(render_tool_bar);
+    anti_aliasing_combo_box_->addItems({QStringLiteral("MSAA 1x (off)"),
+                                        QStringLiteral("MSAA 2x"),
+                                        QStringLiteral("MSAA 4x"),
+                                        QStringLiteral("MSAA 8x"),
+                                        QStringLiteral("FXAA")});
+    anti_aliasing_combo_box_->setCurrentIndex(static_cast<int>(scene->anti_aliasing()));
+    anti_aliasing_combo_box_->setToolTip(QStringLiteral("MSAA level of the offscreen scene target, or a single-sample target with an FXAA pass.\n"
+                                                        "The Frame HUD lists GPU time and memory of every option tried."));
+    render_tool_bar->addWidget(anti_aliasing_combo_box_);
+
+    render_tool_bar->addWidget(new QLabel(QStringLiteral("Lights:"), render_tool_bar));
+    light_count_spin_box_ = new QSpinBox(render_tool_bar);
+    light_count_spin_box_->setRange(0, 1024);
+    light_count_spin_box_->setSingleStep(32);
+    light_count_spin_box_->setValue(scene->light_count());
+    light_count_spin_box_->setToolTip(QStringLiteral("Point and spot lights of the Lit color source, binned into a 16x9x24 cluster grid every frame.\n"
+                                                     "Each pixel only evaluates the lights of its cluster."));
+    render_tool_bar->addWidget(light_count_spin_box_);
+    connect(light_count_spin_box_, qOverload<int>(&QSpinBox::valueChanged), scene, &View::set_light_count); // Shared by all viewports
+
+    shadows_check_box_ = new QCheckBox(QStringLiteral("Shadows"), render_tool_bar);
+    shadows_check_box_->setChecked(scene->shadows());
+    shadows_check_box_->setToolTip(QStringLiteral("Sun shadows of the Lit color source from a cached 8x8-tile shadow atlas.\n"
+                                                  "Only tiles under moved, scaled, added or deleted objects are re-rendered; camera moves reuse the atlas."));
+    render_tool_bar->addWidget(shadows_check_box_);
+
+    wireframe_check_box_ = new QCheckBox(QStringLiteral("Wireframe"), render_tool_bar);
+    wireframe_check_box_->setChecked(scene->wireframe());
+    wireframe_check_box_->setToolTip(QStringLiteral("Triangle edges of imported meshes over their shading, in the same draw.\n"
+                                                    "Forward: a geometry stage adds edge distances; visibility buffer: the resolve's barycentrics."));
+    render_tool_bar->addWidget(wireframe_check_box_);
+
+    bake_occlusion_check_box_ = new QCheckBox(QStringLiteral("Bake AO"), render_tool_bar);
+    bake_occlusion_check_box_->setChecked(scene->bake_ambient_occlusion());
+    bake_occlusion_check_box_->setToolTip(QStringLiteral("Bake per-vertex ambient occlusion when importing (hemisphere rays against the mesh's own BVH, on all cores).\n"
+                                                         "Results are cached per file; shown by the Ambient occlusion color source and darkening Lit ambient."));
+    render_tool_bar->addWidget(bake_occlusion_check_box_);
+    connect(bake_occlusion_check_box_, &QCheckBox::toggled, scene, &View::set_bake_ambient_occlusion); // Import option of the shared scene
+
+    animate_check_box_ = new QCheckBox(QStringLiteral("Animate"), render_tool_bar);
+    animate_check_box_->setChecked(scene->animation_playing());
+    animate_check_box_->setToolTip(QStringLiteral("Play the first clip of rigged meshes (FBX, glTF, Collada). Poses are evaluated on all cores\n"
+                                                  "and skinned on the GPU; further imports of a file are instances sharing its mesh."));
+    render_tool_bar->addWidget(animate_check_box_);
+
+    animation_fixed_step_check_box_ = new QCheckBox(QStringLiteral("Fixed step"), render_tool_bar);
+    animation_fixed_step_check_box_->setChecked(scene->animation_fixed_step());
+    animation_fixed_step_check_box_->setToolTip(QStringLiteral("Advance the animation by exactly 1/60 s per presented frame instead of by wall-clock time,\n"
+                                                               "so every run poses the same frames (benchmarks, recordings)."));
+    render_tool_bar->addWidget(animation_fixed_step_check_box_);
+
+    restart_animation_button_ = new QPushButton(QStringLiteral("Restart"), render_tool_bar);
+    restart_animation_button_->setToolTip(QStringLiteral("Play every clip again from its start"));
+    render_tool_bar->addWidget(restart_animation_button_);
+
+    render_tool_bar->addWidget(new QLabel(QStringLiteral("Texture MB:"), render_tool_bar));
+    texture_budget_spin_box_ = new QSpinBox(render_tool_bar);
+    texture_budget_spin_box_->setRange(16, 4096);
+    texture_budget_spin_box_->setSingleStep(16);
+    texture_budget_spin_box_->setValue(scene->texture_budget_mb());
+    texture_budget_spin_box_->setToolTip(QStringLiteral("GPU memory for streamed diffuse texture mips. Levels stream in coarse to fine by on-screen size;\n"
+                                                        "over budget, detail no view needs goes first, then that of the least recently used textures."));
+    render_tool_bar->addWidget(texture_budget_spin_box_);
+    connect(texture_budget_spin_box_, qOverload<int>(&QSpinBox::valueChanged), scene, &View::set_texture_budget_mb); // Shared by all viewports
+
+    render_tool_bar->addWidget(new QLabel(QStringLiteral("Compression:"), render_tool_bar));
+    texture_compression_combo_box_ = new QComboBox(render_tool_bar);
+    texture_compression_combo_box_->addItems({QStringLiteral("Off (RGBA8)"),
+                                              QStringLiteral("BC1/BC3"),
+                                              QStringLiteral("BC7")});
+    texture_compression_combo_box_->setCurrentIndex(static_cast<int>(scene->texture_compression()));
+    texture_compression_combo_box_->setToolTip(QStringLiteral("Block format of textures imported from now on, encoded on all cores at first import.\n"
+                                                              "Results are cached on disk by image content; the HUD shows the saving per texture."));
+    render_tool_bar->addWidget(texture_compression_combo_box_);
+    connect(texture_compression_combo_box_, qOverload<int>(&QComboBox::currentIndexChanged), this, [scene](const int index)
+    {
+        scene->set_texture_compression(static_cast<TextureCompression>(std::clamp(index, 0, 2))); // Import option of the shared scene
+    });
+
+    render_tool_bar->addWidget(new QLabel(QStringLiteral("Points M:"), render_tool_bar));
+    point_budget_spin_box_ = new QSpinBox(render_tool_bar);
+    point_budget_spin_box_->setRange(1, 100);
+    point_budget_spin_box_->setValue(static_cast<int>(scene->point_budget() / 1'000'000));
+    point_budget_spin_box_->setToolTip(QStringLiteral("Millions of points drawn per frame over every point cloud (faceless OBJ scans).\n"
+                                                      "Octree nodes are picked by on-screen size until the budget is spent; each view caches them in a page buffer of this size."));
+    render_tool_bar->addWidget(point_budget_spin_box_);
+
+    render_tool_bar->addSeparator();
+    threaded_rendering_check_box_ = new QCheckBox(QStringLiteral("Render thread"), render_tool_bar);
+    threaded_rendering_check_box_->setChecked(scene->threaded_rendering());
+    threaded_rendering_check_box_->setToolTip(QStringLiteral("Render on a dedicated thread from double-buffered scene snapshots;\n"
+                                                             "the Frame HUD compares input-to-frame latency of both modes"));
+    if (scene->backend() != View::Backend::Widget) // Needs the composited widget backend (run without --backend window/software)
+    {
+        threaded_rendering_check_box_->setEnabled(false);
+        threaded_rendering_check_box_->setToolTip(scene->backend() == View::Backend::Window ? QStringLiteral("Not available with the native window backend")
+                                                                                             : QStringLiteral("Not available with the software backend"));
+    }
+    render_tool_bar->addWidget(threaded_rendering_check_box_);
+
+    hud_check_box_ = new QCheckBox(QStringLiteral("Frame HUD"), render_tool_bar);
+    hud_check_box_->setChecked(scene->hud_visible());
+    hud_check_box_->setToolTip(QStringLiteral("Overlay with frame time and shaded fragment counts"));
+    render_tool_bar->addWidget(hud_check_box_);
+
+    render_tool_bar->addSeparator();
+    viewports_check_box_ = new QCheckBox(QStringLiteral("Top/front views"), render_tool_bar);
+    viewports_check_box_->setToolTip(QStringLiteral("Add top and front viewports of the same scene.\n"
+                                                    "They draw from the same GPU buffers; only culling and drawing run per view."));
+    render_tool_bar->addWidget(viewports_check_box_);
+    connect(viewports_check_box_, &QCheckBox::toggled, this, [this, scene](const bool enabled)
+    {
+        if (enabled && !side_views_splitter_) // Created on first use, then only hidden
+        {
+            side_views_splitter_ = new QSplitter(Qt::Vertical, viewport_splitter_);
+            const auto add_view = [this, scene](const glm::vec3 &position, const glm::vec3 &rotation)
+            {
+                auto *view = new View(side_views_splitter_, scene->backend(), scene); // Shares objects and pools with scene
+                view->setMinimumSize(200, 150);
+                view->set_cam_position(position.x, position.y, position.z);
+                view->set_cam_rotation(rotation.x, rotation.y, rotation.z);
+                side_views_splitter_->addWidget(view);
+                view->set_animation_playing(animate_check_box_->isChecked()); // Each view runs its own clock
+                view->set_animation_fixed_step(animation_fixed_step_check_box_->isChecked());
+                connect_render_options(view);
+            };
+            add_view({0.0f, 26.0f, 0.0f}, {-90.0f, 0.0f, 0.0f}); // Top: looking straight down
+            add_view({0.0f, 1.0f, 26.0f}, {0.0f, 0.0f, 0.0f}); // Front: looking along -Z
+            viewport_splitter_->addWidget(side_views_splitter_);
+            viewport_splitter_->setSizes({2 * viewport_splitter_->width() / 3, viewport_splitter_->width() / 3});
+        }
+        if (side_views_splitter_) side_views_splitter_->setVisible(enabled);
+    });
+
+    render_tool_bar->addSeparator();
+    auto *screenshot_button = new QPushButton(QStringLiteral("Screenshot"), render_tool_bar);
+    screenshot_button->setToolTip(QStringLiteral("Save the next frame of the main view without the HUD (PNG, JPEG, or .bgra for raw pixels).\n"
+                                                 "Read back through a ring of pixel buffers and encoded on worker threads."));
+    render_tool_bar->addWidget(screenshot_button);
+    connect(screenshot_button, &QPushButton::clicked, this, [this, scene]
+    {
+        const QString file_path = QFileDialog::getSaveFileName(this, tr("Save screenshot"), QStringLiteral("screenshot.png"),
+                                                               tr("Images (*.png *.jpg);;Raw BGRA (*.bgra)"));
+        if (!file_path.isEmpty()) scene->capture_screenshot(file_path);
+    });
+
+    record_check_box_ = new QCheckBox(QStringLiteral("Record"), render_tool_bar);
+    record_check_box_->setToolTip(QStringLiteral("Write every rendered frame of the main view to a directory (frame_000000.png, ...).\n"
+                                                 "Frames the readback ring or the encoders cannot take are skipped, never waited for;\n"
+                                                 "the Frame HUD counts them."));
+    render_tool_bar->addWidget(record_check_box_);
+
+    capture_format_combo_box_ = new QComboBox(render_tool_bar);
+    capture_format_combo_box_->addItem(QStringLiteral("PNG"), static_cast<int>(CaptureFormat::Image));
+    capture_format_combo_box_->addItem(QStringLiteral("Raw BGRA"), static_cast<int>(CaptureFormat::Raw));
+    capture_format_combo_box_->setToolTip(QStringLiteral("Recorded frame format. Raw frames cost no encoding and concatenate into an ffmpeg rawvideo input."));
+    render_tool_bar->addWidget(capture_format_combo_box_);
+    if (scene->backend() == View::Backend::Software) // Readback goes through GL pixel buffers
+    {
+        for (QWidget *widget : {static_cast<QWidget*>(screenshot_button), static_cast<QWidget*>(record_check_box_), static_cast<QWidget*>(capture_format_combo_box_)})
+        {
+            widget->setEnabled(false);
+            widget->setToolTip(QStringLiteral("Not available with the software backend"));
+        }
+    }
+    connect(record_check_box_, &QCheckBox::toggled, this, [this, scene](const bool enabled)
+    {
+        if (!enabled)
+        {
+            scene->set_capture_recording(false);
+            capture_format_combo_box_->setEnabled(true);
+            return;
+        }
+        const QString directory = QFileDialog::getExistingDirectory(this, tr("Record frames to"));
+        const auto format = static_cast<CaptureFormat>(capture_format_combo_box_->currentData().toInt());
+        if (!directory.isEmpty()) scene->set_capture_recording(true, directory, format);
+        if (!scene->capture_recording()) // Cancelled, or the directory could not be created
+        {
+            const QSignalBlocker blocker(record_check_box_);
+            record_check_box_->setChecked(false);
+            return;
+        }
+        capture_format_combo_box_->setEnabled(false); // Fixed for the recording
+    });
+
+    connect_render_options(scene);
+}
+
+void MainWindow::connect_render_options(View *view)
+{
+    connect(color_mode_combo_box_, qOverload<int>(&QComboBox::currentIndexChanged), view,
+            [view](const int index)
+            {
+                view->set_color_mode(static_cast<View::ColorMode>(std::clamp(index, 0, View::kColorModeCount - 1)));
+            });
+    connect(gpu_culling_check_box_, &QCheckBox::toggled, view, &View::set_gpu_culling);
+    connect(sort_draws_check_box_, &QCheckBox::toggled, view, &View::set_sort_draws);
+    connect(render_path_combo_box_, qOverload<int>(&QComboBox::currentIndexChanged), view,
+            [view](const int index)
+            {
+                view->set_render_path(static_cast<View::RenderPath>(std::clamp(index, 0, 1)));
+            });
+    connect(depth_prepass_combo_box_, qOverload<int>(&QComboBox::currentIndexChanged), view,
+            [this, view](const int index)
+            {
+                const int mode = std::clamp(color_mode_combo_box_->currentIndex(), 0, View::kColorModeCount - 1); // The mode the combo shows
+                view->set_depth_prepass(static_cast<View::ColorMode>(mode), static_cast<View::DepthPrepass>(std::clamp(index, 0, 2)));
+            });
+    connect(dynamic_resolution_check_box_, &QCheckBox::toggled, view, &View::set_dynamic_resolution);
+    connect(frame_budget_spin_box_, qOverload<double>(&QDoubleSpinBox::valueChanged), view, &View::set_frame_budget_ms);
+    connect(adaptive_msaa_check_box_, &QCheckBox::toggled, view, &View::set_adaptive_msaa);
+    connect(anti_aliasing_combo_box_, qOverload<int>(&QComboBox::currentIndexChanged), view,
+            [view](const int index)
+            {
+                view->set_anti_aliasing(static_cast<View::AntiAliasing>(std::clamp(index, 0, View::kAntiAliasingCount - 1)));
+            });
+    connect(shadows_check_box_, &QCheckBox::toggled, view, &View::set_shadows);
+    connect(wireframe_check_box_, &QCheckBox::toggled, view, &View::set_wireframe);
+    connect(animate_check_box_, &QCheckBox::toggled, view, &View::set_animation_playing);
+    connect(animation_fixed_step_check_box_, &QCheckBox::toggled, view, &View::set_animation_fixed_step);
+    connect(restart_animation_button_, &QPushButton::clicked, view, &View::restart_animation);
+    connect(point_budget_spin_box_, qOverload<int>(&QSpinBox::valueChanged), view, [view](const int millions)
+    {
+        view->set_point_budget(static_cast<std::size_t>(millions) * 1'000'000);
+    });
+    connect(threaded_rendering_check_box_, &QCheckBox::toggled, view, &View::set_threaded_rendering);
+    connect(hud_check_box_, &QCheckBox::toggled, view, &View::set_hud_visible);
 }
 
 MainWindow::~MainWindow()
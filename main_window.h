@@ -4,7 +4,12 @@
 #include <QMainWindow>  // Qt base class for main application windows
 #include <QLabel>
 #include <QLineEdit>
+#include <QPushButton>
 #include <QComboBox>
+#include <QCheckBox>
+#include <QDoubleSpinBox>
+#include <QSpinBox>
+#include <QSplitter>
 
 
 QT_BEGIN_NAMESPACE  // Begin Qt namespace block (matches ui header style)
@@ -13,6 +18,9 @@ namespace Ui { class MainWindow; }   // Forward declaration of auto-generated Ui
 
 QT_END_NAMESPACE    // End Qt namespace block
 
+class View; // 3D viewport (main view and the optional top/front views)
+class AssetBrowser; // OBJ thumbnails of a directory (created on demand)
+
 class MainWindow final : public QMainWindow // Main window class that publicly inherits QMainWindow class
 {
     Q_OBJECT    // Enables Qt meta-object features (signals/slots, RTTI)
@@ -26,6 +34,35 @@ class MainWindow final : public QMainWindow // Main window class that publicly i
     QLineEdit *camera_rotation_z_line_edit_{nullptr};
     QLabel *help_label_{nullptr};
     QComboBox *color_mode_combo_box_{nullptr};
+    QCheckBox *gpu_culling_check_box_{nullptr};
+    QCheckBox *sort_draws_check_box_{nullptr};
+    QComboBox *render_path_combo_box_{nullptr};
+    QComboBox *depth_prepass_combo_box_{nullptr};
+    QCheckBox *dynamic_resolution_check_box_{nullptr};
+    QDoubleSpinBox *frame_budget_spin_box_{nullptr};
+    QCheckBox *adaptive_msaa_check_box_{nullptr};
+    QComboBox *anti_aliasing_combo_box_{nullptr};
+    QSpinBox *light_count_spin_box_{nullptr};
+    QCheckBox *shadows_check_box_{nullptr};
+    QCheckBox *wireframe_check_box_{nullptr};
+    QCheckBox *bake_occlusion_check_box_{nullptr};
+    QCheckBox *animate_check_box_{nullptr};
+    QCheckBox *animation_fixed_step_check_box_{nullptr};
+    QPushButton *restart_animation_button_{nullptr};
+    QSpinBox *texture_budget_spin_box_{nullptr};
+    QComboBox *texture_compression_combo_box_{nullptr};
+    QSpinBox *point_budget_spin_box_{nullptr};
+    QCheckBox *threaded_rendering_check_box_{nullptr};
+    QCheckBox *hud_check_box_{nullptr};
+    QCheckBox *viewports_check_box_{nullptr};
+    QCheckBox *record_check_box_{nullptr};
+    QComboBox *capture_format_combo_box_{nullptr};
+    QSplitter *content_splitter_{nullptr}; // Asset browser, then the viewports
+    QSplitter *viewport_splitter_{nullptr}; // Main view, then the side views
+    QSplitter *side_views_splitter_{nullptr}; // Top and front views sharing the main view's scene (created on demand)
+    AssetBrowser *asset_browser_{nullptr};
+
+    void connect_render_options(View *view); // Apply the rendering toolbar to one view
 
 public:
     explicit MainWindow(QWidget *parent = nullptr); // Constructor; "explicit" avoids implicit conversions
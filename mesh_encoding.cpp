@@ -0,0 +1,207 @@
+#include "mesh_encoding.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace // Anonymous namespace holding the per-attribute packing helpers
+{
+constexpr float kMaxPackedUV = 64.0f; // Beyond this UV magnitude half floats lose too much precision
+
+std::uint16_t float_to_half(const float value)
+{
+    const auto bits = std::bit_cast<std::uint32_t>(value); // Raw IEEE-754 single precision bits
+    const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u); // Sign moves to bit 15
+    const std::int32_t exponent = static_cast<std::int32_t>((bits >> 23) & 0xFFu) - 127 + 15; // Re-bias exponent for half precision
+    std::uint32_t mantissa = bits & 0x007FFFFFu; // 23-bit mantissa
+
+    if (((bits >> 23) & 0xFFu) == 0xFFu) // Infinity or NaN
+    {
+        return static_cast<std::uint16_t>(sign | 0x7C00u | (mantissa ? 0x0200u : 0u));
+    }
+    if (exponent >= 31) // Overflow clamps to infinity
+    {
+        return static_cast<std::uint16_t>(sign | 0x7C00u);
+    }
+    if (exponent <= 0) // Subnormal half or underflow to zero
+    {
+        if (exponent < -10) return sign;
+        mantissa |= 0x00800000u; // Restore implicit leading one
+        const auto shift = static_cast<std::uint32_t>(14 - exponent);
+        const std::uint32_t rounded = (mantissa + (1u << (shift - 1))) >> shift; // Round to nearest
+        return static_cast<std::uint16_t>(sign | rounded);
+    }
+
+    const std::uint32_t rounded = mantissa + 0x00001000u; // Round to nearest on the dropped 13 bits
+    if (rounded & 0x00800000u) // Mantissa overflowed into the exponent
+    {
+        return static_cast<std::uint16_t>(sign | ((exponent + 1) >= 31 ? 0x7C00u : static_cast<std::uint32_t>(exponent + 1) << 10));
+    }
+    return static_cast<std::uint16_t>(sign | (static_cast<std::uint32_t>(exponent) << 10) | (rounded >> 13));
+}
+
+std::uint32_t pack_half_2x16(const glm::vec2 &value)
+{
+    return static_cast<std::uint32_t>(float_to_half(value.x)) | static_cast<std::uint32_t>(float_to_half(value.y)) << 16; // Matches GLSL unpackHalf2x16
+}
+
+std::uint32_t pack_unorm_2x16(const float x, const float y)
+{
+    const auto quantize = [](const float v)
+    {
+        return static_cast<std::uint32_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 65535.0f));
+    };
+    return quantize(x) | quantize(y) << 16; // Matches GLSL unpackUnorm2x16
+}
+
+std::uint32_t pack_snorm_2x16(const glm::vec2 &value)
+{
+    const auto quantize = [](const float v)
+    {
+        const auto q = static_cast<std::int32_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+        return static_cast<std::uint32_t>(static_cast<std::uint16_t>(static_cast<std::int16_t>(q)));
+    };
+    return quantize(value.x) | quantize(value.y) << 16; // Matches GLSL unpackSnorm2x16
+}
+
+glm::vec2 encode_octahedral(const glm::vec3 &normal)
+{
+    const float l1 = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z); // L1 norm projects onto the octahedron
+    if (l1 < 1e-8f) return {0.0f, 0.0f}; // Degenerate normal maps to +Z
+    glm::vec2 projected(normal.x / l1, normal.y / l1);
+    if (normal.z < 0.0f) // Fold the lower hemisphere over the diagonals
+    {
+        const float sx = projected.x >= 0.0f ? 1.0f : -1.0f;
+        const float sy = projected.y >= 0.0f ? 1.0f : -1.0f;
+        projected = {(1.0f - std::abs(projected.y)) * sx, (1.0f - std::abs(projected.x)) * sy};
+    }
+    return projected;
+}
+}
+
+std::uint32_t vertex_format_stride(const VertexFormat format)
+{
+    switch (format)
+    {
+        case VertexFormat::Float32: return 8u;
+        case VertexFormat::Packed16: return 4u;
+    }
+    return 8u;
+}
+
+std::uint32_t vertex_format_position_stride(const VertexFormat format)
+{
+    switch (format)
+    {
+        case VertexFormat::Float32: return 3u;
+        case VertexFormat::Packed16: return 2u;
+    }
+    return 3u;
+}
+
+VertexFormat choose_vertex_format(const std::span<const MeshVertex> vertices)
+{
+    const bool uv_fits = std::ranges::all_of(vertices, [](const MeshVertex &vertex)
+    {
+        return std::abs(vertex.uv.x) <= kMaxPackedUV && std::abs(vertex.uv.y) <= kMaxPackedUV;
+    }); // Half-float UVs are only safe for moderately tiled coordinates
+    return uv_fits ? VertexFormat::Packed16 : VertexFormat::Float32;
+}
+
+EncodedVertices encode_vertices(const std::span<const MeshVertex> vertices, const VertexFormat format)
+{
+    EncodedVertices encoded;
+    encoded.format = format;
+    encoded.words.reserve(vertices.size() * vertex_format_stride(format)); // Exact size known up front
+    encoded.position_words.reserve(vertices.size() * vertex_format_position_stride(format));
+
+    if (format == VertexFormat::Float32)
+    {
+        for (const auto &[position, normal, uv] : vertices) // Same interleaved order as the original VBO layout
+        {
+            for (const float value : {position.x, position.y, position.z, normal.x, normal.y, normal.z, uv.x, uv.y})
+            {
+                encoded.words.push_back(std::bit_cast<std::uint32_t>(value));
+            }
+            for (const float value : {position.x, position.y, position.z}) // Same bits as the interleaved copy
+            {
+                encoded.position_words.push_back(std::bit_cast<std::uint32_t>(value));
+            }
+        }
+        return encoded;
+    }
+
+    glm::vec3 bounds_min(std::numeric_limits<float>::max()); // Quantization box (min corner)
+    glm::vec3 bounds_max(std::numeric_limits<float>::lowest()); // Quantization box (max corner)
+    for (const auto &vertex : vertices)
+    {
+        bounds_min = glm::min(bounds_min, vertex.position);
+        bounds_max = glm::max(bounds_max, vertex.position);
+    }
+    if (vertices.empty())
+    {
+        bounds_min = glm::vec3(0.0f);
+        bounds_max = glm::vec3(0.0f);
+    }
+    encoded.bounds_min = bounds_min;
+    encoded.bounds_extent = glm::max(bounds_max - bounds_min, glm::vec3(1e-6f)); // Avoid division by zero on flat meshes
+
+    for (const auto &[position, normal, uv] : vertices)
+    {
+        const glm::vec3 unit = (position - encoded.bounds_min) / encoded.bounds_extent; // Normalized position inside the box
+        encoded.words.push_back(pack_unorm_2x16(unit.x, unit.y)); // Word 0: x, y
+        encoded.words.push_back(pack_unorm_2x16(unit.z, 0.0f)); // Word 1: z, upper half reserved
+        encoded.words.push_back(pack_snorm_2x16(encode_octahedral(normal))); // Word 2: octahedral normal
+        encoded.words.push_back(pack_half_2x16(uv)); // Word 3: half-float UV
+        encoded.position_words.insert(encoded.position_words.end(), encoded.words.end() - 4, encoded.words.end() - 2); // Words 0-1 again
+    }
+    return encoded;
+}
+
+std::vector<std::uint32_t> encode_vertex_occlusion(const std::span<const float> occlusion)
+{
+    std::vector<std::uint32_t> words((occlusion.size() + 3) / 4, 0u);
+    for (std::size_t i(0); i < occlusion.size(); i++)
+    {
+        const auto value = static_cast<std::uint32_t>(std::lround(std::clamp(occlusion[i], 0.0f, 1.0f) * 255.0f));
+        words[i / 4] |= value << (8 * (i % 4)); // Matches GLSL unpackUnorm4x8
+    }
+    return words;
+}
+
+void append_vertex_occlusion(EncodedVertices &encoded, const std::span<const float> occlusion)
+{
+    encoded.occlusion_offset = static_cast<std::uint32_t>(encoded.words.size()); // Stays valid when the pool moves the mesh
+    const std::vector<std::uint32_t> words = encode_vertex_occlusion(occlusion);
+    encoded.words.insert(encoded.words.end(), words.begin(), words.end());
+}
+
+void append_vertex_skin(EncodedVertices &encoded, const std::span<const VertexSkin> skin)
+{
+    encoded.skin_offset = static_cast<std::uint32_t>(encoded.words.size()); // Relative, like the occlusion stream
+    encoded.words.reserve(encoded.words.size() + skin.size() * 2);
+    for (const VertexSkin &vertex : skin)
+    {
+        std::array<long, 4> weights{};
+        long total = 0;
+        std::size_t heaviest = 0;
+        for (std::size_t lane(0); lane < 4; lane++)
+        {
+            weights[lane] = std::lround(std::clamp(vertex.weights[lane], 0.0f, 1.0f) * 255.0f);
+            total += weights[lane];
+            if (vertex.weights[lane] > vertex.weights[heaviest]) heaviest = lane;
+        }
+        if (total > 0) weights[heaviest] = std::clamp(weights[heaviest] + 255 - total, 0L, 255L); // Rounding error goes to the heaviest bone, so the sum stays 255
+
+        std::uint32_t bone_word = 0;
+        std::uint32_t weight_word = 0;
+        for (std::size_t lane(0); lane < 4; lane++)
+        {
+            bone_word |= static_cast<std::uint32_t>(vertex.bones[lane]) << (8 * lane); // Read with bitfieldExtract
+            weight_word |= static_cast<std::uint32_t>(weights[lane]) << (8 * lane); // Matches GLSL unpackUnorm4x8
+        }
+        encoded.words.push_back(bone_word);
+        encoded.words.push_back(weight_word);
+    }
+}
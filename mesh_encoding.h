@@ -0,0 +1,53 @@
+#ifndef MESH_ENCODING_H // Guard against multiple inclusion
+#define MESH_ENCODING_H // Begin include guard
+
+#include <glm/glm.hpp> // GLM vector types used by staged vertices
+
+#include <array> // Bone influences of a skinned vertex
+#include <cstdint> // Fixed-width words stored in the vertex pool
+#include <span> // Non-owning view over staged vertex data
+#include <vector> // Owning container for encoded vertex words
+
+enum class VertexFormat : std::uint32_t // Vertex encodings understood by the pulling vertex shader
+{
+    Float32 = 0, // 3 position + 3 normal + 2 UV floats (8 words per vertex)
+    Packed16 = 1 // 16-bit quantized position, octahedral normal, half-float UV (4 words per vertex)
+};
+
+struct MeshVertex // Importer-side vertex before it is encoded into a pool format
+{
+    glm::vec3 position{}; // Object-space position
+    glm::vec3 normal{0.0f, 1.0f, 0.0f}; // Object-space normal
+    glm::vec2 uv{0.0f, 0.0f}; // Texture coordinates
+};
+
+struct VertexSkin // Bone influences of one vertex of a rigged mesh (weights sum to 1; unused lanes have weight 0)
+{
+    std::array<std::uint8_t, 4> bones{}; // Skin bone indices (SkinnedAsset::bone_joints)
+    std::array<float, 4> weights{1.0f, 0.0f, 0.0f, 0.0f};
+};
+
+constexpr std::uint32_t kNoVertexOcclusion = 0xFFFFFFFFu; // Occlusion offset of meshes without a baked stream (shaders read 1.0)
+constexpr std::uint32_t kNoVertexSkin = 0xFFFFFFFFu; // Skin offset of static meshes
+
+struct EncodedVertices // Vertex words ready for upload plus the data needed to decode them
+{
+    VertexFormat format = VertexFormat::Float32; // Encoding used for the words below
+    std::vector<std::uint32_t> words; // Encoded vertex stream (stride given by vertex_format_stride)
+    std::vector<std::uint32_t> position_words; // Position-only stream for depth passes (stride given by vertex_format_position_stride)
+    glm::vec3 bounds_min{0.0f}; // Quantization origin (packed formats only)
+    glm::vec3 bounds_extent{1.0f}; // Quantization scale (packed formats only)
+    std::uint32_t occlusion_offset = kNoVertexOcclusion; // First word of the baked occlusion stream inside words (relative)
+    std::uint32_t skin_offset = kNoVertexSkin; // First word of the skin stream inside words (relative)
+};
+
+[[nodiscard]] std::uint32_t vertex_format_stride(VertexFormat format); // Number of 32-bit words per vertex
+[[nodiscard]] std::uint32_t vertex_format_position_stride(VertexFormat format); // Words per vertex of the position-only stream
+[[nodiscard]] VertexFormat choose_vertex_format(std::span<const MeshVertex> vertices); // Pick the most compact format that keeps the mesh intact
+[[nodiscard]] EncodedVertices encode_vertices(std::span<const MeshVertex> vertices, VertexFormat format); // Encode staged vertices for the vertex pool
+[[nodiscard]] std::vector<std::uint32_t> encode_vertex_occlusion(std::span<const float> occlusion); // unorm8 stream, 4 vertices per word
+void append_vertex_occlusion(EncodedVertices &encoded, std::span<const float> occlusion); // Append that stream after the vertices
+void append_vertex_skin(EncodedVertices &encoded, std::span<const VertexSkin> skin); // Append 2 words per vertex: 4 bone indices, 4 unorm8 weights
+
+
+#endif //MESH_ENCODING_H // End include guard
@@ -0,0 +1,136 @@
+#include "mesh_simplify.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace // Anonymous namespace holding clustering constants and helpers
+{
+constexpr std::uint32_t kFinestLodGrid = 64; // Cells per axis for LOD 1 (halved for every further level)
+constexpr std::size_t kMinLodTriangles = 32; // Meshes this small are not worth another level
+constexpr float kMinLodReduction = 0.75f; // A level must keep at most 75% of its parent's triangles
+
+struct TriangleKey // Order-independent triangle identity used to drop duplicates after clustering
+{
+    std::uint32_t a, b, c;
+    bool operator==(const TriangleKey &) const = default;
+};
+
+struct TriangleKeyHash
+{
+    std::size_t operator()(const TriangleKey &key) const noexcept
+    {
+        std::uint64_t h = key.a; // Simple multiplicative mix; collisions only cost a comparison
+        h = h * 0x9E3779B97F4A7C15ull ^ key.b;
+        h = h * 0x9E3779B97F4A7C15ull ^ key.c;
+        return static_cast<std::size_t>(h ^ (h >> 29));
+    }
+};
+}
+
+std::vector<std::uint32_t> simplify_by_clustering(const std::span<const MeshVertex> vertices,
+                                                  const std::span<const std::uint32_t> indices,
+                                                  const std::uint32_t grid_resolution)
+{
+    if (indices.empty() || grid_resolution == 0) return {indices.begin(), indices.end()};
+
+    glm::vec3 bounds_min(std::numeric_limits<float>::max()); // Bounds of the referenced vertices
+    glm::vec3 bounds_max(std::numeric_limits<float>::lowest());
+    for (const std::uint32_t index : indices)
+    {
+        bounds_min = glm::min(bounds_min, vertices[index].position);
+        bounds_max = glm::max(bounds_max, vertices[index].position);
+    }
+    const glm::vec3 extent = bounds_max - bounds_min;
+    const float cell_size = std::max({extent.x, extent.y, extent.z, 1e-6f}) / static_cast<float>(grid_resolution); // Cubic cells
+
+    const auto cell_of = [&](const glm::vec3 &position)
+    {
+        const auto axis = [&](const float value, const float origin)
+        {
+            const auto cell = static_cast<std::uint64_t>(std::max(0.0f, (value - origin) / cell_size));
+            return std::min<std::uint64_t>(cell, grid_resolution - 1); // Max corner falls into the last cell
+        };
+        const std::uint64_t resolution = grid_resolution;
+        return axis(position.x, bounds_min.x) + resolution * (axis(position.y, bounds_min.y) + resolution * axis(position.z, bounds_min.z));
+    };
+
+    struct Cell // Accumulates the mean position of all vertices in a cell, then its closest vertex
+    {
+        glm::vec3 sum{0.0f};
+        std::uint32_t count = 0;
+        std::uint32_t representative = std::numeric_limits<std::uint32_t>::max();
+        float best_distance = std::numeric_limits<float>::max();
+    };
+    std::unordered_map<std::uint64_t, Cell> cells; // Sparse grid: only occupied cells are stored
+    std::unordered_map<std::uint32_t, std::uint64_t> vertex_cell; // Cell of every referenced vertex
+    vertex_cell.reserve(indices.size());
+
+    for (const std::uint32_t index : indices)
+    {
+        if (vertex_cell.contains(index)) continue;
+        const std::uint64_t cell_key = cell_of(vertices[index].position);
+        vertex_cell.emplace(index, cell_key);
+        Cell &cell = cells[cell_key];
+        cell.sum += vertices[index].position;
+        cell.count++;
+    }
+
+    for (const auto &[index, cell_key] : vertex_cell) // Representative = existing vertex closest to the cell mean
+    {
+        Cell &cell = cells[cell_key];
+        const glm::vec3 mean = cell.sum / static_cast<float>(cell.count);
+        const glm::vec3 delta = vertices[index].position - mean;
+        const float distance = glm::dot(delta, delta);
+        if (distance < cell.best_distance || (distance == cell.best_distance && index < cell.representative)) // Tie-break keeps output deterministic
+        {
+            cell.best_distance = distance;
+            cell.representative = index;
+        }
+    }
+
+    std::vector<std::uint32_t> simplified; // Surviving triangles remapped to representatives
+    simplified.reserve(indices.size() / 2);
+    std::unordered_set<TriangleKey, TriangleKeyHash> emitted; // Triangles already written (any winding)
+
+    for (std::size_t i(0); i + 2 < indices.size(); i += 3)
+    {
+        std::array<std::uint32_t, 3> corners{};
+        for (std::size_t corner(0); corner < 3; corner++)
+        {
+            corners[corner] = cells[vertex_cell[indices[i + corner]]].representative;
+        }
+        if (corners[0] == corners[1] || corners[1] == corners[2] || corners[0] == corners[2]) continue; // Collapsed to a line or point
+
+        std::array<std::uint32_t, 3> sorted = corners;
+        std::ranges::sort(sorted);
+        if (!emitted.insert({sorted[0], sorted[1], sorted[2]}).second) continue; // Another triangle already covers this cell triple
+
+        simplified.insert(simplified.end(), corners.begin(), corners.end()); // Keep original winding
+    }
+    return simplified;
+}
+
+std::vector<std::vector<std::uint32_t>> build_lod_chain(const std::span<const MeshVertex> vertices,
+                                                        std::vector<std::uint32_t> indices,
+                                                        const std::size_t max_levels)
+{
+    std::vector<std::vector<std::uint32_t>> levels;
+    levels.push_back(std::move(indices)); // LOD 0 is the full-resolution mesh
+
+    std::uint32_t grid = kFinestLodGrid;
+    while (levels.size() < max_levels && grid >= 2)
+    {
+        const auto &parent = levels.back();
+        if (parent.size() / 3 < kMinLodTriangles) break; // Already tiny
+
+        std::vector<std::uint32_t> level = simplify_by_clustering(vertices, levels.front(), grid); // Always cluster the full mesh to avoid error accumulation
+        grid /= 2;
+        if (level.empty()) break;
+        if (static_cast<float>(level.size()) > kMinLodReduction * static_cast<float>(parent.size())) continue; // Too similar; try a coarser grid
+        levels.push_back(std::move(level));
+    }
+    return levels;
+}
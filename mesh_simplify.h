@@ -0,0 +1,23 @@
+#ifndef MESH_SIMPLIFY_H // Guard against multiple inclusion
+#define MESH_SIMPLIFY_H // Begin include guard
+
+#include "mesh_encoding.h" // MeshVertex staging type
+
+#include <cstdint> // Index type shared with the index pool
+#include <span> // Non-owning views over mesh data
+#include <vector> // Owning containers for generated index lists
+
+// Collapse vertices into a uniform grid of grid_resolution^3 cells and return the surviving triangles.
+// The result indexes the same vertex array, so every LOD of a mesh shares one vertex range in the pool.
+[[nodiscard]] std::vector<std::uint32_t> simplify_by_clustering(std::span<const MeshVertex> vertices,
+                                                                std::span<const std::uint32_t> indices,
+                                                                std::uint32_t grid_resolution);
+
+// Build up to max_levels index lists (level 0 is the input) with progressively coarser clustering.
+// Generation stops early once a level no longer removes a meaningful share of triangles.
+[[nodiscard]] std::vector<std::vector<std::uint32_t>> build_lod_chain(std::span<const MeshVertex> vertices,
+                                                                      std::vector<std::uint32_t> indices,
+                                                                      std::size_t max_levels);
+
+
+#endif //MESH_SIMPLIFY_H // End include guard
@@ -0,0 +1,498 @@
+#include "point_cloud.h"
+
+#include "frame_jobs.h"
+
+#include <QFile>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <string_view>
+
+namespace // Anonymous namespace holding the parser, Morton codes and the node builder
+{
+constexpr std::size_t kMinBytesPerJob = std::size_t{1} << 20; // Parse jobs below this cost more to schedule than to run
+constexpr std::size_t kMinPointsPerJob = 65536; // Same for bounds, sorting and copying
+constexpr std::uint32_t kMortonBits = 21; // Bits per axis in a 63-bit code; also the deepest octree level
+constexpr std::uint32_t kGridLevels = 6; // log2(kPointCloudGridCells)
+static_assert((1u << kGridLevels) == kPointCloudGridCells, "Grid cells must match the Morton levels used per node");
+
+struct KeyedPoint // Point with its Morton code while sorting and building
+{
+    std::uint64_t code = 0;
+    PointCloudPoint point;
+};
+
+struct NodeRange // Points of a node and its subtree inside the sorted array
+{
+    std::uint32_t node = 0;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+};
+
+struct NodeSplit // Builder output of one node: its own points, then the ranges of its children
+{
+    std::size_t count = 0;
+    std::size_t dropped = 0;
+    std::array<std::size_t, 9> child_bounds{}; // Octant o covers [child_bounds[o], child_bounds[o + 1])
+};
+
+struct MappedFile // Whole file mapped read-only (scans can be larger than memory would like to copy)
+{
+    QFile file;
+    std::string_view text;
+
+    explicit MappedFile(const QString &path) : file(path)
+    {
+        if (!file.open(QIODevice::ReadOnly) || file.size() == 0) return;
+        if (const uchar *data = file.map(0, file.size())) text = {reinterpret_cast<const char*>(data), static_cast<std::size_t>(file.size())};
+    }
+};
+
+bool is_blank(const char c) { return c == ' ' || c == '\t'; }
+
+// Up to six numbers after "v"; returns how many were read
+int parse_vertex_line(const char *begin, const char *end, std::array<double, 6> &values)
+{
+    int count = 0;
+    const char *cursor = begin;
+    while (count < 6)
+    {
+        while (cursor < end && is_blank(*cursor)) cursor++;
+        if (cursor >= end || *cursor == '\r') break;
+        if (*cursor == '+') cursor++; // from_chars does not accept a leading plus
+        const auto [next, error] = std::from_chars(cursor, end, values[count]);
+        if (error != std::errc()) break;
+        cursor = next;
+        count++;
+    }
+    return count;
+}
+
+// Calls line(begin, end) for every line whose first character lies in [first, last) of text, until it returns false
+template <typename Line>
+void for_each_line(const std::string_view text, const std::size_t first, const std::size_t last, const Line &line)
+{
+    std::size_t cursor = first;
+    if (cursor > 0 && text[cursor - 1] != '\n') // Started inside a line: the previous job owns it
+    {
+        const std::size_t newline = text.find('\n', cursor);
+        cursor = newline == std::string_view::npos ? text.size() : newline + 1;
+    }
+    while (cursor < last)
+    {
+        std::size_t newline = text.find('\n', cursor);
+        if (newline == std::string_view::npos) newline = text.size();
+        if (!line(text.data() + cursor, text.data() + newline)) return;
+        cursor = newline + 1;
+    }
+}
+
+bool is_vertex_line(const char *begin, const char *end) { return end - begin > 2 && begin[0] == 'v' && is_blank(begin[1]); }
+bool is_face_line(const char *begin, const char *end) { return end - begin > 2 && begin[0] == 'f' && is_blank(begin[1]); }
+
+std::uint32_t pack_color(const glm::vec3 &color)
+{
+    const auto channel = [](const float value) { return static_cast<std::uint32_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f)); };
+    return channel(color.r) | channel(color.g) << 8 | channel(color.b) << 16 | 0xFF000000u;
+}
+
+glm::vec3 height_ramp(const float t) // Blue (low) through green to yellow (high) for clouds without colors
+{
+    const glm::vec3 low(0.15f, 0.3f, 0.85f);
+    const glm::vec3 middle(0.2f, 0.75f, 0.35f);
+    const glm::vec3 high(0.95f, 0.85f, 0.25f);
+    return t < 0.5f ? glm::mix(low, middle, t * 2.0f) : glm::mix(middle, high, t * 2.0f - 1.0f);
+}
+
+std::uint64_t spread_bits(std::uint64_t value) // 21 bits to every third bit
+{
+    value &= 0x1FFFFFu;
+    value = (value | value << 32) & 0x1F00000000FFFFull;
+    value = (value | value << 16) & 0x1F0000FF0000FFull;
+    value = (value | value << 8) & 0x100F00F00F00F00Full;
+    value = (value | value << 4) & 0x10C30C30C30C30C3ull;
+    value = (value | value << 2) & 0x1249249249249249ull;
+    return value;
+}
+
+std::uint64_t morton_code(const glm::vec3 &position, const glm::vec3 &origin, const float scale)
+{
+    constexpr float max_cell = static_cast<float>((1u << kMortonBits) - 1);
+    const glm::vec3 cell = glm::clamp((position - origin) * scale, glm::vec3(0.0f), glm::vec3(max_cell));
+    return spread_bits(static_cast<std::uint64_t>(cell.x)) << 2 | spread_bits(static_cast<std::uint64_t>(cell.y)) << 1 |
+           spread_bits(static_cast<std::uint64_t>(cell.z)); // Octant digit: x is the high bit
+}
+
+// Sort by code: each job sorts its range, then pairs of runs are merged in parallel until one is left
+void sort_points(std::vector<KeyedPoint> &points, const std::size_t jobs)
+{
+    const auto by_code = [](const KeyedPoint &a, const KeyedPoint &b) { return a.code < b.code; };
+    std::vector<std::size_t> bounds(jobs + 1);
+    for (std::size_t job(0); job <= jobs; job++) bounds[job] = points.size() * job / jobs; // Same ranges as run_frame_jobs
+    run_background_jobs(jobs, points.size(), [&](std::size_t, const std::size_t begin, const std::size_t end)
+    {
+        std::sort(points.begin() + static_cast<std::ptrdiff_t>(begin), points.begin() + static_cast<std::ptrdiff_t>(end), by_code);
+    });
+
+    std::vector<KeyedPoint> scratch(points.size());
+    while (bounds.size() > 2)
+    {
+        const std::size_t runs = bounds.size() - 1;
+        const std::size_t pairs = (runs + 1) / 2;
+        run_background_jobs(pairs, pairs, [&](std::size_t, const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t pair(begin); pair < end; pair++)
+            {
+                const auto first = points.begin() + static_cast<std::ptrdiff_t>(bounds[2 * pair]);
+                const auto middle = points.begin() + static_cast<std::ptrdiff_t>(bounds[std::min(2 * pair + 1, runs)]);
+                const auto last = points.begin() + static_cast<std::ptrdiff_t>(bounds[std::min(2 * pair + 2, runs)]);
+                std::merge(first, middle, middle, last, scratch.begin() + static_cast<std::ptrdiff_t>(bounds[2 * pair]), by_code);
+            }
+        });
+        points.swap(scratch);
+        std::vector<std::size_t> merged;
+        for (std::size_t run(0); run < runs; run += 2) merged.push_back(bounds[run]);
+        merged.push_back(bounds.back());
+        bounds = std::move(merged);
+    }
+}
+
+// Keep one point per grid cell of the node at the front of its range (thinned to the node limit); the rest stay sorted
+// behind them and are split into the eight child octants
+NodeSplit split_node(std::vector<KeyedPoint> &points, const NodeRange &range, const std::uint32_t level)
+{
+    NodeSplit split;
+    const std::size_t count = range.end - range.begin;
+    const auto begin = points.begin() + static_cast<std::ptrdiff_t>(range.begin);
+    const auto end = points.begin() + static_cast<std::ptrdiff_t>(range.end);
+    if (count <= kPointCloudMaxNodePoints) // Leaf: everything left
+    {
+        split.count = count;
+        split.child_bounds.fill(range.end);
+        return split;
+    }
+    if (level >= kMortonBits) // Cube of a single Morton cell: nothing to split by any more
+    {
+        split.count = kPointCloudMaxNodePoints;
+        split.dropped = count - kPointCloudMaxNodePoints;
+        split.child_bounds.fill(range.end);
+        return split;
+    }
+
+    const std::uint32_t shift = 3 * (kMortonBits - std::min(level + kGridLevels, kMortonBits));
+    std::vector<bool> keep(count, false);
+    std::size_t cells = 0;
+    for (std::size_t i(0); i < count; i++) // Sorted codes: the first point of every run of equal cells
+    {
+        keep[i] = i == 0 || (begin[static_cast<std::ptrdiff_t>(i)].code >> shift) != (begin[static_cast<std::ptrdiff_t>(i - 1)].code >> shift);
+        if (keep[i]) cells++;
+    }
+    const std::size_t stride = (cells + kPointCloudMaxNodePoints - 1) / kPointCloudMaxNodePoints; // Thin dense cubes evenly
+    std::size_t cell = 0;
+    std::vector<KeyedPoint> rest;
+    rest.reserve(count - std::min(count, cells / stride));
+    for (std::size_t i(0); i < count; i++)
+    {
+        KeyedPoint &point = begin[static_cast<std::ptrdiff_t>(i)];
+        if (keep[i] && cell++ % stride == 0) begin[static_cast<std::ptrdiff_t>(split.count++)] = point; // Compacts in place: writes trail reads
+        else rest.push_back(point);
+    }
+    std::copy(rest.begin(), rest.end(), begin + static_cast<std::ptrdiff_t>(split.count));
+
+    const std::uint32_t child_shift = 3 * (kMortonBits - level - 1);
+    auto cursor = begin + static_cast<std::ptrdiff_t>(split.count);
+    for (std::uint32_t octant(0); octant < 8; octant++)
+    {
+        split.child_bounds[octant] = static_cast<std::size_t>(cursor - points.begin());
+        cursor = std::partition_point(cursor, end, [child_shift, octant](const KeyedPoint &point)
+        {
+            return ((point.code >> child_shift) & 7u) <= octant;
+        });
+    }
+    split.child_bounds[8] = range.end;
+    return split;
+}
+}
+
+bool obj_may_be_point_cloud(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || file.size() == 0) return false;
+    constexpr auto probe = static_cast<qint64>(kPointCloudProbeBytes);
+    const QByteArray head = file.read(probe);
+    QByteArray tail;
+    if (file.size() > probe && file.seek(std::max(file.size() - probe, probe))) tail = file.read(probe);
+
+    bool faces = false;
+    bool vertices = false;
+    const auto scan = [&faces, &vertices](const QByteArray &window, const bool starts_line)
+    {
+        const std::string_view text(window.constData(), static_cast<std::size_t>(window.size()));
+        for_each_line(text, starts_line ? 0 : 1, text.size(), [&faces, &vertices](const char *begin, const char *end) // 1: skips a cut first line
+        {
+            faces = is_face_line(begin, end);
+            vertices = vertices || is_vertex_line(begin, end);
+            return !faces; // One face settles it
+        });
+    };
+    scan(head, true);
+    if (!faces) scan(tail, false);
+    return !faces && vertices; // Faceless files without vertices are not clouds either
+}
+
+PointCloudOctree read_point_cloud(const QString &path)
+{
+    using Clock = std::chrono::steady_clock;
+    PointCloudOctree octree;
+    const auto read_start = Clock::now();
+    const MappedFile mapped(path);
+    const std::string_view text = mapped.text;
+    if (text.empty())
+    {
+        octree.error = mapped.file.size() == 0 ? QStringLiteral("empty file") : mapped.file.errorString();
+        return octree;
+    }
+
+    std::array<double, 6> origin{}; // First vertex: georeferenced coordinates lose their detail when stored as float directly
+    bool found = false;
+    for (std::size_t cursor = 0; cursor < text.size() && !found;)
+    {
+        std::size_t newline = text.find('\n', cursor);
+        if (newline == std::string_view::npos) newline = text.size();
+        const char *begin = text.data() + cursor;
+        const char *end = text.data() + newline;
+        found = is_vertex_line(begin, end) && parse_vertex_line(begin + 2, end, origin) >= 3;
+        cursor = newline + 1;
+    }
+    if (!found)
+    {
+        octree.error = QStringLiteral("no vertices");
+        return octree;
+    }
+
+    // Parse: every job reads the lines starting in its byte range; lists are joined in job order
+    octree.jobs = frame_job_count(text.size(), kMinBytesPerJob);
+    std::vector<std::vector<PointCloudPoint>> job_points(octree.jobs);
+    std::vector<char> job_colors(octree.jobs, 0);
+    std::atomic<bool> faces{false}; // Set by the first job to meet an "f" line; every job then stops
+    run_background_jobs(octree.jobs, text.size(), [&](const std::size_t job, const std::size_t first, const std::size_t last)
+    {
+        std::vector<PointCloudPoint> &points = job_points[job];
+        for_each_line(text, first, last, [&](const char *begin, const char *end)
+        {
+            if (is_face_line(begin, end)) faces.store(true, std::memory_order_relaxed);
+            if (faces.load(std::memory_order_relaxed)) return false;
+            if (!is_vertex_line(begin, end)) return true;
+            std::array<double, 6> values{};
+            const int count = parse_vertex_line(begin + 2, end, values);
+            if (count < 3) return true;
+            PointCloudPoint point;
+            point.position = glm::vec3(static_cast<float>(values[0] - origin[0]), static_cast<float>(values[1] - origin[1]),
+                                       static_cast<float>(values[2] - origin[2]));
+            if (count >= 6) // "v x y z r g b" (MeshLab, CloudCompare); some writers use 0-255 instead of 0-1
+            {
+                glm::vec3 color(static_cast<float>(values[3]), static_cast<float>(values[4]), static_cast<float>(values[5]));
+                if (std::max({color.r, color.g, color.b}) > 1.0f) color /= 255.0f;
+                point.color = pack_color(color);
+                job_colors[job] = 1;
+            }
+            points.push_back(point);
+            return true;
+        });
+    });
+    if (faces.load())
+    {
+        octree.has_faces = true; // Faces between the probed windows; the caller imports a mesh instead
+        return octree;
+    }
+    std::size_t point_count = 0;
+    for (const auto &points : job_points) point_count += points.size();
+    octree.has_colors = std::ranges::any_of(job_colors, [](const char colored) { return colored != 0; });
+    octree.read_ms = std::chrono::duration<double, std::milli>(Clock::now() - read_start).count();
+
+    // Bounds, then recentre like meshes: centered on X/Z, lowest point on the ground
+    const auto build_start = Clock::now();
+    std::vector<glm::vec3> job_min(octree.jobs, glm::vec3(std::numeric_limits<float>::max()));
+    std::vector<glm::vec3> job_max(octree.jobs, glm::vec3(std::numeric_limits<float>::lowest()));
+    run_background_jobs(octree.jobs, octree.jobs, [&](std::size_t, const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t job(begin); job < end; job++)
+        {
+            for (const PointCloudPoint &point : job_points[job])
+            {
+                job_min[job] = glm::min(job_min[job], point.position);
+                job_max[job] = glm::max(job_max[job], point.position);
+            }
+        }
+    });
+    glm::vec3 bounds_min(std::numeric_limits<float>::max());
+    glm::vec3 bounds_max(std::numeric_limits<float>::lowest());
+    for (std::size_t job(0); job < octree.jobs; job++)
+    {
+        bounds_min = glm::min(bounds_min, job_min[job]);
+        bounds_max = glm::max(bounds_max, job_max[job]);
+    }
+    const glm::vec3 recenter(0.5f * (bounds_min.x + bounds_max.x), bounds_min.y, 0.5f * (bounds_min.z + bounds_max.z));
+    octree.bounds_min = bounds_min - recenter;
+    octree.bounds_max = bounds_max - recenter;
+
+    const glm::vec3 extent = octree.bounds_max - octree.bounds_min;
+    const float size = std::max({extent.x, extent.y, extent.z, 1e-6f}); // Root cube anchored at the minimum corner
+    const float scale = static_cast<float>(1u << kMortonBits) / size;
+    std::vector<std::size_t> job_offsets(octree.jobs + 1, 0);
+    for (std::size_t job(0); job < octree.jobs; job++) job_offsets[job + 1] = job_offsets[job] + job_points[job].size();
+    std::vector<KeyedPoint> keyed(point_count);
+    run_background_jobs(octree.jobs, octree.jobs, [&](std::size_t, const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t job(begin); job < end; job++)
+        {
+            for (std::size_t i(0); i < job_points[job].size(); i++)
+            {
+                KeyedPoint &out = keyed[job_offsets[job] + i];
+                out.point = job_points[job][i];
+                out.point.position -= recenter;
+                if (!octree.has_colors) out.point.color = pack_color(height_ramp(out.point.position.y / std::max(extent.y, 1e-6f)));
+                out.code = morton_code(out.point.position, octree.bounds_min, scale);
+            }
+            std::vector<PointCloudPoint>().swap(job_points[job]); // Release as we go: scans can be large
+        }
+    });
+    sort_points(keyed, frame_job_count(keyed.size(), kMinPointsPerJob));
+
+    // Nodes level by level: the nodes of one level own disjoint ranges, so they split in parallel
+    PointCloudNode root;
+    root.half_size = 0.5f * size;
+    root.center = octree.bounds_min + glm::vec3(root.half_size);
+    root.spacing = size / static_cast<float>(kPointCloudGridCells);
+    octree.nodes.push_back(root);
+    std::vector<NodeRange> level_nodes{{0, 0, keyed.size()}};
+    std::vector<NodeSplit> splits;
+    while (!level_nodes.empty())
+    {
+        splits.assign(level_nodes.size(), {});
+        const std::uint32_t level = octree.nodes[level_nodes.front().node].level;
+        run_background_jobs(frame_job_count(level_nodes.size(), 1), level_nodes.size(), [&](std::size_t, const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t i(begin); i < end; i++) splits[i] = split_node(keyed, level_nodes[i], level);
+        });
+
+        std::vector<NodeRange> next_level;
+        for (std::size_t i(0); i < level_nodes.size(); i++)
+        {
+            const NodeSplit &split = splits[i];
+            const std::uint32_t parent = level_nodes[i].node;
+            octree.nodes[parent].first = static_cast<std::uint32_t>(level_nodes[i].begin);
+            octree.nodes[parent].count = static_cast<std::uint32_t>(split.count);
+            octree.dropped_points += split.dropped;
+            octree.depth = std::max(octree.depth, level);
+            for (std::uint32_t octant(0); octant < 8; octant++)
+            {
+                if (split.child_bounds[octant] == split.child_bounds[octant + 1]) continue;
+                PointCloudNode child;
+                child.level = level + 1;
+                child.half_size = 0.5f * octree.nodes[parent].half_size;
+                child.spacing = 0.5f * octree.nodes[parent].spacing;
+                const glm::vec3 side(static_cast<float>(octant >> 2 & 1u), static_cast<float>(octant >> 1 & 1u), static_cast<float>(octant & 1u));
+                child.center = octree.nodes[parent].center + (side * 2.0f - 1.0f) * child.half_size;
+                octree.nodes[parent].children[octant] = static_cast<std::uint32_t>(octree.nodes.size());
+                next_level.push_back({static_cast<std::uint32_t>(octree.nodes.size()), split.child_bounds[octant], split.child_bounds[octant + 1]});
+                octree.nodes.push_back(child);
+            }
+        }
+        level_nodes = std::move(next_level);
+    }
+
+    octree.points.resize(keyed.size()); // Dropped duplicates keep their slots; no node points at them
+    run_background_jobs(frame_job_count(keyed.size(), kMinPointsPerJob), keyed.size(), [&](std::size_t, const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i(begin); i < end; i++) octree.points[i] = keyed[i].point;
+    });
+    octree.build_ms = std::chrono::duration<double, std::milli>(Clock::now() - build_start).count();
+    return octree;
+}
+
+std::vector<PointCloudSelection> select_point_cloud_nodes(const std::span<const PointCloudInstance> clouds, const glm::mat4 &view_projection,
+                                                          const glm::vec3 &camera_position, const float projection_scale,
+                                                          const std::size_t point_budget, const std::size_t max_nodes,
+                                                          const float min_spacing_pixels, PointCloudSelectionStats &stats)
+{
+    stats = {};
+    const auto row = [&view_projection](const int i)
+    {
+        return glm::vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]);
+    };
+    std::array<glm::vec4, 6> planes{row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(3) + row(2), row(3) - row(2)};
+    for (glm::vec4 &plane : planes) plane /= glm::length(glm::vec3(plane));
+
+    struct Candidate
+    {
+        float priority = 0.0f; // Projected size in pixels
+        std::size_t cloud = 0;
+        std::uint32_t node = 0;
+        std::size_t parent = std::numeric_limits<std::size_t>::max(); // Selection index of the parent
+        bool operator<(const Candidate &other) const { return priority < other.priority; }
+    };
+    std::priority_queue<Candidate> candidates;
+    const auto push = [&](const std::size_t cloud, const std::uint32_t node_index, const std::size_t parent)
+    {
+        stats.visited_nodes++;
+        const PointCloudNode &node = clouds[cloud].octree->nodes[node_index];
+        const glm::vec3 center = node.center + clouds[cloud].translation;
+        const float radius = node.half_size * 1.7320508f; // Bounding sphere of the cube
+        for (const glm::vec4 &plane : planes)
+        {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return; // Outside
+        }
+        const float distance = glm::length(center - camera_position);
+        const float priority = distance > radius ? radius / distance * projection_scale : std::numeric_limits<float>::max();
+        candidates.push({priority, cloud, node_index, parent});
+    };
+    for (std::size_t cloud(0); cloud < clouds.size(); cloud++)
+    {
+        if (clouds[cloud].octree && !clouds[cloud].octree->nodes.empty()) push(cloud, 0, std::numeric_limits<std::size_t>::max());
+    }
+
+    std::vector<PointCloudSelection> selection;
+    std::vector<std::size_t> parents; // Per selection
+    while (!candidates.empty())
+    {
+        const Candidate candidate = candidates.top();
+        candidates.pop();
+        const PointCloudNode &node = clouds[candidate.cloud].octree->nodes[candidate.node];
+        if (stats.selected_points + node.count > point_budget || selection.size() >= max_nodes)
+        {
+            stats.budget_reached = true;
+            break;
+        }
+        stats.selected_points += node.count;
+        selection.push_back({candidate.cloud, candidate.node, node.spacing});
+        parents.push_back(candidate.parent);
+
+        const float distance = std::max(glm::length(node.center + clouds[candidate.cloud].translation - camera_position) - node.half_size * 1.7320508f,
+                                        1e-3f); // Nearest part of the cube
+        if (node.spacing / distance * projection_scale < min_spacing_pixels) continue; // Children would add sub-pixel detail
+        for (const std::uint32_t child : node.children)
+        {
+            if (child != kPointCloudNoChild) push(candidate.cloud, child, selection.size() - 1);
+        }
+    }
+
+    // Point sizes, children before parents: a node whose children are all drawn takes the coarsest spacing among them
+    std::vector<std::uint32_t> selected_children(selection.size(), 0);
+    std::vector<float> child_spacing(selection.size(), 0.0f);
+    for (std::size_t i = selection.size(); i-- > 0;)
+    {
+        const PointCloudNode &node = clouds[selection[i].cloud].octree->nodes[selection[i].node];
+        const auto children = static_cast<std::uint32_t>(std::ranges::count_if(node.children, [](const std::uint32_t child) { return child != kPointCloudNoChild; }));
+        if (children > 0 && selected_children[i] == children) selection[i].spacing = child_spacing[i];
+        if (parents[i] == std::numeric_limits<std::size_t>::max()) continue;
+        selected_children[parents[i]]++;
+        child_spacing[parents[i]] = std::max(child_spacing[parents[i]], selection[i].spacing);
+    }
+    return selection;
+}
@@ -0,0 +1,99 @@
+#ifndef POINT_CLOUD_H // Guard against multiple inclusion
+#define POINT_CLOUD_H // Begin include guard
+
+#include <QString> // Source file paths and read errors
+
+#include <glm/glm.hpp> // Positions, bounds and camera matrices
+
+#include <array> // Child links
+#include <cstddef> // Point and node counts
+#include <cstdint> // Packed colors and node indices
+#include <span> // Non-owning view over the clouds of a frame
+#include <vector> // Points, nodes and selections
+
+// Point clouds: OBJ files with vertices but no faces (scans). The points are sorted into a multi-resolution octree: every
+// node keeps one point per cell of a kPointCloudGridCells^3 grid over its cube, and the remaining points go down to its
+// children. Drawing a node together with its ancestors therefore gives the density of its level, so a frame only needs
+// the nodes whose spacing is still visible on screen, in order of projected size until the point budget is spent.
+
+constexpr std::uint32_t kPointCloudGridCells = 64; // Subsampling grid per node and axis (6 Morton levels)
+constexpr std::uint32_t kPointCloudMaxNodePoints = 16384; // Larger subsamples are thinned; leaves hold at most this many
+constexpr std::uint32_t kPointCloudNoChild = 0xFFFFFFFFu; // Empty octant
+
+struct PointCloudPoint // std430 mirror of one point in the GPU node pages (16 bytes)
+{
+    glm::vec3 position{}; // Relative to the cloud origin (centered on X/Z, lowest point at Y = 0)
+    std::uint32_t color = 0xFFFFFFFFu; // RGBA8, read with unpackUnorm4x8
+};
+
+struct PointCloudNode // Cube of the octree; its points are a contiguous range of PointCloudOctree::points
+{
+    glm::vec3 center{}; // Cube center in cloud coordinates
+    float half_size = 0.0f; // Half the cube edge
+    float spacing = 0.0f; // Grid cell size of the node's subsample (distance between its points on a dense surface)
+    std::uint32_t level = 0; // Depth below the root
+    std::uint32_t first = 0; // First point of the node
+    std::uint32_t count = 0; // Points of the node (not counting its descendants)
+    std::array<std::uint32_t, 8> children{kPointCloudNoChild, kPointCloudNoChild, kPointCloudNoChild, kPointCloudNoChild,
+                                          kPointCloudNoChild, kPointCloudNoChild, kPointCloudNoChild, kPointCloudNoChild};
+};
+
+struct PointCloudOctree // Output of a worker-thread import; immutable afterwards and shared by every view
+{
+    std::vector<PointCloudPoint> points; // A node's points are contiguous and precede those of its descendants
+    std::vector<PointCloudNode> nodes; // nodes[0] is the root; breadth first, so children follow their parents
+    glm::vec3 bounds_min{0.0f}; // Cloud coordinates
+    glm::vec3 bounds_max{0.0f};
+    bool has_colors = false; // Colors came from the file (otherwise a height ramp)
+    std::size_t dropped_points = 0; // Points beyond kPointCloudMaxNodePoints in a cube at the deepest level (duplicates)
+    std::uint32_t depth = 0; // Deepest level
+    double read_ms = 0.0; // File parse
+    double build_ms = 0.0; // Bounds, Morton sort and node construction
+    std::size_t jobs = 1; // Jobs the work was split into
+    bool has_faces = false; // The parse met an "f" line: the file is a mesh after all (nothing else is filled in)
+    QString error; // Empty on success
+};
+
+// False when the first or last kPointCloudProbeBytes of an OBJ file hold a face ("f") line, or no vertex line. Reads only
+// those two windows, so it is cheap for any file size; mesh writers put faces after their vertices, so the tail almost
+// always catches them. True is only a guess: read_point_cloud still reports faces it meets anywhere in the file.
+constexpr std::size_t kPointCloudProbeBytes = std::size_t{1} << 20;
+[[nodiscard]] bool obj_may_be_point_cloud(const QString &path);
+
+// Parse the "v x y z [r g b]" lines of an OBJ file on all cores and build the octree. Coordinates are read in double
+// precision relative to the first vertex, so georeferenced scans keep their detail in float. Touches no GL or GUI state.
+// Stops at the first "f" line, with has_faces set and no octree built, when the file turns out to be a mesh.
+[[nodiscard]] PointCloudOctree read_point_cloud(const QString &path);
+
+struct PointCloudInstance // One placed cloud as seen by the node selection
+{
+    const PointCloudOctree *octree = nullptr;
+    glm::vec3 translation{0.0f}; // World position of the cloud origin
+};
+
+struct PointCloudSelection // Node drawn this frame
+{
+    std::size_t cloud = 0; // Index into the instances
+    std::uint32_t node = 0;
+    float spacing = 0.0f; // World-space point spacing where the node is drawn (sets the point size)
+};
+
+struct PointCloudSelectionStats
+{
+    std::size_t visited_nodes = 0; // Nodes tested against the frustum
+    std::size_t selected_points = 0;
+    bool budget_reached = false; // More detail was visible than the budget allowed
+};
+
+// Nodes to draw, coarse to fine: the visible node with the largest projected size is taken first, and its children become
+// candidates while the node's spacing still projects to at least min_spacing_pixels. Stops once point_budget points or
+// max_nodes nodes are selected. Each selection's spacing is that of the shallowest level where the drawn subtree stops,
+// so points grow where detail is missing and shrink where finer nodes fill the gaps.
+[[nodiscard]] std::vector<PointCloudSelection> select_point_cloud_nodes(std::span<const PointCloudInstance> clouds,
+                                                                        const glm::mat4 &view_projection, const glm::vec3 &camera_position,
+                                                                        float projection_scale, std::size_t point_budget,
+                                                                        std::size_t max_nodes, float min_spacing_pixels,
+                                                                        PointCloudSelectionStats &stats);
+
+
+#endif //POINT_CLOUD_H // End include guard
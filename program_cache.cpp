@@ -0,0 +1,48 @@
+#include "program_cache.h"
+
+#include "disk_cache.h"
+
+#include <QCryptographicHash>
+
+#include <cstring>
+
+namespace // Anonymous namespace holding the cache description
+{
+constexpr DiskCache kProgramCache{"programs", ".bin", {'P', 'G', 'B', '2'}, 2, "program"}; // Payload: binary format, then the binary
+}
+
+QByteArray program_cache_key(const QByteArray &sources, const QByteArray &driver)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(sources);
+    hash.addData(driver);
+    hash.addData(reinterpret_cast<const char*>(&kProgramCache.version), sizeof(kProgramCache.version));
+    return hash.result().toHex();
+}
+
+std::optional<ProgramBinary> load_cached_program(const QByteArray &key)
+{
+    const std::optional<QByteArray> payload = load_disk_cache_entry(kProgramCache, key);
+    if (!payload) return std::nullopt; // Not linked yet, or damaged
+    ProgramBinary binary;
+    if (payload->size() < static_cast<qsizetype>(sizeof(binary.format)))
+    {
+        warn_damaged_disk_cache_entry(kProgramCache, key);
+        return std::nullopt;
+    }
+    std::memcpy(&binary.format, payload->constData(), sizeof(binary.format));
+    binary.data = payload->mid(sizeof(binary.format));
+    return binary;
+}
+
+void store_cached_program(const QByteArray &key, const ProgramBinary &binary)
+{
+    QByteArray payload(reinterpret_cast<const char*>(&binary.format), sizeof(binary.format));
+    payload.append(binary.data);
+    store_disk_cache_entry(kProgramCache, key, payload);
+}
+
+void remove_cached_program(const QByteArray &key)
+{
+    remove_disk_cache_entry(kProgramCache, key);
+}
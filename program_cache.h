@@ -0,0 +1,25 @@
+#ifndef PROGRAM_CACHE_H // Guard against multiple inclusion
+#define PROGRAM_CACHE_H // Begin include guard
+
+#include <QByteArray> // Cache keys and binary blobs
+
+#include <cstdint> // Binary format enum as stored on disk
+#include <optional> // Cache misses
+
+struct ProgramBinary // Linked program as returned by glGetProgramBinary
+{
+    std::uint32_t format = 0; // Driver-specific binary format (GLenum)
+    QByteArray data;
+};
+
+// Key of a linked program: every source string of every stage plus the driver identity (vendor, renderer, version),
+// so a driver update or a shader edit misses instead of handing the driver a binary it may reject
+[[nodiscard]] QByteArray program_cache_key(const QByteArray &sources, const QByteArray &driver);
+
+// Disk cache of program binaries under the application cache location
+[[nodiscard]] std::optional<ProgramBinary> load_cached_program(const QByteArray &key);
+void store_cached_program(const QByteArray &key, const ProgramBinary &binary);
+void remove_cached_program(const QByteArray &key); // Drop an entry the driver rejected
+
+
+#endif //PROGRAM_CACHE_H // End include guard
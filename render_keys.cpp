@@ -0,0 +1,40 @@
+#include "render_keys.h"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+
+std::uint64_t make_render_key(const std::uint32_t vertex_format, const float view_depth)
+{
+    const float depth = view_depth > 0.0f ? view_depth : 0.0f; // Behind/at the eye sorts first; NaN also lands here
+    const auto depth_bits = std::bit_cast<std::uint32_t>(depth); // Non-negative IEEE floats order like their bit patterns
+    return static_cast<std::uint64_t>(vertex_format) << 32 | depth_bits;
+}
+
+std::uint32_t render_key_format(const std::uint64_t key)
+{
+    return static_cast<std::uint32_t>(key >> 32);
+}
+
+void radix_sort_render_keys(std::vector<RenderKeyEntry> &entries, std::vector<RenderKeyEntry> &scratch)
+{
+    if (entries.size() < 2) return;
+    scratch.resize(entries.size());
+
+    for (unsigned shift(0); shift < 64; shift += 8)
+    {
+        std::array<std::size_t, 256> offsets{}; // Histogram, then exclusive prefix sum
+        for (const auto &entry : entries) offsets[(entry.key >> shift) & 0xFFu]++;
+        if (offsets[(entries.front().key >> shift) & 0xFFu] == entries.size()) continue; // Every key shares this byte
+
+        std::size_t running = 0;
+        for (auto &offset : offsets)
+        {
+            const std::size_t count = offset;
+            offset = running;
+            running += count;
+        }
+        for (const auto &entry : entries) scratch[offsets[(entry.key >> shift) & 0xFFu]++] = entry; // Stable scatter
+        entries.swap(scratch);
+    }
+}
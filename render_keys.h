@@ -0,0 +1,25 @@
+#ifndef RENDER_KEYS_H // Guard against multiple inclusion
+#define RENDER_KEYS_H // Begin include guard
+
+#include <cstdint> // Packed 64-bit keys
+#include <vector> // Sort buffers
+
+// Key layout, most significant first, so a plain ascending sort groups vertex formats and then orders by depth:
+//   [63:32] vertex format (decode branch of the pulling shader)   [31:0] view depth (front to back)
+// Every draw is part of one multi-draw over the shared pools, so there are no GL state changes to save; grouping formats
+// keeps neighbouring draws on the same decode branch, and depth order lets near objects fill the depth buffer first.
+struct RenderKeyEntry // One draw to sort; the index points back into the caller's draw list
+{
+    std::uint64_t key = 0;
+    std::uint32_t index = 0;
+};
+
+[[nodiscard]] std::uint64_t make_render_key(std::uint32_t vertex_format, float view_depth); // Pack one key
+[[nodiscard]] std::uint32_t render_key_format(std::uint64_t key); // Vertex format bits (a change means a decode-branch switch)
+
+// Stable LSD radix sort on the 64-bit key, 8 bits per pass. Passes whose byte is equal for every key are skipped,
+// so keys that differ only in depth cost four passes. scratch is reused between frames to avoid allocations.
+void radix_sort_render_keys(std::vector<RenderKeyEntry> &entries, std::vector<RenderKeyEntry> &scratch);
+
+
+#endif //RENDER_KEYS_H // End include guard
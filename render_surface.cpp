@@ -0,0 +1,94 @@
+#include "render_surface.h"
+
+#include "view_3D.h"
+
+#include <QCoreApplication>
+#include <QOpenGLContext>
+#include <QPainter>
+#include <QResizeEvent>
+
+WidgetRenderSurface::WidgetRenderSurface(View *view) : QOpenGLWidget(view), view_(view)
+{
+    setFocusPolicy(Qt::NoFocus); // Keys go to the view, which takes focus on click
+    setMouseTracking(true); // Unhandled mouse events propagate to the view
+}
+
+void WidgetRenderSurface::initializeGL()
+{
+    view_->initializeGL();
+}
+
+void WidgetRenderSurface::resizeGL(const int w, const int h)
+{
+    view_->resizeGL(w, h);
+}
+
+void WidgetRenderSurface::paintGL()
+{
+    view_->paintGL();
+}
+
+void WidgetRenderSurface::paintEvent(QPaintEvent *event)
+{
+    if (view_->renderer_) return; // The render thread draws; composition picks up the widget framebuffer as it is
+    QOpenGLWidget::paintEvent(event);
+}
+
+WindowRenderSurface::WindowRenderSurface(View *view) : QOpenGLWindow(QOpenGLContext::globalShareContext()), view_(view)
+{
+    setFormat(QSurfaceFormat::defaultFormat()); // Depth and swap interval as requested in main.cpp
+    container_ = QWidget::createWindowContainer(this, view); // Takes ownership of the window
+    container_->setFocusPolicy(Qt::StrongFocus); // Clicks focus the native window, which forwards keys
+}
+
+void WindowRenderSurface::initializeGL()
+{
+    view_->initializeGL();
+}
+
+void WindowRenderSurface::resizeGL(const int w, const int h)
+{
+    view_->resizeGL(w, h);
+}
+
+void WindowRenderSurface::paintGL()
+{
+    view_->paintGL();
+}
+
+bool WindowRenderSurface::event(QEvent *event)
+{
+    switch (event->type())
+    {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::MouseMove:
+        case QEvent::Wheel:
+        case QEvent::KeyPress:
+        case QEvent::KeyRelease:
+            // The container sits at the view's origin, so window coordinates are view coordinates
+            return QCoreApplication::sendEvent(view_, event);
+        default:
+            return QOpenGLWindow::event(event);
+    }
+}
+
+SoftwareRenderSurface::SoftwareRenderSurface(View *view) : QWidget(view), view_(view)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent); // Every frame covers the whole widget
+    setFocusPolicy(Qt::NoFocus); // Keys go to the view, which takes focus on click
+    setMouseTracking(true); // Unhandled mouse events propagate to the view
+}
+
+void SoftwareRenderSurface::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    view_->paint_software(painter);
+}
+
+void SoftwareRenderSurface::resizeEvent(QResizeEvent *event)
+{
+    view_->resizeGL(event->size().width(), event->size().height());
+    QWidget::resizeEvent(event);
+}
@@ -0,0 +1,101 @@
+#ifndef RENDER_SURFACE_H // Guard against multiple inclusion
+#define RENDER_SURFACE_H // Begin include guard
+
+#include <QOpenGLWidget> // Widget backend: renders into an FBO that Qt composites into the top-level window
+#include <QOpenGLWindow> // Window backend: renders into the native window's default framebuffer and swaps it
+#include <QWidget> // Software backend: paints the CPU rasterizer's frames with QPainter
+
+class View; // Owner of all GL state; the surfaces only forward to it
+
+// What View needs from the object that owns the GL context and puts frames on screen
+class RenderSurface
+{
+public:
+    virtual ~RenderSurface() = default;
+
+    [[nodiscard]] virtual QWidget *surface_widget() = 0; // Widget placed in View's layout
+    [[nodiscard]] virtual QOpenGLContext *gl_context() const = 0; // Null before the surface was initialized
+    [[nodiscard]] virtual GLuint default_framebuffer() const = 0; // Target of the final blit and the HUD
+    [[nodiscard]] virtual bool gl_initialized() const = 0; // initializeGL has run
+    virtual void make_current() = 0; // Context current with the default framebuffer bound
+    virtual void done_current() = 0; // Release the context on this thread
+    virtual void schedule_paint() = 0; // Ask for paintGL on the GUI thread
+};
+
+// Fallback backend: every frame goes through Qt's composition of the widget FBO into the top-level window
+class WidgetRenderSurface final : public QOpenGLWidget, public RenderSurface
+{
+    Q_OBJECT // aboutToCompose/frameSwapped/aboutToResize/resized are used by the render thread
+
+public:
+    explicit WidgetRenderSurface(View *view); // Child of view; input events propagate to it
+
+    [[nodiscard]] QWidget *surface_widget() override { return this; }
+    [[nodiscard]] QOpenGLContext *gl_context() const override { return context(); }
+    [[nodiscard]] GLuint default_framebuffer() const override { return defaultFramebufferObject(); }
+    [[nodiscard]] bool gl_initialized() const override { return isValid(); }
+    void make_current() override { makeCurrent(); }
+    void done_current() override { doneCurrent(); }
+    void schedule_paint() override { update(); }
+
+protected:
+    void initializeGL() override; // Forwarded to View
+    void resizeGL(int w, int h) override; // Forwarded to View
+    void paintGL() override; // Forwarded to View
+    void paintEvent(QPaintEvent *event) override; // Skips GUI-thread painting while the render thread draws
+
+private:
+    View *view_ = nullptr; // Parent view
+};
+
+// Native backend: a QOpenGLWindow inside a window container draws straight into the window surface
+class WindowRenderSurface final : public QOpenGLWindow, public RenderSurface
+{
+    Q_OBJECT // frameSwapped feeds the input latency measurement
+
+public:
+    explicit WindowRenderSurface(View *view); // Owned by the container it creates in view
+
+    [[nodiscard]] QWidget *surface_widget() override { return container_; }
+    [[nodiscard]] QOpenGLContext *gl_context() const override { return context(); }
+    [[nodiscard]] GLuint default_framebuffer() const override { return defaultFramebufferObject(); }
+    [[nodiscard]] bool gl_initialized() const override { return context() != nullptr; }
+    void make_current() override { makeCurrent(); }
+    void done_current() override { doneCurrent(); }
+    void schedule_paint() override { update(); }
+
+protected:
+    void initializeGL() override; // Forwarded to View
+    void resizeGL(int w, int h) override; // Forwarded to View
+    void paintGL() override; // Forwarded to View
+    bool event(QEvent *event) override; // Mouse, wheel and key input goes to the view handlers
+
+private:
+    View *view_ = nullptr; // View receiving GL callbacks and input
+    QWidget *container_ = nullptr; // createWindowContainer() wrapper laid out in view
+};
+
+// CPU backend: a plain widget showing the frames of the software rasterizer; there is no context, so the GL calls are no-ops
+class SoftwareRenderSurface final : public QWidget, public RenderSurface
+{
+public:
+    explicit SoftwareRenderSurface(View *view); // Child of view; input events propagate to it
+
+    [[nodiscard]] QWidget *surface_widget() override { return this; }
+    [[nodiscard]] QOpenGLContext *gl_context() const override { return nullptr; }
+    [[nodiscard]] GLuint default_framebuffer() const override { return 0; }
+    [[nodiscard]] bool gl_initialized() const override { return false; } // Keeps every GL-only path (pools, render thread) off
+    void make_current() override {}
+    void done_current() override {}
+    void schedule_paint() override { update(); }
+
+protected:
+    void paintEvent(QPaintEvent *event) override; // Rasterizes and draws a frame on the GUI thread
+    void resizeEvent(QResizeEvent *event) override; // Forwarded to View::resizeGL (projection and image size)
+
+private:
+    View *view_ = nullptr; // Parent view
+};
+
+
+#endif //RENDER_SURFACE_H // End include guard
@@ -0,0 +1,57 @@
+#include "shader_reload.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
+ShaderReload::ShaderReload(const QString &directory, QObject *parent) : QObject(parent),
+    directory_(QDir(directory).absolutePath()), overrides_(std::make_shared<const ShaderOverrides>())
+{
+    if (!QDir().mkpath(directory_)) qWarning() << "Cannot create shader directory" << directory_;
+    for (const ShaderSnippet &snippet : shader_snippets()) // Seed the directory so there is something to edit
+    {
+        QFile file(QDir(directory_).filePath(QString::fromLatin1(snippet.name) + QStringLiteral(".glsl")));
+        if (file.exists()) continue;
+        if (!file.open(QIODevice::WriteOnly)) qWarning() << "Cannot write" << file.fileName();
+        else file.write(snippet.source);
+    }
+
+    reload_timer_.setSingleShot(true);
+    reload_timer_.setInterval(100);
+    connect(&reload_timer_, &QTimer::timeout, this, &ShaderReload::reload);
+    connect(&watcher_, &QFileSystemWatcher::fileChanged, this, [this] { reload_timer_.start(); });
+    connect(&watcher_, &QFileSystemWatcher::directoryChanged, this, [this] { reload_timer_.start(); });
+    watch_files();
+    reload(); // Files edited before this launch apply from the first frame
+    qInfo() << "Shader hot reload watching" << directory_;
+}
+
+void ShaderReload::watch_files()
+{
+    QStringList paths;
+    if (!watcher_.directories().contains(directory_)) paths << directory_;
+    for (const ShaderSnippet &snippet : shader_snippets())
+    {
+        const QString path = QDir(directory_).filePath(QString::fromLatin1(snippet.name) + QStringLiteral(".glsl"));
+        if (QFile::exists(path) && !watcher_.files().contains(path)) paths << path;
+    }
+    if (!paths.isEmpty()) watcher_.addPaths(paths);
+}
+
+void ShaderReload::reload()
+{
+    watch_files();
+    auto overrides = std::make_shared<ShaderOverrides>();
+    for (const ShaderSnippet &snippet : shader_snippets())
+    {
+        QFile file(QDir(directory_).filePath(QString::fromLatin1(snippet.name) + QStringLiteral(".glsl")));
+        if (!file.open(QIODevice::ReadOnly)) continue; // Deleted file: the built-in snippet applies again
+        const QByteArray text = file.readAll();
+        if (text != QByteArray(snippet.source)) overrides->emplace(snippet.name, text.toStdString());
+    }
+    if (*overrides == *overrides_) return; // Saved without changes, or a notification about another file
+    overrides_ = std::move(overrides);
+    revision_++;
+    qInfo() << "Shader sources changed:" << overrides_->size() << "snippets differ from the built-in ones";
+    emit changed();
+}
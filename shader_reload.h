@@ -0,0 +1,43 @@
+#ifndef SHADER_RELOAD_H // Guard against multiple inclusion
+#define SHADER_RELOAD_H // Begin include guard
+
+#include "shader_sources.h" // Snippet names and the override table
+
+#include <QFileSystemWatcher> // Change notifications for the snippet files
+#include <QObject> // Base class; emits changed() on the GUI thread
+#include <QString> // Directory path
+#include <QTimer> // Coalesces the several notifications of one save
+
+#include <cstdint> // Revision counter
+#include <memory> // Override tables shared with the renderers
+
+// Shader hot reload (--shader-dir). The directory holds one <snippet>.glsl file per entry of shader_snippets(); missing
+// files are written from the built-in sources on start. Every saved edit rebuilds the override table (files whose text
+// differs from the built-in snippet) and emits changed(); views hand the table to their renderer, which recompiles
+// the affected programs without blocking and keeps the old ones when the new text fails to compile.
+class ShaderReload final : public QObject
+{
+    Q_OBJECT // Enable signals/slots
+
+public:
+    explicit ShaderReload(const QString &directory, QObject *parent = nullptr);
+
+    [[nodiscard]] std::shared_ptr<const ShaderOverrides> overrides() const { return overrides_; } // Never null
+    [[nodiscard]] std::uint64_t revision() const { return revision_; } // Bumped by every reload that changed the table
+
+signals:
+    void changed(); // New overrides are available
+
+private:
+    void watch_files(); // (Re)add the snippet files; editors that save by renaming drop them from the watcher
+    void reload(); // Read every file and publish a new table when it differs
+
+    QString directory_; // Absolute path of the snippet files
+    QFileSystemWatcher watcher_; // Snippet files and the directory itself
+    QTimer reload_timer_; // Single shot: reload once the editor finished writing
+    std::shared_ptr<const ShaderOverrides> overrides_; // Current table
+    std::uint64_t revision_ = 0;
+};
+
+
+#endif //SHADER_RELOAD_H // End include guard
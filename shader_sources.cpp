@@ -0,0 +1,894 @@
+#include "shader_sources.h"
+
+#include <array>
+
+namespace // Anonymous namespace holding the GLSL snippets
+{
+const char *const shader_version_source = "#version 450 core\n"; // First string of every stage
+
+// Draw records, geometry pools and vertex decoding shared by every pass that reads meshes
+const char *const draw_record_source = R"(
+// Per-draw data written by the CPU on scene edits (layout mirrors View::DrawRecord)
+struct DrawRecord
+{
+    mat4 model;
+    mat4 normal_matrix;
+    vec4 color;
+    vec4 bounds_min;
+    vec4 bounds_extent;
+    uint vertex_offset;
+    uint format;
+    int color_mode;
+    uint position_offset;
+    uint occlusion_offset; // 0xFFFFFFFF: no baked occlusion
+    int texture_slot; // -1: untextured
+    uint flags; // kDrawWireframe
+    uint skin_offset; // 0xFFFFFFFF: static mesh
+    uint bone_offset; // First matrix of the draw in the bone palette
+    uint padding0;
+    uint padding1;
+    uint padding2;
+};
+
+const uint kDrawWireframe = 1u; // Flag of imported meshes (kDrawWireframe in shader_sources.h)
+
+layout(std430, binding = 0) readonly buffer VertexPool { uint vertex_words[]; };
+layout(std430, binding = 1) readonly buffer IndexPool { uint pool_indices[]; };
+layout(std430, binding = 2) readonly buffer DrawRecords { DrawRecord draws[]; };
+layout(std430, binding = 7) readonly buffer PositionPool { uint position_words[]; };
+layout(std430, binding = 13) readonly buffer BonePalette { mat4 bones[]; }; // Rewritten every animated frame
+
+// Blend of the draw's bones for one vertex: 4 bone indices and 4 unorm8 weights per vertex after the mesh's vertices.
+// Weight missing to 1 keeps that share of the rest position, so vertices no bone influences stay where they are.
+mat4 skin_matrix(uint record_index, uint vertex)
+{
+    uint base = draws[record_index].skin_offset + vertex * 2u;
+    uint bone_word = vertex_words[base];
+    vec4 weights = unpackUnorm4x8(vertex_words[base + 1u]);
+    uint first = draws[record_index].bone_offset;
+    mat4 skin = mat4(1.0) * (1.0 - (weights.x + weights.y + weights.z + weights.w));
+    for (int lane = 0; lane < 4; ++lane) skin += bones[first + bitfieldExtract(bone_word, lane * 8, 8)] * weights[lane];
+    return skin;
+}
+
+// Position decode shared by the full and position-only streams, so both produce bit-identical depth
+vec3 decode_position(uint record_index, uint word0, uint word1, uint word2)
+{
+    if (draws[record_index].format == 1u) // Packed16: unorm16 x, y, z inside the mesh bounds
+    {
+        vec3 unit = vec3(unpackUnorm2x16(word0), unpackUnorm2x16(word1).x);
+        return draws[record_index].bounds_min.xyz + unit * draws[record_index].bounds_extent.xyz;
+    }
+    return uintBitsToFloat(uvec3(word0, word1, word2)); // Float32
+}
+
+// Position-only fetch used by depth passes (2 or 3 words per vertex instead of 4 or 8); skinned like fetch_vertex
+vec3 fetch_position(uint record_index, uint vertex)
+{
+    uint stride = draws[record_index].format == 1u ? 2u : 3u;
+    uint base = draws[record_index].position_offset + vertex * stride;
+    uint word2 = stride == 3u ? position_words[base + 2u] : 0u;
+    vec3 position = decode_position(record_index, position_words[base], position_words[base + 1u], word2);
+    if (draws[record_index].skin_offset == 0xFFFFFFFFu) return position;
+    return (skin_matrix(record_index, vertex) * vec4(position, 1.0)).xyz;
+}
+
+// Inverse of the CPU octahedral mapping used by the packed format
+vec3 decode_octahedral(vec2 encoded)
+{
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-normal.z, 0.0);
+    normal.x += normal.x >= 0.0 ? -fold : fold;
+    normal.y += normal.y >= 0.0 ? -fold : fold;
+    return normalize(normal);
+}
+
+// Decode one vertex; adding a format means adding a branch here and an encoder in mesh_encoding.cpp
+void decode_vertex(uint record_index, uint vertex, out vec3 position, out vec3 normal, out vec2 uv)
+{
+    uint format = draws[record_index].format;
+    if (format == 1u) // Packed16: unorm16 position, octahedral snorm16 normal, half UV
+    {
+        uint base = draws[record_index].vertex_offset + vertex * 4u;
+        position = decode_position(record_index, vertex_words[base], vertex_words[base + 1u], 0u);
+        normal = decode_octahedral(unpackSnorm2x16(vertex_words[base + 2u]));
+        uv = unpackHalf2x16(vertex_words[base + 3u]);
+        return;
+    }
+
+    uint base = draws[record_index].vertex_offset + vertex * 8u; // Float32: 3 position + 3 normal + 2 UV
+    position = decode_position(record_index, vertex_words[base], vertex_words[base + 1u], vertex_words[base + 2u]);
+    normal = uintBitsToFloat(uvec3(vertex_words[base + 3u], vertex_words[base + 4u], vertex_words[base + 5u]));
+    uv = uintBitsToFloat(uvec2(vertex_words[base + 6u], vertex_words[base + 7u]));
+}
+
+// Decoded vertex in the pose of the frame (rigged meshes) or as stored (static meshes)
+void fetch_vertex(uint record_index, uint vertex, out vec3 position, out vec3 normal, out vec2 uv)
+{
+    decode_vertex(record_index, vertex, position, normal, uv);
+    if (draws[record_index].skin_offset == 0xFFFFFFFFu) return;
+    mat4 skin = skin_matrix(record_index, vertex);
+    position = (skin * vec4(position, 1.0)).xyz; // Same expression as fetch_position, so depth passes match exactly
+    normal = mat3(skin) * normal; // Bones carry no shear; the vertex shaders normalize after the normal matrix
+}
+
+// Baked ambient occlusion: unorm8 per vertex, four vertices per word after the mesh's vertices
+float fetch_occlusion(uint record_index, uint vertex)
+{
+    uint offset = draws[record_index].occlusion_offset;
+    if (offset == 0xFFFFFFFFu) return 1.0;
+    return unpackUnorm4x8(vertex_words[offset + vertex / 4u])[vertex % 4u];
+}
+)";
+
+// Clustered Blinn-Phong lighting; gl_FragCoord picks the screen tile, view depth the slice
+const char *const lighting_source = R"(
+// Scene light (layout mirrors ClusterLight in light_clusters.h)
+struct Light
+{
+    vec4 position_range; // xyz: world position, w: range
+    vec4 color_intensity; // rgb: color, a: intensity
+    vec4 direction_cos_outer; // xyz: spot direction, w: outer cone cosine (< -1: point light)
+    vec4 cos_inner; // x: inner cone cosine
+};
+
+layout(std430, binding = 8) readonly buffer Lights { Light lights[]; };
+layout(std430, binding = 9) readonly buffer LightClusters { uvec2 light_clusters[]; }; // First index, light count
+layout(std430, binding = 10) readonly buffer LightIndices { uint light_indices[]; };
+
+const uvec3 kClusterGrid = uvec3(16u, 9u, 24u); // kClusterGridX/Y/Z in light_clusters.h
+
+layout(location = 2) uniform mat4 light_view; // World to view space
+layout(location = 3) uniform vec2 cluster_viewport_size; // Render area in pixels
+layout(location = 4) uniform vec2 cluster_depth_scale_bias; // Slice = log(view depth) * x - y
+layout(location = 5) uniform vec3 light_eye; // World-space camera position
+
+// Sun: directional and the only shadowed light (atlas cached across frames)
+layout(binding = 2) uniform sampler2DShadow shadow_atlas; // Hardware depth compare, bilinear
+layout(location = 6) uniform mat4 shadow_matrix; // World to atlas coordinates in [0, 1]
+layout(location = 7) uniform int shadows_enabled;
+const vec3 kSunToLight = normalize(vec3(0.4, 1.0, 0.3)); // sun_to_light() in view_3D.cpp
+const vec3 kSunColor = vec3(0.75, 0.72, 0.66);
+
+float sun_visibility(vec3 world_position, vec3 n)
+{
+    if (shadows_enabled == 0) return 1.0;
+    vec3 coord = (shadow_matrix * vec4(world_position + n * 0.04, 1.0)).xyz; // Normal offset against acne at grazing angles
+    if (any(lessThan(coord, vec3(0.0))) || any(greaterThan(coord, vec3(1.0)))) return 1.0; // Outside the shadowed box
+    vec2 texel = 1.0 / vec2(textureSize(shadow_atlas, 0));
+    float visible = 0.0;
+    for (int y = -1; y <= 1; ++y) // 3x3 PCF over bilinear compares
+    {
+        for (int x = -1; x <= 1; ++x) visible += texture(shadow_atlas, vec3(coord.xy + vec2(x, y) * texel, coord.z));
+    }
+    return visible / 9.0;
+}
+
+vec3 shade_lit(vec3 albedo, vec3 world_position, vec3 normal, float occlusion)
+{
+    vec3 n = normalize(normal);
+    vec3 v = normalize(light_eye - world_position);
+    vec3 result = albedo * mix(vec3(0.03, 0.035, 0.05), vec3(0.09, 0.09, 0.08), n.y * 0.5 + 0.5) * occlusion; // Hemispheric ambient
+
+    float n_dot_sun = max(dot(n, kSunToLight), 0.0);
+    if (n_dot_sun > 0.0)
+    {
+        float sun_specular = pow(max(dot(n, normalize(kSunToLight + v)), 0.0), 48.0);
+        result += (albedo * n_dot_sun + vec3(0.35) * sun_specular) * kSunColor * sun_visibility(world_position, n);
+    }
+
+    vec2 tile = clamp(gl_FragCoord.xy / cluster_viewport_size, vec2(0.0), vec2(0.99999)) * vec2(kClusterGrid.xy);
+    float depth = max(-(light_view * vec4(world_position, 1.0)).z, 1e-4);
+    uint slice = uint(clamp(log(depth) * cluster_depth_scale_bias.x - cluster_depth_scale_bias.y, 0.0, float(kClusterGrid.z - 1u)));
+    uvec2 cluster = light_clusters[(slice * kClusterGrid.y + uint(tile.y)) * kClusterGrid.x + uint(tile.x)];
+
+    for (uint i = 0u; i < cluster.y; ++i) // Only the lights binned into this cluster
+    {
+        Light light = lights[light_indices[cluster.x + i]];
+        vec3 to_light = light.position_range.xyz - world_position;
+        float distance_squared = dot(to_light, to_light);
+        float light_range = light.position_range.w;
+        if (distance_squared >= light_range * light_range) continue;
+
+        float distance = sqrt(distance_squared);
+        vec3 l = to_light / max(distance, 1e-4);
+        float window = clamp(1.0 - pow(distance / light_range, 4.0), 0.0, 1.0); // Reaches zero exactly at the range
+        float attenuation = window * window / (distance_squared + 1.0);
+        if (light.direction_cos_outer.w > -1.5) // Spot light: smooth falloff between the inner and outer cone
+        {
+            attenuation *= smoothstep(light.direction_cos_outer.w, light.cos_inner.x, dot(-l, light.direction_cos_outer.xyz));
+        }
+
+        float n_dot_l = max(dot(n, l), 0.0);
+        float specular = n_dot_l > 0.0 ? pow(max(dot(n, normalize(l + v)), 0.0), 48.0) : 0.0;
+        result += (albedo * n_dot_l + vec3(0.35) * specular) * light.color_intensity.rgb * (light.color_intensity.a * attenuation);
+    }
+    return result;
+}
+)";
+
+// Color-mode shading shared by the forward fragment shader and the visibility resolve
+const char *const shading_source = R"(
+layout(binding = 3) uniform sampler2D material_textures[12]; // kMaterialTextureUnit / kMaterialTextureSlots in view_3D.cpp
+
+// Tint times the draw's diffuse texture. Slots are visited with constant indices and explicit gradients, so the
+// lookup stays valid when neighbouring pixels belong to other draws (visibility resolve).
+vec3 material_albedo(vec3 tint, int texture_slot, vec2 uv, vec4 uv_gradients)
+{
+    vec4 texel = vec4(1.0);
+    for (int slot = 0; slot < 12; ++slot)
+    {
+        if (slot == texture_slot) texel = textureGrad(material_textures[slot], uv, uv_gradients.xy, uv_gradients.zw);
+    }
+    return tint * texel.rgb;
+}
+
+// Encode normalized world position into RGB for visualization
+vec3 encode_position(vec3 world_position)
+{
+    float length_value = length(world_position);
+    if (length_value > 1e-5)
+    {
+        vec3 normalized = clamp(world_position / length_value, vec3(-1.0), vec3(1.0));
+        return 0.5 + 0.5 * normalized;
+    }
+    return vec3(0.5);
+}
+
+// Encode normalized world-space normal into RGB (useful to inspect shading data)
+vec3 encode_normal(vec3 normal)
+{
+    float length_value = length(normal);
+    vec3 normalized = length_value > 1e-5 ? normalize(normal) : vec3(0.0, 1.0, 0.0);
+    return 0.5 + 0.5 * normalized;
+}
+
+// Encode UV coordinates into RG channels (reveals UV layout / seams)
+vec3 encode_uv(vec2 uv)
+{
+    vec2 wrapped = fract(uv);
+    return vec3(wrapped, 0.5);
+}
+
+// Wireframe overlay: darkens pixels closer than a line width to the nearest triangle edge (distances in pixels)
+const float kWireframeWidth = 1.0; // Half the line width
+vec3 apply_wireframe(vec3 color, vec3 edge_distance)
+{
+    float distance = min(edge_distance.x, min(edge_distance.y, edge_distance.z));
+    float coverage = 1.0 - smoothstep(kWireframeWidth - 0.5, kWireframeWidth + 0.5, distance); // One pixel of anti-aliasing
+    return mix(color, vec3(0.02), coverage * 0.8);
+}
+
+// Modes outside color_mode_mask (a specialization constant) are folded away with their branch, so a variant for
+// the attribute modes carries no lighting loop and the lit variant no attribute encoders
+bool mode_enabled(int mode) { return (color_mode_mask & (1 << mode)) != 0; }
+
+// Final surface color for a draw's tint and color mode; uv_gradients holds d(uv)/dx and d(uv)/dy
+vec3 shade_surface(vec4 color, int color_mode, vec3 world_position, vec3 normal, vec2 uv, float occlusion,
+                   int texture_slot, vec4 uv_gradients)
+{
+    vec3 final_color = color.rgb; // Default color uses provided material tint
+    if (color_mode == 0)
+    {
+        return material_albedo(color.rgb, texture_slot, uv, uv_gradients); // Textured objects show their diffuse map
+    }
+
+    if (mode_enabled(1) && color_mode == 1)
+    {
+        final_color = encode_position(world_position);
+    }
+    else if (mode_enabled(2) && color_mode == 2)
+    {
+        final_color = encode_normal(normal);
+    }
+    else if (mode_enabled(3) && color_mode == 3)
+    {
+        final_color = encode_uv(uv);
+    }
+    else if (mode_enabled(4) && color_mode == 4)
+    {
+        vec3 position_color = encode_position(world_position); // World position visualization
+        vec3 normal_color = encode_normal(normal); // Surface normal visualization
+        final_color = mix(position_color, normal_color, 0.5); // Blend both sources equally
+    }
+    else if (mode_enabled(5) && color_mode == 5)
+    {
+        return shade_lit(material_albedo(color.rgb, texture_slot, uv, uv_gradients), world_position, normal, occlusion); // No attribute blend
+    }
+    else if (mode_enabled(6) && color_mode == 6)
+    {
+        return mix(vec3(1.0), color.rgb, 0.35) * occlusion; // Light tint keeps objects apart without hiding the bake
+    }
+
+    if (color_mode != 0)
+    {
+        final_color = mix(final_color, color.rgb, 0.35); // Blend attribute visualization with base tint
+    }
+    return final_color;
+}
+)";
+
+// Vertex shader pulling vertices from the geometry pool and generating varyings for fragment stage
+const char *const vertex_shader_source = R"(
+// The only vertex attribute: per-draw record index, advanced by the base instance of each draw
+layout(location = 0) in uint draw_id;
+
+// Camera transform shared by every draw
+layout(location = 0) uniform mat4 view_projection;
+
+invariant gl_Position; // Must match the depth pre-pass exactly for the GL_EQUAL color pass
+
+// Varyings forwarded to fragment shader (explicit locations: SPIR-V stages are matched by location, not name)
+layout(location = 0) out vec3 vWorldPosition;
+layout(location = 1) out vec3 vNormal;
+layout(location = 2) out vec2 vTexCoord;
+layout(location = 3) out float vOcclusion;
+layout(location = 4) flat out vec4 vColor;
+layout(location = 5) flat out int vColorMode;
+layout(location = 6) flat out int vTextureSlot;
+layout(location = 7) flat out uint vDrawId;
+
+void main()
+{
+    vec3 position;
+    vec3 normal;
+    vec2 texcoord;
+    fetch_vertex(draw_id, uint(gl_VertexID), position, normal, texcoord); // gl_VertexID is the mesh-local index
+
+    vec4 world_position = draws[draw_id].model * vec4(position, 1.0); // Transform vertex into world space
+    vWorldPosition = world_position.xyz; // Preserve world-space position for color encoding
+    vNormal = normalize(mat3(draws[draw_id].normal_matrix) * normal); // Transform normal to world space
+    vTexCoord = texcoord; // Pass UV straight through
+    vOcclusion = fetch_occlusion(draw_id, uint(gl_VertexID)); // Interpolated like any other attribute
+    vColor = draws[draw_id].color; // Per-draw tint
+    vColorMode = draws[draw_id].color_mode; // Per-draw color source
+    vTextureSlot = draws[draw_id].texture_slot; // Per-draw diffuse texture
+    vDrawId = draw_id; // Record index for the visibility buffer
+    gl_Position = view_projection * world_position; // Project into clip space
+}
+)";
+
+// Fragment shader selecting color source
+const char *const fragment_shader_source = R"(
+layout(location = 0) out vec4 FragColor;
+
+layout(location = 0) in vec3 vWorldPosition;
+layout(location = 1) in vec3 vNormal;
+layout(location = 2) in vec2 vTexCoord;
+layout(location = 3) in float vOcclusion;
+
+// Per-draw values forwarded from the draw record
+layout(location = 4) flat in vec4 vColor;
+layout(location = 5) flat in int vColorMode;
+layout(location = 6) flat in int vTextureSlot;
+
+void main()
+{
+    vec4 uv_gradients = vec4(dFdx(vTexCoord), dFdy(vTexCoord)); // Uniform control flow: before any per-mode branch
+    FragColor = vec4(shade_surface(vColor, vColorMode, vWorldPosition, vNormal, vTexCoord, vOcclusion,
+                                   vTextureSlot, uv_gradients), vColor.a); // Output RGBA color for framebuffer
+}
+)";
+
+// Wireframe geometry stage: passes the triangle through and adds each corner's distance to the opposite edge in pixels.
+// Interpolated without perspective, the smallest component is the pixel's distance to the nearest edge, so lines cost no
+// extra draw and keep a constant width. Indexed and instanced draws work alike: the stage sees assembled triangles.
+const char *const wireframe_geometry_source = R"(
+layout(triangles) in;
+layout(triangle_strip, max_vertices = 3) out;
+
+layout(location = 9) uniform vec2 viewport_size; // Render area in pixels
+
+invariant gl_Position; // Copied unchanged: the depth pre-pass still matches with GL_EQUAL
+
+layout(location = 0) in vec3 vWorldPosition[];
+layout(location = 1) in vec3 vNormal[];
+layout(location = 2) in vec2 vTexCoord[];
+layout(location = 3) in float vOcclusion[];
+layout(location = 4) flat in vec4 vColor[];
+layout(location = 5) flat in int vColorMode[];
+layout(location = 6) flat in int vTextureSlot[];
+layout(location = 7) flat in uint vDrawId[];
+
+// Same locations as the forward fragment inputs (stages match by location)
+layout(location = 0) out vec3 gWorldPosition;
+layout(location = 1) out vec3 gNormal;
+layout(location = 2) out vec2 gTexCoord;
+layout(location = 3) out float gOcclusion;
+layout(location = 4) flat out vec4 gColor;
+layout(location = 5) flat out int gColorMode;
+layout(location = 6) flat out int gTextureSlot;
+layout(location = 8) noperspective out vec3 gEdgeDistance;
+
+void main()
+{
+    vec3 heights = vec3(1e6); // Far from any edge: ground, and triangles crossing the camera plane
+    bool in_front = gl_in[0].gl_Position.w > 0.0 && gl_in[1].gl_Position.w > 0.0 && gl_in[2].gl_Position.w > 0.0;
+    bool wire = (draws[vDrawId[0]].flags & kDrawWireframe) != 0u && in_front;
+    if (wire)
+    {
+        vec2 p0 = gl_in[0].gl_Position.xy / gl_in[0].gl_Position.w * 0.5 * viewport_size;
+        vec2 p1 = gl_in[1].gl_Position.xy / gl_in[1].gl_Position.w * 0.5 * viewport_size;
+        vec2 p2 = gl_in[2].gl_Position.xy / gl_in[2].gl_Position.w * 0.5 * viewport_size;
+        vec2 edge1 = p1 - p0;
+        vec2 edge2 = p2 - p0;
+        float twice_area = abs(edge1.x * edge2.y - edge1.y * edge2.x);
+        heights = twice_area / max(vec3(length(p2 - p1), length(edge2), length(edge1)), vec3(1e-6));
+    }
+
+    for (int corner = 0; corner < 3; ++corner)
+    {
+        gl_Position = gl_in[corner].gl_Position;
+        gWorldPosition = vWorldPosition[corner];
+        gNormal = vNormal[corner];
+        gTexCoord = vTexCoord[corner];
+        gOcclusion = vOcclusion[corner];
+        gColor = vColor[corner];
+        gColorMode = vColorMode[corner];
+        gTextureSlot = vTextureSlot[corner];
+        gEdgeDistance = wire ? heights * vec3(corner == 0, corner == 1, corner == 2) : heights; // 0 on the two adjacent edges
+        EmitVertex();
+    }
+    EndPrimitive();
+}
+)";
+
+// Forward fragment shader with the wireframe overlay
+const char *const wireframe_fragment_source = R"(
+layout(location = 0) out vec4 FragColor;
+
+layout(location = 0) in vec3 vWorldPosition;
+layout(location = 1) in vec3 vNormal;
+layout(location = 2) in vec2 vTexCoord;
+layout(location = 3) in float vOcclusion;
+layout(location = 4) flat in vec4 vColor;
+layout(location = 5) flat in int vColorMode;
+layout(location = 6) flat in int vTextureSlot;
+layout(location = 8) noperspective in vec3 vEdgeDistance; // Pixels to each edge of the triangle
+
+void main()
+{
+    vec4 uv_gradients = vec4(dFdx(vTexCoord), dFdy(vTexCoord));
+    vec3 color = shade_surface(vColor, vColorMode, vWorldPosition, vNormal, vTexCoord, vOcclusion, vTextureSlot, uv_gradients);
+    FragColor = vec4(apply_wireframe(color, vEdgeDistance), vColor.a);
+}
+)";
+
+// Visibility fragment shader: no shading, only the id of the nearest triangle survives the depth test
+const char *const visibility_fragment_source = R"(
+layout(location = 0) out uint visibility_id;
+
+layout(location = 7) flat in uint vDrawId;
+
+layout(location = 1) uniform uint triangle_bits; // Low bits hold the triangle, high bits the draw record
+
+void main()
+{
+    visibility_id = (vDrawId << triangle_bits) | uint(gl_PrimitiveID); // gl_PrimitiveID restarts for every draw of the multi-draw
+}
+)";
+
+// Depth pre-pass: position-only stream, same transform as the main vertex shader, no fragment stage
+const char *const depth_prepass_vertex_source = R"(
+layout(location = 0) in uint draw_id;
+
+layout(location = 0) uniform mat4 view_projection;
+
+invariant gl_Position;
+
+void main()
+{
+    vec4 world_position = draws[draw_id].model * vec4(fetch_position(draw_id, uint(gl_VertexID)), 1.0);
+    gl_Position = view_projection * world_position;
+}
+)";
+
+// Point clouds: one vertex per point, pulled from the node pages; each page draw carries the cloud placement and the
+// spacing of the level it is drawn at, which sets the point size (see PointCloudSelection)
+const char *const point_vertex_source = R"(
+struct Point // PointCloudPoint in point_cloud.h
+{
+    vec3 position; // Cloud coordinates
+    uint color; // RGBA8
+};
+
+layout(location = 0) in uint draw_id; // Page draw (base instance of the multi-draw)
+
+layout(std430, binding = 11) readonly buffer PointPages { Point points[]; };
+layout(std430, binding = 12) readonly buffer PointDraws { vec4 point_draws[]; }; // xyz: cloud translation, w: point spacing
+
+layout(location = 0) uniform mat4 view_projection;
+layout(location = 1) uniform float point_scale; // World size at distance 1 to pixels
+
+layout(location = 0) flat out vec4 vColor;
+
+void main()
+{
+    Point point = points[gl_VertexID]; // DrawArrays: first + vertex, i.e. the point's slot in the pages
+    vec4 draw = point_draws[draw_id];
+    gl_Position = view_projection * vec4(point.position + draw.xyz, 1.0);
+    gl_PointSize = clamp(draw.w * point_scale / max(gl_Position.w, 1e-4), 1.0, 16.0); // Spacing in pixels closes the gaps
+    vColor = unpackUnorm4x8(point.color);
+}
+)";
+
+const char *const point_fragment_source = R"(
+layout(location = 0) out vec4 FragColor;
+
+layout(location = 0) flat in vec4 vColor;
+
+void main()
+{
+    vec2 offset = gl_PointCoord * 2.0 - 1.0;
+    if (dot(offset, offset) > 1.0) discard; // Round splats instead of squares
+    FragColor = vec4(vColor.rgb, 1.0);
+}
+)";
+
+// Fullscreen triangle covering the viewport; no vertex data needed
+const char *const fullscreen_vertex_source = R"(
+void main()
+{
+    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+// FXAA (after Lottes' FXAA 3.11): find the dominant edge from luma, search its ends, blend across it
+const char *const fxaa_fragment_source = R"(
+layout(location = 0) out vec4 FragColor;
+
+layout(binding = 0) uniform sampler2D scene_color; // Bilinear, clamp to edge
+layout(location = 0) uniform vec2 texel_size; // 1 / texture size
+layout(location = 1) uniform vec2 uv_max; // Last texel center of the render area (the texture is larger when scaled)
+
+const float kEdgeThresholdMin = 0.0312; // Skip dark, low-contrast areas
+const float kEdgeThreshold = 0.125; // Local contrast needed to count as an edge
+const float kSubpixelQuality = 0.75; // Strength of the sub-pixel blend
+const int kSearchSteps = 10;
+const float kSearchStepSizes[kSearchSteps] = float[](1.0, 1.0, 1.0, 1.0, 1.0, 1.5, 2.0, 2.0, 4.0, 8.0);
+
+vec3 sample_color(vec2 uv) { return textureLod(scene_color, min(uv, uv_max), 0.0).rgb; }
+float luma(vec3 color) { return dot(color, vec3(0.299, 0.587, 0.114)); }
+float sample_luma(vec2 uv) { return luma(sample_color(uv)); }
+
+void main()
+{
+    vec2 uv = gl_FragCoord.xy * texel_size;
+    vec3 center_color = sample_color(uv);
+    float luma_center = luma(center_color);
+    float luma_down = sample_luma(uv + vec2(0.0, -texel_size.y));
+    float luma_up = sample_luma(uv + vec2(0.0, texel_size.y));
+    float luma_left = sample_luma(uv + vec2(-texel_size.x, 0.0));
+    float luma_right = sample_luma(uv + vec2(texel_size.x, 0.0));
+
+    float luma_min = min(luma_center, min(min(luma_down, luma_up), min(luma_left, luma_right)));
+    float luma_max = max(luma_center, max(max(luma_down, luma_up), max(luma_left, luma_right)));
+    float luma_range = luma_max - luma_min;
+    if (luma_range < max(kEdgeThresholdMin, luma_max * kEdgeThreshold))
+    {
+        FragColor = vec4(center_color, 1.0); // Not an edge
+        return;
+    }
+
+    float luma_down_left = sample_luma(uv - texel_size);
+    float luma_up_right = sample_luma(uv + texel_size);
+    float luma_up_left = sample_luma(uv + vec2(-texel_size.x, texel_size.y));
+    float luma_down_right = sample_luma(uv + vec2(texel_size.x, -texel_size.y));
+
+    float luma_down_up = luma_down + luma_up;
+    float luma_left_right = luma_left + luma_right;
+    float luma_left_corners = luma_down_left + luma_up_left;
+    float luma_down_corners = luma_down_left + luma_down_right;
+    float luma_right_corners = luma_down_right + luma_up_right;
+    float luma_up_corners = luma_up_right + luma_up_left;
+
+    // Second derivatives across both axes decide the edge orientation
+    float edge_horizontal = abs(-2.0 * luma_left + luma_left_corners) + 2.0 * abs(-2.0 * luma_center + luma_down_up) +
+                            abs(-2.0 * luma_right + luma_right_corners);
+    float edge_vertical = abs(-2.0 * luma_up + luma_up_corners) + 2.0 * abs(-2.0 * luma_center + luma_left_right) +
+                          abs(-2.0 * luma_down + luma_down_corners);
+    bool horizontal = edge_horizontal >= edge_vertical;
+
+    // Pick the side of the edge with the steeper gradient
+    float luma1 = horizontal ? luma_down : luma_left;
+    float luma2 = horizontal ? luma_up : luma_right;
+    float gradient1 = luma1 - luma_center;
+    float gradient2 = luma2 - luma_center;
+    bool steepest1 = abs(gradient1) >= abs(gradient2);
+    float gradient_scaled = 0.25 * max(abs(gradient1), abs(gradient2));
+    float step_length = horizontal ? texel_size.y : texel_size.x;
+    float luma_local_average = 0.5 * ((steepest1 ? luma1 : luma2) + luma_center);
+    if (steepest1) step_length = -step_length;
+
+    vec2 edge_uv = uv; // Half a pixel towards the edge
+    if (horizontal) edge_uv.y += 0.5 * step_length;
+    else edge_uv.x += 0.5 * step_length;
+
+    // Walk along the edge in both directions until the luma leaves the edge's average
+    vec2 offset = horizontal ? vec2(texel_size.x, 0.0) : vec2(0.0, texel_size.y);
+    vec2 uv1 = edge_uv - offset;
+    vec2 uv2 = edge_uv + offset;
+    float luma_end1 = sample_luma(uv1) - luma_local_average;
+    float luma_end2 = sample_luma(uv2) - luma_local_average;
+    bool reached1 = abs(luma_end1) >= gradient_scaled;
+    bool reached2 = abs(luma_end2) >= gradient_scaled;
+    for (int i = 1; i < kSearchSteps && !(reached1 && reached2); ++i)
+    {
+        if (!reached1)
+        {
+            uv1 -= offset * kSearchStepSizes[i];
+            luma_end1 = sample_luma(uv1) - luma_local_average;
+            reached1 = abs(luma_end1) >= gradient_scaled;
+        }
+        if (!reached2)
+        {
+            uv2 += offset * kSearchStepSizes[i];
+            luma_end2 = sample_luma(uv2) - luma_local_average;
+            reached2 = abs(luma_end2) >= gradient_scaled;
+        }
+    }
+
+    // Offset towards the nearer end, only if the luma variation there matches the center
+    float distance1 = horizontal ? uv.x - uv1.x : uv.y - uv1.y;
+    float distance2 = horizontal ? uv2.x - uv.x : uv2.y - uv.y;
+    bool direction1 = distance1 < distance2;
+    float pixel_offset = 0.5 - min(distance1, distance2) / (distance1 + distance2);
+    bool center_smaller = luma_center < luma_local_average;
+    bool correct_variation = ((direction1 ? luma_end1 : luma_end2) < 0.0) != center_smaller;
+    float final_offset = correct_variation ? pixel_offset : 0.0;
+
+    // Sub-pixel aliasing: thin features get blended by their contrast against the 3x3 average
+    float luma_average = (2.0 * (luma_down_up + luma_left_right) + luma_left_corners + luma_right_corners) / 12.0;
+    float subpixel = clamp(abs(luma_average - luma_center) / luma_range, 0.0, 1.0);
+    subpixel = (-2.0 * subpixel + 3.0) * subpixel * subpixel;
+    final_offset = max(final_offset, subpixel * subpixel * kSubpixelQuality);
+
+    vec2 final_uv = uv;
+    if (horizontal) final_uv.y += final_offset * step_length;
+    else final_uv.x += final_offset * step_length;
+    FragColor = vec4(sample_color(final_uv), 1.0);
+}
+)";
+
+// Resolve: decode the id, refetch the triangle from the pools, interpolate and shade once per pixel
+const char *const resolve_fragment_source = R"(
+layout(location = 0) out vec4 FragColor;
+
+layout(binding = 0) uniform usampler2D visibility_ids;
+layout(binding = 1) uniform sampler2D visibility_depth;
+layout(std430, binding = 6) readonly buffer FrameFirstIndex { uint frame_first_index[]; };
+
+layout(location = 8) uniform mat4 inverse_view_projection; // Unprojects pixels into world-space rays
+layout(location = 9) uniform vec2 viewport_size; // Target size in pixels
+layout(location = 1) uniform uint triangle_bits; // Must match the id pass
+layout(location = 10) uniform int wireframe; // Overlay edges on draws flagged kDrawWireframe
+
+// Perspective-correct barycentrics from the ray through a window position hitting the triangle plane
+// (robust when a corner is behind the camera)
+vec3 ray_barycentrics(vec2 window_position, vec3 world[3])
+{
+    vec2 ndc = window_position / viewport_size * 2.0 - 1.0;
+    vec4 near_point = inverse_view_projection * vec4(ndc, -1.0, 1.0);
+    vec4 far_point = inverse_view_projection * vec4(ndc, 1.0, 1.0);
+    vec3 origin = near_point.xyz / near_point.w;
+    vec3 direction = far_point.xyz / far_point.w - origin;
+
+    vec3 edge1 = world[1] - world[0];
+    vec3 edge2 = world[2] - world[0];
+    vec3 p = cross(direction, edge2);
+    float determinant = dot(edge1, p);
+    float inverse_determinant = abs(determinant) > 1e-20 ? 1.0 / determinant : 0.0;
+    vec3 t = origin - world[0];
+    float b1 = dot(t, p) * inverse_determinant;
+    float b2 = dot(direction, cross(t, edge1)) * inverse_determinant;
+    return vec3(1.0 - b1 - b2, b1, b2);
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    uint id = texelFetch(visibility_ids, pixel, 0).r;
+    if (id == 0xFFFFFFFFu) discard; // Background keeps the clear color
+
+    uint record = id >> triangle_bits;
+    uint triangle = id & ((1u << triangle_bits) - 1u);
+    uint first = frame_first_index[record] + triangle * 3u; // LOD range the record was drawn with this frame
+
+    vec3 world[3];
+    vec3 normals[3];
+    vec2 uvs[3];
+    vec3 occlusions;
+    for (int corner = 0; corner < 3; ++corner)
+    {
+        vec3 position;
+        uint vertex = pool_indices[first + uint(corner)];
+        fetch_vertex(record, vertex, position, normals[corner], uvs[corner]);
+        occlusions[corner] = fetch_occlusion(record, vertex);
+        world[corner] = (draws[record].model * vec4(position, 1.0)).xyz;
+    }
+
+    vec3 barycentric = ray_barycentrics(gl_FragCoord.xy, world);
+
+    vec3 world_position = barycentric.x * world[0] + barycentric.y * world[1] + barycentric.z * world[2];
+    vec3 normal = normalize(mat3(draws[record].normal_matrix) *
+                            (barycentric.x * normals[0] + barycentric.y * normals[1] + barycentric.z * normals[2]));
+    vec2 uv = barycentric.x * uvs[0] + barycentric.y * uvs[1] + barycentric.z * uvs[2];
+    float occlusion = dot(barycentric, occlusions);
+    vec4 uv_gradients = vec4(0.0); // Analytic: screen-space derivatives would mix triangles at their edges
+    bool wire = wireframe != 0 && (draws[record].flags & kDrawWireframe) != 0u;
+    vec3 dx = vec3(0.0);
+    vec3 dy = vec3(0.0);
+    if (draws[record].texture_slot >= 0 || wire)
+    {
+        dx = ray_barycentrics(gl_FragCoord.xy + vec2(1.0, 0.0), world) - barycentric;
+        dy = ray_barycentrics(gl_FragCoord.xy + vec2(0.0, 1.0), world) - barycentric;
+        uv_gradients = vec4(dx.x * uvs[0] + dx.y * uvs[1] + dx.z * uvs[2], dy.x * uvs[0] + dy.y * uvs[1] + dy.z * uvs[2]);
+    }
+
+    vec4 color = draws[record].color;
+    vec3 shaded = shade_surface(color, draws[record].color_mode, world_position, normal, uv, occlusion,
+                                draws[record].texture_slot, uv_gradients);
+    if (wire) // The barycentrics are already here: a barycentric over its screen gradient is the distance to that edge
+    {
+        vec3 gradient = sqrt(dx * dx + dy * dy);
+        shaded = apply_wireframe(shaded, barycentric / max(gradient, vec3(1e-8)));
+    }
+    FragColor = vec4(shaded, color.a);
+    gl_FragDepth = texelFetch(visibility_depth, pixel, 0).r; // Later passes (ground outline) depth-test against the scene
+}
+)";
+
+// Compute shader: one invocation per cull object; frustum test, LOD pick, command write
+const char *const cull_shader_source = R"(
+layout(local_size_x = 64) in;
+
+// Layouts mirror View::CullObject and DrawElementsIndirectCommand
+struct CullObject
+{
+    vec4 sphere;
+    uvec4 lod_first_index;
+    uvec4 lod_index_count;
+    uint record_index;
+    uint lod_count;
+    uint padding0;
+    uint padding1;
+};
+
+struct DrawCommand
+{
+    uint count;
+    uint instance_count;
+    uint first_index;
+    int base_vertex;
+    uint base_instance;
+};
+
+layout(std430, binding = 3) readonly buffer CullObjects { CullObject objects[]; };
+layout(std430, binding = 4) writeonly buffer DrawCommands { DrawCommand commands[]; };
+layout(std430, binding = 5) buffer DrawCount { uint draw_count; };
+layout(std430, binding = 6) writeonly buffer FrameFirstIndex { uint frame_first_index[]; };
+
+layout(location = 0) uniform vec4 frustum_planes[6]; // Normalized planes, inside is positive (locations 0-5)
+layout(location = 6) uniform vec3 camera_position; // World-space eye for distance-based LOD
+layout(location = 7) uniform float lod_projection_scale; // radius / distance * scale = projected radius in pixels
+layout(location = 8) uniform vec3 lod_thresholds; // Pixel radii below which LOD 1, 2, 3 are used
+layout(location = 9) uniform uint object_count; // Number of valid entries in objects[]
+layout(location = 10) uniform bool compact_output; // true: append visible commands + count; false: one slot per object
+
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= object_count) return;
+
+    vec4 sphere = objects[index].sphere;
+    bool visible = true;
+    for (int plane = 0; plane < 6; ++plane)
+    {
+        if (dot(frustum_planes[plane].xyz, sphere.xyz) + frustum_planes[plane].w < -sphere.w)
+        {
+            visible = false; // Entirely outside one plane
+            break;
+        }
+    }
+
+    uint lod = 0u;
+    float distance = length(sphere.xyz - camera_position);
+    if (distance > sphere.w) // Camera inside the bounds always gets full detail
+    {
+        float pixels = sphere.w / distance * lod_projection_scale;
+        lod = uint(pixels < lod_thresholds.x) + uint(pixels < lod_thresholds.y) + uint(pixels < lod_thresholds.z);
+    }
+    lod = min(lod, objects[index].lod_count - 1u);
+
+    DrawCommand command;
+    command.count = objects[index].lod_index_count[lod];
+    command.instance_count = 1u;
+    command.first_index = objects[index].lod_first_index[lod];
+    command.base_vertex = 0;
+    command.base_instance = objects[index].record_index;
+    frame_first_index[command.base_instance] = command.first_index; // Lets the visibility resolve find the drawn triangles
+
+    if (compact_output)
+    {
+        if (!visible) return;
+        commands[atomicAdd(draw_count, 1u)] = command; // Order is irrelevant with depth testing
+    }
+    else
+    {
+        command.instance_count = visible ? 1u : 0u; // Fallback: culled slots become empty draws
+        commands[index] = command;
+    }
+}
+)";
+}
+
+const char *const kSpecializationSource = "// specialization constants\n";
+
+std::string specialization_source(const bool spirv, const std::uint32_t color_mode_mask)
+{
+    if (spirv) return "layout(constant_id = " + std::to_string(kColorModeMaskConstantId) + ") const int color_mode_mask = " +
+                      std::to_string(kAllColorModes) + ";\n"; // Value chosen by glSpecializeShader at load time
+    return "const int color_mode_mask = " + std::to_string(color_mode_mask) + ";\n";
+}
+
+std::span<const ShaderSnippet> shader_snippets()
+{
+    static const std::array<ShaderSnippet, 15> snippets{{
+        {"draw_record", draw_record_source},
+        {"lighting", lighting_source},
+        {"shading", shading_source},
+        {"forward_vertex", vertex_shader_source},
+        {"forward_fragment", fragment_shader_source},
+        {"wireframe_geometry", wireframe_geometry_source},
+        {"wireframe_fragment", wireframe_fragment_source},
+        {"visibility_fragment", visibility_fragment_source},
+        {"depth_prepass_vertex", depth_prepass_vertex_source},
+        {"point_vertex", point_vertex_source},
+        {"point_fragment", point_fragment_source},
+        {"fullscreen_vertex", fullscreen_vertex_source},
+        {"fxaa_fragment", fxaa_fragment_source},
+        {"resolve_fragment", resolve_fragment_source},
+        {"cull_compute", cull_shader_source}}};
+    return snippets;
+}
+
+const char *shader_snippet_name(const char *source)
+{
+    for (const ShaderSnippet &snippet : shader_snippets())
+    {
+        if (snippet.source == source) return snippet.name;
+    }
+    return nullptr;
+}
+
+const ShaderProgramSource &shader_program_source(const ShaderProgramId program)
+{
+    static const std::array<ShaderProgramSource, static_cast<std::size_t>(ShaderProgramId::Count)> programs{{
+        {"forward", "forward",
+         {{ShaderStageKind::Vertex, {shader_version_source, draw_record_source, vertex_shader_source}},
+          {ShaderStageKind::Fragment, {shader_version_source, kSpecializationSource, lighting_source, shading_source, fragment_shader_source}}}},
+        {"visibility", "visibility",
+         {{ShaderStageKind::Vertex, {shader_version_source, draw_record_source, vertex_shader_source}},
+          {ShaderStageKind::Fragment, {shader_version_source, visibility_fragment_source}}}},
+        {"depth_prepass", "depth pre-pass", // No fragment shader: depth writes only
+         {{ShaderStageKind::Vertex, {shader_version_source, draw_record_source, depth_prepass_vertex_source}}}},
+        {"resolve", "visibility resolve",
+         {{ShaderStageKind::Vertex, {shader_version_source, fullscreen_vertex_source}},
+          {ShaderStageKind::Fragment, {shader_version_source, kSpecializationSource, draw_record_source, lighting_source, shading_source,
+                                       resolve_fragment_source}}}},
+        {"fxaa", "FXAA",
+         {{ShaderStageKind::Vertex, {shader_version_source, fullscreen_vertex_source}},
+          {ShaderStageKind::Fragment, {shader_version_source, fxaa_fragment_source}}}},
+        {"cull", "cull",
+         {{ShaderStageKind::Compute, {shader_version_source, cull_shader_source}}}},
+        {"wireframe", "wireframe",
+         {{ShaderStageKind::Vertex, {shader_version_source, draw_record_source, vertex_shader_source}},
+          {ShaderStageKind::Geometry, {shader_version_source, draw_record_source, wireframe_geometry_source}},
+          {ShaderStageKind::Fragment, {shader_version_source, kSpecializationSource, lighting_source, shading_source,
+                                       wireframe_fragment_source}}}},
+        {"points", "point cloud",
+         {{ShaderStageKind::Vertex, {shader_version_source, point_vertex_source}},
+          {ShaderStageKind::Fragment, {shader_version_source, point_fragment_source}}}}}};
+    return programs[static_cast<std::size_t>(program)];
+}
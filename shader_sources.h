@@ -0,0 +1,101 @@
+#ifndef SHADER_SOURCES_H // Guard against multiple inclusion
+#define SHADER_SOURCES_H // Begin include guard
+
+#include <cstddef> // Program and stage indices
+#include <cstdint> // SPIR-V words and specialization values
+#include <map> // Hot-reloaded snippet texts by name
+#include <span> // Non-owning view over an embedded module
+#include <string> // Generated specialization declarations
+#include <vector> // Snippet and stage lists
+
+// GLSL of every program, shared by the runtime compiler (View::begin_program) and the build-time SPIR-V compiler
+// (spirv_embed). Free of Qt and GL headers so the build tool links without them.
+
+enum class ShaderStageKind : int // Pipeline stage of one shader (mapped to GL_*_SHADER by the view)
+{
+    Vertex = 0,
+    Fragment = 1,
+    Compute = 2,
+    Geometry = 3
+};
+
+enum class ShaderProgramId : std::size_t // Programs built by the view; also the index of their embedded modules
+{
+    Forward = 0, // Pulling vertex shader + color-mode shading
+    Visibility = 1, // Pulling vertex shader + packed triangle ids
+    DepthPrepass = 2, // Position-only vertex shader, no fragment stage
+    Resolve = 3, // Fullscreen triangle + visibility buffer shading
+    Fxaa = 4, // Fullscreen triangle + FXAA
+    Cull = 5, // Frustum cull, LOD pick, command write
+    Wireframe = 6, // Forward program + a geometry stage adding edge distances (wireframe over shaded)
+    Points = 7, // Point cloud pages pulled by gl_VertexID, drawn as round GL_POINTS
+    Count = 8
+};
+
+struct ShaderStageSource // Snippets of one stage, concatenated in order
+{
+    ShaderStageKind kind = ShaderStageKind::Vertex;
+    std::vector<const char*> sources; // kSpecializationSource marks where the specialization constants are declared
+};
+
+struct ShaderProgramSource // Stages of one program
+{
+    const char *name = ""; // File stem of the build-time modules ("forward", "cull", ...)
+    const char *label = ""; // Name used in log messages
+    std::vector<ShaderStageSource> stages;
+};
+
+[[nodiscard]] const ShaderProgramSource &shader_program_source(ShaderProgramId program);
+
+struct ShaderSnippet // Named snippet; the name is also the file stem used by shader hot reload
+{
+    const char *name = "";
+    const char *source = "";
+};
+
+[[nodiscard]] std::span<const ShaderSnippet> shader_snippets(); // Every snippet except the version line and the placeholder
+[[nodiscard]] const char *shader_snippet_name(const char *source); // Name of a snippet pointer, nullptr if it has none
+
+using ShaderOverrides = std::map<std::string, std::string>; // Snippet name to replacement text (edited files)
+
+extern const char *const kSpecializationSource; // Placeholder snippet, replaced by specialization_source()
+
+// Specialization constant selecting the ColorMode branches compiled into shade_surface (bit n: ColorMode n may occur)
+constexpr std::uint32_t kColorModeMaskConstantId = 0; // constant_id of color_mode_mask
+constexpr std::uint32_t kAllColorModes = 0x7F; // Default: every mode of View::ColorMode
+
+constexpr std::uint32_t kDrawWireframe = 1; // DrawRecord::flags bit: the draw gets the wireframe overlay (imported meshes)
+
+// Declaration of the specialization constants: constant_id layouts (default values) for SPIR-V, plain constants with the
+// given values for the driver's GLSL compiler, where the value is fixed per compile.
+[[nodiscard]] std::string specialization_source(bool spirv, std::uint32_t color_mode_mask);
+
+// Explicit uniform locations. SPIR-V modules carry no names the driver must resolve, so the view falls back to these.
+// The forward and resolve programs share the lighting block, so its locations are unique within both.
+constexpr int kViewProjectionLocation = 0; // Pulling vertex shaders
+constexpr int kTriangleBitsLocation = 1; // Visibility id pass and resolve
+constexpr int kLightViewLocation = 2; // Lighting block
+constexpr int kClusterViewportSizeLocation = 3;
+constexpr int kClusterDepthScaleBiasLocation = 4;
+constexpr int kLightEyeLocation = 5;
+constexpr int kShadowMatrixLocation = 6;
+constexpr int kShadowsEnabledLocation = 7;
+constexpr int kInverseViewProjectionLocation = 8; // Resolve
+constexpr int kViewportSizeLocation = 9; // Also the wireframe geometry stage
+constexpr int kWireframeLocation = 10; // Resolve
+constexpr int kPointScaleLocation = 1; // Points (with kViewProjectionLocation)
+constexpr int kTexelSizeLocation = 0; // FXAA
+constexpr int kUvMaxLocation = 1;
+constexpr int kFrustumPlanesLocation = 0; // Cull (six consecutive locations)
+constexpr int kCameraPositionLocation = 6;
+constexpr int kLodProjectionScaleLocation = 7;
+constexpr int kLodThresholdsLocation = 8;
+constexpr int kObjectCountLocation = 9;
+constexpr int kCompactOutputLocation = 10;
+
+// SPIR-V module of one stage, compiled from the sources above at build time (defined in the generated
+// embedded_spirv.cpp). Empty when the build had no glslangValidator; the view then compiles the GLSL.
+[[nodiscard]] std::span<const std::uint32_t> embedded_spirv(ShaderProgramId program, std::size_t stage);
+
+
+#endif //SHADER_SOURCES_H // End include guard
@@ -0,0 +1,374 @@
+#include "skeletal_animation.h"
+
+#include "frame_jobs.h"
+
+#include <QDebug>
+
+#include <assimp/anim.h>
+#include <assimp/mesh.h>
+#include <assimp/scene.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SKELETAL_ANIMATION_SSE2 1 // Quaternion blends and joint products four lanes at a time
+#endif
+
+namespace // Anonymous namespace holding the Assimp conversion and the pose math
+{
+constexpr std::size_t kMinInstancesPerJob = 8; // A rig of a few dozen joints is cheap; smaller jobs cost more to schedule
+constexpr int kRadiusSamplesPerClip = 16; // Poses sampled per clip when bounding the animated mesh
+constexpr double kDefaultTicksPerSecond = 25.0; // Assimp reports 0 when the file does not say
+
+glm::mat4 to_mat4(const aiMatrix4x4 &matrix)
+{
+    return glm::transpose(glm::make_mat4(&matrix.a1)); // Assimp stores rows, GLM columns
+}
+
+glm::vec3 to_vec3(const aiVector3D &vector)
+{
+    return {vector.x, vector.y, vector.z};
+}
+
+glm::quat to_quat(const aiQuaternion &quaternion)
+{
+    return {quaternion.w, quaternion.x, quaternion.y, quaternion.z};
+}
+
+glm::mat4 compose(const glm::vec3 &translation, const glm::quat &rotation, const glm::vec3 &scale)
+{
+    const glm::mat3 basis = glm::mat3_cast(rotation);
+    glm::mat4 matrix(1.0f);
+    matrix[0] = glm::vec4(basis[0] * scale.x, 0.0f);
+    matrix[1] = glm::vec4(basis[1] * scale.y, 0.0f);
+    matrix[2] = glm::vec4(basis[2] * scale.z, 0.0f);
+    matrix[3] = glm::vec4(translation, 1.0f);
+    return matrix;
+}
+
+#ifdef SKELETAL_ANIMATION_SSE2
+__m128 dot4(const __m128 a, const __m128 b) // Dot product broadcast to every lane (SSE2 has no horizontal add)
+{
+    const __m128 products = _mm_mul_ps(a, b);
+    const __m128 pairs = _mm_add_ps(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_add_ps(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+#endif
+
+// Normalized lerp along the shorter arc; keys are close enough that it matches slerp to within the key error
+glm::quat blend_rotations(const glm::quat &a, const glm::quat &b, const float t)
+{
+#ifdef SKELETAL_ANIMATION_SSE2
+    const __m128 first = _mm_setr_ps(a.x, a.y, a.z, a.w);
+    __m128 second = _mm_setr_ps(b.x, b.y, b.z, b.w);
+    const __m128 flip = _mm_and_ps(_mm_cmplt_ps(dot4(first, second), _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+    second = _mm_xor_ps(second, flip); // q and -q are the same rotation; pick the one next to a
+    __m128 blended = _mm_add_ps(first, _mm_mul_ps(_mm_sub_ps(second, first), _mm_set1_ps(t)));
+    blended = _mm_div_ps(blended, _mm_sqrt_ps(dot4(blended, blended)));
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, blended);
+    return {lanes[3], lanes[0], lanes[1], lanes[2]};
+#else
+    const glm::quat second = glm::dot(a, b) < 0.0f ? -b : b;
+    return glm::normalize(a + (second - a) * t);
+#endif
+}
+
+glm::mat4 multiply(const glm::mat4 &a, const glm::mat4 &b)
+{
+#ifdef SKELETAL_ANIMATION_SSE2
+    const __m128 a0 = _mm_loadu_ps(glm::value_ptr(a));
+    const __m128 a1 = _mm_loadu_ps(glm::value_ptr(a) + 4);
+    const __m128 a2 = _mm_loadu_ps(glm::value_ptr(a) + 8);
+    const __m128 a3 = _mm_loadu_ps(glm::value_ptr(a) + 12);
+    glm::mat4 result;
+    for (int column(0); column < 4; column++) // Column of the result = a times the column of b
+    {
+        __m128 sum = _mm_mul_ps(a0, _mm_set1_ps(b[column][0]));
+        sum = _mm_add_ps(sum, _mm_mul_ps(a1, _mm_set1_ps(b[column][1])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(a2, _mm_set1_ps(b[column][2])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(a3, _mm_set1_ps(b[column][3])));
+        _mm_storeu_ps(glm::value_ptr(result) + 4 * column, sum);
+    }
+    return result;
+#else
+    return a * b;
+#endif
+}
+
+// Key interval containing time: index of its first key and the blend factor (clamped outside the keys)
+std::pair<std::size_t, float> key_interval(const std::vector<float> &times, const float time)
+{
+    if (times.size() < 2 || time <= times.front()) return {0, 0.0f};
+    if (time >= times.back()) return {times.size() - 1, 0.0f};
+    const auto next = static_cast<std::size_t>(std::ranges::upper_bound(times, time) - times.begin());
+    const float span = times[next] - times[next - 1];
+    return {next - 1, span > 0.0f ? (time - times[next - 1]) / span : 0.0f};
+}
+
+glm::vec3 sample_vector(const std::vector<float> &times, const std::vector<glm::vec3> &values, const float time, const glm::vec3 &rest)
+{
+    if (values.empty()) return rest;
+    const auto [key, t] = key_interval(times, time);
+    if (t == 0.0f) return values[key];
+    return glm::mix(values[key], values[key + 1], t);
+}
+
+glm::quat sample_rotation(const JointChannel &channel, const float time, const glm::quat &rest)
+{
+    if (channel.rotations.empty()) return rest;
+    const auto [key, t] = key_interval(channel.rotation_times, time);
+    if (t == 0.0f) return channel.rotations[key];
+    return blend_rotations(channel.rotations[key], channel.rotations[key + 1], t);
+}
+
+// Scene-space transform of every joint (globals), then the skin matrix of every bone
+void pose_skeleton(const SkinnedAsset &asset, const AnimationClip *clip, const float time, std::vector<glm::mat4> &globals, glm::mat4 *bones)
+{
+    globals.resize(asset.joints.size());
+    for (std::size_t joint(0); joint < asset.joints.size(); joint++)
+    {
+        const SkeletonJoint &rest = asset.joints[joint];
+        glm::mat4 local;
+        if (clip)
+        {
+            const JointChannel &channel = clip->channels[joint];
+            local = compose(sample_vector(channel.translation_times, channel.translations, time, rest.translation),
+                            sample_rotation(channel, time, rest.rotation),
+                            sample_vector(channel.scale_times, channel.scales, time, rest.scale));
+        }
+        else
+        {
+            local = compose(rest.translation, rest.rotation, rest.scale);
+        }
+        globals[joint] = rest.parent < 0 ? local : multiply(globals[static_cast<std::size_t>(rest.parent)], local);
+    }
+    for (std::size_t bone(0); bone < asset.bone_joints.size(); bone++)
+    {
+        bones[bone] = multiply(multiply(asset.mesh_from_scene, globals[static_cast<std::size_t>(asset.bone_joints[bone])]), asset.bone_offsets[bone]);
+    }
+}
+
+void flatten_nodes(const aiNode *node, const int parent, std::vector<SkeletonJoint> &joints, std::unordered_map<std::string, int> &names,
+                   std::vector<const aiNode*> &nodes)
+{
+    aiVector3D scale, position;
+    aiQuaternion rotation;
+    node->mTransformation.Decompose(scale, rotation, position);
+    const int index = static_cast<int>(joints.size());
+    joints.push_back({parent, to_vec3(position), to_quat(rotation), to_vec3(scale)});
+    nodes.push_back(node);
+    names.try_emplace(node->mName.C_Str(), index); // First node wins when names repeat
+    for (unsigned int child(0); child < node->mNumChildren; child++) flatten_nodes(node->mChildren[child], index, joints, names, nodes);
+}
+
+glm::mat4 global_rest_transform(const std::vector<SkeletonJoint> &joints, int joint)
+{
+    glm::mat4 transform(1.0f);
+    for (; joint >= 0; joint = joints[static_cast<std::size_t>(joint)].parent)
+    {
+        const SkeletonJoint &rest = joints[static_cast<std::size_t>(joint)];
+        transform = compose(rest.translation, rest.rotation, rest.scale) * transform;
+    }
+    return transform;
+}
+
+// Distance bound of the animated vertices: each bone's vertices lie in a bind-space sphere, which a pose moves and scales;
+// a blended vertex lies between its bones' images, so the farthest posed sphere bounds it (sampled poses only)
+float animated_radius(const SkinnedAsset &asset, const std::span<const MeshVertex> vertices, const std::span<const VertexSkin> skin)
+{
+    std::vector<glm::vec3> bone_min(asset.bone_joints.size(), glm::vec3(std::numeric_limits<float>::max()));
+    std::vector<glm::vec3> bone_max(asset.bone_joints.size(), glm::vec3(std::numeric_limits<float>::lowest()));
+    float rest_radius = 0.0f; // Vertices whose weights do not sum to 1 keep part of their rest position
+    for (std::size_t vertex(0); vertex < vertices.size(); vertex++)
+    {
+        const glm::vec3 &position = vertices[vertex].position;
+        float weight = 0.0f;
+        for (std::size_t lane(0); lane < 4; lane++)
+        {
+            if (skin[vertex].weights[lane] <= 0.0f) continue;
+            weight += skin[vertex].weights[lane];
+            bone_min[skin[vertex].bones[lane]] = glm::min(bone_min[skin[vertex].bones[lane]], position);
+            bone_max[skin[vertex].bones[lane]] = glm::max(bone_max[skin[vertex].bones[lane]], position);
+        }
+        if (weight < 0.999f) rest_radius = std::max(rest_radius, glm::length(position));
+    }
+
+    float radius = rest_radius;
+    std::vector<glm::mat4> globals;
+    std::vector<glm::mat4> bones(asset.bone_joints.size());
+    const auto measure = [&](const AnimationClip *clip, const float time)
+    {
+        pose_skeleton(asset, clip, time, globals, bones.data());
+        for (std::size_t bone(0); bone < bones.size(); bone++)
+        {
+            if (bone_min[bone].x > bone_max[bone].x) continue; // No vertex uses the bone
+            const glm::vec3 center = 0.5f * (bone_min[bone] + bone_max[bone]);
+            const float extent = 0.5f * glm::length(bone_max[bone] - bone_min[bone]);
+            const float scale = std::max({glm::length(glm::vec3(bones[bone][0])), glm::length(glm::vec3(bones[bone][1])),
+                                          glm::length(glm::vec3(bones[bone][2]))});
+            radius = std::max(radius, glm::length(glm::vec3(bones[bone] * glm::vec4(center, 1.0f))) + extent * scale);
+        }
+    };
+    measure(nullptr, 0.0f); // Rest pose
+    for (const AnimationClip &clip : asset.clips)
+    {
+        for (int sample(0); sample <= kRadiusSamplesPerClip; sample++) measure(&clip, clip.duration * static_cast<float>(sample) / kRadiusSamplesPerClip);
+    }
+    return radius;
+}
+}
+
+std::optional<SkinnedMeshImport> import_skinned_mesh(const aiScene &scene, const aiMesh &mesh, const glm::vec3 &recenter,
+                                                     const std::span<const MeshVertex> vertices)
+{
+    if (!mesh.HasBones() || !scene.mRootNode) return std::nullopt;
+    if (mesh.mNumBones > kMaxSkinBones)
+    {
+        qWarning() << "Mesh has" << mesh.mNumBones << "bones, more than" << kMaxSkinBones << "; importing it without animation";
+        return std::nullopt;
+    }
+
+    auto asset = std::make_shared<SkinnedAsset>();
+    std::unordered_map<std::string, int> names;
+    std::vector<const aiNode*> nodes;
+    flatten_nodes(scene.mRootNode, -1, asset->joints, names, nodes);
+
+    int mesh_node = 0; // The node instancing the mesh places it in the scene; skinning ends back in its space (root by default)
+    const auto mesh_index = static_cast<unsigned int>(std::find(scene.mMeshes, scene.mMeshes + scene.mNumMeshes, &mesh) - scene.mMeshes);
+    for (std::size_t node(0); node < nodes.size(); node++)
+    {
+        if (std::find(nodes[node]->mMeshes, nodes[node]->mMeshes + nodes[node]->mNumMeshes, mesh_index) == nodes[node]->mMeshes + nodes[node]->mNumMeshes) continue;
+        mesh_node = static_cast<int>(node);
+        break;
+    }
+    const glm::mat4 recentered_from_mesh = glm::translate(glm::mat4(1.0f), -recenter);
+    const glm::mat4 mesh_from_recentered = glm::translate(glm::mat4(1.0f), recenter);
+    asset->mesh_from_scene = recentered_from_mesh * glm::inverse(global_rest_transform(asset->joints, mesh_node));
+
+    SkinnedMeshImport result;
+    result.skin.resize(vertices.size());
+    for (VertexSkin &vertex : result.skin) vertex.weights = {0.0f, 0.0f, 0.0f, 0.0f}; // Unweighted vertices stay in their rest position
+    std::vector<std::uint8_t> influences(vertices.size(), 0);
+    asset->bone_joints.resize(mesh.mNumBones);
+    asset->bone_offsets.resize(mesh.mNumBones);
+    for (unsigned int bone(0); bone < mesh.mNumBones; bone++)
+    {
+        const aiBone *source = mesh.mBones[bone];
+        const auto joint = names.find(source->mName.C_Str());
+        if (joint == names.end())
+        {
+            qWarning() << "Bone" << source->mName.C_Str() << "has no node; importing the mesh without animation";
+            return std::nullopt;
+        }
+        asset->bone_joints[bone] = joint->second;
+        asset->bone_offsets[bone] = to_mat4(source->mOffsetMatrix) * mesh_from_recentered;
+
+        for (unsigned int weight(0); weight < source->mNumWeights; weight++)
+        {
+            const aiVertexWeight &influence = source->mWeights[weight];
+            if (influence.mVertexId >= vertices.size() || influence.mWeight <= 0.0f) continue;
+            VertexSkin &vertex = result.skin[influence.mVertexId];
+            std::uint8_t &count = influences[influence.mVertexId];
+            std::size_t lane = count;
+            if (count == 4) // aiProcess_LimitBoneWeights keeps four; replace the lightest if a file still has more
+            {
+                lane = static_cast<std::size_t>(std::ranges::min_element(vertex.weights) - vertex.weights.begin());
+                if (vertex.weights[lane] >= influence.mWeight) continue;
+            }
+            else count++;
+            vertex.bones[lane] = static_cast<std::uint8_t>(bone);
+            vertex.weights[lane] = influence.mWeight;
+        }
+    }
+    for (VertexSkin &vertex : result.skin)
+    {
+        const float total = std::accumulate(vertex.weights.begin(), vertex.weights.end(), 0.0f);
+        if (total > 0.0f) for (float &weight : vertex.weights) weight /= total;
+    }
+
+    for (unsigned int animation_index(0); animation_index < scene.mNumAnimations; animation_index++)
+    {
+        const aiAnimation *animation = scene.mAnimations[animation_index];
+        const double ticks_per_second = animation->mTicksPerSecond > 0.0 ? animation->mTicksPerSecond : kDefaultTicksPerSecond;
+        AnimationClip clip;
+        clip.name = animation->mName.C_Str();
+        clip.duration = static_cast<float>(animation->mDuration / ticks_per_second);
+        clip.channels.resize(asset->joints.size());
+        for (unsigned int channel_index(0); channel_index < animation->mNumChannels; channel_index++)
+        {
+            const aiNodeAnim *source = animation->mChannels[channel_index];
+            const auto joint = names.find(source->mNodeName.C_Str());
+            if (joint == names.end()) continue; // Animates a node of another mesh
+            JointChannel &channel = clip.channels[static_cast<std::size_t>(joint->second)];
+            for (unsigned int key(0); key < source->mNumPositionKeys; key++)
+            {
+                channel.translation_times.push_back(static_cast<float>(source->mPositionKeys[key].mTime / ticks_per_second));
+                channel.translations.push_back(to_vec3(source->mPositionKeys[key].mValue));
+            }
+            for (unsigned int key(0); key < source->mNumRotationKeys; key++)
+            {
+                channel.rotation_times.push_back(static_cast<float>(source->mRotationKeys[key].mTime / ticks_per_second));
+                channel.rotations.push_back(to_quat(source->mRotationKeys[key].mValue));
+            }
+            for (unsigned int key(0); key < source->mNumScalingKeys; key++)
+            {
+                channel.scale_times.push_back(static_cast<float>(source->mScalingKeys[key].mTime / ticks_per_second));
+                channel.scales.push_back(to_vec3(source->mScalingKeys[key].mValue));
+            }
+        }
+        asset->clips.push_back(std::move(clip));
+    }
+
+    asset->radius = animated_radius(*asset, vertices, result.skin);
+    result.asset = std::move(asset);
+    return result;
+}
+
+float animation_clip_time(const AnimationClip &clip, const std::uint64_t tick)
+{
+    if (clip.duration <= 0.0f) return 0.0f;
+    return static_cast<float>(std::fmod(static_cast<double>(tick) * kAnimationStepSeconds, static_cast<double>(clip.duration)));
+}
+
+void evaluate_animation_palette(const std::span<const AnimationInstance> instances, const std::uint64_t tick, std::vector<glm::mat4> &palette,
+                                AnimationStats &stats)
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::size_t> first_bones(instances.size()); // Palette offsets are fixed before the jobs start
+    std::size_t bone_count = 0;
+    for (std::size_t i(0); i < instances.size(); i++)
+    {
+        first_bones[i] = bone_count;
+        bone_count += instances[i].asset->bone_joints.size();
+    }
+    palette.resize(bone_count);
+
+    stats.jobs = frame_job_count(instances.size(), kMinInstancesPerJob);
+    run_frame_jobs(stats.jobs, instances.size(), [&](std::size_t, const std::size_t begin, const std::size_t end)
+    {
+        std::vector<glm::mat4> globals; // Joint transforms of one instance; reused by the job
+        for (std::size_t i = begin; i < end; i++)
+        {
+            const AnimationInstance &instance = instances[i];
+            const SkinnedAsset &asset = *instance.asset;
+            const bool playing = instance.clip >= 0 && static_cast<std::size_t>(instance.clip) < asset.clips.size();
+            const AnimationClip *clip = playing ? &asset.clips[static_cast<std::size_t>(instance.clip)] : nullptr;
+            const float time = clip ? animation_clip_time(*clip, tick + instance.tick_offset) : 0.0f;
+            pose_skeleton(asset, clip, time, globals, palette.data() + first_bones[i]);
+        }
+    });
+
+    stats.instances = instances.size();
+    stats.bones = bone_count;
+    stats.evaluate_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,100 @@
+#ifndef SKELETAL_ANIMATION_H // Guard against multiple inclusion
+#define SKELETAL_ANIMATION_H // Begin include guard
+
+#include "mesh_encoding.h" // VertexSkin, the per-vertex stream written at import
+
+#include <glm/glm.hpp> // Joint transforms and bone matrices
+#include <glm/gtc/quaternion.hpp> // Joint rotations
+
+#include <cstddef> // Counts
+#include <cstdint> // Clock ticks
+#include <memory> // Assets shared by their instances
+#include <optional> // Meshes without bones
+#include <span> // Instances of a frame, staged vertices
+#include <string> // Clip names
+#include <vector> // Joints, keys, palettes
+
+struct aiMesh; // Assimp types stay out of the header (only skeletal_animation.cpp parses them)
+struct aiScene;
+
+// Skeletal animation of rigged meshes. The importer reads the skeleton, the bind matrices and every clip once per file into a
+// SkinnedAsset that all instances of the mesh share, together with their pooled vertices. Each frame the instances are
+// posed on the frame jobs (keys blended with SSE quaternion nlerp, joints composed with SSE matrix products) into one
+// palette of bone matrices, which the view uploads to an SSBO; the pulling vertex shaders blend up to four bones per vertex.
+// Poses depend only on the integer clock tick, never on the job split or on accumulated time, so a fixed-step clock
+// replays bit-identical frames.
+
+constexpr std::size_t kMaxSkinBones = 256; // Bone indices are 8-bit lanes of the skin stream
+constexpr double kAnimationStepSeconds = 1.0 / 60.0; // Length of one clock tick
+
+struct SkeletonJoint // One node of the imported hierarchy (every node, so clips may animate joints that no vertex uses)
+{
+    int parent = -1; // Parents precede their children; -1 for the root
+    glm::vec3 translation{0.0f}; // Rest transform, used where a clip has no channel for the joint
+    glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 scale{1.0f};
+};
+
+struct JointChannel // Keys of one joint in one clip; each track may be empty (rest value) or hold a single key (constant)
+{
+    std::vector<float> translation_times; // Seconds, ascending
+    std::vector<glm::vec3> translations;
+    std::vector<float> rotation_times;
+    std::vector<glm::quat> rotations;
+    std::vector<float> scale_times;
+    std::vector<glm::vec3> scales;
+};
+
+struct AnimationClip
+{
+    std::string name;
+    float duration = 0.0f; // Seconds; playback loops
+    std::vector<JointChannel> channels; // One per joint
+};
+
+struct SkinnedAsset // Everything needed to pose one rigged mesh; immutable after import
+{
+    std::vector<SkeletonJoint> joints; // Parents first
+    std::vector<int> bone_joints; // Joint driving each skin bone (the bone index of the skin stream)
+    std::vector<glm::mat4> bone_offsets; // Per bone: recentered mesh space to the joint's space, in the bind pose
+    glm::mat4 mesh_from_scene{1.0f}; // Back from the scene space of the joints to the recentered mesh space
+    std::vector<AnimationClip> clips;
+    float radius = 1.0f; // Largest distance of a vertex from the mesh origin over sampled poses of every clip (picking, culling, shadows)
+};
+
+struct SkinnedMeshImport // Result of import_skinned_mesh
+{
+    std::shared_ptr<const SkinnedAsset> asset;
+    std::vector<VertexSkin> skin; // One entry per vertex of the mesh
+};
+
+// Skeleton, clips and skin weights of a mesh whose vertices were moved by -recenter (load_object puts the base on the
+// ground); std::nullopt when the mesh has no bones or more than kMaxSkinBones. vertices are the recentered staged vertices.
+[[nodiscard]] std::optional<SkinnedMeshImport> import_skinned_mesh(const aiScene &scene, const aiMesh &mesh, const glm::vec3 &recenter,
+                                                                   std::span<const MeshVertex> vertices);
+
+struct AnimationInstance // One posed copy of an asset in a frame
+{
+    const SkinnedAsset *asset = nullptr; // Owned by the scene; must outlive the evaluation
+    int clip = 0; // Played clip (no clip: rest pose)
+    std::uint64_t tick_offset = 0; // Added to the clock, so instances of one asset do not move in lockstep
+};
+
+struct AnimationStats // Last evaluation, shown by the HUD
+{
+    std::size_t instances = 0;
+    std::size_t bones = 0; // Matrices in the palette
+    std::size_t jobs = 1;
+    double evaluate_ms = 0.0;
+};
+
+// Local time in seconds of a clip after tick ticks (exact multiples of kAnimationStepSeconds, wrapped to the duration)
+[[nodiscard]] float animation_clip_time(const AnimationClip &clip, std::uint64_t tick);
+
+// Pose every instance at the clock tick into palette: each instance's bone matrices, back to back in instance order
+// (the first matrix of instance i is the sum of the bone counts before it)
+void evaluate_animation_palette(std::span<const AnimationInstance> instances, std::uint64_t tick, std::vector<glm::mat4> &palette,
+                                AnimationStats &stats);
+
+
+#endif //SKELETAL_ANIMATION_H // End include guard
@@ -0,0 +1,678 @@
+#include "software_rasterizer.h"
+
+#include "frame_jobs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFTWARE_RASTERIZER_SSE2 1 // Edge functions and depth test four pixels at a time
+#endif
+
+namespace // Anonymous namespace holding the edge setup and the color-mode shading
+{
+constexpr std::size_t kMinVerticesPerJob = 4096; // Below this a job costs more to schedule than to transform
+constexpr std::size_t kMinTrianglesPerJob = 2048; // Same for clipping and binning
+constexpr std::uint32_t kEmptyPixel = 0xFFFFFFFFu; // Triangle id of pixels no triangle covered
+constexpr std::uint32_t kNoCorners = 0xFFFFFFFFu; // SetupTriangle::corners of unclipped triangles
+constexpr int kLitColorMode = 5; // View::ColorMode::Lit (the only mode that needs the light clusters)
+constexpr float kWireframeWidth = 1.0f; // Half the line width in pixels (kWireframeWidth in shader_sources.cpp)
+const glm::vec3 kSunToLight = glm::normalize(glm::vec3(0.4f, 1.0f, 0.3f)); // Same sun as the lit shading
+const glm::vec3 kSunColor{0.75f, 0.72f, 0.66f};
+
+double elapsed_ms(const std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// frame_job_count, capped by the frame's max_jobs
+std::size_t frame_jobs_of(const SoftwareFrame &frame, const std::size_t items, const std::size_t min_items_per_job)
+{
+    const std::size_t jobs = frame_job_count(items, min_items_per_job);
+    return frame.max_jobs > 0 ? std::min(jobs, frame.max_jobs) : jobs;
+}
+
+// Edge functions E_i(x, y) = a_i * x + (b_i * y + c_i) of the edge opposite corner i, positive inside, with x and y relative
+// to an origin (the tile being rasterized). Evaluated in this order, the edge shared by two triangles gives exactly opposite
+// values in both, so no pixel is drawn twice or missed; the tile origin keeps the values small, so slivers near the horizon
+// do not lose their pixels to rounding.
+struct TriangleEdges
+{
+    std::array<float, 3> a{};
+    std::array<float, 3> b{};
+    std::array<float, 3> c{};
+    std::array<float, 3> threshold{}; // 0 where pixels on the edge belong to this triangle (top-left rule), FLT_MIN elsewhere
+    float inv_area = 0.0f; // 1 / (E_0 + E_1 + E_2)
+    float z = 0.0f; // Depth plane: depth at the origin and its slopes
+    float dz_dx = 0.0f;
+    float dz_dy = 0.0f;
+};
+
+TriangleEdges triangle_edges(const std::array<float, 3> &x, const std::array<float, 3> &y, const std::array<float, 3> &z,
+                             const float origin_x, const float origin_y)
+{
+    const std::array<float, 3> rx{x[0] - origin_x, x[1] - origin_x, x[2] - origin_x};
+    const std::array<float, 3> ry{y[0] - origin_y, y[1] - origin_y, y[2] - origin_y};
+    TriangleEdges edges;
+    float area = 0.0f;
+    for (std::size_t i(0); i < 3; i++)
+    {
+        const std::size_t j = (i + 1) % 3; // Edge j -> k
+        const std::size_t k = (i + 2) % 3;
+        edges.a[i] = ry[j] - ry[k];
+        edges.b[i] = rx[k] - rx[j];
+        edges.c[i] = rx[j] * ry[k] - rx[k] * ry[j];
+        const bool inclusive = edges.a[i] > 0.0f || (edges.a[i] == 0.0f && edges.b[i] > 0.0f); // The reversed edge is never inclusive
+        edges.threshold[i] = inclusive ? 0.0f : std::numeric_limits<float>::min();
+        area += edges.a[i] * rx[i] + (edges.b[i] * ry[i] + edges.c[i]);
+    }
+    edges.inv_area = 1.0f / area;
+    edges.dz_dx = (edges.a[0] * z[0] + edges.a[1] * z[1] + edges.a[2] * z[2]) * edges.inv_area;
+    edges.dz_dy = (edges.b[0] * z[0] + edges.b[1] * z[1] + edges.b[2] * z[2]) * edges.inv_area;
+    edges.z = z[0] - edges.dz_dx * rx[0] - edges.dz_dy * ry[0];
+    return edges;
+}
+
+struct LitShading // Inputs of shade_lit() shared by every pixel of a frame
+{
+    const std::vector<ClusterLight> *lights = nullptr;
+    const LightClusters *clusters = nullptr;
+    glm::mat4 view{1.0f};
+    glm::vec2 depth_scale_bias{0.0f};
+    glm::vec3 eye{0.0f};
+    glm::vec2 viewport{1.0f};
+};
+
+glm::vec3 encode_position(const glm::vec3 &world_position)
+{
+    const float length_value = glm::length(world_position);
+    if (length_value > 1e-5f) return 0.5f + 0.5f * glm::clamp(world_position / length_value, glm::vec3(-1.0f), glm::vec3(1.0f));
+    return glm::vec3(0.5f);
+}
+
+glm::vec3 encode_normal(const glm::vec3 &normal)
+{
+    const float length_value = glm::length(normal);
+    return 0.5f + 0.5f * (length_value > 1e-5f ? normal / length_value : glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+float smoothstep(const float edge0, const float edge1, const float x)
+{
+    const float t = std::clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+    return t * t * (3.0f - 2.0f * t);
+}
+
+// shade_lit() of the lit shading without the shadow atlas (the software backend has no shadow pass)
+glm::vec3 shade_lit(const glm::vec3 &albedo, const glm::vec3 &world_position, const glm::vec3 &normal, const float occlusion,
+                    const glm::vec2 &frag_coord, const LitShading &lit)
+{
+    const glm::vec3 n = glm::normalize(normal);
+    const glm::vec3 v = glm::normalize(lit.eye - world_position);
+    glm::vec3 result = albedo * glm::mix(glm::vec3(0.03f, 0.035f, 0.05f), glm::vec3(0.09f, 0.09f, 0.08f), n.y * 0.5f + 0.5f) * occlusion;
+
+    if (const float n_dot_sun = std::max(glm::dot(n, kSunToLight), 0.0f); n_dot_sun > 0.0f)
+    {
+        const float sun_specular = std::pow(std::max(glm::dot(n, glm::normalize(kSunToLight + v)), 0.0f), 48.0f);
+        result += (albedo * n_dot_sun + glm::vec3(0.35f) * sun_specular) * kSunColor;
+    }
+    if (!lit.lights || lit.clusters->ranges.size() != kClusterCount) return result;
+
+    const glm::vec2 tile = glm::clamp(frag_coord / lit.viewport, glm::vec2(0.0f), glm::vec2(0.99999f)) *
+                           glm::vec2(kClusterGridX, kClusterGridY);
+    const float depth = std::max(-(lit.view * glm::vec4(world_position, 1.0f)).z, 1e-4f);
+    const auto slice = static_cast<std::uint32_t>(std::clamp(std::log(depth) * lit.depth_scale_bias.x - lit.depth_scale_bias.y,
+                                                             0.0f, static_cast<float>(kClusterGridZ - 1)));
+    const glm::uvec2 cluster = lit.clusters->ranges[(slice * kClusterGridY + static_cast<std::uint32_t>(tile.y)) * kClusterGridX +
+                                                    static_cast<std::uint32_t>(tile.x)];
+    for (std::uint32_t i(0); i < cluster.y; i++) // Only the lights binned into this cluster
+    {
+        const ClusterLight &light = (*lit.lights)[lit.clusters->indices[cluster.x + i]];
+        const glm::vec3 to_light = glm::vec3(light.position_range) - world_position;
+        const float distance_squared = glm::dot(to_light, to_light);
+        const float light_range = light.position_range.w;
+        if (distance_squared >= light_range * light_range) continue;
+
+        const float distance = std::sqrt(distance_squared);
+        const glm::vec3 l = to_light / std::max(distance, 1e-4f);
+        const float window = std::clamp(1.0f - std::pow(distance / light_range, 4.0f), 0.0f, 1.0f);
+        float attenuation = window * window / (distance_squared + 1.0f);
+        if (light.direction_cos_outer.w > -1.5f) // Spot light
+        {
+            attenuation *= smoothstep(light.direction_cos_outer.w, light.cos_inner.x, glm::dot(-l, glm::vec3(light.direction_cos_outer)));
+        }
+
+        const float n_dot_l = std::max(glm::dot(n, l), 0.0f);
+        const float specular = n_dot_l > 0.0f ? std::pow(std::max(glm::dot(n, glm::normalize(l + v)), 0.0f), 48.0f) : 0.0f;
+        result += (albedo * n_dot_l + glm::vec3(0.35f) * specular) * glm::vec3(light.color_intensity) * (light.color_intensity.a * attenuation);
+    }
+    return result;
+}
+
+// shade_surface() of shader_sources.cpp; textures are not sampled (the albedo is the tint)
+glm::vec3 shade_surface(const glm::vec4 &color, const int color_mode, const glm::vec3 &world_position, const glm::vec3 &normal,
+                        const glm::vec2 &uv, const float occlusion, const glm::vec2 &frag_coord, const LitShading &lit)
+{
+    const glm::vec3 tint(color);
+    glm::vec3 final_color = tint;
+    switch (color_mode)
+    {
+        case 1: final_color = encode_position(world_position); break;
+        case 2: final_color = encode_normal(normal); break;
+        case 3: final_color = glm::vec3(glm::fract(uv), 0.5f); break;
+        case 4: final_color = glm::mix(encode_position(world_position), encode_normal(normal), 0.5f); break;
+        case kLitColorMode: return shade_lit(tint, world_position, normal, occlusion, frag_coord, lit);
+        case 6: return glm::mix(glm::vec3(1.0f), tint, 0.35f) * occlusion;
+        default: return tint;
+    }
+    return glm::mix(final_color, tint, 0.35f); // Blend attribute visualization with base tint
+}
+
+QRgb pack_color(const glm::vec3 &color)
+{
+    const glm::vec3 scaled = glm::clamp(color, glm::vec3(0.0f), glm::vec3(1.0f)) * 255.0f + 0.5f;
+    return qRgb(static_cast<int>(scaled.r), static_cast<int>(scaled.g), static_cast<int>(scaled.b));
+}
+
+struct ClipVertex // Polygon vertex while clipping against the near plane
+{
+    glm::vec4 clip{0.0f}; // Clip-space position
+    glm::vec3 corner{0.0f}; // Barycentrics in the source triangle
+    bool source_edge = true; // The edge to the next vertex lies on an edge of the source triangle
+};
+}
+
+SoftwareMesh make_software_mesh(const std::span<const MeshVertex> vertices, std::vector<std::uint32_t> indices, std::vector<float> occlusion)
+{
+    SoftwareMesh mesh;
+    mesh.positions.reserve(vertices.size());
+    mesh.normals.reserve(vertices.size());
+    mesh.uvs.reserve(vertices.size());
+    for (const MeshVertex &vertex : vertices)
+    {
+        mesh.positions.push_back(vertex.position);
+        mesh.normals.push_back(vertex.normal);
+        mesh.uvs.push_back(vertex.uv);
+    }
+    mesh.indices = std::move(indices);
+    if (occlusion.size() == vertices.size()) mesh.occlusion = std::move(occlusion);
+    return mesh;
+}
+
+SoftwareMesh make_software_cube()
+{
+    struct Face // Outward normal and the two in-plane axes of one cube side
+    {
+        glm::vec3 normal;
+        glm::vec3 u;
+        glm::vec3 v;
+    };
+    const std::array<Face, 6> faces{{
+        {{0.0f, 0.0f, -1.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+        {{1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},
+        {{0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+        {{-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 1.0f, 0.0f}},
+        {{0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}},
+        {{0.0f, -1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}}
+    }};
+
+    SoftwareMesh mesh;
+    for (const Face &face : faces)
+    {
+        const auto first = static_cast<std::uint32_t>(mesh.positions.size());
+        for (const glm::vec2 uv : {glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(1.0f, 1.0f), glm::vec2(0.0f, 1.0f)})
+        {
+            mesh.positions.push_back(0.5f * face.normal + (uv.x - 0.5f) * face.u + (uv.y - 0.5f) * face.v);
+            mesh.normals.push_back(face.normal);
+            mesh.uvs.push_back(uv);
+        }
+        for (const std::uint32_t corner : {0u, 1u, 2u, 0u, 2u, 3u}) mesh.indices.push_back(first + corner); // No culling: winding is free
+    }
+    return mesh;
+}
+
+void SoftwareRasterizer::render(const SoftwareFrame &frame, QImage &image, SoftwareFrameStats &stats)
+{
+    stats = {};
+    const int width = image.width();
+    const int height = image.height();
+    if (width <= 0 || height <= 0) return;
+    pixels_ = image.bits(); // Detaches once here, so the raster jobs only write
+    bytes_per_line_ = image.bytesPerLine();
+
+    auto start = std::chrono::steady_clock::now();
+    transform_vertices(frame);
+    stats.transform_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    bin_triangles(frame, width, height);
+    stats.bin_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    const bool lit = frame.lights && std::ranges::any_of(frame.draws, [](const SoftwareDraw &draw) { return draw.color_mode == kLitColorMode; });
+    if (lit) // Same grid and slices as the GL path, so both backends light a pixel with the same lights
+    {
+        build_light_clusters(*frame.lights, frame.view, frame.projection, frame.near_plane, frame.far_plane, clusters_);
+        cluster_depth_scale_bias_ = cluster_depth_scale_bias(frame.near_plane, frame.far_plane);
+    }
+    else
+    {
+        clusters_.ranges.clear();
+    }
+
+    const std::size_t tile_count = tile_order_.size();
+    const std::size_t jobs = frame_jobs_of(frame, tile_count, 1);
+    tile_buffers_.resize(std::max(tile_buffers_.size(), jobs));
+    std::atomic<std::size_t> next_tile{0}; // Biggest bins first; whichever job is free takes the next tile
+    run_frame_jobs(jobs, jobs, [&](const std::size_t job, std::size_t, std::size_t)
+    {
+        TileBuffer &buffer = tile_buffers_[job];
+        for (std::size_t k = next_tile++; k < tile_count; k = next_tile++)
+        {
+            rasterize_tile(tile_order_[k], buffer);
+            resolve_tile(tile_order_[k], buffer, frame, width, height);
+        }
+    });
+    stats.raster_ms = elapsed_ms(start);
+
+    stats.triangles = triangle_count_;
+    stats.binned_triangles = job_first_ids_.empty() ? 0 : job_first_ids_.back();
+    for (const JobBins &bins : job_bins_)
+    {
+        stats.clipped_triangles += bins.clipped;
+        for (const auto &tile : bins.tiles) stats.bin_entries += tile.size();
+    }
+    stats.tiles = tile_count;
+    stats.jobs = jobs;
+    pixels_ = nullptr;
+}
+
+void SoftwareRasterizer::transform_vertices(const SoftwareFrame &frame)
+{
+    const glm::mat4 view_projection = frame.projection * frame.view;
+    draw_setups_.resize(frame.draws.size());
+    vertex_count_ = 0;
+    triangle_count_ = 0;
+    for (std::size_t i(0); i < frame.draws.size(); i++)
+    {
+        const SoftwareDraw &draw = frame.draws[i];
+        DrawSetup &setup = draw_setups_[i];
+        setup.model_view_projection = view_projection * draw.model;
+        setup.normal_matrix = glm::mat3(glm::transpose(glm::inverse(draw.model)));
+        setup.first_vertex = vertex_count_;
+        setup.first_triangle = triangle_count_;
+        vertex_count_ += draw.mesh->positions.size();
+        triangle_count_ += draw.mesh->indices.size() / 3;
+    }
+
+    clip_positions_.resize(vertex_count_);
+    run_frame_jobs(frame_jobs_of(frame, vertex_count_, kMinVerticesPerJob), vertex_count_,
+                   [&](std::size_t, const std::size_t begin, const std::size_t end)
+    {
+        auto draw = static_cast<std::size_t>(std::ranges::upper_bound(draw_setups_, begin, {}, &DrawSetup::first_vertex) - draw_setups_.begin()) - 1;
+        for (std::size_t vertex = begin; vertex < end; vertex++)
+        {
+            while (draw + 1 < draw_setups_.size() && draw_setups_[draw + 1].first_vertex <= vertex) draw++; // Skips empty meshes too
+            const DrawSetup &setup = draw_setups_[draw];
+            clip_positions_[vertex] = setup.model_view_projection *
+                                      glm::vec4(frame.draws[draw].mesh->positions[vertex - setup.first_vertex], 1.0f);
+        }
+    });
+}
+
+void SoftwareRasterizer::bin_triangles(const SoftwareFrame &frame, const int width, const int height)
+{
+    tiles_x_ = (width + kSoftwareTileSize - 1) / kSoftwareTileSize;
+    tiles_y_ = (height + kSoftwareTileSize - 1) / kSoftwareTileSize;
+    const auto tile_count = static_cast<std::size_t>(tiles_x_) * static_cast<std::size_t>(tiles_y_);
+
+    const std::size_t jobs = frame_jobs_of(frame, triangle_count_, kMinTrianglesPerJob);
+    job_bins_.resize(jobs);
+    run_frame_jobs(jobs, triangle_count_, [&](const std::size_t job, const std::size_t begin, const std::size_t end)
+    {
+        JobBins &bins = job_bins_[job];
+        bins.triangles.clear();
+        bins.corners.clear();
+        bins.clipped = 0;
+        bins.tiles.resize(tile_count);
+        for (auto &tile : bins.tiles) tile.clear();
+        if (begin == end) return;
+
+        auto draw = static_cast<std::size_t>(std::ranges::upper_bound(draw_setups_, begin, {}, &DrawSetup::first_triangle) - draw_setups_.begin()) - 1;
+        for (std::size_t triangle = begin; triangle < end; triangle++)
+        {
+            while (draw + 1 < draw_setups_.size() && draw_setups_[draw + 1].first_triangle <= triangle) draw++;
+            const DrawSetup &setup = draw_setups_[draw];
+            const auto local = static_cast<std::uint32_t>(triangle - setup.first_triangle);
+            const std::uint32_t *indices = frame.draws[draw].mesh->indices.data() + std::size_t{local} * 3;
+            const std::array<glm::vec4, 3> clip{clip_positions_[setup.first_vertex + indices[0]], clip_positions_[setup.first_vertex + indices[1]],
+                                                clip_positions_[setup.first_vertex + indices[2]]};
+
+            bool outside = false; // All corners beyond the same side of the frustum
+            for (int axis(0); axis < 3 && !outside; axis++)
+            {
+                outside = std::ranges::all_of(clip, [axis](const glm::vec4 &p) { return p[axis] > p.w; }) ||
+                          std::ranges::all_of(clip, [axis](const glm::vec4 &p) { return p[axis] < -p.w; });
+            }
+            if (outside) continue;
+
+            const std::array<glm::vec3, 3> source{glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)};
+            if (std::ranges::all_of(clip, [](const glm::vec4 &p) { return p.z >= -p.w; }))
+            {
+                setup_triangle(bins, static_cast<std::uint32_t>(draw), local, clip, source, 7, false, width, height);
+                continue;
+            }
+
+            // Crosses the near plane: clip to z >= -w, which keeps w >= near, then fan the polygon (at most a quad)
+            std::array<ClipVertex, 4> polygon;
+            std::size_t count = 0;
+            for (std::size_t i(0); i < 3; i++)
+            {
+                const std::size_t next = (i + 1) % 3;
+                const float current_distance = clip[i].z + clip[i].w;
+                const float next_distance = clip[next].z + clip[next].w;
+                if (current_distance >= 0.0f) polygon[count++] = {clip[i], source[i], true};
+                if ((current_distance >= 0.0f) != (next_distance >= 0.0f))
+                {
+                    const float t = current_distance / (current_distance - next_distance);
+                    polygon[count++] = {glm::mix(clip[i], clip[next], t), glm::mix(source[i], source[next], t),
+                                        current_distance < 0.0f}; // Leaving the plane, the next edge runs along it
+                }
+            }
+            bins.clipped++;
+            for (std::size_t k(1); k + 1 < count; k++)
+            {
+                const std::uint32_t edge_mask = (polygon[k].source_edge ? 1u : 0u) |
+                                                (k + 2 == count && polygon[count - 1].source_edge ? 2u : 0u) |
+                                                (k == 1 && polygon[0].source_edge ? 4u : 0u);
+                setup_triangle(bins, static_cast<std::uint32_t>(draw), local, {polygon[0].clip, polygon[k].clip, polygon[k + 1].clip},
+                               {polygon[0].corner, polygon[k].corner, polygon[k + 1].corner}, edge_mask, true, width, height);
+            }
+        }
+    });
+
+    job_first_ids_.resize(jobs + 1);
+    job_first_ids_[0] = 0;
+    for (std::size_t job(0); job < jobs; job++)
+    {
+        job_first_ids_[job + 1] = job_first_ids_[job] + static_cast<std::uint32_t>(job_bins_[job].triangles.size());
+    }
+
+    std::vector<std::size_t> entries(tile_count, 0); // Raster cost estimate per tile
+    for (const JobBins &bins : job_bins_)
+    {
+        for (std::size_t tile(0); tile < tile_count; tile++) entries[tile] += bins.tiles[tile].size();
+    }
+    tile_order_.resize(tile_count);
+    std::iota(tile_order_.begin(), tile_order_.end(), std::size_t{0});
+    std::ranges::stable_sort(tile_order_, std::greater{}, [&entries](const std::size_t tile) { return entries[tile]; });
+}
+
+void SoftwareRasterizer::setup_triangle(JobBins &bins, const std::uint32_t draw, const std::uint32_t triangle, const std::array<glm::vec4, 3> &clip,
+                                        const std::array<glm::vec3, 3> &corners, std::uint32_t edge_mask, const bool clipped,
+                                        const int width, const int height)
+{
+    SetupTriangle setup;
+    for (std::size_t i(0); i < 3; i++)
+    {
+        const float inv_w = 1.0f / clip[i].w;
+        setup.x[i] = (clip[i].x * inv_w * 0.5f + 0.5f) * static_cast<float>(width);
+        setup.y[i] = (0.5f - clip[i].y * inv_w * 0.5f) * static_cast<float>(height); // Image rows go down
+        setup.z[i] = clip[i].z * inv_w * 0.5f + 0.5f;
+        setup.inv_w[i] = inv_w;
+    }
+    const float area = (setup.x[1] - setup.x[0]) * (setup.y[2] - setup.y[0]) - (setup.x[2] - setup.x[0]) * (setup.y[1] - setup.y[0]);
+    if (!(std::abs(area) > 0.0f)) return; // Degenerate (or not finite)
+
+    std::array<glm::vec3, 3> ordered = corners;
+    if (area < 0.0f) // No face culling (as in the GL path): flip the winding so that the inside is positive
+    {
+        std::swap(setup.x[1], setup.x[2]);
+        std::swap(setup.y[1], setup.y[2]);
+        std::swap(setup.z[1], setup.z[2]);
+        std::swap(setup.inv_w[1], setup.inv_w[2]);
+        std::swap(ordered[1], ordered[2]);
+        edge_mask = (edge_mask & 1u) | ((edge_mask & 2u) << 1) | ((edge_mask & 4u) >> 1);
+    }
+
+    // Pixel centers inside the bounding box, clamped to the image (floats first: off-screen corners can be far away)
+    const auto [min_x, max_x] = std::ranges::minmax(setup.x);
+    const auto [min_y, max_y] = std::ranges::minmax(setup.y);
+    const auto first_center = [](const float value, const int size) { return static_cast<int>(std::ceil(std::clamp(value - 0.5f, -1.0f, static_cast<float>(size)))); };
+    const auto last_center = [](const float value, const int size) { return static_cast<int>(std::floor(std::clamp(value - 0.5f, -1.0f, static_cast<float>(size)))); };
+    setup.bounds = {std::max(0, first_center(min_x, width)), std::max(0, first_center(min_y, height)),
+                    std::min(width - 1, last_center(max_x, width)), std::min(height - 1, last_center(max_y, height))};
+    if (setup.bounds[0] > setup.bounds[2] || setup.bounds[1] > setup.bounds[3]) return; // Between pixel centers or off-screen
+
+    setup.draw = draw;
+    setup.triangle = triangle;
+    setup.edge_mask = edge_mask;
+    if (clipped)
+    {
+        setup.corners = static_cast<std::uint32_t>(bins.corners.size());
+        bins.corners.push_back(ordered);
+    }
+    const auto index = static_cast<std::uint32_t>(bins.triangles.size());
+    bins.triangles.push_back(setup);
+
+    const int tile_x0 = setup.bounds[0] / kSoftwareTileSize;
+    const int tile_y0 = setup.bounds[1] / kSoftwareTileSize;
+    const int tile_x1 = setup.bounds[2] / kSoftwareTileSize;
+    const int tile_y1 = setup.bounds[3] / kSoftwareTileSize;
+    if (tile_x0 == tile_x1 && tile_y0 == tile_y1) // Most triangles of a dense mesh
+    {
+        bins.tiles[static_cast<std::size_t>(tile_y0) * tiles_x_ + tile_x0].push_back(index);
+        return;
+    }
+    const auto origin_x = static_cast<float>(tile_x0 * kSoftwareTileSize);
+    const auto origin_y = static_cast<float>(tile_y0 * kSoftwareTileSize);
+    const TriangleEdges edges = triangle_edges(setup.x, setup.y, setup.z, origin_x, origin_y);
+    for (int tile_y = tile_y0; tile_y <= tile_y1; tile_y++)
+    {
+        const float top = static_cast<float>(tile_y * kSoftwareTileSize) + 0.5f - origin_y;
+        const float bottom = top + static_cast<float>(kSoftwareTileSize - 1);
+        for (int tile_x = tile_x0; tile_x <= tile_x1; tile_x++)
+        {
+            const float left = static_cast<float>(tile_x * kSoftwareTileSize) + 0.5f - origin_x;
+            const float right = left + static_cast<float>(kSoftwareTileSize - 1);
+            bool overlaps = true; // Large triangles skip the tiles entirely outside one of their edges
+            for (std::size_t i(0); i < 3 && overlaps; i++)
+            {
+                const float x = edges.a[i] > 0.0f ? right : left; // Corner of the tile where the edge function is largest
+                const float y = edges.b[i] > 0.0f ? bottom : top;
+                overlaps = edges.a[i] * x + (edges.b[i] * y + edges.c[i]) >= 0.0f;
+            }
+            if (overlaps) bins.tiles[static_cast<std::size_t>(tile_y) * tiles_x_ + tile_x].push_back(index);
+        }
+    }
+}
+
+void SoftwareRasterizer::rasterize_tile(const std::size_t tile, TileBuffer &buffer) const
+{
+    const int tile_x0 = static_cast<int>(tile % tiles_x_) * kSoftwareTileSize;
+    const int tile_y0 = static_cast<int>(tile / tiles_x_) * kSoftwareTileSize;
+    buffer.depth.fill(1.0f); // Far plane, as the GL depth clear
+    buffer.ids.fill(kEmptyPixel);
+
+    for (std::size_t job(0); job < job_bins_.size(); job++) // Submission order: the earlier triangle wins equal depths
+    {
+        const JobBins &bins = job_bins_[job];
+        for (const std::uint32_t index : bins.tiles[tile])
+        {
+            const SetupTriangle &triangle = bins.triangles[index];
+            const std::uint32_t id = job_first_ids_[job] + index;
+            const TriangleEdges edges = triangle_edges(triangle.x, triangle.y, triangle.z, static_cast<float>(tile_x0), static_cast<float>(tile_y0));
+            const int x_begin = std::max(triangle.bounds[0], tile_x0) & ~3; // Groups of four stay aligned inside the tile
+            const int x_end = std::min(triangle.bounds[2], tile_x0 + kSoftwareTileSize - 1);
+            const int y_begin = std::max(triangle.bounds[1], tile_y0);
+            const int y_end = std::min(triangle.bounds[3], tile_y0 + kSoftwareTileSize - 1);
+
+#ifdef SOFTWARE_RASTERIZER_SSE2
+            const __m128 lane_centers = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            const __m128 a0 = _mm_set1_ps(edges.a[0]);
+            const __m128 a1 = _mm_set1_ps(edges.a[1]);
+            const __m128 a2 = _mm_set1_ps(edges.a[2]);
+            const __m128 threshold0 = _mm_set1_ps(edges.threshold[0]);
+            const __m128 threshold1 = _mm_set1_ps(edges.threshold[1]);
+            const __m128 threshold2 = _mm_set1_ps(edges.threshold[2]);
+            const __m128 dz_dx = _mm_set1_ps(edges.dz_dx);
+            const __m128i id_lanes = _mm_set1_epi32(static_cast<int>(id));
+            const __m128 lane_limit = _mm_set1_ps(static_cast<float>(x_end - tile_x0) + 1.0f);
+            for (int y = y_begin; y <= y_end; y++)
+            {
+                const float center_y = static_cast<float>(y - tile_y0) + 0.5f; // Tile-relative, like the edges
+                const __m128 row0 = _mm_set1_ps(edges.b[0] * center_y + edges.c[0]);
+                const __m128 row1 = _mm_set1_ps(edges.b[1] * center_y + edges.c[1]);
+                const __m128 row2 = _mm_set1_ps(edges.b[2] * center_y + edges.c[2]);
+                const __m128 row_depth = _mm_set1_ps(edges.z + edges.dz_dy * center_y);
+                float *depth_row = buffer.depth.data() + static_cast<std::size_t>(y - tile_y0) * kSoftwareTileSize;
+                std::uint32_t *id_row = buffer.ids.data() + static_cast<std::size_t>(y - tile_y0) * kSoftwareTileSize;
+                for (int x = x_begin; x <= x_end; x += 4)
+                {
+                    const int lane = x - tile_x0;
+                    const __m128 center_x = _mm_add_ps(_mm_set1_ps(static_cast<float>(lane)), lane_centers);
+                    const __m128 inside01 = _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, center_x), row0), threshold0),
+                                                       _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, center_x), row1), threshold1));
+                    const __m128 inside2 = _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, center_x), row2), threshold2),
+                                                      _mm_cmplt_ps(center_x, lane_limit)); // Lanes past the bounds are skipped, as in the scalar loop
+                    const __m128 inside = _mm_and_ps(inside01, inside2);
+                    if (_mm_movemask_ps(inside) == 0) continue;
+
+                    const __m128 depth = _mm_add_ps(row_depth, _mm_mul_ps(dz_dx, center_x));
+                    const __m128 stored = _mm_load_ps(depth_row + lane);
+                    const __m128 pass = _mm_and_ps(inside, _mm_cmplt_ps(depth, stored));
+                    _mm_store_ps(depth_row + lane, _mm_or_ps(_mm_and_ps(pass, depth), _mm_andnot_ps(pass, stored)));
+                    const __m128i pass_lanes = _mm_castps_si128(pass);
+                    auto *ids = reinterpret_cast<__m128i*>(id_row + lane);
+                    _mm_store_si128(ids, _mm_or_si128(_mm_and_si128(pass_lanes, id_lanes), _mm_andnot_si128(pass_lanes, _mm_load_si128(ids))));
+                }
+            }
+#else
+            for (int y = y_begin; y <= y_end; y++)
+            {
+                const float center_y = static_cast<float>(y - tile_y0) + 0.5f; // Tile-relative, like the edges
+                const std::array<float, 3> row{edges.b[0] * center_y + edges.c[0], edges.b[1] * center_y + edges.c[1], edges.b[2] * center_y + edges.c[2]};
+                const float row_depth = edges.z + edges.dz_dy * center_y;
+                const std::size_t row_offset = static_cast<std::size_t>(y - tile_y0) * kSoftwareTileSize;
+                for (int x = x_begin; x <= x_end; x++)
+                {
+                    const float center_x = static_cast<float>(x - tile_x0) + 0.5f;
+                    if (edges.a[0] * center_x + row[0] < edges.threshold[0] || edges.a[1] * center_x + row[1] < edges.threshold[1] ||
+                        edges.a[2] * center_x + row[2] < edges.threshold[2]) continue;
+                    const float depth = row_depth + edges.dz_dx * center_x;
+                    const std::size_t pixel = row_offset + static_cast<std::size_t>(x - tile_x0);
+                    if (depth >= buffer.depth[pixel]) continue;
+                    buffer.depth[pixel] = depth;
+                    buffer.ids[pixel] = id;
+                }
+            }
+#endif
+        }
+    }
+}
+
+const SoftwareRasterizer::SetupTriangle &SoftwareRasterizer::triangle_of(const std::uint32_t id, const std::array<glm::vec3, 3> *&corners) const
+{
+    const auto job = static_cast<std::size_t>(std::ranges::upper_bound(job_first_ids_, id) - job_first_ids_.begin()) - 1;
+    const JobBins &bins = job_bins_[job];
+    const SetupTriangle &triangle = bins.triangles[id - job_first_ids_[job]];
+    corners = triangle.corners == kNoCorners ? nullptr : &bins.corners[triangle.corners];
+    return triangle;
+}
+
+void SoftwareRasterizer::resolve_tile(const std::size_t tile, const TileBuffer &buffer, const SoftwareFrame &frame, const int width,
+                                      const int height) const
+{
+    const int tile_x0 = static_cast<int>(tile % tiles_x_) * kSoftwareTileSize;
+    const int tile_y0 = static_cast<int>(tile / tiles_x_) * kSoftwareTileSize;
+    const int tile_width = std::min(kSoftwareTileSize, width - tile_x0);
+    const int tile_height = std::min(kSoftwareTileSize, height - tile_y0);
+    const QRgb clear = pack_color(frame.clear_color);
+
+    LitShading lit;
+    if (!clusters_.ranges.empty())
+    {
+        lit.lights = frame.lights;
+        lit.clusters = &clusters_;
+    }
+    lit.view = frame.view;
+    lit.depth_scale_bias = cluster_depth_scale_bias_;
+    lit.eye = frame.eye;
+    lit.viewport = glm::vec2(static_cast<float>(width), static_cast<float>(height));
+
+    // Pixels of one triangle are mostly neighbours, so its edges and vertices are looked up once per run
+    std::uint32_t current = kEmptyPixel;
+    const SetupTriangle *triangle = nullptr;
+    const std::array<glm::vec3, 3> *corners = nullptr;
+    TriangleEdges edges;
+    std::array<std::uint32_t, 3> vertices{};
+    const SoftwareDraw *draw = nullptr;
+    const DrawSetup *setup = nullptr;
+    std::array<float, 3> edge_scale{}; // 1 / edge length: edge function to pixel distance
+
+    for (int y(0); y < tile_height; y++)
+    {
+        auto *row = reinterpret_cast<QRgb*>(pixels_ + static_cast<qsizetype>(tile_y0 + y) * bytes_per_line_) + tile_x0;
+        for (int x(0); x < tile_width; x++)
+        {
+            const std::uint32_t id = buffer.ids[static_cast<std::size_t>(y) * kSoftwareTileSize + x];
+            if (id == kEmptyPixel)
+            {
+                row[x] = clear;
+                continue;
+            }
+            if (id != current)
+            {
+                current = id;
+                triangle = &triangle_of(id, corners);
+                edges = triangle_edges(triangle->x, triangle->y, triangle->z, static_cast<float>(tile_x0), static_cast<float>(tile_y0));
+                draw = &frame.draws[triangle->draw];
+                setup = &draw_setups_[triangle->draw];
+                const std::uint32_t *indices = draw->mesh->indices.data() + std::size_t{triangle->triangle} * 3;
+                vertices = {indices[0], indices[1], indices[2]};
+                for (std::size_t i(0); i < 3; i++) edge_scale[i] = 1.0f / std::sqrt(edges.a[i] * edges.a[i] + edges.b[i] * edges.b[i]);
+            }
+
+            const float center_x = static_cast<float>(x) + 0.5f; // Tile-relative, like the edges
+            const float center_y = static_cast<float>(y) + 0.5f;
+            std::array<float, 3> edge_values{};
+            for (std::size_t i(0); i < 3; i++) edge_values[i] = edges.a[i] * center_x + (edges.b[i] * center_y + edges.c[i]);
+            const glm::vec3 screen = glm::vec3(edge_values[0], edge_values[1], edge_values[2]) * edges.inv_area; // Screen-space barycentrics
+            glm::vec3 perspective = screen * glm::vec3(triangle->inv_w[0], triangle->inv_w[1], triangle->inv_w[2]);
+            perspective /= perspective.x + perspective.y + perspective.z;
+            const glm::vec3 weights = corners ? perspective.x * (*corners)[0] + perspective.y * (*corners)[1] + perspective.z * (*corners)[2]
+                                              : perspective; // Back to the source triangle when it was clipped
+
+            const SoftwareMesh &mesh = *draw->mesh;
+            const glm::vec3 position = weights.x * mesh.positions[vertices[0]] + weights.y * mesh.positions[vertices[1]] +
+                                       weights.z * mesh.positions[vertices[2]];
+            const glm::vec3 normal = weights.x * mesh.normals[vertices[0]] + weights.y * mesh.normals[vertices[1]] +
+                                     weights.z * mesh.normals[vertices[2]];
+            const glm::vec2 uv = weights.x * mesh.uvs[vertices[0]] + weights.y * mesh.uvs[vertices[1]] + weights.z * mesh.uvs[vertices[2]];
+            const float occlusion = mesh.occlusion.empty() ? 1.0f : weights.x * mesh.occlusion[vertices[0]] +
+                                                                    weights.y * mesh.occlusion[vertices[1]] +
+                                                                    weights.z * mesh.occlusion[vertices[2]];
+            const glm::vec3 world_position(draw->model * glm::vec4(position, 1.0f));
+            const glm::vec2 frag_coord(static_cast<float>(tile_x0) + center_x, static_cast<float>(height - tile_y0) - center_y); // gl_FragCoord has its origin at the bottom
+
+            glm::vec3 color = shade_surface(draw->color, draw->color_mode, world_position, setup->normal_matrix * normal, uv, occlusion,
+                                            frag_coord, lit);
+            if (draw->wireframe)
+            {
+                float distance = std::numeric_limits<float>::max();
+                for (std::size_t i(0); i < 3; i++)
+                {
+                    if (triangle->edge_mask & (1u << i)) distance = std::min(distance, edge_values[i] * edge_scale[i]);
+                }
+                const float coverage = 1.0f - smoothstep(kWireframeWidth - 0.5f, kWireframeWidth + 0.5f, distance);
+                color = glm::mix(color, glm::vec3(0.02f), coverage * 0.8f);
+            }
+            row[x] = pack_color(color);
+        }
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef SOFTWARE_RASTERIZER_H // Guard against multiple inclusion
+#define SOFTWARE_RASTERIZER_H // Begin include guard
+
+#include "light_clusters.h" // Lit frames bin the scene lights exactly like the GL path
+#include "mesh_encoding.h" // Importer-side vertices the CPU meshes are copied from
+
+#include <QImage> // Frame output: painted into the view or saved by image tests
+
+#include <glm/glm.hpp> // Positions, normals and camera matrices
+
+#include <array> // Clipped triangle corners
+#include <cstddef> // Counts
+#include <cstdint> // Triangle ids and indices
+#include <span> // Importer vertices
+#include <vector> // Meshes, draws, per-job bins
+
+// CPU renderer used when OpenGL 4.5 is unavailable (the software backend) and for headless image tests. A frame transforms
+// every vertex, clips and bins the triangles into kSoftwareTileSize tiles, then rasterizes the tiles in parallel: edge
+// functions are evaluated four pixels at a time into a tile-local depth and triangle-id buffer (a visibility buffer, as in
+// the GL visibility path), and every covered pixel is shaded once with the color-mode formulas of shader_sources.cpp.
+
+constexpr int kSoftwareTileSize = 64; // Pixels per tile edge; a tile's depth and ids stay in the core's cache
+
+struct SoftwareMesh // CPU copy of an imported mesh (full detail: the software backend has no LOD selection)
+{
+    std::vector<glm::vec3> positions; // Object space, recentered like the pooled mesh
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> uvs;
+    std::vector<float> occlusion; // Baked ambient occlusion per vertex (empty: unoccluded)
+    std::vector<std::uint32_t> indices; // Triangle list
+};
+
+// Copy the staged importer vertices; occlusion is either empty or one value per vertex
+[[nodiscard]] SoftwareMesh make_software_mesh(std::span<const MeshVertex> vertices, std::vector<std::uint32_t> indices, std::vector<float> occlusion);
+
+// Unit cube centered on the origin with face normals (the ground plane, same as the GL cube mesh)
+[[nodiscard]] SoftwareMesh make_software_cube();
+
+struct SoftwareDraw // One mesh instance of a frame
+{
+    const SoftwareMesh *mesh = nullptr; // Owned by the scene; must outlive render()
+    glm::mat4 model{1.0f}; // Object to world
+    glm::vec4 color{1.0f}; // Base material color
+    int color_mode = 0; // View::ColorMode of the draw
+    bool wireframe = false; // Darken pixels near the triangle edges
+};
+
+struct SoftwareFrame // Everything render() reads
+{
+    std::vector<SoftwareDraw> draws; // Drawn in order; equal depths keep the earlier draw (GL_LESS)
+    glm::mat4 view{1.0f}; // World to view
+    glm::mat4 projection{1.0f}; // OpenGL clip conventions (z in [-w, w])
+    glm::vec3 eye{0.0f}; // World-space camera position (specular)
+    float near_plane = 0.1f; // Clip and cluster depth range of the projection
+    float far_plane = 100.0f;
+    const std::vector<ClusterLight> *lights = nullptr; // Lights of ColorMode::Lit (null: sun only)
+    glm::vec3 clear_color{0.10f, 0.10f, 0.12f}; // Background
+    std::size_t max_jobs = 0; // Cap on the jobs of every stage (0: one per hardware thread; 1: thumbnails rendered side by side)
+};
+
+struct SoftwareFrameStats // Numbers shown by the HUD of the software backend
+{
+    std::size_t triangles = 0; // Submitted by the draws
+    std::size_t binned_triangles = 0; // Left after clipping, off-screen and empty-coverage rejection
+    std::size_t clipped_triangles = 0; // Crossed the near plane and were split
+    std::size_t bin_entries = 0; // Triangle-tile pairs rasterized
+    std::size_t tiles = 0; // Tiles of the image
+    std::size_t jobs = 1; // Raster jobs (one per hardware thread)
+    double transform_ms = 0.0; // Vertex transform
+    double bin_ms = 0.0; // Clipping, setup and binning
+    double raster_ms = 0.0; // Rasterization and shading of every tile
+};
+
+class SoftwareRasterizer // Keeps its scratch buffers between frames; not thread-safe, one instance per view
+{
+public:
+    // Render into image (Format_RGB32, allocated by the caller; its size is the viewport)
+    void render(const SoftwareFrame &frame, QImage &image, SoftwareFrameStats &stats);
+
+private:
+    struct SetupTriangle // Screen-space triangle after clipping, ready for any tile it overlaps
+    {
+        std::array<float, 3> x{}; // Pixel coordinates (y down), ordered so that every edge function is positive inside
+        std::array<float, 3> y{};
+        std::array<float, 3> z{}; // Window depth in [0, 1]
+        std::array<float, 3> inv_w{}; // Perspective-correct interpolation
+        std::uint32_t draw = 0; // Index into the frame's draws
+        std::uint32_t triangle = 0; // Triangle of the draw's mesh
+        std::uint32_t corners = 0xFFFFFFFFu; // Barycentrics of the corners in the source triangle (index into JobBins::corners), or none
+        std::uint32_t edge_mask = 7; // Edges opposite each corner that belong to the source triangle (wireframe)
+        std::array<std::int32_t, 4> bounds{}; // Covered pixel range: x0, y0, x1, y1 (inclusive)
+    };
+
+    struct JobBins // Output of one binning job; merged in job order, so ids match a serial pass
+    {
+        std::vector<SetupTriangle> triangles;
+        std::vector<std::array<glm::vec3, 3>> corners; // Source barycentrics of clipped triangle corners
+        std::vector<std::vector<std::uint32_t>> tiles; // Per tile: indices into triangles, in submission order
+        std::size_t clipped = 0;
+    };
+
+    struct DrawSetup // Per-draw transforms
+    {
+        glm::mat4 model_view_projection{1.0f};
+        glm::mat3 normal_matrix{1.0f};
+        std::size_t first_vertex = 0; // Offset of the draw's vertices in clip_positions_
+        std::size_t first_triangle = 0; // Offset of the draw's triangles in the frame
+    };
+
+    struct alignas(16) TileBuffer // Visibility buffer of the tile a raster job works on
+    {
+        std::array<float, kSoftwareTileSize * kSoftwareTileSize> depth{};
+        std::array<std::uint32_t, kSoftwareTileSize * kSoftwareTileSize> ids{};
+    };
+
+    void transform_vertices(const SoftwareFrame &frame);
+    void bin_triangles(const SoftwareFrame &frame, int width, int height);
+    void setup_triangle(JobBins &bins, std::uint32_t draw, std::uint32_t triangle, const std::array<glm::vec4, 3> &clip,
+                        const std::array<glm::vec3, 3> &corners, std::uint32_t edge_mask, bool clipped, int width, int height);
+    void rasterize_tile(std::size_t tile, TileBuffer &buffer) const;
+    void resolve_tile(std::size_t tile, const TileBuffer &buffer, const SoftwareFrame &frame, int width, int height) const;
+    [[nodiscard]] const SetupTriangle &triangle_of(std::uint32_t id, const std::array<glm::vec3, 3> *&corners) const;
+
+    std::vector<DrawSetup> draw_setups_;
+    std::vector<glm::vec4> clip_positions_; // Every vertex of every draw, in draw order
+    std::vector<JobBins> job_bins_;
+    std::vector<std::uint32_t> job_first_ids_; // Global id of each job's first triangle
+    std::vector<std::size_t> tile_order_; // Tiles by decreasing bin size (raster jobs take them in this order)
+    std::vector<TileBuffer> tile_buffers_; // One per raster job
+    LightClusters clusters_; // Lit frames only
+    glm::vec2 cluster_depth_scale_bias_{0.0f};
+    int tiles_x_ = 0;
+    int tiles_y_ = 0;
+    std::size_t vertex_count_ = 0; // Vertices of every draw of the frame
+    std::size_t triangle_count_ = 0; // Triangles of every draw of the frame
+    std::uint8_t *pixels_ = nullptr; // Image rows of the frame being rendered (detached before the jobs start)
+    qsizetype bytes_per_line_ = 0;
+};
+
+
+#endif //SOFTWARE_RASTERIZER_H // End include guard
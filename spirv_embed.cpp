@@ -0,0 +1,127 @@
+// Build tool: compiles every stage of shader_sources.cpp to SPIR-V with glslangValidator and writes a C++ file defining
+// embedded_spirv() with the modules as word arrays. A stage that fails to compile fails the build. Without a compiler
+// the generated table is empty and the application compiles the GLSL at run time.
+//
+// Usage: spirv_embed <output.cpp> <work directory> [glslangValidator]
+
+#include "shader_sources.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace // Anonymous namespace holding file helpers
+{
+const char *stage_extension(const ShaderStageKind kind) // glslangValidator picks the stage from the extension
+{
+    switch (kind)
+    {
+    case ShaderStageKind::Fragment: return "frag";
+    case ShaderStageKind::Compute: return "comp";
+    case ShaderStageKind::Geometry: return "geom";
+    default: return "vert";
+    }
+}
+
+std::string stage_text(const ShaderStageSource &stage)
+{
+    std::string text;
+    for (const char *snippet : stage.sources)
+    {
+        text += snippet == kSpecializationSource ? specialization_source(true, kAllColorModes) : snippet; // constant_id layouts
+    }
+    return text;
+}
+
+std::string quoted(const std::filesystem::path &path)
+{
+    return "\"" + path.string() + "\"";
+}
+
+bool read_words(const std::filesystem::path &path, std::vector<std::uint32_t> &words)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    const std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.empty() || bytes.size() % 4 != 0) return false;
+    words.resize(bytes.size() / 4);
+    std::memcpy(words.data(), bytes.data(), bytes.size()); // Modules are written in host byte order
+    return true;
+}
+}
+
+int main(const int argc, char **argv)
+{
+    if (argc != 3 && argc != 4)
+    {
+        std::cerr << "usage: spirv_embed <output.cpp> <work directory> [glslangValidator]\n";
+        return 2;
+    }
+    const std::filesystem::path output = argv[1];
+    const std::filesystem::path work_directory = argv[2];
+    const bool compile = argc == 4;
+    std::filesystem::create_directories(work_directory);
+
+    std::ostringstream modules; // Word arrays
+    std::ostringstream table; // Program, stage and words of every module
+    std::size_t module_count = 0;
+    for (std::size_t program(0); compile && program < static_cast<std::size_t>(ShaderProgramId::Count); program++)
+    {
+        const ShaderProgramSource &source = shader_program_source(static_cast<ShaderProgramId>(program));
+        for (std::size_t stage(0); stage < source.stages.size(); stage++)
+        {
+            const std::string stem = std::string(source.name) + "_" + std::to_string(stage);
+            const std::filesystem::path glsl_path = work_directory / (stem + "." + stage_extension(source.stages[stage].kind));
+            const std::filesystem::path spirv_path = work_directory / (stem + ".spv");
+            {
+                std::ofstream glsl(glsl_path, std::ios::binary | std::ios::trunc);
+                glsl << stage_text(source.stages[stage]);
+            }
+
+            std::string command = quoted(argv[3]) + " -G -o " + quoted(spirv_path) + " " + quoted(glsl_path); // -G: OpenGL SPIR-V
+#ifdef _WIN32
+            command = "\"" + command + "\""; // cmd.exe strips the outer pair of quotes
+#endif
+            std::vector<std::uint32_t> words;
+            if (std::system(command.c_str()) != 0 || !read_words(spirv_path, words))
+            {
+                std::cerr << "spirv_embed: stage " << stage << " of program " << source.label << " failed to compile (" << glsl_path.string() << ")\n";
+                return 1;
+            }
+
+            modules << "const std::uint32_t k_" << stem << "[] = {";
+            for (std::size_t i(0); i < words.size(); i++) modules << (i % 8 == 0 ? "\n    " : " ") << words[i] << "u,";
+            modules << "\n};\n\n";
+            table << "    EmbeddedModule{" << program << ", " << stage << ", k_" << stem << "},\n";
+            module_count++;
+        }
+    }
+
+    std::ostringstream code;
+    code << "// Generated by spirv_embed from shader_sources.cpp. Do not edit.\n"
+         << "#include \"shader_sources.h\"\n\n#include <array>\n\n"
+         << "namespace\n{\n"
+         << "struct EmbeddedModule\n{\n    std::size_t program;\n    std::size_t stage;\n    std::span<const std::uint32_t> words;\n};\n\n"
+         << modules.str()
+         << "const std::array<EmbeddedModule, " << module_count << "> kModules{\n" << table.str() << "};\n}\n\n"
+         << "std::span<const std::uint32_t> embedded_spirv(const ShaderProgramId program, const std::size_t stage)\n{\n"
+         << "    for (const EmbeddedModule &module : kModules)\n    {\n"
+         << "        if (module.program == static_cast<std::size_t>(program) && module.stage == stage) return module.words;\n    }\n"
+         << "    return {};\n}\n";
+
+    std::ofstream file(output, std::ios::binary | std::ios::trunc);
+    file << code.str();
+    if (!file)
+    {
+        std::cerr << "spirv_embed: cannot write " << output.string() << "\n";
+        return 1;
+    }
+    std::cout << "spirv_embed: " << module_count << " SPIR-V modules embedded\n";
+    return 0;
+}
@@ -0,0 +1,604 @@
+#include "texture_compression.h"
+
+#include "disk_cache.h"
+#include "frame_jobs.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TEXTURE_COMPRESSION_SSE2 1 // Palette distances four entries at a time
+#endif
+
+namespace // Anonymous namespace holding the block encoders and the cache format
+{
+constexpr std::size_t kMinBlocksPerJob = 256; // Below this a job costs more to schedule than to encode
+constexpr DiskCache kTextureCache{"textures", ".tex", {'T', 'X', 'C', '2'}, 2, "texture"}; // Bump the version when an encoder changes
+constexpr std::array<std::uint32_t, 16> kBc7Weights{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64}; // 4-bit index weights (of 64)
+
+using Color = std::array<float, 4>; // RGBA in 0..255
+using Block = std::array<std::array<std::int16_t, 4>, 16>; // 4x4 texels in row order
+using BlockIndices = std::array<std::uint8_t, 16>;
+
+struct BlockPalette // Up to 16 decoded colors an index may select
+{
+    std::size_t size = 0;
+    std::array<std::array<std::int16_t, 4>, 16> colors{};
+};
+
+Block read_block(const TextureMip &level, const int block_x, const int block_y, const bool keep_alpha)
+{
+    Block block{};
+    for (int y(0); y < 4; y++)
+    {
+        const int source_y = std::min(block_y * 4 + y, level.height - 1); // Edge texels repeat into partial blocks
+        for (int x(0); x < 4; x++)
+        {
+            const int source_x = std::min(block_x * 4 + x, level.width - 1);
+            const std::uint8_t *texel = level.data.data() + (static_cast<std::size_t>(source_y) * level.width + source_x) * 4;
+            block[y * 4 + x] = {texel[0], texel[1], texel[2], static_cast<std::int16_t>(keep_alpha ? texel[3] : 0)};
+        }
+    }
+    return block;
+}
+
+// Index of the closest palette entry per texel (squared RGBA distance) and the summed error
+std::uint32_t nearest_indices(const Block &block, const BlockPalette &palette, BlockIndices &indices)
+{
+    std::uint32_t total = 0;
+#ifdef TEXTURE_COMPRESSION_SSE2
+    const std::size_t groups = (palette.size + 3) / 4;
+    __m128i red_green[4]; // Four entries per register as interleaved 16-bit pairs
+    __m128i blue_alpha[4];
+    for (std::size_t group(0); group < groups; group++)
+    {
+        alignas(16) std::array<std::int16_t, 8> rg{};
+        alignas(16) std::array<std::int16_t, 8> ba{};
+        for (std::size_t lane(0); lane < 4; lane++)
+        {
+            const auto &color = palette.colors[std::min(group * 4 + lane, palette.size - 1)]; // Padding repeats the last entry; it never wins a tie
+            rg[lane * 2] = color[0];
+            rg[lane * 2 + 1] = color[1];
+            ba[lane * 2] = color[2];
+            ba[lane * 2 + 1] = color[3];
+        }
+        red_green[group] = _mm_load_si128(reinterpret_cast<const __m128i*>(rg.data()));
+        blue_alpha[group] = _mm_load_si128(reinterpret_cast<const __m128i*>(ba.data()));
+    }
+    for (std::size_t texel(0); texel < block.size(); texel++)
+    {
+        const auto &color = block[texel];
+        const __m128i texel_rg = _mm_set1_epi32(color[0] | color[1] << 16);
+        const __m128i texel_ba = _mm_set1_epi32(color[2] | color[3] << 16);
+        std::uint32_t best = std::numeric_limits<std::uint32_t>::max();
+        for (std::size_t group(0); group < groups; group++)
+        {
+            const __m128i rg = _mm_sub_epi16(red_green[group], texel_rg);
+            const __m128i ba = _mm_sub_epi16(blue_alpha[group], texel_ba);
+            alignas(16) std::array<std::uint32_t, 4> distances{};
+            _mm_store_si128(reinterpret_cast<__m128i*>(distances.data()), _mm_add_epi32(_mm_madd_epi16(rg, rg), _mm_madd_epi16(ba, ba)));
+            for (std::size_t lane(0); lane < 4; lane++)
+            {
+                if (distances[lane] < best)
+                {
+                    best = distances[lane];
+                    indices[texel] = static_cast<std::uint8_t>(group * 4 + lane);
+                }
+            }
+        }
+        total += best;
+    }
+#else
+    for (std::size_t texel(0); texel < block.size(); texel++)
+    {
+        std::uint32_t best = std::numeric_limits<std::uint32_t>::max();
+        for (std::size_t entry(0); entry < palette.size; entry++)
+        {
+            std::uint32_t distance = 0;
+            for (std::size_t channel(0); channel < 4; channel++)
+            {
+                const int delta = palette.colors[entry][channel] - block[texel][channel];
+                distance += static_cast<std::uint32_t>(delta * delta);
+            }
+            if (distance < best)
+            {
+                best = distance;
+                indices[texel] = static_cast<std::uint8_t>(entry);
+            }
+        }
+        total += best;
+    }
+#endif
+    return total;
+}
+
+// Ends of the block's principal axis: the mean plus the extreme projections onto the dominant covariance direction
+void principal_endpoints(const Block &block, const std::size_t channels, Color &first, Color &second)
+{
+    Color mean{};
+    for (const auto &texel : block)
+    {
+        for (std::size_t c(0); c < channels; c++) mean[c] += texel[c];
+    }
+    for (float &value : mean) value /= static_cast<float>(block.size());
+
+    std::array<std::array<float, 4>, 4> covariance{};
+    for (const auto &texel : block)
+    {
+        for (std::size_t i(0); i < channels; i++)
+        {
+            for (std::size_t j(0); j < channels; j++) covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+        }
+    }
+
+    Color axis{1.0f, 1.0f, 1.0f, channels == 4 ? 1.0f : 0.0f};
+    for (int iteration(0); iteration < 8; iteration++) // Power iteration converges quickly for 3x3/4x4 matrices
+    {
+        Color next{};
+        for (std::size_t i(0); i < channels; i++)
+        {
+            for (std::size_t j(0); j < channels; j++) next[i] += covariance[i][j] * axis[j];
+        }
+        const float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2] + next[3] * next[3]);
+        if (length < 1e-6f) break; // Flat block: keep the previous direction, the projections collapse to the mean anyway
+        for (std::size_t c(0); c < 4; c++) axis[c] = next[c] / length;
+    }
+
+    float low = std::numeric_limits<float>::max();
+    float high = std::numeric_limits<float>::lowest();
+    for (const auto &texel : block)
+    {
+        float t = 0.0f;
+        for (std::size_t c(0); c < channels; c++) t += (texel[c] - mean[c]) * axis[c];
+        low = std::min(low, t);
+        high = std::max(high, t);
+    }
+    for (std::size_t c(0); c < 4; c++)
+    {
+        first[c] = std::clamp(mean[c] + axis[c] * low, 0.0f, 255.0f);
+        second[c] = std::clamp(mean[c] + axis[c] * high, 0.0f, 255.0f);
+    }
+}
+
+// Least-squares endpoints for fixed indices: texel = (1 - w) * first + w * second, w read from weights[index]
+bool refine_endpoints(const Block &block, const BlockIndices &indices, const std::span<const float> weights, Color &first, Color &second)
+{
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    Color ax{}, bx{};
+    for (std::size_t texel(0); texel < block.size(); texel++)
+    {
+        const float w = weights[indices[texel]];
+        const float v = 1.0f - w;
+        aa += v * v;
+        ab += v * w;
+        bb += w * w;
+        for (std::size_t c(0); c < 4; c++)
+        {
+            ax[c] += v * block[texel][c];
+            bx[c] += w * block[texel][c];
+        }
+    }
+    const float determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) < 1e-6f) return false; // Every texel picked the same weight
+    for (std::size_t c(0); c < 4; c++)
+    {
+        first[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+        second[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+std::uint16_t pack_565(const Color &color)
+{
+    const auto r = static_cast<std::uint16_t>(std::lround(color[0] * 31.0f / 255.0f));
+    const auto g = static_cast<std::uint16_t>(std::lround(color[1] * 63.0f / 255.0f));
+    const auto b = static_cast<std::uint16_t>(std::lround(color[2] * 31.0f / 255.0f));
+    return static_cast<std::uint16_t>(r << 11 | g << 5 | b);
+}
+
+std::array<std::int16_t, 4> unpack_565(const std::uint16_t packed)
+{
+    const int r = packed >> 11 & 31;
+    const int g = packed >> 5 & 63;
+    const int b = packed & 31;
+    return {static_cast<std::int16_t>(r << 3 | r >> 2), static_cast<std::int16_t>(g << 2 | g >> 4), static_cast<std::int16_t>(b << 3 | b >> 2), 0};
+}
+
+struct ColorBlock // Candidate BC1 color block
+{
+    std::uint16_t color0 = 0;
+    std::uint16_t color1 = 0;
+    BlockIndices indices{};
+    std::uint32_t error = std::numeric_limits<std::uint32_t>::max();
+};
+
+ColorBlock fit_color_block(const Block &block, const Color &first, const Color &second)
+{
+    ColorBlock candidate;
+    candidate.color0 = pack_565(first);
+    candidate.color1 = pack_565(second);
+    if (candidate.color0 < candidate.color1) std::swap(candidate.color0, candidate.color1); // color0 > color1 selects 4-color mode
+    BlockPalette palette;
+    const auto end0 = unpack_565(candidate.color0);
+    const auto end1 = unpack_565(candidate.color1);
+    palette.colors[0] = end0;
+    palette.colors[1] = end1;
+    palette.size = 1; // Equal ends decode as 3-color mode with transparent black at index 3: use index 0 only
+    if (candidate.color0 != candidate.color1)
+    {
+        palette.size = 4;
+        for (std::size_t c(0); c < 3; c++)
+        {
+            palette.colors[2][c] = static_cast<std::int16_t>((2 * end0[c] + end1[c] + 1) / 3);
+            palette.colors[3][c] = static_cast<std::int16_t>((end0[c] + 2 * end1[c] + 1) / 3);
+        }
+    }
+    candidate.error = nearest_indices(block, palette, candidate.indices);
+    return candidate;
+}
+
+// BC1 color block (also the color half of BC3): principal axis fit, then one least-squares refinement
+void encode_color_block(const Block &block, std::uint8_t *out)
+{
+    Color first{}, second{};
+    principal_endpoints(block, 3, first, second);
+    ColorBlock best = fit_color_block(block, first, second);
+    constexpr std::array<float, 4> weights{0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f}; // Share of color1 per index
+    if (best.color0 != best.color1)
+    {
+        const auto end0 = unpack_565(best.color0);
+        const auto end1 = unpack_565(best.color1);
+        for (std::size_t c(0); c < 3; c++)
+        {
+            first[c] = end0[c];
+            second[c] = end1[c];
+        }
+        if (refine_endpoints(block, best.indices, weights, first, second))
+        {
+            const ColorBlock refined = fit_color_block(block, first, second);
+            if (refined.error < best.error) best = refined;
+        }
+    }
+
+    std::uint32_t bits = 0;
+    for (std::size_t texel(0); texel < block.size(); texel++) bits |= static_cast<std::uint32_t>(best.indices[texel]) << (texel * 2);
+    out[0] = static_cast<std::uint8_t>(best.color0);
+    out[1] = static_cast<std::uint8_t>(best.color0 >> 8);
+    out[2] = static_cast<std::uint8_t>(best.color1);
+    out[3] = static_cast<std::uint8_t>(best.color1 >> 8);
+    for (std::size_t byte(0); byte < 4; byte++) out[4 + byte] = static_cast<std::uint8_t>(bits >> (byte * 8));
+}
+
+// BC3 alpha half: the block's alpha range in 8-value mode with 3-bit indices
+void encode_alpha_block(const TextureMip &level, const int block_x, const int block_y, std::uint8_t *out)
+{
+    std::array<int, 16> alpha{};
+    for (int y(0); y < 4; y++)
+    {
+        for (int x(0); x < 4; x++)
+        {
+            const int source_x = std::min(block_x * 4 + x, level.width - 1);
+            const int source_y = std::min(block_y * 4 + y, level.height - 1);
+            alpha[y * 4 + x] = level.data[(static_cast<std::size_t>(source_y) * level.width + source_x) * 4 + 3];
+        }
+    }
+    const auto [low, high] = std::ranges::minmax(alpha);
+    std::array<int, 8> palette{high, low};
+    for (int k(1); k < 7; k++) palette[k + 1] = ((7 - k) * high + k * low + 3) / 7;
+
+    std::uint64_t bits = 0;
+    if (high != low) // Equal ends: every index 0
+    {
+        for (std::size_t texel(0); texel < alpha.size(); texel++)
+        {
+            std::size_t best = 0;
+            for (std::size_t entry(1); entry < palette.size(); entry++)
+            {
+                if (std::abs(palette[entry] - alpha[texel]) < std::abs(palette[best] - alpha[texel])) best = entry;
+            }
+            bits |= static_cast<std::uint64_t>(best) << (texel * 3);
+        }
+    }
+    out[0] = static_cast<std::uint8_t>(high);
+    out[1] = static_cast<std::uint8_t>(low);
+    for (std::size_t byte(0); byte < 6; byte++) out[2 + byte] = static_cast<std::uint8_t>(bits >> (byte * 8));
+}
+
+struct Bc7Endpoint // 7-bit RGBA plus the shared low bit of mode 6
+{
+    std::array<std::uint8_t, 4> color{};
+    std::uint8_t p_bit = 0;
+
+    [[nodiscard]] std::array<std::int16_t, 4> decoded() const
+    {
+        return {static_cast<std::int16_t>(color[0] << 1 | p_bit), static_cast<std::int16_t>(color[1] << 1 | p_bit),
+                static_cast<std::int16_t>(color[2] << 1 | p_bit), static_cast<std::int16_t>(color[3] << 1 | p_bit)};
+    }
+};
+
+Bc7Endpoint quantize_bc7_endpoint(const Color &color)
+{
+    Bc7Endpoint best;
+    float best_error = std::numeric_limits<float>::max();
+    for (std::uint8_t p_bit(0); p_bit < 2; p_bit++) // Both low bits, keep the closer one
+    {
+        Bc7Endpoint candidate;
+        candidate.p_bit = p_bit;
+        float error = 0.0f;
+        for (std::size_t c(0); c < 4; c++)
+        {
+            candidate.color[c] = static_cast<std::uint8_t>(std::clamp(std::lround((color[c] - p_bit) * 0.5f), 0L, 127L));
+            const float delta = static_cast<float>(candidate.color[c] << 1 | p_bit) - color[c];
+            error += delta * delta;
+        }
+        if (error < best_error)
+        {
+            best_error = error;
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+struct Bc7Candidate
+{
+    Bc7Endpoint end0;
+    Bc7Endpoint end1;
+    BlockIndices indices{};
+    std::uint32_t error = std::numeric_limits<std::uint32_t>::max();
+};
+
+Bc7Candidate fit_bc7_block(const Block &block, const Color &first, const Color &second)
+{
+    Bc7Candidate candidate;
+    candidate.end0 = quantize_bc7_endpoint(first);
+    candidate.end1 = quantize_bc7_endpoint(second);
+    const auto end0 = candidate.end0.decoded();
+    const auto end1 = candidate.end1.decoded();
+    BlockPalette palette;
+    palette.size = kBc7Weights.size();
+    for (std::size_t entry(0); entry < palette.size; entry++)
+    {
+        const auto weight = static_cast<int>(kBc7Weights[entry]);
+        for (std::size_t c(0); c < 4; c++) palette.colors[entry][c] = static_cast<std::int16_t>(((64 - weight) * end0[c] + weight * end1[c] + 32) >> 6);
+    }
+    candidate.error = nearest_indices(block, palette, candidate.indices);
+    return candidate;
+}
+
+class BitWriter // Little-endian bit stream over one 16-byte block
+{
+public:
+    explicit BitWriter(std::uint8_t *out) : out_(out) { std::fill_n(out_, 16, std::uint8_t{0}); }
+    void put(const std::uint32_t value, const std::size_t count)
+    {
+        for (std::size_t bit(0); bit < count; bit++, position_++)
+        {
+            if (value >> bit & 1u) out_[position_ / 8] |= static_cast<std::uint8_t>(1u << (position_ % 8));
+        }
+    }
+
+private:
+    std::uint8_t *out_;
+    std::size_t position_ = 0;
+};
+
+// BC7 mode 6: one RGBA subset, 7-bit endpoints with a low bit each and 4-bit indices. A single mode keeps the encoder
+// fast; it covers opaque and translucent blocks alike.
+void encode_bc7_block(const Block &block, std::uint8_t *out)
+{
+    Color first{}, second{};
+    principal_endpoints(block, 4, first, second);
+    Bc7Candidate best = fit_bc7_block(block, first, second);
+    std::array<float, 16> weights{};
+    std::ranges::transform(kBc7Weights, weights.begin(), [](const std::uint32_t weight) { return static_cast<float>(weight) / 64.0f; });
+    const auto end0 = best.end0.decoded();
+    const auto end1 = best.end1.decoded();
+    for (std::size_t c(0); c < 4; c++)
+    {
+        first[c] = end0[c];
+        second[c] = end1[c];
+    }
+    if (refine_endpoints(block, best.indices, weights, first, second))
+    {
+        const Bc7Candidate refined = fit_bc7_block(block, first, second);
+        if (refined.error < best.error) best = refined;
+    }
+
+    if (best.indices[0] >= 8) // The anchor index is stored without its top bit: swap the ends so it is clear
+    {
+        std::swap(best.end0, best.end1);
+        for (std::uint8_t &index : best.indices) index = static_cast<std::uint8_t>(15 - index);
+    }
+
+    BitWriter writer(out);
+    writer.put(1u << 6, 7); // Mode 6
+    for (std::size_t c(0); c < 4; c++)
+    {
+        writer.put(best.end0.color[c], 7);
+        writer.put(best.end1.color[c], 7);
+    }
+    writer.put(best.end0.p_bit, 1);
+    writer.put(best.end1.p_bit, 1);
+    writer.put(best.indices[0], 3);
+    for (std::size_t texel(1); texel < best.indices.size(); texel++) writer.put(best.indices[texel], 4);
+}
+
+QByteArray texture_cache_key(const QString &path, const TextureCompression compression)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return {};
+    QCryptographicHash hash(QCryptographicHash::Sha1); // Image content, so renamed or copied files still hit
+    if (!hash.addData(&file)) return {};
+    for (const qint64 value : {static_cast<qint64>(compression), static_cast<qint64>(kTextureCache.version)})
+    {
+        hash.addData(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    return hash.result().toHex();
+}
+
+// Payload: format, level count, then width, height, byte count and blocks of every level (32-bit little endian)
+std::optional<DecodedTexture> load_cached_texture(const QByteArray &key)
+{
+    const auto payload = load_disk_cache_entry(kTextureCache, key);
+    if (!payload) return std::nullopt; // Not encoded yet (or damaged)
+
+    const QByteArray &data = *payload;
+    std::size_t cursor = 0;
+    const auto read_word = [&](std::uint32_t &value)
+    {
+        if (cursor + sizeof(value) > static_cast<std::size_t>(data.size())) return false;
+        std::memcpy(&value, data.constData() + cursor, sizeof(value));
+        cursor += sizeof(value);
+        return true;
+    };
+    const auto damaged = [&]
+    {
+        warn_damaged_disk_cache_entry(kTextureCache, key);
+        return std::nullopt;
+    };
+
+    std::uint32_t format = 0, level_count = 0;
+    if (!read_word(format) || !read_word(level_count) || format > static_cast<std::uint32_t>(TextureFormat::Bc7) || level_count == 0 || level_count > 32)
+    {
+        return damaged();
+    }
+
+    DecodedTexture texture;
+    texture.format = static_cast<TextureFormat>(format);
+    texture.mips.resize(level_count);
+    for (std::uint32_t level(0); level < level_count; level++)
+    {
+        std::uint32_t width = 0, height = 0, bytes = 0;
+        if (!read_word(width) || !read_word(height) || !read_word(bytes) || width == 0 || height == 0 || width > 65536 || height > 65536 ||
+            bytes != texture_level_bytes(texture.format, static_cast<int>(width), static_cast<int>(height), 0) ||
+            cursor + bytes > static_cast<std::size_t>(data.size()))
+        {
+            return damaged();
+        }
+        TextureMip &mip = texture.mips[level];
+        mip.width = static_cast<int>(width);
+        mip.height = static_cast<int>(height);
+        mip.data.assign(data.constData() + cursor, data.constData() + cursor + bytes);
+        cursor += bytes;
+    }
+    if (cursor != static_cast<std::size_t>(data.size())) return damaged();
+    return texture;
+}
+
+void store_cached_texture(const QByteArray &key, const DecodedTexture &texture)
+{
+    QByteArray data;
+    const auto append_word = [&data](const std::uint32_t value) { data.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    append_word(static_cast<std::uint32_t>(texture.format));
+    append_word(static_cast<std::uint32_t>(texture.mips.size()));
+    for (const TextureMip &mip : texture.mips)
+    {
+        append_word(static_cast<std::uint32_t>(mip.width));
+        append_word(static_cast<std::uint32_t>(mip.height));
+        append_word(static_cast<std::uint32_t>(mip.data.size()));
+        data.append(reinterpret_cast<const char*>(mip.data.data()), static_cast<qsizetype>(mip.data.size()));
+    }
+    store_disk_cache_entry(kTextureCache, key, data);
+}
+}
+
+DecodedTexture compress_texture(DecodedTexture texture, const TextureCompression compression)
+{
+    if (compression == TextureCompression::Off || texture.format != TextureFormat::Rgba8 || texture.mips.empty()) return texture;
+    const TextureMip &base = texture.mips.front();
+    if (!std::has_single_bit(static_cast<unsigned>(base.width)) || !std::has_single_bit(static_cast<unsigned>(base.height)))
+    {
+        return texture; // Non power-of-two chains would have levels that are neither whole blocks nor smaller than one
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    TextureFormat format = TextureFormat::Bc7;
+    if (compression == TextureCompression::Bc1Bc3)
+    {
+        bool translucent = false;
+        for (std::size_t i(3); i < base.data.size() && !translucent; i += 4) translucent = base.data[i] != 255;
+        format = translucent ? TextureFormat::Bc3 : TextureFormat::Bc1;
+    }
+    const std::size_t block_bytes = format == TextureFormat::Bc1 ? 8 : 16;
+
+    std::vector<std::size_t> first_block(texture.mips.size() + 1, 0); // Blocks of every level numbered back to back
+    std::vector<TextureMip> encoded(texture.mips.size());
+    for (std::size_t level(0); level < texture.mips.size(); level++)
+    {
+        const TextureMip &mip = texture.mips[level];
+        const std::size_t blocks = static_cast<std::size_t>((mip.width + 3) / 4) * ((mip.height + 3) / 4);
+        first_block[level + 1] = first_block[level] + blocks;
+        encoded[level].width = mip.width;
+        encoded[level].height = mip.height;
+        encoded[level].data.resize(blocks * block_bytes);
+    }
+
+    const std::size_t block_count = first_block.back();
+    const std::size_t jobs = frame_job_count(block_count, kMinBlocksPerJob);
+    run_background_jobs(jobs, block_count, [&](std::size_t, const std::size_t begin, const std::size_t end)
+    {
+        std::size_t level = static_cast<std::size_t>(std::ranges::upper_bound(first_block, begin) - first_block.begin()) - 1;
+        for (std::size_t block(begin); block < end; block++)
+        {
+            while (block >= first_block[level + 1]) level++;
+            const TextureMip &mip = texture.mips[level];
+            const int blocks_per_row = (mip.width + 3) / 4;
+            const auto local = static_cast<int>(block - first_block[level]);
+            const int block_x = local % blocks_per_row;
+            const int block_y = local / blocks_per_row;
+            std::uint8_t *out = encoded[level].data.data() + static_cast<std::size_t>(local) * block_bytes;
+            switch (format)
+            {
+            case TextureFormat::Bc1:
+                encode_color_block(read_block(mip, block_x, block_y, false), out);
+                break;
+            case TextureFormat::Bc3:
+                encode_alpha_block(mip, block_x, block_y, out);
+                encode_color_block(read_block(mip, block_x, block_y, false), out + 8);
+                break;
+            default:
+                encode_bc7_block(read_block(mip, block_x, block_y, true), out);
+                break;
+            }
+        }
+    });
+
+    texture.format = format;
+    texture.mips = std::move(encoded);
+    texture.encode_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    texture.encode_jobs = jobs;
+    return texture;
+}
+
+DecodedTexture load_texture(const QString &path, const TextureCompression compression)
+{
+    if (compression == TextureCompression::Off) return decode_texture(path);
+
+    const auto start = std::chrono::steady_clock::now();
+    const QByteArray key = texture_cache_key(path, compression);
+    if (!key.isEmpty())
+    {
+        if (auto cached = load_cached_texture(key))
+        {
+            cached->from_cache = true;
+            cached->decode_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); // Hash and read
+            return std::move(*cached);
+        }
+    }
+
+    DecodedTexture texture = compress_texture(decode_texture(path), compression);
+    if (!key.isEmpty() && texture.format != TextureFormat::Rgba8) store_cached_texture(key, texture); // Uncompressed chains are cheap to rebuild
+    return texture;
+}
@@ -0,0 +1,25 @@
+#ifndef TEXTURE_COMPRESSION_H // Guard against multiple inclusion
+#define TEXTURE_COMPRESSION_H // Begin include guard
+
+#include "texture_streaming.h" // Decoded mip chains and their storage formats
+
+#include <QString> // Image paths
+
+enum class TextureCompression : int // Import option: block format applied to decoded textures
+{
+    Off = 0, // Keep RGBA8
+    Bc1Bc3 = 1, // BC1 for opaque images, BC3 as soon as one texel is translucent
+    Bc7 = 2 // BC7 for every image (same size as BC3, better quality)
+};
+
+// Encode every level of an RGBA8 chain to the block format chosen by compression. Blocks of all levels are split into
+// contiguous ranges encoded in parallel by the frame job pool. Images whose sides are not powers of two stay RGBA8, so
+// every level of the chain (and every base the streamer may pick) is a whole number of blocks or smaller than one.
+[[nodiscard]] DecodedTexture compress_texture(DecodedTexture texture, TextureCompression compression);
+
+// Worker-thread entry point: the compressed chain from the disk cache when the image content was encoded before,
+// otherwise decode_texture followed by compress_texture, storing the result in the cache.
+[[nodiscard]] DecodedTexture load_texture(const QString &path, TextureCompression compression);
+
+
+#endif //TEXTURE_COMPRESSION_H // End include guard
@@ -0,0 +1,231 @@
+#include "texture_streaming.h"
+
+#include <QImage>
+#include <QImageReader>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+
+namespace // Anonymous namespace holding colour conversion and planner helpers
+{
+const std::array<float, 256> &srgb_to_linear_table()
+{
+    static const std::array<float, 256> table = []
+    {
+        std::array<float, 256> values{};
+        for (std::size_t i(0); i < values.size(); i++)
+        {
+            const float c = static_cast<float>(i) / 255.0f;
+            values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return values;
+    }();
+    return table;
+}
+
+std::uint8_t linear_to_srgb(const float value)
+{
+    const float c = std::clamp(value, 0.0f, 1.0f);
+    const float encoded = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    return static_cast<std::uint8_t>(std::lround(encoded * 255.0f));
+}
+
+TextureMip downsample(const TextureMip &source)
+{
+    const auto &to_linear = srgb_to_linear_table();
+    TextureMip level;
+    level.width = std::max(1, source.width / 2);
+    level.height = std::max(1, source.height / 2);
+    level.data.resize(static_cast<std::size_t>(level.width) * level.height * 4);
+    for (int y(0); y < level.height; y++)
+    {
+        const int y0 = std::min(2 * y, source.height - 1);
+        const int y1 = std::min(2 * y + 1, source.height - 1); // Odd sizes repeat the last row
+        for (int x(0); x < level.width; x++)
+        {
+            const int x0 = std::min(2 * x, source.width - 1);
+            const int x1 = std::min(2 * x + 1, source.width - 1);
+            const std::array<std::size_t, 4> texels{(static_cast<std::size_t>(y0) * source.width + x0) * 4,
+                                                    (static_cast<std::size_t>(y0) * source.width + x1) * 4,
+                                                    (static_cast<std::size_t>(y1) * source.width + x0) * 4,
+                                                    (static_cast<std::size_t>(y1) * source.width + x1) * 4};
+            const std::size_t out = (static_cast<std::size_t>(y) * level.width + x) * 4;
+            for (std::size_t channel(0); channel < 3; channel++) // Colour is averaged in linear light, then re-encoded
+            {
+                float sum = 0.0f;
+                for (const std::size_t texel : texels) sum += to_linear[source.data[texel + channel]];
+                level.data[out + channel] = linear_to_srgb(sum * 0.25f);
+            }
+            unsigned alpha = 0; // Alpha is linear already
+            for (const std::size_t texel : texels) alpha += source.data[texel + 3];
+            level.data[out + 3] = static_cast<std::uint8_t>((alpha + 2) / 4);
+        }
+    }
+    return level;
+}
+
+std::size_t level_extent(const int size, const std::uint32_t level)
+{
+    return static_cast<std::size_t>(std::max(1, size >> std::min<std::uint32_t>(level, 31)));
+}
+}
+
+DecodedTexture decode_texture(const QString &path)
+{
+    const auto start = std::chrono::steady_clock::now();
+    DecodedTexture decoded;
+    QImageReader reader(path);
+    reader.setAutoTransform(true); // Honour EXIF orientation
+    const QImage image = reader.read().convertToFormat(QImage::Format_RGBA8888);
+    if (image.isNull())
+    {
+        decoded.error = reader.errorString();
+        return decoded;
+    }
+
+    TextureMip base;
+    base.width = image.width();
+    base.height = image.height();
+    base.data.resize(static_cast<std::size_t>(base.width) * base.height * 4);
+    const std::size_t row_bytes = static_cast<std::size_t>(base.width) * 4;
+    for (int y(0); y < base.height; y++) // GL rows start at the bottom, where OBJ puts v = 0
+    {
+        const uchar *row = image.constScanLine(base.height - 1 - y);
+        std::copy(row, row + row_bytes, base.data.begin() + static_cast<std::ptrdiff_t>(y * row_bytes));
+    }
+
+    decoded.mips.push_back(std::move(base));
+    while (decoded.mips.back().width > 1 || decoded.mips.back().height > 1) // Full chain down to 1x1
+    {
+        decoded.mips.push_back(downsample(decoded.mips.back()));
+    }
+    decoded.decode_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return decoded;
+}
+
+const char *texture_format_name(const TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::Bc1: return "BC1";
+    case TextureFormat::Bc3: return "BC3";
+    case TextureFormat::Bc7: return "BC7";
+    default: return "RGBA8";
+    }
+}
+
+std::size_t texture_level_bytes(const TextureFormat format, const int width, const int height, const std::uint32_t level)
+{
+    const std::size_t level_width = level_extent(width, level);
+    const std::size_t level_height = level_extent(height, level);
+    if (format == TextureFormat::Rgba8) return level_width * level_height * 4;
+    const std::size_t blocks = (level_width + 3) / 4 * ((level_height + 3) / 4); // Partial blocks at the edges are stored whole
+    return blocks * (format == TextureFormat::Bc1 ? 8 : 16);
+}
+
+std::size_t texture_resident_bytes(const TextureFormat format, const int width, const int height, const std::uint32_t level_count,
+                                   const std::uint32_t resident_level)
+{
+    std::size_t bytes = 0;
+    for (std::uint32_t level(resident_level); level < level_count; level++) bytes += texture_level_bytes(format, width, height, level);
+    return bytes;
+}
+
+std::uint32_t wanted_mip_level(const TextureResidency &texture, const float screen_pixels)
+{
+    if (texture.level_count == 0) return 0;
+    const std::uint32_t coarsest = texture.level_count - 1;
+    if (screen_pixels <= 1.0f) return coarsest;
+    const float ratio = static_cast<float>(std::max(texture.width, texture.height)) / screen_pixels; // Texels per pixel at level 0
+    if (ratio <= 1.0f) return 0; // Magnified: full detail
+    return std::min(coarsest, static_cast<std::uint32_t>(std::floor(std::log2(ratio)))); // Never coarser than the screen needs
+}
+
+std::uint32_t base_mip_level(const TextureResidency &texture, const std::uint32_t min_resident_size)
+{
+    std::uint32_t level = 0;
+    while (level + 1 < texture.level_count &&
+           std::max(level_extent(texture.width, level), level_extent(texture.height, level)) > min_resident_size)
+    {
+        level++;
+    }
+    return level;
+}
+
+std::vector<ResidencyChange> plan_texture_residency(const std::span<const TextureResidency> textures, const std::size_t budget_bytes,
+                                                    const std::size_t max_upload_bytes, const std::uint32_t min_resident_size)
+{
+    std::vector<std::uint32_t> levels(textures.size()); // Planned resident level per texture
+    std::vector<std::uint32_t> base_levels(textures.size()); // Eviction floor per texture
+    std::size_t total = 0;
+    for (std::size_t i(0); i < textures.size(); i++)
+    {
+        levels[i] = textures[i].resident_level;
+        base_levels[i] = base_mip_level(textures[i], min_resident_size);
+        total += texture_resident_bytes(textures[i].format, textures[i].width, textures[i].height, textures[i].level_count, levels[i]);
+    }
+
+    // Victim for a texture used at tick `user_tick`: unneeded detail first, then the least recently used
+    const auto evict_one = [&](const std::size_t keep, const std::uint64_t user_tick)
+    {
+        std::size_t victim = textures.size();
+        for (std::size_t i(0); i < textures.size(); i++)
+        {
+            if (i == keep || textures[i].level_count == 0 || levels[i] >= base_levels[i]) continue;
+            const bool unneeded = levels[i] < textures[i].wanted_level;
+            if (!unneeded && textures[i].last_used >= user_tick) continue; // As recent as the requester: not evictable for it
+            if (victim == textures.size()) { victim = i; continue; }
+            const bool victim_unneeded = levels[victim] < textures[victim].wanted_level;
+            if (unneeded != victim_unneeded ? unneeded : textures[i].last_used < textures[victim].last_used) victim = i;
+        }
+        if (victim == textures.size()) return false;
+        total -= texture_level_bytes(textures[victim].format, textures[victim].width, textures[victim].height, levels[victim]);
+        levels[victim]++; // Drop the finest level
+        return true;
+    };
+
+    while (total > budget_bytes && evict_one(textures.size(), ~std::uint64_t{0})) {} // Budget was lowered or textures were added
+
+    std::vector<std::size_t> requests; // Textures that want finer detail
+    for (std::size_t i(0); i < textures.size(); i++)
+    {
+        if (textures[i].level_count > 0 && textures[i].wanted_level < levels[i]) requests.push_back(i);
+    }
+    std::ranges::sort(requests, [&](const std::size_t a, const std::size_t b)
+    {
+        if (textures[a].last_used != textures[b].last_used) return textures[a].last_used > textures[b].last_used;
+        return levels[a] - textures[a].wanted_level > levels[b] - textures[b].wanted_level;
+    });
+
+    std::size_t uploaded = 0;
+    for (const std::size_t i : requests)
+    {
+        const std::size_t cost = texture_level_bytes(textures[i].format, textures[i].width, textures[i].height, levels[i] - 1);
+        if (uploaded > 0 && uploaded + cost > max_upload_bytes) break; // Always allow one level, even a large one
+        const std::vector<std::uint32_t> saved_levels = levels; // Evictions are undone if they cannot make enough room
+        const std::size_t saved_total = total;
+        bool fits = true;
+        while (total + cost > budget_bytes)
+        {
+            if (!evict_one(i, textures[i].last_used)) { fits = false; break; }
+        }
+        if (!fits)
+        {
+            levels = saved_levels;
+            total = saved_total;
+            continue;
+        }
+        levels[i]--;
+        total += cost;
+        uploaded += cost;
+    }
+
+    std::vector<ResidencyChange> changes;
+    for (std::size_t i(0); i < textures.size(); i++)
+    {
+        if (levels[i] != textures[i].resident_level) changes.push_back({i, levels[i]});
+    }
+    return changes;
+}
@@ -0,0 +1,77 @@
+#ifndef TEXTURE_STREAMING_H // Guard against multiple inclusion
+#define TEXTURE_STREAMING_H // Begin include guard
+
+#include <QString> // Image paths and decode errors
+
+#include <cstddef> // Byte counts
+#include <cstdint> // Level indices and LRU ticks
+#include <span> // Non-owning view over the planner input
+#include <vector> // Mip chains and planned changes
+
+enum class TextureFormat : std::uint32_t // Storage of the mip levels (values are stored in the compressed texture cache)
+{
+    Rgba8 = 0, // Uncompressed, 4 bytes per texel
+    Bc1 = 1, // Opaque RGB, 8 bytes per 4x4 block
+    Bc3 = 2, // RGB block plus interpolated alpha block, 16 bytes per 4x4 block
+    Bc7 = 3 // High-quality RGBA, 16 bytes per 4x4 block
+};
+
+struct TextureMip // One level of a decoded texture: tightly packed texels, or 4x4 blocks in row order
+{
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint8_t> data;
+};
+
+struct DecodedTexture // Output of a worker-thread decode
+{
+    TextureFormat format = TextureFormat::Rgba8; // Layout of every level's data
+    std::vector<TextureMip> mips; // Level 0 is full resolution, the last level is 1x1
+    double decode_ms = 0.0; // Image decode plus mip generation
+    double encode_ms = 0.0; // Block compression (0 when uncompressed or loaded from the cache)
+    std::size_t encode_jobs = 0; // Jobs the blocks were split into
+    bool from_cache = false; // Compressed levels read from the disk cache; the image itself was not decoded
+    QString error; // Empty on success
+};
+
+// Decode an image file to RGBA8 and build its full mip chain with a 2x2 box filter that averages in linear light.
+// Touches no GL or GUI state, so it runs on worker threads.
+[[nodiscard]] DecodedTexture decode_texture(const QString &path);
+
+[[nodiscard]] const char *texture_format_name(TextureFormat format); // "RGBA8", "BC1", ... (HUD and log)
+[[nodiscard]] std::size_t texture_level_bytes(TextureFormat format, int width, int height, std::uint32_t level); // Bytes of one level
+[[nodiscard]] std::size_t texture_resident_bytes(TextureFormat format, int width, int height, std::uint32_t level_count,
+                                                 std::uint32_t resident_level); // Levels resident_level..last
+
+struct TextureResidency // Streaming state of one texture as seen by the planner
+{
+    TextureFormat format = TextureFormat::Rgba8; // Level sizes depend on it
+    int width = 0; // Level 0 size
+    int height = 0;
+    std::uint32_t level_count = 0; // Levels of the full chain (0 until decoded)
+    std::uint32_t resident_level = 0; // Finest level in GPU memory; every coarser level is resident too
+    std::uint32_t wanted_level = 0; // Finest level the views currently need
+    std::uint64_t last_used = 0; // Streaming tick in which a view last needed the texture (LRU order)
+};
+
+struct ResidencyChange // New finest resident level of one texture
+{
+    std::size_t texture = 0;
+    std::uint32_t resident_level = 0;
+};
+
+// Level whose larger side best matches screen_pixels (texture assumed to cover the object once)
+[[nodiscard]] std::uint32_t wanted_mip_level(const TextureResidency &texture, float screen_pixels);
+
+// Coarsest level that is never evicted: the first one whose larger side fits min_resident_size
+[[nodiscard]] std::uint32_t base_mip_level(const TextureResidency &texture, std::uint32_t min_resident_size);
+
+// One streaming step. Textures move at most one level per step, so detail arrives coarse to fine: the most recently used
+// first, then the largest shortfall. A step that would exceed budget_bytes first evicts finest levels from textures
+// that no longer need them, then from the least recently used ones (never below the base level). Uploads stop once
+// max_upload_bytes were planned; a texture that cannot make room is skipped until the next step.
+[[nodiscard]] std::vector<ResidencyChange> plan_texture_residency(std::span<const TextureResidency> textures, std::size_t budget_bytes,
+                                                                  std::size_t max_upload_bytes, std::uint32_t min_resident_size);
+
+
+#endif //TEXTURE_STREAMING_H // End include guard
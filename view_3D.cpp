@@ -1,18 +1,45 @@
 #include "view_3D.h"
 
+#include "frame_jobs.h"
+#include "frame_renderer.h"
+#include "program_cache.h"
+#include "render_surface.h"
+#include "shader_reload.h"
+
 #include <QDebug>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QMutexLocker>
+#include <QOpenGLContext>
+#include <QOpenGLPaintDevice>
+#include <QPainter>
+#include <QPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <QVBoxLayout>
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
+#include "mesh_simplify.h"
+
 #include <glm/gtc/matrix_inverse.hpp>
 
 #include <algorithm>
+#include <bit>
+#include <chrono>
 #include <cmath>
 #include <limits>
+#include <map>
+#include <numeric>
 #include <ranges>
 #include <string>
+#include <utility>
 
 namespace // Anonymous namespace holding file-level constants for scene layout
 {
@@ -20,48 +47,418 @@ constexpr float kGroundPlaneY = -2.0f + 0.15f; // Height of ground plane relativ
 constexpr float kGroundExtent = 12.0f; // Half-extent of ground plane cube
 constexpr float kMinObjectScale = 0.25f; // Clamp for minimum object scale factor
 constexpr float kMaxObjectScale = 8.0f; // Clamp for maximum object scale factor
+constexpr float kNearPlane = 0.1f; // Perspective near plane (also the first cluster slice)
+constexpr float kFarPlane = 100.0f; // Perspective far plane (also the last cluster slice)
+constexpr std::size_t kDefaultLightCount = 128; // Demo lights of a new scene
+constexpr int kShadowAtlasSize = 2048; // Shadow atlas resolution per axis (one light-space projection over the ground)
+constexpr int kShadowTilesPerSide = 8; // Atlas tiles per axis; an edit re-renders only the tiles under the caster
+constexpr std::uint64_t kAllShadowTiles = ~std::uint64_t{0}; // One bit per tile (8 x 8)
+constexpr float kShadowHalfExtent = 18.0f; // Half-size of the light-space box: the ground plus a margin for overhangs
+constexpr GLuint kShadowAtlasUnit = 2; // Texture unit of the atlas (units 0 and 1 belong to the resolve pass)
+constexpr GLuint kMaterialTextureUnit = 3; // First unit of the material texture slots (matches the shaders)
+constexpr std::size_t kMaterialTextureSlots = 12; // Distinct diffuse textures per scene (sampler array size in the shaders)
+constexpr std::size_t kTextureStreamBytesPerStep = std::size_t{8} << 20; // Level uploads planned per streaming step
+constexpr std::uint32_t kMinResidentTextureSize = 64; // Levels up to this size are never evicted (drawn while finer ones stream)
+
+constexpr GLuint kVertexPoolBinding = 0; // SSBO binding of the vertex pool (matches the vertex shader)
+constexpr GLuint kIndexPoolBinding = 1; // SSBO binding of the index pool (read by the visibility resolve)
+constexpr GLuint kDrawRecordBinding = 2; // SSBO binding of the per-draw records
+constexpr GLuint kCullObjectBinding = 3; // SSBO binding of the culling inputs
+constexpr GLuint kDrawCommandBinding = 4; // SSBO binding of the indirect commands written by the cull shader
+constexpr GLuint kDrawCountBinding = 5; // SSBO binding of the atomic draw counter
+constexpr GLuint kFrameFirstIndexBinding = 6; // SSBO binding of the per-record LOD offsets chosen this frame
+constexpr GLuint kPositionPoolBinding = 7; // SSBO binding of the position-only stream (depth pre-pass)
+constexpr GLuint kLightBinding = 8; // SSBO binding of the scene lights (lit shading)
+constexpr GLuint kLightClusterBinding = 9; // SSBO binding of the per-cluster light ranges
+constexpr GLuint kLightIndexBinding = 10; // SSBO binding of the clustered light index lists
+constexpr GLuint kPointPageBinding = 11; // SSBO binding of the point cloud pages
+constexpr GLuint kPointDrawBinding = 12; // SSBO binding of the per-page placement and spacing
+constexpr GLuint kBonePaletteBinding = 13; // SSBO binding of the bone matrices of rigged meshes
+constexpr GLuint kCullWorkgroupSize = 64; // local_size_x of the cull shader
+constexpr GLenum kParameterBuffer = 0x80EE; // GL_PARAMETER_BUFFER_ARB (GL_ARB_indirect_parameters)
+constexpr GLenum kCompressedRgbS3tcDxt1 = 0x83F0; // GL_COMPRESSED_RGB_S3TC_DXT1_EXT (BC1, GL_EXT_texture_compression_s3tc)
+constexpr GLenum kCompressedRgbaS3tcDxt5 = 0x83F3; // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT (BC3)
+constexpr GLenum kShaderBinaryFormatSpirV = 0x9551; // GL_SHADER_BINARY_FORMAT_SPIR_V (GL 4.6, GL_ARB_gl_spirv)
+constexpr GLenum kCompletionStatus = 0x91B1; // GL_COMPLETION_STATUS_KHR/_ARB (parallel shader compile)
+constexpr GLuint kGroundRecord = 0; // Draw record of the ground cube
+constexpr GLuint kGroundEdgeRecord = 1; // Draw record of the ground outline
+constexpr std::size_t kFirstObjectRecord = 2; // Draw record of the first imported object
+constexpr std::size_t kFirstObjectCullObject = 1; // Cull object of the first imported object (the outline has none)
+constexpr std::size_t kMinRecordsPerJob = 512; // Smallest record-packing range worth a worker (matrix inverse per object)
+constexpr std::size_t kMinCullObjectsPerJob = 2048; // Smallest culling range worth a worker (a few dot products per object)
+const glm::vec3 kLodPixelThresholds{160.0f, 80.0f, 40.0f}; // Projected radius (px) below which LOD 1, 2, 3 are used
+constexpr std::size_t kPointPageSize = 1024; // Points per cache page (16 KB); a node takes ceil(count / size) pages
+constexpr std::size_t kPointSparePages = 64; // Pages beyond budget * 5/4 (partly filled last pages of small nodes)
+constexpr std::size_t kPointUploadsPerFrame = std::size_t{2} << 20; // Points streamed per frame; parents draw until children arrive
+constexpr float kPointMinSpacingPixels = 1.0f; // Children are only selected while the node's spacing covers a pixel or more
+constexpr GLuint kDrawIdAttribute = 0; // Attribute location of the instanced draw_id
+constexpr GLsizeiptr kInitialPoolBytes = 1 << 20; // First allocation of each geometry pool (grows by doubling)
+constexpr GLuint kEmptyVisibilityId = 0xFFFFFFFFu; // Clear value of the id target (never a valid draw/triangle pair)
+constexpr double kPrepassEnableOverdraw = 1.5; // Auto pre-pass turns on above this many fragments per pixel
+constexpr double kPrepassDisableOverdraw = 1.2; // ...and off below this one (hysteresis avoids flip-flopping)
+constexpr float kMinRenderScale = 0.5f; // Lowest resolution scale per axis (a quarter of the pixels)
+constexpr float kRenderScaleStep = 0.05f; // Scale granularity; also the step used when scaling back up
+constexpr double kGovernorTarget = 0.9; // Scaling down aims at this fraction of the budget
+constexpr double kGovernorScaleUpHeadroom = 0.75; // Scale up one step only below this fraction of the budget
+constexpr double kGovernorSamplesUpHeadroom = 0.45; // Doubling MSAA can double the cost, so require more room
+constexpr double kLatencyAverageWeight = 0.1; // Weight of a new sample in the running input latency averages
+constexpr std::uint64_t kInstanceTickSpread = 37; // Clock ticks between consecutive instances of one rigged file (no lockstep)
+constexpr auto kAnimationStepNs = static_cast<std::int64_t>(kAnimationStepSeconds * 1.0e9); // Real-time clock tick length
+
+View::Backend default_view_backend = View::Backend::Widget; // Changed by main.cpp before the window is built
+
+// Monotonic timestamp shared by both threads (input stamps and frame presentation)
+std::int64_t monotonic_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Taken during static initialization, before main: the reference of the time-to-first-frame report
+const std::int64_t process_start_ns = monotonic_ns();
+
+// Gribb/Hartmann plane extraction; planes are normalized so sphere tests can use the radius directly
+std::array<glm::vec4, 6> extract_frustum_planes(const glm::mat4 &m)
+{
+    const auto row = [&m](const int i) { return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]); };
+    std::array<glm::vec4, 6> planes{
+        row(3) + row(0), row(3) - row(0), // Left, right
+        row(3) + row(1), row(3) - row(1), // Bottom, top
+        row(3) + row(2), row(3) - row(2)  // Near, far
+    };
+    for (auto &plane : planes)
+    {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return planes;
+}
+
+// GL storage format of a mip chain format
+GLenum texture_internal_format(const TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::Bc1: return kCompressedRgbS3tcDxt1;
+    case TextureFormat::Bc3: return kCompressedRgbaS3tcDxt5;
+    case TextureFormat::Bc7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    default: return GL_RGBA8;
+    }
+}
+
+// GL shader type of a stage of the shared sources
+GLenum shader_stage_type(const ShaderStageKind kind)
+{
+    switch (kind)
+    {
+    case ShaderStageKind::Fragment: return GL_FRAGMENT_SHADER;
+    case ShaderStageKind::Compute: return GL_COMPUTE_SHADER;
+    case ShaderStageKind::Geometry: return GL_GEOMETRY_SHADER;
+    default: return GL_VERTEX_SHADER;
+    }
+}
+
+// Color modes a specialized forward/resolve program may meet: the objects' mode, plus Uniform for the outline and for
+// the ground outside Lit mode
+std::uint32_t color_mode_variant_mask(const View::ColorMode mode)
+{
+    return (1u << static_cast<std::uint32_t>(mode)) | (1u << static_cast<std::uint32_t>(View::ColorMode::Uniform));
+}
+
+QString shader_directory; // --shader-dir; empty: no hot reload
+QPointer<ShaderReload> shader_reload_instance; // Created with the first view, owned by the application
+
+// Process-wide watcher of the shader directory (null when hot reload is off)
+ShaderReload *shader_reload()
+{
+    if (!shader_reload_instance && !shader_directory.isEmpty())
+    {
+        shader_reload_instance = new ShaderReload(shader_directory, QCoreApplication::instance());
+    }
+    return shader_reload_instance.data();
+}
+
+// Direction towards the sun, the only shadowed light
+glm::vec3 sun_to_light()
+{
+    return glm::normalize(glm::vec3(0.4f, 1.0f, 0.3f));
 }
 
-View::View(QWidget *parent) : QOpenGLWidget(parent)
+// Fixed light-space projection of the sun. It does not follow the camera, so orbiting never invalidates the atlas
+const glm::mat4 &shadow_view_projection()
+{
+    static const glm::mat4 matrix = []
+    {
+        const glm::mat4 view = glm::lookAt(sun_to_light() * 60.0f, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        return glm::ortho(-kShadowHalfExtent, kShadowHalfExtent, -kShadowHalfExtent, kShadowHalfExtent, 1.0f, 120.0f) * view;
+    }();
+    return matrix;
+}
+
+// Atlas tiles a bounding sphere can cast into (one bit per tile, row-major from the bottom-left)
+std::uint64_t shadow_tiles_of(const glm::vec3 &center, const float radius)
+{
+    const glm::vec4 clip = shadow_view_projection() * glm::vec4(center, 1.0f); // Orthographic: w stays 1
+    const float ndc_radius = radius / kShadowHalfExtent; // Same scale on both axes
+    if (clip.x + ndc_radius < -1.0f || clip.x - ndc_radius > 1.0f || clip.y + ndc_radius < -1.0f || clip.y - ndc_radius > 1.0f) return 0;
+
+    const auto tile = [](const float ndc)
+    {
+        const float index = std::floor((ndc * 0.5f + 0.5f) * static_cast<float>(kShadowTilesPerSide));
+        return static_cast<int>(std::clamp(index, 0.0f, static_cast<float>(kShadowTilesPerSide - 1)));
+    };
+    std::uint64_t tiles = 0;
+    for (int y = tile(clip.y - ndc_radius); y <= tile(clip.y + ndc_radius); y++)
+        for (int x = tile(clip.x - ndc_radius); x <= tile(clip.x + ndc_radius); x++) tiles |= std::uint64_t{1} << (y * kShadowTilesPerSide + x);
+    return tiles;
+}
+
+// MSAA samples of the scene target requested by an anti-aliasing option (FXAA works on a single-sample target)
+int anti_aliasing_samples(const View::AntiAliasing mode)
+{
+    switch (mode)
+    {
+        case View::AntiAliasing::Msaa2: return 2;
+        case View::AntiAliasing::Msaa4: return 4;
+        case View::AntiAliasing::Msaa8: return 8;
+        case View::AntiAliasing::Msaa1:
+        case View::AntiAliasing::Fxaa: return 1;
+    }
+    return 1;
+}
+
+// Option an MSAA sample count corresponds to (the governor may run below the selected level)
+View::AntiAliasing msaa_option(const int samples)
+{
+    if (samples >= 8) return View::AntiAliasing::Msaa8;
+    if (samples >= 4) return View::AntiAliasing::Msaa4;
+    if (samples >= 2) return View::AntiAliasing::Msaa2;
+    return View::AntiAliasing::Msaa1;
+}
+}
+
+View::View(QWidget *parent, const Backend backend, View *share_scene_with) : QWidget(parent), backend_(backend)
 {
     setMinimumSize(400, 300);
     setFocusPolicy(Qt::StrongFocus);
     setMouseTracking(true);
+    animation_start_ns_ = monotonic_ns(); // Tick 0 of the real-time animation clock
+
+    if (share_scene_with) // Pools and objects are reused through the shared contexts (Qt::AA_ShareOpenGLContexts)
+    {
+        scene_ = share_scene_with->scene_;
+        settings_ = share_scene_with->settings_;
+        threaded_rendering_ = share_scene_with->threaded_rendering_; // Started by initializeGL
+    }
+    else
+    {
+        scene_ = std::make_shared<SharedScene>();
+        scene_->lights = make_demo_lights(kDefaultLightCount, kGroundExtent, kGroundPlaneY);
+    }
+    scene_->views.push_back(this);
+    if (ShaderReload *reload = shader_reload()) // Edited shader files reach the renderer with the next snapshot
+    {
+        connect(reload, &ShaderReload::changed, this, [this] { request_frame(); });
+    }
+
+    if (backend_ == Backend::Software)
+    {
+        surface_ = new SoftwareRenderSurface(this);
+        hud_font_ = QFontDatabase::systemFont(QFontDatabase::FixedFont); // initializeGL never runs on this backend
+        if (!scene_->software_cube) scene_->software_cube = std::make_shared<const SoftwareMesh>(make_software_cube());
+    }
+    else if (backend_ == Backend::Window)
+    {
+        auto *window = new WindowRenderSurface(this);
+        connect(window, &QOpenGLWindow::frameSwapped, this, &View::on_frame_swapped); // After swapBuffers of each frame
+        surface_ = window;
+    }
+    else
+    {
+        widget_surface_ = new WidgetRenderSurface(this);
+        surface_ = widget_surface_;
+
+        // Render thread hand-shakes; these signals are emitted on the GUI thread in both rendering modes
+        connect(widget_surface_, &QOpenGLWidget::aboutToCompose, this, [this] { lock_renderer(false); }); // Do not compose a half-drawn frame
+        connect(widget_surface_, &QOpenGLWidget::frameSwapped, this, &View::on_frame_swapped);
+        connect(widget_surface_, &QOpenGLWidget::aboutToResize, this, [this] { lock_renderer(true); }); // The framebuffer is recreated with our context
+        connect(widget_surface_, &QOpenGLWidget::resized, this, [this]
+        {
+            if (!renderer_) return;
+            // resizeEvent still calls makeCurrent() and resizeGL() after this signal, so release the context once it returns
+            QMetaObject::invokeMethod(this, [this] { unlock_renderer(); request_frame(); }, Qt::QueuedConnection);
+        });
+    }
+
+    auto *layout = new QVBoxLayout(this); // The surface fills the view, so event positions match view coordinates
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(surface_->surface_widget());
+}
+
+void View::set_shader_directory(const QString &directory)
+{
+    shader_directory = directory;
+}
+
+void View::set_default_backend(const Backend backend)
+{
+    default_view_backend = backend;
+}
+
+View::Backend View::default_backend()
+{
+    return default_view_backend;
 }
 
 View::~View()
 {
-    makeCurrent();    // Make this widget's OpenGL context current; required so GL calls below operate on the right context
+    stop_render_thread(); // The context must be back on the GUI thread before anything below
 
-    delete_imported_objects();
+    std::erase(scene_->views, this); // Views still sharing the scene keep its objects and pools
+    surface_->make_current();    // Make the surface's OpenGL context current; required so GL calls below operate on the right context
+
+    if (scene_->views.empty() && surface_->gl_initialized()) // Last view of the scene releases the shared pools
+    {
+        delete_imported_objects();
 
-    /* If a vertex buffer (VBO) was created (non-zero ID), delete it from GPU memory to free VRAM
-       Then reset its handle to 0 (the “no buffer” default value). */
-    if (vertex_buffer_object) glDeleteBuffers(1, &vertex_buffer_object); vertex_buffer_object = 0;
-    /* If a vertex array object (VAO) exists, delete it to release GPU state resources.
+        /* If a geometry pool buffer was created (non-zero ID), delete it from GPU memory to free VRAM
+           Then reset its handle to 0 (the “no buffer” default value). */
+        if (scene_->vertex_pool_buffer) glDeleteBuffers(1, &scene_->vertex_pool_buffer); scene_->vertex_pool_buffer = 0;
+        if (scene_->position_pool_buffer) glDeleteBuffers(1, &scene_->position_pool_buffer); scene_->position_pool_buffer = 0;
+        if (scene_->index_pool_buffer) glDeleteBuffers(1, &scene_->index_pool_buffer); scene_->index_pool_buffer = 0;
+    }
+    if (draw_record_buffer_) glDeleteBuffers(1, &draw_record_buffer_); draw_record_buffer_ = 0;
+    if (draw_id_buffer_) glDeleteBuffers(1, &draw_id_buffer_); draw_id_buffer_ = 0;
+    if (indirect_buffer_) glDeleteBuffers(1, &indirect_buffer_); indirect_buffer_ = 0;
+    if (cull_object_buffer_) glDeleteBuffers(1, &cull_object_buffer_); cull_object_buffer_ = 0;
+    if (draw_count_buffer_) glDeleteBuffers(1, &draw_count_buffer_); draw_count_buffer_ = 0;
+    if (frame_first_index_buffer_) glDeleteBuffers(1, &frame_first_index_buffer_); frame_first_index_buffer_ = 0;
+    if (light_buffer_) glDeleteBuffers(1, &light_buffer_); light_buffer_ = 0;
+    if (light_cluster_buffer_) glDeleteBuffers(1, &light_cluster_buffer_); light_cluster_buffer_ = 0;
+    if (light_index_buffer_) glDeleteBuffers(1, &light_index_buffer_); light_index_buffer_ = 0;
+    if (bone_palette_buffer_) glDeleteBuffers(1, &bone_palette_buffer_); bone_palette_buffer_ = 0;
+    if (shadow_indirect_buffer_) glDeleteBuffers(1, &shadow_indirect_buffer_); shadow_indirect_buffer_ = 0;
+    if (shadow_framebuffer_) glDeleteFramebuffers(1, &shadow_framebuffer_); shadow_framebuffer_ = 0;
+    if (shadow_atlas_texture_) glDeleteTextures(1, &shadow_atlas_texture_); shadow_atlas_texture_ = 0;
+    if (fallback_texture_) glDeleteTextures(1, &fallback_texture_); fallback_texture_ = 0;
+    release_point_pages(); // Point cloud page cache
+    if (point_draw_buffer_) glDeleteBuffers(1, &point_draw_buffer_); point_draw_buffer_ = 0;
+    if (point_indirect_buffer_) glDeleteBuffers(1, &point_indirect_buffer_); point_indirect_buffer_ = 0;
+    release_capture_slots(); // Capture ring (frames still in flight are written first)
+    destroy_render_target(visibility_target_); // Id target of the visibility path
+    destroy_scene_target(); // Offscreen scene color/depth (all MSAA levels)
+    destroy_render_target(post_target_); // FXAA output before upscaling
+    for (auto &queries : query_frames_) // HUD occlusion and timer queries
+    {
+        if (queries.geometry) glDeleteQueries(1, &queries.geometry); queries.geometry = 0;
+        if (queries.resolve) glDeleteQueries(1, &queries.resolve); queries.resolve = 0;
+        if (queries.gpu_time) glDeleteQueries(1, &queries.gpu_time); queries.gpu_time = 0;
+    }
+    /* If the global vertex array object (VAO) exists, delete it to release GPU state resources.
        Reset the handle to 0 to mark it invalid/unused. */
     if (vertex_array_object) glDeleteVertexArrays(1, &vertex_array_object); vertex_array_object = 0;
-    if (edge_vertex_buffer_object) glDeleteBuffers(1, &edge_vertex_buffer_object); edge_vertex_buffer_object = 0;
-    if (edge_vertex_array_object) glDeleteVertexArrays(1, &edge_vertex_array_object); edge_vertex_array_object = 0;
     /* If the shader program was successfully created, delete it from the GPU.
        Reset to 0 to indicate no active program is bound to this object anymore. */
-    if (shader_program_id) glDeleteProgram(shader_program_id); shader_program_id = 0;
-
-    doneCurrent();    // Release the current OpenGL context; Qt’s cleanup convention after finishing GL operations
+    for (const PendingProgram &pending : pending_programs_) glDeleteProgram(pending.program); // Still compiling
+    pending_programs_.clear();
+    const auto delete_variant = [this](ShadingVariant &variant) // shader_program_id and resolve_program_id_ point into these
+    {
+        if (variant.forward) glDeleteProgram(variant.forward);
+        if (variant.resolve) glDeleteProgram(variant.resolve);
+        variant = {};
+    };
+    delete_variant(generic_shading_);
+    for (ShadingVariant &variant : shading_variants_) delete_variant(variant);
+    shader_program_id = 0;
+    if (cull_program_id_) glDeleteProgram(cull_program_id_); cull_program_id_ = 0;
+    if (visibility_program_id_) glDeleteProgram(visibility_program_id_); visibility_program_id_ = 0;
+    resolve_program_id_ = 0;
+    if (depth_prepass_program_id_) glDeleteProgram(depth_prepass_program_id_); depth_prepass_program_id_ = 0;
+    if (fxaa_program_id_) glDeleteProgram(fxaa_program_id_); fxaa_program_id_ = 0;
+    if (wireframe_program_id_) glDeleteProgram(wireframe_program_id_); wireframe_program_id_ = 0;
+    if (point_program_id_) glDeleteProgram(point_program_id_); point_program_id_ = 0;
+
+    surface_->done_current();    // Release the current OpenGL context; Qt’s cleanup convention after finishing GL operations
 }
 
 void View::initializeGL()
 {
-    initializeOpenGLFunctions();    // Enables 4.5 core entry points via QOpenGLFunctions_4_5_Core
+    if (!initializeOpenGLFunctions()) // Enables 4.5 core entry points via QOpenGLFunctions_4_5_Core
+    {
+        qWarning() << "OpenGL 4.5 core functions are unavailable; nothing will be drawn (run with --backend software)";
+        return; // main.cpp probes for this and picks the software backend, so this only happens on drivers that lied to the probe
+    }
+    gl_functions_ = true;
 
     glEnable(GL_DEPTH_TEST);   // Enable depth test
     glEnable(GL_MULTISAMPLE);   // Emable multisampling
     glClearColor(0.10f, 0.10f, 0.12f, 1.0f);    // Set the background color for the next frame (dark blue-gray)
 
+    GLint binary_formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binary_formats);
+    program_binaries_ = binary_formats > 0;
+    for (const GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) // Binaries are only valid for the driver that produced them
+    {
+        driver_identity_ += reinterpret_cast<const char*>(glGetString(name));
+        driver_identity_ += "\n";
+    }
+    const QOpenGLContext *context = surface_->gl_context();
+    const QSurfaceFormat format = context->format();
+    if (format.majorVersion() > 4 || (format.majorVersion() == 4 && format.minorVersion() >= 6)) // Core since 4.6; the extension adds a suffix
+    {
+        specialize_shader_ = reinterpret_cast<SpecializeShader>(context->getProcAddress("glSpecializeShader"));
+    }
+    else if (context->hasExtension(QByteArrayLiteral("GL_ARB_gl_spirv")))
+    {
+        specialize_shader_ = reinterpret_cast<SpecializeShader>(context->getProcAddress("glSpecializeShaderARB"));
+    }
+    MaxShaderCompilerThreads max_shader_compiler_threads = nullptr; // Same entry point under both extension names
+    if (context->hasExtension(QByteArrayLiteral("GL_KHR_parallel_shader_compile")))
+    {
+        max_shader_compiler_threads = reinterpret_cast<MaxShaderCompilerThreads>(context->getProcAddress("glMaxShaderCompilerThreadsKHR"));
+    }
+    else if (context->hasExtension(QByteArrayLiteral("GL_ARB_parallel_shader_compile")))
+    {
+        max_shader_compiler_threads = reinterpret_cast<MaxShaderCompilerThreads>(context->getProcAddress("glMaxShaderCompilerThreadsARB"));
+    }
+    if (max_shader_compiler_threads)
+    {
+        max_shader_compiler_threads(0xFFFFFFFFu); // Implementation-chosen thread count; compiles no longer block the caller
+        shader_stats_.parallel_compile = true;
+    }
+    if (const ShaderReload *reload = shader_reload()) // Startup programs already use the edited files
+    {
+        shader_overrides_ = reload->overrides();
+        shader_stats_.revision = reload->revision();
+    }
+
+    QElapsedTimer shader_timer;
+    shader_timer.start();
     setup_shaders();
     setup_geometry();
+    setup_culling();
+    startup_.shader_ms = static_cast<double>(shader_timer.nsecsElapsed()) / 1.0e6; // Geometry setup is a few tiny uploads
+    qInfo().nospace() << "Shader programs ready in " << startup_.shader_ms << " ms: " << startup_.programs.cached << " from the binary cache, "
+                      << startup_.programs.compiled << " compiled (" << startup_.programs.spirv << " from SPIR-V, "
+                      << startup_.programs.rejected << " cached binaries rejected)";
+    s3tc_supported_ = surface_->gl_context()->hasExtension(QByteArrayLiteral("GL_EXT_texture_compression_s3tc")); // BC1/BC3 upload
+
+    for (auto &queries : query_frames_) // Samples-passed and timer queries feeding the HUD and the resolution governor
+    {
+        glGenQueries(1, &queries.geometry);
+        glGenQueries(1, &queries.resolve);
+        glGenQueries(1, &queries.gpu_time);
+    }
+    glGetIntegerv(GL_MAX_SAMPLES, &max_samples_); // MSAA now lives in the scene target, not in the widget format
+    max_samples_ = std::max(1, max_samples_);
+    preferred_samples_ = std::min(anti_aliasing_samples(frame_.settings.anti_aliasing), max_samples_); // Later changes arrive with snapshots
+    scene_samples_ = preferred_samples_;
+
+    hud_font_ = QFontDatabase::systemFont(QFontDatabase::FixedFont); // Columns of numbers stay aligned
+    swap_interval_ = surface_->gl_context()->format().swapInterval(); // What the platform granted (HUD)
 
-    view_matrix = build_view_matrix(); // Initial camera
+    if (threaded_rendering_) // Enabled before the widget was shown; start once initialization has returned
+    {
+        QMetaObject::invokeMethod(this, [this] { start_render_thread(); }, Qt::QueuedConnection);
+    }
 }
 
 glm::mat4 View::build_view_matrix() const
@@ -84,67 +481,269 @@ void View::emit_camera_state()
 void View::update_projection(const int w, const int h)
 {
     const float aspect = h > 0 ? static_cast<float>(w)/static_cast<float>(h) : 1.0f; // Safe aspect ratio computation
-    projection = glm::perspective(glm::radians(45.0f), aspect, 0.1f, 100.0f); // Rebuild perspective projection to match viewport
+    projection = glm::perspective(glm::radians(45.0f), aspect, kNearPlane, kFarPlane); // Rebuild perspective projection to match viewport
 }
 
 void View::resizeGL(const int w, const int h)
 {
-    glViewport(0,0,w,h); // Update GL viewport to new widget dimensions
+    if (gl_functions_) glViewport(0,0,w,h); // Update GL viewport to new widget dimensions
     update_projection(w,h); // Refresh projection matrix for updated aspect ratio
+    device_pixel_ratio_ = devicePixelRatioF();
+    framebuffer_width_ = std::max(1, static_cast<int>(std::lround(w * device_pixel_ratio_))); // Offscreen targets match the real framebuffer
+    framebuffer_height_ = std::max(1, static_cast<int>(std::lround(h * device_pixel_ratio_)));
 }
 
 void View::paintGL()
 {
+    if (!gl_functions_) return; // initializeGL failed: leave the surface as the platform cleared it
+    publish_snapshot(); // Same hand-over as the render thread, consumed right away
+    render_frame();
+}
+
+void View::paint_software(QPainter &painter)
+{
+    publish_snapshot(); // Same hand-over as paintGL
+    render_software(software_image_);
+    software_image_.setDevicePixelRatio(device_pixel_ratio_); // Rendered at framebuffer resolution, drawn at widget size
+    painter.drawImage(QPoint(0, 0), software_image_);
+    if (frame_.settings.hud_visible) paint_hud(painter);
+    on_frame_swapped(); // No swap to wait for: Qt flushes the widget's backing store right after paintEvent
+}
+
+void View::render_software(QImage &image)
+{
+    QElapsedTimer frame_timer; // CPU cost of this frame for the HUD
+    frame_timer.start();
+    consume_snapshot();
+    if (image.width() != framebuffer_width_ || image.height() != framebuffer_height_ || image.format() != QImage::Format_RGB32)
+    {
+        image = QImage(framebuffer_width_, framebuffer_height_, QImage::Format_RGB32);
+    }
+
+    SoftwareFrame frame; // Same records as the GL backends; the outline, material textures and point clouds are GL-only
+    frame.view = frame_.view_matrix;
+    frame.projection = frame_.projection;
+    frame.eye = frame_.camera_position;
+    frame.near_plane = kNearPlane;
+    frame.far_plane = kFarPlane;
+    frame.lights = &frame_.records.lights;
+    const SceneRecords &records = frame_.records;
+    frame.draws.reserve(records.draw_records.size());
+    for (std::size_t i(0); i < records.draw_records.size() && i < records.software_meshes.size(); i++)
+    {
+        if (!records.software_meshes[i]) continue;
+        const DrawRecord &record = records.draw_records[i];
+        frame.draws.push_back({records.software_meshes[i].get(), record.model, record.color, record.color_mode,
+                               frame_.settings.wireframe && (record.flags & kDrawWireframe) != 0});
+    }
+    software_rasterizer_.render(frame, image, frame_stats_.software);
+
+    frame_stats_.lit = frame_.settings.color_mode == ColorMode::Lit;
+    frame_stats_.render_width = image.width();
+    frame_stats_.render_height = image.height();
+    frame_stats_.cpu_frame_ms = static_cast<double>(frame_timer.nsecsElapsed()) / 1.0e6;
+    if (frame_.input_ns) presented_input_ns_ = std::exchange(frame_.input_ns, 0); // Latency ends when the image is painted
+}
+
+QImage View::render_image(const QSize &size)
+{
+    if (backend_ != Backend::Software)
+    {
+        qWarning() << "render_image needs the software backend";
+        return {};
+    }
+    device_pixel_ratio_ = 1.0; // Exactly the requested pixels, whatever screen the hidden widget would use
+    framebuffer_width_ = std::max(1, size.width());
+    framebuffer_height_ = std::max(1, size.height());
+    update_projection(framebuffer_width_, framebuffer_height_);
+    publish_snapshot();
+    QImage image;
+    render_software(image);
+    return image;
+}
+
+void View::render_frame()
+{
+    QElapsedTimer frame_timer; // CPU cost of this frame for the HUD
+    frame_timer.start();
+    consume_snapshot(); // Settings, camera and records of this frame; the GUI thread keeps editing its own copy
+    collect_frame_queries(); // Results of the previous frame are ready by now (also steers the resolution governor)
+
+    QueryFrame &queries = query_frames_[query_frame_index_]; // Queries issued by this frame
+    glBeginQuery(GL_TIME_ELAPSED, queries.gpu_time); // Everything up to and including the upscale
+
+    const bool offscreen = ensure_scene_target(); // False only if allocation failed: draw straight into the widget
+    const float render_scale = offscreen ? render_scale_ : 1.0f;
+    render_width_ = std::max(1, static_cast<int>(std::lround(framebuffer_width_ * render_scale))); // Same aspect, fewer pixels
+    render_height_ = std::max(1, static_cast<int>(std::lround(framebuffer_height_ * render_scale)));
+    viewport_height_ = render_height_; // LOD selection works in rendered pixels
+    glBindFramebuffer(GL_FRAMEBUFFER, scene_framebuffer());
+    glViewport(0, 0, render_width_, render_height_); // Bottom-left corner of the full-size targets
+
+    glEnable(GL_DEPTH_TEST); // The HUD painter may have changed these states last frame
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    glDisable(GL_SCISSOR_TEST);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // Clear frame for fresh render
 
-    glUseProgram(shader_program_id); // Bind active shader program
-    glBindVertexArray(vertex_array_object); // Bind default VAO containing cube geometry
+    const glm::mat4 view_projection = frame_.projection * frame_.view_matrix; // Shared camera transform; model matrices come from the records
 
-    // Update camera matrix every frame (allows live control)
-    view_matrix = build_view_matrix(); // Recompute view matrix using latest camera transform
+    if (frame_.records.revision != uploaded_records_revision_) upload_draw_records(); // Only scene edits touch per-object data; camera moves do not
+    if (frame_.bone_palette_revision != uploaded_bone_palette_revision_) upload_bone_palette(); // Poses change with the animation clock only
 
-    // Ground plane
+    if (frame_.settings.gpu_culling && cull_program_id_)
+    {
+        cull_on_gpu(view_projection); // One dispatch; the CPU only sorts the objects when draws are sorted
+    }
+    else
+    {
+        cull_on_cpu(view_projection); // Reference path: same rules evaluated per object on the CPU
+    }
+
+    queries.depth_prepass = false;
+    queries.samples = offscreen ? scene_samples_ : 1;
+    queries.render_pixels = static_cast<double>(render_width_) * render_height_;
+    queries.render_scale = render_scale;
+    queries.fxaa = fxaa_active();
+    queries.path = frame_.settings.render_path == RenderPath::VisibilityBuffer && visibility_program_id_ && resolve_program_id_ &&
+                   frame_.records.ids_fit && ensure_visibility_target() ? RenderPath::VisibilityBuffer : RenderPath::Forward;
+
+    glBindVertexArray(vertex_array_object); // Bind the global VAO (index pool + draw_id) once per frame
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kVertexPoolBinding, scene_->vertex_pool_buffer); // Vertices are pulled by gl_VertexID
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kIndexPoolBinding, scene_->index_pool_buffer); // Indices are also visible to shaders
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kDrawRecordBinding, draw_record_buffer_); // Per-draw transforms and formats
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kFrameFirstIndexBinding, frame_first_index_buffer_); // LOD ranges for the resolve
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kPositionPoolBinding, scene_->position_pool_buffer); // Position-only stream for depth passes
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kBonePaletteBinding, bone_palette_buffer_); // Poses of rigged meshes (every pass that pulls vertices)
+    bind_material_textures(); // Whatever levels are resident now; streaming swaps them between frames
+    measure_texture_demand(view_projection); // Feeds the next streaming step on the GUI thread
+
+    if (frame_.shader_revision != shader_stats_.revision) reload_shaders(); // Shader files were edited
+    if (frame_.settings.wireframe && !wireframe_requested_) // First frame with the overlay: build its program in the background
+    {
+        wireframe_requested_ = true;
+        pending_programs_.push_back(begin_program(ShaderProgramId::Wireframe, kAllColorModes, shader_stats_.programs));
+    }
+    if (!frame_.records.point_clouds.empty() && !point_program_requested_) // First frame with a point cloud
+    {
+        point_program_requested_ = true;
+        pending_programs_.push_back(begin_program(ShaderProgramId::Points, kAllColorModes, shader_stats_.programs));
+    }
+    poll_programs(); // Install programs the driver finished compiling
+    use_shading_variant(frame_.settings.color_mode); // Specialized forward/resolve programs once ready, the generic ones until then
+    frame_stats_.lit = frame_.settings.color_mode == ColorMode::Lit;
+    if (frame_stats_.lit)
     {
-        glm::mat4 Mg(1.0f); // Initialize ground model matrix
-        Mg = glm::translate(Mg, glm::vec3(0.0f, -2.0f, 0.0f));   // Slightly below origin
-        Mg = glm::scale(Mg, glm::vec3(kGroundExtent, 0.30f, kGroundExtent)); // Scale ground to desired footprint
-        draw_cube(Mg, glm::vec4(15.0f/255.0f, 43.0f/255.0f, 70.0f/255.0f, 1.0f),
-                  ColorMode::Uniform);
-        glLineWidth(2.0f); // Emphasize wireframe edges around ground
-        draw_cube_edges(Mg, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)); // Render ground outline
-        glLineWidth(1.0f); // Restore default line width for remainder
+        bin_lights(); // Per frame: the clusters follow the camera and the render area
+        update_shadow_atlas(); // Only tiles touched by scene edits; camera moves reuse the atlas
+        if (shadow_atlas_texture_)
+        {
+            glActiveTexture(GL_TEXTURE0 + kShadowAtlasUnit);
+            glBindTexture(GL_TEXTURE_2D, shadow_atlas_texture_);
+            glActiveTexture(GL_TEXTURE0);
+        }
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kLightBinding, light_buffer_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kLightClusterBinding, light_cluster_buffer_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kLightIndexBinding, light_index_buffer_);
+        set_lighting_uniforms(shader_program_id, forward_lighting_locations_);
+        set_lighting_uniforms(resolve_program_id_, resolve_lighting_locations_);
+        set_lighting_uniforms(wireframe_program_id_, wireframe_lighting_locations_);
     }
 
-    int object_index = 0; // Track object index for coloring/selection
-    for (const auto &object : imported_objects_) // Iterate through imported meshes
+    // Forward color pass: the wireframe program adds edge distances in a geometry stage, so the overlay costs no extra draw
+    const bool wireframe = frame_.settings.wireframe && wireframe_program_id_;
+    const auto use_scene_program = [this, wireframe, &view_projection]
+    {
+        if (wireframe)
+        {
+            glUseProgram(wireframe_program_id_);
+            glUniformMatrix4fv(wireframe_location_view_projection_, 1, GL_FALSE, glm::value_ptr(view_projection));
+            glUniform2f(wireframe_location_viewport_size_, static_cast<float>(render_width_), static_cast<float>(render_height_));
+            return;
+        }
+        glUseProgram(shader_program_id);
+        if (uniform_location_view_projection >= 0) glUniformMatrix4fv(uniform_location_view_projection, 1, GL_FALSE, glm::value_ptr(view_projection));
+    };
+
+    if (queries.path == RenderPath::VisibilityBuffer)
+    {
+        render_visibility(view_projection, queries); // Ids first, then one shading pass per pixel
+    }
+    else if (use_depth_prepass())
+    {
+        queries.depth_prepass = true;
+        glUseProgram(depth_prepass_program_id_); // Positions only: a third of the interleaved bandwidth, no fragment shader
+        glUniformMatrix4fv(depth_prepass_location_view_projection_, 1, GL_FALSE, glm::value_ptr(view_projection));
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glBeginQuery(GL_SAMPLES_PASSED, queries.geometry); // Fragments a single forward pass would have shaded
+        submit_culled_draws();
+        glEndQuery(GL_SAMPLES_PASSED);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+        glDepthFunc(GL_EQUAL); // Only the front-most surface survives; depth is already final
+        glDepthMask(GL_FALSE);
+        use_scene_program();
+        glBeginQuery(GL_SAMPLES_PASSED, queries.resolve);
+        submit_culled_draws();
+        glEndQuery(GL_SAMPLES_PASSED);
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
+    }
+    else
     {
-        const bool is_selected = object_index == selected_object_index_; // Determine selection state
-        const float r = is_selected ? 0.95f : 0.6f + 0.15f * static_cast<float>(object_index % 3); // Pick stable color ramp
-        const float g = is_selected ? 0.85f : 0.65f + 0.12f * static_cast<float>((object_index + 1) % 3); // Tweak green per index
-        const float b = is_selected ? 0.35f : 0.75f; // Accent color used when selected
-        glm::mat4 model = glm::translate(glm::mat4(1.0f), object.translation); // Build model matrix from object state
-        draw_mesh(object, model, glm::vec4(r, g, b, 1.0f),
-                  color_mode_);
-        object_index++;
+        use_scene_program(); // Bind active shader program
+        glBeginQuery(GL_SAMPLES_PASSED, queries.geometry); // Every passing sample is shaded in this path
+        submit_culled_draws(); // Ground and all visible meshes in one call
+        glEndQuery(GL_SAMPLES_PASSED);
     }
+    glUseProgram(shader_program_id); // The outline is always drawn forward, after either path
+    if (uniform_location_view_projection >= 0) glUniformMatrix4fv(uniform_location_view_projection, 1, GL_FALSE, glm::value_ptr(view_projection));
+    glLineWidth(2.0f); // Emphasize wireframe edges around ground
+    glDrawElementsInstancedBaseInstance(GL_LINES, static_cast<GLsizei>(scene_->cube_edge_mesh.index_count), GL_UNSIGNED_INT,
+                                        reinterpret_cast<const void*>(static_cast<std::uintptr_t>(scene_->cube_edge_mesh.first_index) * sizeof(GLuint)),
+                                        1, kGroundEdgeRecord); // Render ground outline from the same pools
+    glLineWidth(1.0f); // Restore default line width for remainder
+    draw_point_clouds(view_projection); // Depth-tested against the scene of either path
 
     glBindVertexArray(0); // Unbind VAO to avoid accidental state leakage
     glUseProgram(0); // Unbind shader for cleanliness
+
+    present_scene(); // Resolve + upscale; the HUD is painted afterwards at full resolution
+    glEndQuery(GL_TIME_ELAPSED);
+    queries.pending = true;
+    query_frame_index_ ^= 1; // Next frame writes the other slot while this one completes
+    capture_frame(); // Before the HUD, outside the timed passes (the governor does not see the readback)
+
+    frame_stats_.render_scale = render_scale;
+    frame_stats_.render_width = render_width_;
+    frame_stats_.render_height = render_height_;
+    frame_stats_.samples = queries.samples;
+    frame_stats_.fxaa = queries.fxaa;
+    frame_stats_.cpu_frame_ms = static_cast<double>(frame_timer.nsecsElapsed()) / 1.0e6;
+    if (frame_.settings.hud_visible)
+    {
+        draw_hud();
+        hud_catch_up_frame_ = !hud_catch_up_frame_; // One extra frame shows this frame's query results once the scene is idle
+        if (hud_catch_up_frame_) request_redraw();
+    }
+    if (frame_.input_ns) presented_input_ns_ = std::exchange(frame_.input_ns, 0); // Latency ends when this frame is swapped
 }
 
 void View::mousePressEvent(QMouseEvent *event)
 {
+    const std::int64_t input_ns = monotonic_ns(); // Start of the input-to-frame latency
     setFocus(Qt::MouseFocusReason); // Ensure widget retains keyboard focus during interaction
     last_mouse = event->pos(); // Cache current mouse position for delta calculations
 
     if (event->button() == Qt::RightButton)
     {
-        if (selected_object_index_ >= 0 && selected_object_index_ < static_cast<int>(imported_objects_.size()))
+        if (scene_->selected_object_index >= 0 && scene_->selected_object_index < static_cast<int>(scene_->imported_objects.size()))
         {
             if (glm::vec3 hit; intersect_ground_plane(event->pos(), hit))
             {
                 dragging_object_ = true; // Begin drag state when ground intersection succeeds
-                drag_offset_ = imported_objects_[selected_object_index_].translation - hit; // Maintain offset so object sticks to cursor
+                drag_offset_ = scene_->imported_objects[scene_->selected_object_index].translation - hit; // Maintain offset so object sticks to cursor
             }
             else
             {
@@ -161,13 +760,14 @@ void View::mousePressEvent(QMouseEvent *event)
 
     if (event->button() == Qt::LeftButton)
     {
-        if (selected_object_index_ >= 0 && selected_object_index_ < static_cast<int>(imported_objects_.size()))
+        if (scene_->selected_object_index >= 0 && scene_->selected_object_index < static_cast<int>(scene_->imported_objects.size()))
         {
             if (const int hit_index = pick_object(event->pos()); hit_index < 0)
             {
-                selected_object_index_ = -1; // Clear selection when click misses current object
+                scene_->selected_object_index = -1; // Clear selection when click misses current object
                 focus_point_ = {0.0f, 0.0f, 0.0f}; // Reset focus to origin for camera orbit
-                update(); // Refresh render to drop highlight
+                mark_scene_dirty(); // Highlight color lives in the draw record
+                request_frame(input_ns); // Refresh render to drop highlight
             }
         }
         rotating = true; // Left button initiates camera orbit
@@ -209,19 +809,23 @@ void View::mouseReleaseEvent(QMouseEvent *event)
 
 void View::mouseMoveEvent(QMouseEvent *event)
 {
+    const std::int64_t input_ns = monotonic_ns(); // Start of the input-to-frame latency
     const QPoint distance = event->pos() - last_mouse; // Compute screen-space delta
     last_mouse = event->pos(); // Update cached mouse position
 
-    if (dragging_object_ && selected_object_index_ >= 0 &&
-        selected_object_index_ < static_cast<int>(imported_objects_.size()))
+    if (dragging_object_ && scene_->selected_object_index >= 0 &&
+        scene_->selected_object_index < static_cast<int>(scene_->imported_objects.size()))
     {
         if (glm::vec3 hit; intersect_ground_plane(event->pos(), hit))
         {
-            auto &object = imported_objects_[selected_object_index_]; // Access actively dragged mesh
+            auto &object = scene_->imported_objects[scene_->selected_object_index]; // Access actively dragged mesh
             glm::vec3 new_translation = hit + drag_offset_; // Maintain drag offset so object follows cursor smoothly
             new_translation.y = kGroundPlaneY; // Force object back to ground plane
+            mark_shadow_caster_dirty(object); // Shadow leaves the tiles under the old position...
             object.translation = new_translation; // Apply new position
-            update(); // Redraw scene to reflect move
+            mark_shadow_caster_dirty(object); // ...and is drawn into the tiles under the new one
+            mark_scene_dirty(); // Model matrix and cull sphere moved
+            request_frame(input_ns); // Redraw scene to reflect move
         }
         return;
     }
@@ -248,7 +852,7 @@ void View::mouseMoveEvent(QMouseEvent *event)
         cam_position = focus_point_ + offset; // Update camera position around focus point
         cam_rotation_degree.y = glm::degrees(yaw); // Store new yaw in degrees for UI
         emit_camera_state(); // Sync updated camera state with UI
-        update(); // Redraw scene with new camera pose
+        request_frame(input_ns); // Redraw scene with new camera pose
         return;
     }
 
@@ -257,7 +861,7 @@ void View::mouseMoveEvent(QMouseEvent *event)
         cam_rotation_degree.y += 0.3f * dx; // Adjust yaw from horizontal movement
         cam_rotation_degree.x += 0.3f * dy; // Adjust pitch from vertical movement
         emit_camera_state(); // Update UI spin boxes
-        update(); // Redraw using updated camera angles
+        request_frame(input_ns); // Redraw using updated camera angles
         return;
     }
 
@@ -273,51 +877,58 @@ void View::mouseMoveEvent(QMouseEvent *event)
             cam_position.z +=  0.01f * dy; // Translate camera along Z axis
         }
         emit_camera_state(); // Notify UI of position change
-        update(); // Redraw with new camera position
+        request_frame(input_ns); // Redraw with new camera position
     }
 }
 
 void View::mouseDoubleClickEvent(QMouseEvent *event)
 {
+    const std::int64_t input_ns = monotonic_ns(); // Start of the input-to-frame latency
     if (event->button() == Qt::LeftButton)
     {
         if (const int hit_index = pick_object(event->pos()); hit_index >= 0)
         {
-            selected_object_index_ = hit_index; // Select object under cursor
-            focus_point_ = imported_objects_[hit_index].translation; // Set camera orbit focus to selected object
+            scene_->selected_object_index = hit_index; // Select object under cursor
+            focus_point_ = scene_->imported_objects[hit_index].translation; // Set camera orbit focus to selected object
             dragging_object_ = false; // Stop any drag interaction
             rotating = false; // Reset rotation flag to avoid conflict
-            update(); // Redraw with selection highlight
+            mark_scene_dirty(); // Highlight color lives in the draw record
+            request_frame(input_ns); // Redraw with selection highlight
             return;
         }
     }
-    QOpenGLWidget::mouseDoubleClickEvent(event);
+    QWidget::mouseDoubleClickEvent(event);
 }
 
 void View::wheelEvent(QWheelEvent* event)
 {
+    const std::int64_t input_ns = monotonic_ns(); // Start of the input-to-frame latency
     const float steps = static_cast<float>(event->angleDelta().y()) / 120.0f; // Convert wheel delta to detent steps
     if (std::abs(steps) < std::numeric_limits<float>::epsilon())
     {
         return; // Ignore zero movement to prevent unnecessary redraws
     }
 
-    if (selected_object_index_ >= 0 && selected_object_index_ < static_cast<int>(imported_objects_.size()))
+    if (scene_->selected_object_index >= 0 && scene_->selected_object_index < static_cast<int>(scene_->imported_objects.size()))
     {
-        auto &object = imported_objects_[selected_object_index_]; // Target currently selected object
+        auto &object = scene_->imported_objects[scene_->selected_object_index]; // Target currently selected object
         const float factor = std::pow(1.1f, steps); // Exponential scale factor for smooth resizing
+        mark_shadow_caster_dirty(object); // Tiles under the old and the new size
         object.scale = std::clamp(object.scale * factor, kMinObjectScale, kMaxObjectScale); // Clamp scale within safe bounds
-        update(); // Redraw scene to reflect new scale
+        mark_shadow_caster_dirty(object);
+        mark_scene_dirty(); // Model matrix and cull radius changed
+        request_frame(input_ns); // Redraw scene to reflect new scale
         return;
     }
 
     cam_position.z += -0.5f * steps; // Dolly camera forward/backward when nothing is selected
     emit_camera_state(); // Sync UI with updated camera position
-    update(); // Redraw scene with new camera distance
+    request_frame(input_ns); // Redraw scene with new camera distance
 }
 
 void View::keyPressEvent(QKeyEvent *event)
 {
+    const std::int64_t input_ns = monotonic_ns(); // Start of the input-to-frame latency
     const float move = event->modifiers() & Qt::ShiftModifier ? 0.25f : 0.1f; // Faster motion when Shift held
     constexpr float rotate  = 2.0f; // Fixed rotational step in degrees
 
@@ -325,9 +936,9 @@ void View::keyPressEvent(QKeyEvent *event)
     {
         case Qt::Key_Backspace:
         case Qt::Key_Delete:
-            if (selected_object_index_ >= 0 && selected_object_index_ < static_cast<int>(imported_objects_.size()))
+            if (scene_->selected_object_index >= 0 && scene_->selected_object_index < static_cast<int>(scene_->imported_objects.size()))
             {
-                delete_object(selected_object_index_);
+                delete_object(scene_->selected_object_index, input_ns);
             }
             return;
 
@@ -350,36 +961,69 @@ void View::keyPressEvent(QKeyEvent *event)
         default: return;
     }
     emit_camera_state();
-    update();
+    request_frame(input_ns);
 }
 
 void View::reset_all()
 {
-    makeCurrent(); // Ensure GL context is current before touching GPU resources
+    begin_gui_gl(); // Ensure GL context is current before touching GPU resources
     delete_imported_objects(); // Release all imported mesh resources
-    doneCurrent(); // Release GL context so Qt can manage it
+    end_gui_gl(); // Release GL context so Qt (or the render thread) can use it
 
     cam_position = {3.0f, 3.5f, 15.0f}; // Restore default camera position
     cam_rotation_degree = {-15.0f, 15.0f, 0.0f}; // Restore default camera orientation
-    selected_object_index_ = -1; // Clear selection state
+    scene_->selected_object_index = -1; // Clear selection state
     dragging_object_ = false; // Reset drag mode
     rotating = false; // Reset orbit mode
     panning = false; // Reset pan mode
     scrolling_navigation_ = false; // Reset middle-mouse orbit mode
     focus_point_ = {0.0f, 0.0f, 0.0f}; // Return focus point to origin
-    color_mode_ = ColorMode::Uniform; // Return to default color mode
+    settings_.color_mode = ColorMode::Uniform; // Return to default color mode
+    mark_draws_dirty(); // Color mode is stored per draw record (the objects were dropped by delete_imported_objects)
     update_projection(width(), height()); // Recompute projection in case viewport changed
     emit_camera_state(); // Notify UI of restored camera state
-    update(); // Redraw scene with clean slate
+    request_frame(); // Redraw scene with clean slate
 }
 
 bool View::load_object(const QString &file_path)
 {
+    if (QFileInfo(file_path).suffix().compare(QStringLiteral("obj"), Qt::CaseInsensitive) == 0 && obj_may_be_point_cloud(file_path))
+    {
+        return load_point_cloud(file_path); // Scans: vertices without faces, too many for the mesh path
+    }
+    return load_mesh(file_path);
+}
+
+bool View::load_mesh(const QString &file_path)
+{
+    const QString source_path = QFileInfo(file_path).absoluteFilePath();
+    const auto rigged = std::ranges::find_if(scene_->imported_objects, [&source_path](const ImportedObject &object)
+    {
+        return object.skin && object.source_path == source_path;
+    });
+    if (rigged != scene_->imported_objects.end()) // Another instance of a rigged file: no import, no upload
+    {
+        ImportedObject instance = *rigged; // Same pooled mesh, skin and texture; placement, scale and phase are its own
+        instance.scale = 1.0f;
+        const auto instances = std::ranges::count_if(scene_->imported_objects, [&instance](const ImportedObject &object) { return object.skin == instance.skin; });
+        instance.animation_tick_offset = static_cast<std::uint64_t>(instances) * kInstanceTickSpread;
+
+        begin_gui_gl(); // Locks the renderers like any other scene edit
+        instance.translation = free_ground_position(instance.base_footprint * instance.scale);
+        scene_->imported_objects.push_back(instance);
+        mark_shadow_caster_dirty(instance);
+        mark_scene_dirty();
+        end_gui_gl();
+        request_frame();
+        return true;
+    }
+
     Assimp::Importer importer; // Helper object used to parse mesh assets
     constexpr unsigned int flags =
         aiProcess_Triangulate |
         aiProcess_JoinIdenticalVertices |
         aiProcess_GenSmoothNormals |
+        aiProcess_LimitBoneWeights | // At most four bones per vertex (the skin stream has four lanes)
         aiProcess_ImproveCacheLocality; // Preprocess mesh for rendering efficiency
 
     const aiScene *scene = importer.ReadFile(file_path.toStdString(), flags); // Load OBJ scene from disk
@@ -396,15 +1040,22 @@ bool View::load_object(const QString &file_path)
         return false;
     }
 
-    struct VertexData // Staging struct to simplify interleaved buffer creation
+    QString texture_path; // Diffuse map named by the material (MTL paths are relative to the OBJ)
+    if (mesh->mMaterialIndex < scene->mNumMaterials && mesh->HasTextureCoords(0))
     {
-        glm::vec3 position{};
-        glm::vec3 normal{0.0f, 1.0f, 0.0f};
-        glm::vec2 uv{0.0f, 0.0f};
-    };
+        aiString name;
+        if (scene->mMaterials[mesh->mMaterialIndex]->GetTexture(aiTextureType_DIFFUSE, 0, &name) == aiReturn_SUCCESS)
+        {
+            const QString relative = QString::fromUtf8(name.C_Str()).replace(QLatin1Char('\\'), QLatin1Char('/'));
+            if (relative.startsWith(QLatin1Char('*'))) qWarning() << "Embedded textures are not supported:" << relative;
+            else texture_path = QFileInfo(file_path).dir().filePath(relative);
+        }
+    }
 
-    std::vector<VertexData> vertices; // Temporary vertex list used to build VBO
-    vertices.reserve(mesh->mNumFaces * 3); // Reserve to avoid reallocations
+    std::vector<MeshVertex> vertices; // Staged copy of the Assimp vertices (indices below refer to it)
+    vertices.reserve(mesh->mNumVertices); // One staged vertex per imported vertex
+    std::vector<GLuint> indices; // Triangle list indices local to this mesh
+    indices.reserve(static_cast<std::size_t>(mesh->mNumFaces) * 3); // Reserve to avoid reallocations
 
     float min_x = std::numeric_limits<float>::max(); // Bounding box accumulator (min X)
     float min_y = std::numeric_limits<float>::max(); // Bounding box accumulator (min Y)
@@ -416,43 +1067,56 @@ bool View::load_object(const QString &file_path)
     const bool has_normals = mesh->HasNormals(); // Determine if imported mesh provides normals
     const bool has_uvs = mesh->HasTextureCoords(0); // Determine if imported mesh provides UVs
 
-    // Iterate faces to flatten mesh into triangle list suitable for GL_TRIANGLES
+    for (unsigned int vertex_index(0); vertex_index < mesh->mNumVertices; vertex_index++) // Stage every vertex once; sharing is kept through indices
+    {
+        const aiVector3D &vertex = mesh->mVertices[vertex_index];
+        MeshVertex data;
+        data.position = {vertex.x, vertex.y, vertex.z};
+        if (has_normals)
+        {
+            const aiVector3D &normal = mesh->mNormals[vertex_index];
+            data.normal = {normal.x, normal.y, normal.z};
+        }
+        if (has_uvs)
+        {
+            const aiVector3D &uv = mesh->mTextureCoords[0][vertex_index];
+            data.uv = {uv.x, uv.y};
+        }
+        vertices.push_back(data);
+    }
+
+    std::vector<bool> referenced(vertices.size(), false); // Bounds only consider vertices used by triangles
+
+    // Iterate faces to build a triangle list suitable for GL_TRIANGLES
     for (unsigned int faceIndex(0); faceIndex < mesh->mNumFaces; faceIndex++)
     {
         const aiFace &face = mesh->mFaces[faceIndex];
         if (face.mNumIndices < 3) continue;
 
-        for (unsigned int i(0); i < face.mNumIndices; i++)
-        {
-            const unsigned int vertex_index = face.mIndices[i];
-            if (vertex_index >= mesh->mNumVertices) continue;
-
-            const aiVector3D &vertex = mesh->mVertices[vertex_index];
+        const bool valid = std::all_of(face.mIndices, face.mIndices + face.mNumIndices,
+                                       [&](const unsigned int index) { return index < mesh->mNumVertices; });
+        if (!valid) continue; // Skip faces pointing outside the vertex array
 
-            min_x = std::min(min_x, vertex.x);
-            min_y = std::min(min_y, vertex.y);
-            min_z = std::min(min_z, vertex.z);
-            max_x = std::max(max_x, vertex.x);
-            max_y = std::max(max_y, vertex.y);
-            max_z = std::max(max_z, vertex.z);
-
-            VertexData data;
-            data.position = {vertex.x, vertex.y, vertex.z};
-            if (has_normals)
-            {
-                const aiVector3D &normal = mesh->mNormals[vertex_index];
-                data.normal = {normal.x, normal.y, normal.z};
-            }
-            if (has_uvs)
+        for (unsigned int i(1); i + 1 < face.mNumIndices; i++) // Fan-triangulate any polygon Assimp left behind
+        {
+            for (const unsigned int vertex_index : {face.mIndices[0], face.mIndices[i], face.mIndices[i + 1]})
             {
-                const aiVector3D &uv = mesh->mTextureCoords[0][vertex_index];
-                data.uv = {uv.x, uv.y};
+                indices.push_back(vertex_index);
+                if (referenced[vertex_index]) continue;
+                referenced[vertex_index] = true;
+
+                const glm::vec3 &position = vertices[vertex_index].position;
+                min_x = std::min(min_x, position.x);
+                min_y = std::min(min_y, position.y);
+                min_z = std::min(min_z, position.z);
+                max_x = std::max(max_x, position.x);
+                max_y = std::max(max_y, position.y);
+                max_z = std::max(max_z, position.z);
             }
-            vertices.push_back(data);
         }
     }
 
-    if (vertices.empty()) // Abort when no triangle data was produced
+    if (indices.empty()) // Abort when no triangle data was produced
     {
         qWarning() << "OBJ contains no triangles.";
         return false;
@@ -460,130 +1124,259 @@ bool View::load_object(const QString &file_path)
 
     const float center_x = 0.5f * (min_x + max_x); // Compute horizontal center to recenter mesh
     const float center_z = 0.5f * (min_z + max_z); // Compute depth center to recenter mesh
-    for (auto &vertex : vertices) // Normalize vertices so base sits on ground and center is at origin
+    for (std::size_t i(0); i < vertices.size(); i++) // Normalize vertices so base sits on ground and center is at origin
     {
+        auto &vertex = vertices[i];
         vertex.position.x -= center_x;
         vertex.position.y -= min_y;
         vertex.position.z -= center_z;
-        max_radius_sq = std::max(max_radius_sq, glm::dot(vertex.position, vertex.position));
+        if (referenced[i]) max_radius_sq = std::max(max_radius_sq, glm::dot(vertex.position, vertex.position));
     }
 
+    const bool software = backend_ == Backend::Software; // CPU copy of the mesh instead of pool uploads
     ImportedObject object; // Prepare GPU resource descriptors for new mesh
-    object.vertex_count = static_cast<GLsizei>(vertices.size()); // Store triangle vertex count
     object.base_footprint = std::max({1.0f, max_x - min_x, max_z - min_z}) + 0.5f; // Footprint guides placement spacing
     object.radius = std::sqrt(max_radius_sq); // Use radius for click picking
+    object.source_path = source_path;
+
+    std::optional<SkinnedMeshImport> skin; // Skeleton, clips and bone weights of rigged meshes
+    if (mesh->HasBones() && software)
+    {
+        qInfo() << "The software backend draws rigged meshes in their bind pose";
+    }
+    else if (mesh->HasBones())
+    {
+        skin = import_skinned_mesh(*scene, *mesh, glm::vec3(center_x, min_y, center_z), vertices);
+    }
+    if (skin)
+    {
+        object.skin = skin->asset;
+        object.radius = skin->asset->radius; // Covers every sampled pose, so culling and shadows never clip a limb
+        qInfo().nospace() << "Rigged mesh: " << skin->asset->bone_joints.size() << " bones, " << skin->asset->joints.size() << " joints, "
+                          << skin->asset->clips.size() << " clips";
+    }
 
-    std::vector<float> interleaved; // Flatten struct data into float stream
-    interleaved.reserve(vertices.size() * 8); // 3 position + 3 normal + 2 UV
-    for (const auto & [position, normal, uv] : vertices) // Copy attributes in interleaved order
+    EncodedVertices encoded; // Compress per mesh; formats may differ between objects
+    if (!software) encoded = encode_vertices(vertices, choose_vertex_format(vertices));
+    object.mesh_id = scene_->next_mesh_id++;
+    if (scene_->bake_ambient_occlusion) // Optional import stage: occlusion rides along with the vertices as an extra stream
     {
-        interleaved.push_back(position.x);
-        interleaved.push_back(position.y);
-        interleaved.push_back(position.z);
-        interleaved.push_back(normal.x);
-        interleaved.push_back(normal.y);
-        interleaved.push_back(normal.z);
-        interleaved.push_back(uv.x);
-        interleaved.push_back(uv.y);
+        if (!software) append_vertex_occlusion(encoded, std::vector<float>(vertices.size(), 1.0f)); // Reserved; drawn unoccluded until baked
+        bake_occlusion_in_background(object.mesh_id, file_path, vertices, indices); // Copies: the import keeps its own
     }
+    if (skin) append_vertex_skin(encoded, skin->skin); // Another stream after the vertices (occlusion stays baked in the bind pose)
+    std::vector<std::vector<GLuint>> lod_indices; // Coarser levels reuse the same vertices
+    if (software) object.software_mesh = std::make_shared<const SoftwareMesh>(make_software_mesh(vertices, std::move(indices), {}));
+    else lod_indices = build_lod_chain(vertices, std::move(indices), kMaxMeshLods); // The software backend always draws full detail
 
-    makeCurrent(); // Ensure OpenGL context is active before allocating buffers
+    begin_gui_gl(); // Ensure OpenGL context is active before allocating buffers
+    if (!software)
+    {
+        object.mesh = upload_mesh(encoded, lod_indices); // Append vertices and all LOD index lists to the shared pools
+        if (!texture_path.isEmpty()) object.texture = request_texture(texture_path); // Decoded in the background; drawn white until then
+    }
 
-    glGenVertexArrays(1, &object.vao); // Create VAO to store vertex format state
-    glBindVertexArray(object.vao); // Bind VAO for configuration
+    object.translation = free_ground_position(object.base_footprint * object.scale); // Finalize placement position
+    scene_->imported_objects.push_back(object); // Store configured object in scene list
+    mark_shadow_caster_dirty(object); // New caster
+    mark_scene_dirty(); // New object needs a draw record and a cull entry
 
-    glGenBuffers(1, &object.vbo); // Create VBO storing vertex data
-    glBindBuffer(GL_ARRAY_BUFFER, object.vbo); // Bind VBO for upload
-    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(interleaved.size() * sizeof(float)), interleaved.data(), GL_STATIC_DRAW); // Upload vertex data
+    end_gui_gl(); // Release GL context after allocation (publishes the new object)
+    request_frame(); // Request redraw to show new object
+    return true;
+}
 
-    constexpr GLsizei stride = 8 * sizeof(GLfloat);
-    glEnableVertexAttribArray(0); // Enable position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, nullptr); // Describe position layout
-    glEnableVertexAttribArray(1); // Enable normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(3 * sizeof(GLfloat))); // Describe normal layout
-    glEnableVertexAttribArray(2); // Enable UV attribute
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(6 * sizeof(GLfloat))); // Describe UV layout
+void View::bake_occlusion_in_background(const std::uint64_t mesh_id, const QString &file_path, std::vector<MeshVertex> vertices,
+                                        std::vector<GLuint> indices)
+{
+    scene_->occlusion_bakes_pending++;
+    const std::weak_ptr<SharedScene> weak_scene = scene_; // Any view still showing the scene may take the result
+    QThreadPool::globalInstance()->start([weak_scene, mesh_id, file_path, vertices = std::move(vertices), indices = std::move(indices)]
+    {
+        const AmbientOcclusionSettings settings; // Worker thread: no GL, no widgets
+        const QByteArray cache_key = ambient_occlusion_cache_key(file_path, vertices.size(), indices.size(), settings);
+        auto bake = std::make_shared<AmbientOcclusionBake>();
+        if (auto cached = load_cached_ambient_occlusion(cache_key, vertices.size()))
+        {
+            bake->occlusion = std::move(*cached);
+            bake->from_cache = true;
+        }
+        else
+        {
+            *bake = ::bake_ambient_occlusion(vertices, indices, settings); // Uses the recentered positions the mesh is drawn with
+            store_cached_ambient_occlusion(cache_key, bake->occlusion);
+        }
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [weak_scene, mesh_id, bake]
+        {
+            const auto scene = weak_scene.lock(); // Back on the GUI thread
+            if (!scene) return;
+            scene->occlusion_bakes_pending--;
+            if (scene->views.empty()) return; // Every view was closed while baking
+            scene->views.front()->on_occlusion_baked(mesh_id, std::move(*bake));
+        }, Qt::QueuedConnection);
+    });
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0); // Unbind VBO now that VAO stores state
-    glBindVertexArray(0); // Unbind VAO to avoid accidental changes
+void View::on_occlusion_baked(const std::uint64_t mesh_id, AmbientOcclusionBake bake)
+{
+    const auto baked = std::ranges::find(scene_->imported_objects, mesh_id, &ImportedObject::mesh_id);
+    if (baked == scene_->imported_objects.end()) return; // Deleted or scene reset meanwhile
+    if (bake.from_cache)
+    {
+        qInfo() << "Ambient occlusion loaded from cache for" << bake.occlusion.size() << "vertices";
+    }
+    else
+    {
+        qInfo().nospace() << "Ambient occlusion baked: " << bake.rays << " rays in " << bake.trace_ms << " ms on " << bake.jobs
+                          << " jobs (" << bake.rays_per_second() / 1.0e6 << " Mrays/s), BVH " << bake.build_ms << " ms";
+    }
 
-    glm::vec3 desired_translation{0.0f, kGroundPlaneY, 0.0f}; // Start placement on ground at origin
+    begin_gui_gl();
+    if (baked->software_mesh)
+    {
+        const std::shared_ptr<const SoftwareMesh> unbaked = baked->software_mesh; // Records keep drawing it until the next publish
+        auto mesh = std::make_shared<SoftwareMesh>(*unbaked);
+        mesh->occlusion = std::move(bake.occlusion);
+        for (ImportedObject &object : scene_->imported_objects)
+        {
+            if (object.software_mesh == unbaked) object.software_mesh = mesh; // Rigged instances share the copy
+        }
+    }
+    else if (baked->mesh.occlusion_offset != kNoVertexOcclusion)
+    {
+        const std::vector<std::uint32_t> words = encode_vertex_occlusion(bake.occlusion);
+        const auto first_word = static_cast<GLintptr>(baked->mesh.vertex_offset + baked->mesh.occlusion_offset);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, scene_->vertex_pool_buffer); // Fills the reserved stream, so no record changes
+        glBufferSubData(GL_COPY_WRITE_BUFFER, first_word * static_cast<GLintptr>(sizeof(std::uint32_t)),
+                        static_cast<GLsizeiptr>(words.size() * sizeof(std::uint32_t)), words.data());
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    bake.occlusion.clear(); // Values now live in the mesh; keep the statistics for the HUD
+    scene_->last_occlusion_bake = std::move(bake);
+    mark_scene_dirty(); // New software mesh and HUD statistics
+    end_gui_gl();
+    for (View *view : scene_->views) view->request_frame();
+}
 
-    const auto overlaps = [this, &object](const glm::vec3 &position) // Helper to test placement overlap
+glm::vec3 View::free_ground_position(const float footprint) const
+{
+    constexpr float epsilon = 0.05f;
+    const auto overlaps = [this, footprint](const glm::vec3 &position) // Helper to test placement overlap
     {
-        constexpr float epsilon = 0.05f;
-        const float new_radius = object.base_footprint * object.scale * 0.5f;
-        return std::ranges::any_of(imported_objects_,
-                                   [&](const ImportedObject &existing)
+        const auto too_close = [&](const glm::vec3 &existing, const float existing_footprint)
+        {
+            const glm::vec2 delta(existing.x - position.x, existing.z - position.z);
+            return glm::length(delta) < (existing_footprint + footprint) * 0.5f + epsilon;
+        };
+        return std::ranges::any_of(scene_->imported_objects, [&](const ImportedObject &existing)
+                                   {
+                                       return too_close(existing.translation, existing.base_footprint * existing.scale);
+                                   }) ||
+               std::ranges::any_of(scene_->point_clouds, [&](const PointCloudObject &cloud)
                                    {
-                                       const float existing_radius = existing.base_footprint * existing.scale * 0.5f;
-                                       const glm::vec2 delta(existing.translation.x - position.x,
-                                                             existing.translation.z - position.z);
-                                       return glm::length(delta) < existing_radius + new_radius + epsilon;
+                                       return too_close(cloud.translation, cloud.base_footprint);
                                    });
     };
 
-    while (overlaps(desired_translation))
+    glm::vec3 position{0.0f, kGroundPlaneY, 0.0f}; // Start placement on ground at origin
+    while (overlaps(position))
     {
-        desired_translation.x += object.base_footprint * object.scale;
+        position.x += footprint;
     }
-
-    object.translation = desired_translation; // Finalize placement position
-    imported_objects_.push_back(object); // Store configured object in scene list
-
-    doneCurrent(); // Release GL context after allocation
-    update(); // Request redraw to show new object
-    return true;
+    return position;
 }
 
-void View::set_color_mode(const ColorMode mode)
+bool View::load_point_cloud(const QString &file_path)
 {
-    if (color_mode_ == mode) return; // Skip redundant updates
-    color_mode_ = mode; // Store new color interpretation mode
-    update(); // Trigger repaint to reflect change
+    const std::uint64_t generation = scene_->point_cloud_generation;
+    const std::weak_ptr<SharedScene> weak_scene = scene_; // Any view still showing the scene may take the result
+    QThreadPool::globalInstance()->start([weak_scene, file_path, generation]
+    {
+        std::shared_ptr<const PointCloudOctree> octree = std::make_shared<PointCloudOctree>(read_point_cloud(file_path)); // Worker thread: no GL, no widgets
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [weak_scene, file_path, generation, octree]
+        {
+            const auto scene = weak_scene.lock(); // Back on the GUI thread
+            if (!scene || scene->views.empty()) return; // Every view was closed while importing
+            scene->views.front()->on_point_cloud_built(generation, file_path, octree);
+        }, Qt::QueuedConnection);
+    });
+    qInfo() << "Importing point cloud in the background:" << file_path;
+    return true;
 }
 
-void View::delete_object(const int index)
+void View::on_point_cloud_built(const std::uint64_t generation, const QString &file_path, std::shared_ptr<const PointCloudOctree> octree)
 {
-    if (index < 0 || index >= static_cast<int>(imported_objects_.size()))
+    if (generation != scene_->point_cloud_generation) return; // Scene was reset meanwhile
+    if (octree->has_faces) // The probe guessed wrong: faces only in the middle of the file
     {
+        qInfo() << "OBJ file has faces; importing it as a mesh:" << file_path;
+        if (!load_mesh(file_path)) qWarning() << "Mesh import failed:" << file_path;
         return;
     }
-
-    makeCurrent();
-    auto &object = imported_objects_[index];
-    if (object.vbo)
+    if (!octree->error.isEmpty() || octree->nodes.empty())
+    {
+        qWarning() << "Point cloud import failed:" << file_path << octree->error;
+        return;
+    }
+    qInfo().nospace() << "Point cloud imported: " << static_cast<qint64>(octree->points.size()) << " points in "
+                      << static_cast<qint64>(octree->nodes.size()) << " nodes (depth " << octree->depth << "), parse " << octree->read_ms
+                      << " ms, octree " << octree->build_ms << " ms on " << static_cast<qint64>(octree->jobs) << " jobs"
+                      << (octree->has_colors ? "" : ", colored by height");
+    if (octree->dropped_points > 0)
     {
-        glDeleteBuffers(1, &object.vbo);
-        object.vbo = 0;
+        qWarning() << "Point cloud has" << static_cast<qint64>(octree->dropped_points) << "duplicate points beyond the deepest level; they are not drawn";
     }
-    if (object.vao)
+
+    PointCloudObject cloud;
+    const glm::vec3 extent = octree->bounds_max - octree->bounds_min;
+    cloud.base_footprint = std::max({1.0f, extent.x, extent.z}) + 0.5f; // Footprint guides placement spacing
+    cloud.translation = free_ground_position(cloud.base_footprint);
+    cloud.id = scene_->next_point_cloud_id++;
+    cloud.octree = std::move(octree);
+    scene_->point_clouds.push_back(std::move(cloud));
+    mark_scene_dirty(); // Clouds travel with the records of every view
+    request_frame();
+}
+
+void View::set_color_mode(const ColorMode mode)
+{
+    if (settings_.color_mode == mode) return; // Skip redundant updates
+    settings_.color_mode = mode; // Store new color interpretation mode
+    mark_draws_dirty(); // Color mode is stored per draw record
+    request_frame(); // Trigger repaint to reflect change
+}
+
+void View::delete_object(const int index, const std::int64_t input_ns)
+{
+    if (index < 0 || index >= static_cast<int>(scene_->imported_objects.size()))
     {
-        glDeleteVertexArrays(1, &object.vao);
-        object.vao = 0;
+        return;
     }
-    imported_objects_.erase(imported_objects_.begin() + index);
-    doneCurrent();
 
-    if (imported_objects_.empty())
+    begin_gui_gl();
+    mark_shadow_caster_dirty(scene_->imported_objects[index]); // Its shadow disappears from these tiles
+    scene_->imported_objects.erase(scene_->imported_objects.begin() + index);
+    if (gl_functions_) compact_geometry_pool(); // Close the gap left in the shared pools (the software backend has none)
+
+    if (scene_->imported_objects.empty())
     {
-        selected_object_index_ = -1;
+        scene_->selected_object_index = -1;
         focus_point_ = {0.0f, 0.0f, 0.0f};
     }
     else
     {
-        if (selected_object_index_ == index)
+        if (scene_->selected_object_index == index)
         {
-            selected_object_index_ = std::min(index, static_cast<int>(imported_objects_.size()) - 1);
+            scene_->selected_object_index = std::min(index, static_cast<int>(scene_->imported_objects.size()) - 1);
         }
-        else if (selected_object_index_ > index)
+        else if (scene_->selected_object_index > index)
         {
-            selected_object_index_ -= 1;
+            scene_->selected_object_index -= 1;
         }
 
-        if (selected_object_index_ >= 0 && selected_object_index_ < static_cast<int>(imported_objects_.size()))
+        if (scene_->selected_object_index >= 0 && scene_->selected_object_index < static_cast<int>(scene_->imported_objects.size()))
         {
-            focus_point_ = imported_objects_[selected_object_index_].translation;
+            focus_point_ = scene_->imported_objects[scene_->selected_object_index].translation;
         }
         else
         {
@@ -592,147 +1385,538 @@ void View::delete_object(const int index)
     }
 
     dragging_object_ = false;
-    update();
+    mark_scene_dirty(); // Records still point at the old mesh offsets
+    end_gui_gl(); // Publishes records with the compacted offsets before the renderer resumes
+    request_frame(input_ns);
 }
 
 void View::delete_imported_objects()
 {
-    for (auto &object : imported_objects_) // Iterate through loaded objects releasing GPU memory
-    {
-        if (object.vbo)
-        {
-            glDeleteBuffers(1, &object.vbo); // Destroy vertex buffer
-            object.vbo = 0; // Reset handle to avoid double delete
-        }
-        if (object.vao)
-        {
-            glDeleteVertexArrays(1, &object.vao); // Destroy vertex array object
-            object.vao = 0; // Reset handle to avoid double delete
-        }
-    }
-    imported_objects_.clear(); // Remove all metadata records
-    selected_object_index_ = -1; // Clear selection state because objects are gone
+    mark_shadow_tiles_dirty(kAllShadowTiles); // Every object shadow disappears
+    scene_->imported_objects.clear(); // Remove all metadata records
+    delete_scene_textures(); // Textures belong to the imported objects
+    scene_->point_clouds.clear(); // Renderers keep their cached pages until the LRU hands them to other clouds
+    scene_->point_cloud_generation++; // Imports still in flight are dropped when they finish
+    // Built-in meshes sit at the front of the pools, so dropping everything after them frees all imported geometry
+    scene_->vertex_pool_used_words = scene_->cube_edge_mesh.vertex_offset + scene_->cube_edge_mesh.vertex_words;
+    scene_->position_pool_used_words = scene_->cube_edge_mesh.position_offset + scene_->cube_edge_mesh.position_words;
+    scene_->index_pool_used = scene_->cube_edge_mesh.first_index + scene_->cube_edge_mesh.index_count;
+    scene_->selected_object_index = -1; // Clear selection state because objects are gone
     dragging_object_ = false; // Ensure drag state is cleared
+    mark_scene_dirty(); // Records still reference the removed meshes
 }
 
-void View::setup_shaders()
+View::MeshAllocation View::upload_mesh(const EncodedVertices &vertices, const std::vector<std::vector<GLuint>> &lod_indices)
 {
-    // Vertex shader generating varyings for fragment stage
-    static auto vertex_shader_source = R"(#version 450 core
-    // Vertex attributes supplied by VAO (position, normal, uv)
-    layout(location = 0) in vec3 position;
-    layout(location = 1) in vec3 normal;
-    layout(location = 2) in vec2 texcoord;
+    std::vector<GLuint> indices; // All LOD levels stored back to back
+    MeshAllocation mesh; // Describes where the mesh lands in the pools
+    mesh.lod_count = static_cast<GLuint>(std::min(lod_indices.size(), kMaxMeshLods));
+    for (GLuint lod(0); lod < mesh.lod_count; lod++)
+    {
+        mesh.lods[lod].first_index = static_cast<GLuint>(indices.size()); // Relative offsets survive pool compaction
+        mesh.lods[lod].index_count = static_cast<GLuint>(lod_indices[lod].size());
+        indices.insert(indices.end(), lod_indices[lod].begin(), lod_indices[lod].end());
+    }
 
-    // Uniform transforms pushed from CPU side
-    uniform mat4 model;
-    uniform mat4 mvp;
-    uniform mat3 normal_matrix;
+    mesh.format = vertices.format;
+    mesh.vertex_offset = scene_->vertex_pool_used_words;
+    mesh.vertex_words = static_cast<GLuint>(vertices.words.size());
+    mesh.position_offset = scene_->position_pool_used_words;
+    mesh.position_words = static_cast<GLuint>(vertices.position_words.size());
+    mesh.first_index = scene_->index_pool_used;
+    mesh.index_count = static_cast<GLuint>(indices.size());
+    mesh.bounds_min = vertices.bounds_min;
+    mesh.bounds_extent = vertices.bounds_extent;
+    mesh.occlusion_offset = vertices.occlusion_offset; // Relative, so compaction only has to move vertex_offset
+    mesh.skin_offset = vertices.skin_offset; // Same
+
+    const auto vertex_bytes = static_cast<GLsizeiptr>(vertices.words.size() * sizeof(std::uint32_t)); // Size of the new vertex range
+    const auto position_bytes = static_cast<GLsizeiptr>(vertices.position_words.size() * sizeof(std::uint32_t)); // Size of the new position range
+    const auto index_bytes = static_cast<GLsizeiptr>(indices.size() * sizeof(GLuint)); // Size of the new index range
+    const auto vertex_used_bytes = static_cast<GLsizeiptr>(scene_->vertex_pool_used_words * sizeof(std::uint32_t)); // Live bytes to preserve
+    const auto position_used_bytes = static_cast<GLsizeiptr>(scene_->position_pool_used_words * sizeof(std::uint32_t)); // Live bytes to preserve
+    const auto index_used_bytes = static_cast<GLsizeiptr>(scene_->index_pool_used * sizeof(GLuint)); // Live bytes to preserve
+
+    grow_pool_buffer(scene_->vertex_pool_buffer, scene_->vertex_pool_capacity, vertex_used_bytes, vertex_used_bytes + vertex_bytes);
+    grow_pool_buffer(scene_->position_pool_buffer, scene_->position_pool_capacity, position_used_bytes, position_used_bytes + position_bytes);
+    grow_pool_buffer(scene_->index_pool_buffer, scene_->index_pool_capacity, index_used_bytes, index_used_bytes + index_bytes); // Views re-attach it with their next records
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, scene_->vertex_pool_buffer); // Upload through the copy target to leave other bindings untouched
+    glBufferSubData(GL_COPY_WRITE_BUFFER, vertex_used_bytes, vertex_bytes, vertices.words.data()); // Append encoded vertices
+    glBindBuffer(GL_COPY_WRITE_BUFFER, scene_->position_pool_buffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, position_used_bytes, position_bytes, vertices.position_words.data()); // Append position stream
+    glBindBuffer(GL_COPY_WRITE_BUFFER, scene_->index_pool_buffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, index_used_bytes, index_bytes, indices.data()); // Append local indices
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    scene_->vertex_pool_used_words += mesh.vertex_words; // Advance pool cursors
+    scene_->position_pool_used_words += mesh.position_words;
+    scene_->index_pool_used += mesh.index_count;
+    return mesh;
+}
+
+void View::grow_pool_buffer(GLuint &buffer, GLsizeiptr &capacity, const GLsizeiptr used_bytes, const GLsizeiptr required_bytes)
+{
+    if (buffer && required_bytes <= capacity) return; // Enough room already
 
-    // Varyings forwarded to fragment shader
-    out vec3 vWorldPosition;
-    out vec3 vNormal;
-    out vec2 vTexCoord;
+    GLsizeiptr new_capacity = std::max(capacity, kInitialPoolBytes); // Start from the current size
+    while (new_capacity < required_bytes) new_capacity *= 2; // Double to amortize future imports
 
-    void main()
+    GLuint new_buffer = 0;
+    glGenBuffers(1, &new_buffer); // Create the larger pool
+    glBindBuffer(GL_COPY_WRITE_BUFFER, new_buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, new_capacity, nullptr, GL_STATIC_DRAW); // Allocate storage only
+    if (buffer && used_bytes > 0)
     {
-        vec4 world_position = model * vec4(position, 1.0); // Transform vertex into world space
-        vWorldPosition = world_position.xyz; // Preserve world-space position for color encoding
-        vNormal = normalize(normal_matrix * normal); // Transform normal to world space
-        vTexCoord = texcoord; // Pass UV straight through
-        gl_Position = mvp * vec4(position, 1.0); // Project into clip space
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, used_bytes); // Keep existing meshes on the GPU
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
     }
-    )";
-
-    // Fragment shader selecting color source
-    static auto fragment_shader_source = R"(#version 450 core
-    layout(location = 0) out vec4 FragColor;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
 
-    in vec3 vWorldPosition;
-    in vec3 vNormal;
-    in vec2 vTexCoord;
-
-    // Uniforms set per draw call
-    uniform vec4 color;
-    uniform int color_mode;
+    if (buffer) glDeleteBuffers(1, &buffer); // Drop the old pool
+    buffer = new_buffer;
+    capacity = new_capacity;
+}
 
-    // Encode normalized world position into RGB for visualization
-    vec3 encode_position()
+void View::compact_geometry_pool()
+{
+    std::vector<MeshAllocation*> live_meshes{&scene_->cube_mesh, &scene_->cube_edge_mesh}; // Built-ins first keeps them at the front
+    for (auto &object : scene_->imported_objects) live_meshes.push_back(&object.mesh);
+
+    GLuint vertex_pool = 0;
+    GLuint position_pool = 0;
+    GLuint index_pool = 0;
+    glGenBuffers(1, &vertex_pool); // Copies cannot overlap inside one buffer, so repack into fresh storage
+    glGenBuffers(1, &position_pool);
+    glGenBuffers(1, &index_pool);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, vertex_pool);
+    glBufferData(GL_COPY_WRITE_BUFFER, scene_->vertex_pool_capacity, nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, position_pool);
+    glBufferData(GL_COPY_WRITE_BUFFER, scene_->position_pool_capacity, nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, index_pool);
+    glBufferData(GL_COPY_WRITE_BUFFER, scene_->index_pool_capacity, nullptr, GL_STATIC_DRAW);
+
+    GLuint vertex_cursor = 0; // Next free word in the repacked vertex pool
+    GLuint position_cursor = 0; // Next free word in the repacked position pool
+    GLuint index_cursor = 0; // Next free index in the repacked index pool
+    std::map<GLuint, MeshAllocation> relocated; // By old vertex offset: instances of a rigged mesh share one allocation
+    for (MeshAllocation *mesh : live_meshes)
     {
-        float length_value = length(vWorldPosition);
-        if (length_value > 1e-5)
+        if (const auto moved = relocated.find(mesh->vertex_offset); moved != relocated.end())
         {
-            vec3 normalized = clamp(vWorldPosition / length_value, vec3(-1.0), vec3(1.0));
-            return 0.5 + 0.5 * normalized;
+            *mesh = moved->second; // Already copied for an earlier instance
+            continue;
         }
-        return vec3(0.5);
+        const GLuint old_vertex_offset = mesh->vertex_offset;
+        glBindBuffer(GL_COPY_READ_BUFFER, scene_->vertex_pool_buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, vertex_pool);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                            static_cast<GLintptr>(mesh->vertex_offset * sizeof(std::uint32_t)),
+                            static_cast<GLintptr>(vertex_cursor * sizeof(std::uint32_t)),
+                            static_cast<GLsizeiptr>(mesh->vertex_words * sizeof(std::uint32_t)));
+        glBindBuffer(GL_COPY_READ_BUFFER, scene_->position_pool_buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, position_pool);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                            static_cast<GLintptr>(mesh->position_offset * sizeof(std::uint32_t)),
+                            static_cast<GLintptr>(position_cursor * sizeof(std::uint32_t)),
+                            static_cast<GLsizeiptr>(mesh->position_words * sizeof(std::uint32_t)));
+        glBindBuffer(GL_COPY_READ_BUFFER, scene_->index_pool_buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, index_pool);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                            static_cast<GLintptr>(mesh->first_index * sizeof(GLuint)),
+                            static_cast<GLintptr>(index_cursor * sizeof(GLuint)),
+                            static_cast<GLsizeiptr>(mesh->index_count * sizeof(GLuint))); // Indices are mesh-local, so no rebasing
+        mesh->vertex_offset = vertex_cursor;
+        mesh->position_offset = position_cursor;
+        mesh->first_index = index_cursor;
+        relocated.emplace(old_vertex_offset, *mesh);
+        vertex_cursor += mesh->vertex_words;
+        position_cursor += mesh->position_words;
+        index_cursor += mesh->index_count;
     }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    glDeleteBuffers(1, &scene_->vertex_pool_buffer); // Replace the fragmented pools
+    glDeleteBuffers(1, &scene_->position_pool_buffer);
+    glDeleteBuffers(1, &scene_->index_pool_buffer);
+    scene_->vertex_pool_buffer = vertex_pool;
+    scene_->position_pool_buffer = position_pool;
+    scene_->index_pool_buffer = index_pool;
+    scene_->vertex_pool_used_words = vertex_cursor;
+    scene_->position_pool_used_words = position_cursor;
+    scene_->index_pool_used = index_cursor; // Every view re-attaches the new element buffer with its next records
+}
 
-    // Encode normalized world-space normal into RGB (useful to inspect shading data)
-    vec3 encode_normal()
+void View::attach_index_pool()
+{
+    glBindVertexArray(vertex_array_object); // Element buffer binding is VAO state (a container object, one per context)
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, scene_->index_pool_buffer);
+    glBindVertexArray(0);
+}
+
+void View::setup_shaders()
+{
+    // Issue every program before checking any, so drivers with parallel compilation work on all of them at once
+    constexpr std::array<ShaderProgramId, 6> startup_programs{ShaderProgramId::Visibility, ShaderProgramId::DepthPrepass, ShaderProgramId::Fxaa,
+                                                             ShaderProgramId::Forward, ShaderProgramId::Resolve, ShaderProgramId::Cull};
+    std::vector<PendingProgram> pending;
+    for (const ShaderProgramId id : startup_programs) pending.push_back(begin_program(id, kAllColorModes, startup_.programs));
+    for (PendingProgram &program : pending)
+    {
+        install_program(program.id, program.color_mode_mask, finish_program(program, startup_.programs)); // Waits for the driver
+    }
+    // Specialized forward/resolve variants are requested by the first frame that needs them and built in the background
+}
+
+View::ShadingVariant &View::shading_variant(const std::uint32_t color_mode_mask)
+{
+    for (std::size_t mode(0); mode < shading_variants_.size(); mode++)
+    {
+        if (color_mode_variant_mask(static_cast<ColorMode>(mode)) == color_mode_mask) return shading_variants_[mode];
+    }
+    return generic_shading_; // kAllColorModes
+}
+
+void View::install_program(const ShaderProgramId id, const std::uint32_t color_mode_mask, const GLuint program)
+{
+    const auto replace = [this, program](GLuint &slot)
+    {
+        if (slot && slot != program) glDeleteProgram(slot); // Not used by a frame: programs change only between frames
+        slot = program;
+    };
+    const auto lighting_locations = [this](const GLuint lit_program)
+    {
+        LightingLocations locations;
+        locations.view = uniform_location(lit_program, "light_view", kLightViewLocation);
+        locations.viewport_size = uniform_location(lit_program, "cluster_viewport_size", kClusterViewportSizeLocation);
+        locations.depth_scale_bias = uniform_location(lit_program, "cluster_depth_scale_bias", kClusterDepthScaleBiasLocation);
+        locations.eye = uniform_location(lit_program, "light_eye", kLightEyeLocation);
+        locations.shadow_matrix = uniform_location(lit_program, "shadow_matrix", kShadowMatrixLocation);
+        locations.shadows_enabled = uniform_location(lit_program, "shadows_enabled", kShadowsEnabledLocation);
+        return locations;
+    };
+
+    switch (id)
     {
-        float length_value = length(vNormal);
-        vec3 normalized = length_value > 1e-5 ? normalize(vNormal) : vec3(0.0, 1.0, 0.0);
-        return 0.5 + 0.5 * normalized;
+    case ShaderProgramId::Forward:
+    {
+        ShadingVariant &variant = shading_variant(color_mode_mask);
+        replace(variant.forward);
+        variant.forward_view_projection = uniform_location(program, "view_projection", kViewProjectionLocation);
+        variant.forward_lighting = lighting_locations(program);
+        break;
+    }
+    case ShaderProgramId::Resolve:
+    {
+        ShadingVariant &variant = shading_variant(color_mode_mask);
+        replace(variant.resolve);
+        variant.resolve_lighting = lighting_locations(program);
+        variant.resolve_inverse_view_projection = uniform_location(program, "inverse_view_projection", kInverseViewProjectionLocation);
+        variant.resolve_viewport_size = uniform_location(program, "viewport_size", kViewportSizeLocation);
+        variant.resolve_triangle_bits = uniform_location(program, "triangle_bits", kTriangleBitsLocation);
+        variant.resolve_wireframe = uniform_location(program, "wireframe", kWireframeLocation);
+        break;
+    }
+    case ShaderProgramId::Wireframe:
+        replace(wireframe_program_id_);
+        wireframe_location_view_projection_ = uniform_location(program, "view_projection", kViewProjectionLocation);
+        wireframe_location_viewport_size_ = uniform_location(program, "viewport_size", kViewportSizeLocation);
+        wireframe_lighting_locations_ = lighting_locations(program);
+        break;
+    case ShaderProgramId::Points:
+        replace(point_program_id_);
+        point_location_view_projection_ = uniform_location(program, "view_projection", kViewProjectionLocation);
+        point_location_point_scale_ = uniform_location(program, "point_scale", kPointScaleLocation);
+        break;
+    case ShaderProgramId::Visibility:
+        replace(visibility_program_id_);
+        visibility_location_view_projection_ = uniform_location(program, "view_projection", kViewProjectionLocation);
+        visibility_location_triangle_bits_ = uniform_location(program, "triangle_bits", kTriangleBitsLocation);
+        break;
+    case ShaderProgramId::DepthPrepass:
+        replace(depth_prepass_program_id_);
+        depth_prepass_location_view_projection_ = uniform_location(program, "view_projection", kViewProjectionLocation);
+        break;
+    case ShaderProgramId::Fxaa:
+        replace(fxaa_program_id_);
+        fxaa_location_texel_size_ = uniform_location(program, "texel_size", kTexelSizeLocation);
+        fxaa_location_uv_max_ = uniform_location(program, "uv_max", kUvMaxLocation);
+        break;
+    case ShaderProgramId::Cull:
+        replace(cull_program_id_);
+        cull_location_frustum_planes_ = uniform_location(program, "frustum_planes", kFrustumPlanesLocation); // Cache frustum planes handle
+        cull_location_camera_position_ = uniform_location(program, "camera_position", kCameraPositionLocation); // Cache camera position handle
+        cull_location_lod_projection_scale_ = uniform_location(program, "lod_projection_scale", kLodProjectionScaleLocation); // Cache LOD scale handle
+        cull_location_lod_thresholds_ = uniform_location(program, "lod_thresholds", kLodThresholdsLocation); // Cache LOD thresholds handle
+        cull_location_object_count_ = uniform_location(program, "object_count", kObjectCountLocation); // Cache object count handle
+        cull_location_compact_output_ = uniform_location(program, "compact_output", kCompactOutputLocation); // Cache compaction switch handle
+        break;
+    default: break;
     }
+}
 
-    // Encode UV coordinates into RG channels (reveals UV layout / seams)
-    vec3 encode_uv()
+void View::use_shading_variant(const ColorMode mode)
+{
+    ShadingVariant &variant = shading_variants_[static_cast<std::size_t>(mode)];
+    if (!variant.requested) // First frame in this mode: compile its specialized programs in the background
     {
-        vec2 wrapped = fract(vTexCoord);
-        return vec3(wrapped, 0.5);
+        variant.requested = true;
+        const std::uint32_t color_mode_mask = color_mode_variant_mask(mode);
+        pending_programs_.push_back(begin_program(ShaderProgramId::Forward, color_mode_mask, shader_stats_.programs));
+        pending_programs_.push_back(begin_program(ShaderProgramId::Resolve, color_mode_mask, shader_stats_.programs));
+        poll_programs(); // Binaries from the cache are usable right away
     }
 
-    void main()
+    // Until a specialized program links, the generic one (every color mode) draws the same image
+    const ShadingVariant &forward = variant.forward ? variant : generic_shading_;
+    shader_program_id = forward.forward;
+    uniform_location_view_projection = forward.forward_view_projection;
+    forward_lighting_locations_ = forward.forward_lighting;
+    const ShadingVariant &resolve = variant.resolve ? variant : generic_shading_;
+    resolve_program_id_ = resolve.resolve;
+    resolve_location_inverse_view_projection_ = resolve.resolve_inverse_view_projection;
+    resolve_location_viewport_size_ = resolve.resolve_viewport_size;
+    resolve_location_triangle_bits_ = resolve.resolve_triangle_bits;
+    resolve_location_wireframe_ = resolve.resolve_wireframe;
+    resolve_lighting_locations_ = resolve.resolve_lighting;
+}
+
+void View::reload_shaders()
+{
+    shader_stats_.revision = frame_.shader_revision;
+    shader_overrides_ = frame_.shader_overrides;
+    qInfo() << "Recompiling shader programs for revision" << shader_stats_.revision;
+
+    // Every program is rebuilt in the background; the current ones keep drawing and stay if the new text fails
+    for (const ShaderProgramId id : {ShaderProgramId::Visibility, ShaderProgramId::DepthPrepass, ShaderProgramId::Fxaa, ShaderProgramId::Cull})
+    {
+        pending_programs_.push_back(begin_program(id, kAllColorModes, shader_stats_.programs));
+    }
+    pending_programs_.push_back(begin_program(ShaderProgramId::Forward, kAllColorModes, shader_stats_.programs));
+    pending_programs_.push_back(begin_program(ShaderProgramId::Resolve, kAllColorModes, shader_stats_.programs));
+    for (std::size_t mode(0); mode < shading_variants_.size(); mode++)
     {
-        vec3 final_color = color.rgb; // Default color uses provided material tint
+        if (!shading_variants_[mode].requested) continue;
+        const std::uint32_t color_mode_mask = color_mode_variant_mask(static_cast<ColorMode>(mode));
+        pending_programs_.push_back(begin_program(ShaderProgramId::Forward, color_mode_mask, shader_stats_.programs));
+        pending_programs_.push_back(begin_program(ShaderProgramId::Resolve, color_mode_mask, shader_stats_.programs));
+    }
+    if (wireframe_requested_) pending_programs_.push_back(begin_program(ShaderProgramId::Wireframe, kAllColorModes, shader_stats_.programs));
+    if (point_program_requested_) pending_programs_.push_back(begin_program(ShaderProgramId::Points, kAllColorModes, shader_stats_.programs));
+}
 
-        if (color_mode == 1)
+void View::poll_programs()
+{
+    for (auto it = pending_programs_.begin(); it != pending_programs_.end();)
+    {
+        if (!program_ready(*it))
+        {
+            ++it;
+            continue;
+        }
+        PendingProgram pending = *it;
+        it = pending_programs_.erase(it);
+        const GLuint program = finish_program(pending, shader_stats_.programs);
+        if (pending.revision != shader_stats_.revision) // Superseded by a newer edit while it compiled
+        {
+            if (program) glDeleteProgram(program);
+            continue;
+        }
+        if (!program) // The previous program keeps drawing (warning already logged)
         {
-            final_color = encode_position();
+            shader_stats_.failed++;
+            continue;
         }
-        else if (color_mode == 2)
+        shader_stats_.built++;
+        shader_stats_.last_build_ms = static_cast<double>(monotonic_ns() - pending.start_ns) / 1.0e6;
+        install_program(pending.id, pending.color_mode_mask, program);
+    }
+    shader_stats_.pending = pending_programs_.size();
+    if (!pending_programs_.empty()) request_redraw(); // Keep polling while the scene is idle
+}
+
+GLint View::uniform_location(const GLuint program, const char *name, const GLint location)
+{
+    if (!program) return -1;
+    const GLint named = glGetUniformLocation(program, name);
+    if (named >= 0) return named;
+
+    // SPIR-V programs need not expose names: use the explicit location if an active uniform sits there
+    GLint uniform_count = 0;
+    glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniform_count);
+    for (GLint index(0); index < uniform_count; index++)
+    {
+        constexpr GLenum property = GL_LOCATION;
+        GLint active_location = -1;
+        glGetProgramResourceiv(program, GL_UNIFORM, static_cast<GLuint>(index), 1, &property, 1, nullptr, &active_location);
+        if (active_location == location) return location;
+    }
+    return -1; // Optimized out (e.g. lighting in a variant without ColorMode::Lit); glUniform* ignores -1
+}
+
+View::PendingProgram View::begin_program(const ShaderProgramId id, const std::uint32_t color_mode_mask, ProgramCounts &counts)
+{
+    const ShaderProgramSource &source = shader_program_source(id);
+    PendingProgram pending;
+    pending.id = id;
+    pending.color_mode_mask = color_mode_mask;
+    pending.label = source.label;
+    if (color_mode_mask != kAllColorModes) pending.label += " (color modes 0x" + QByteArray::number(color_mode_mask, 16) + ")";
+    pending.revision = shader_stats_.revision;
+    pending.start_ns = monotonic_ns();
+
+    const ShaderOverrides empty_overrides;
+    const ShaderOverrides &overrides = shader_overrides_ ? *shader_overrides_ : empty_overrides;
+    bool edited = false; // Hot-reloaded text replaces a snippet of this program
+    for (const ShaderStageSource &stage : source.stages)
+    {
+        for (const char *snippet : stage.sources)
         {
-            final_color = encode_normal();
+            const char *name = shader_snippet_name(snippet);
+            edited = edited || (name && overrides.contains(name));
         }
-        else if (color_mode == 3)
+    }
+
+    std::vector<std::span<const std::uint32_t>> modules; // Build-time SPIR-V of every stage, or empty to compile the GLSL
+    if (specialize_shader_ && !edited) // Edited sources are newer than the embedded modules
+    {
+        for (std::size_t stage(0); stage < source.stages.size(); stage++)
         {
-            final_color = encode_uv();
+            const auto module = embedded_spirv(id, stage);
+            if (module.empty())
+            {
+                modules.clear();
+                break;
+            }
+            modules.push_back(module);
         }
-        else if (color_mode == 4)
+    }
+    pending.spirv = !modules.empty();
+    const std::string specialization = specialization_source(false, color_mode_mask); // GLSL path: the mask becomes a constant
+    const auto stage_sources = [&](const ShaderStageSource &stage)
+    {
+        std::vector<const char*> sources;
+        for (const char *snippet : stage.sources)
         {
-            vec3 position_color = encode_position(); // World position visualization
-            vec3 normal_color = encode_normal(); // Surface normal visualization
-            final_color = mix(position_color, normal_color, 0.5); // Blend both sources equally
+            const char *name = shader_snippet_name(snippet);
+            const auto edit = name ? overrides.find(name) : overrides.end();
+            if (snippet == kSpecializationSource) sources.push_back(specialization.c_str());
+            else sources.push_back(edit != overrides.end() ? edit->second.c_str() : snippet);
         }
+        return sources;
+    };
 
-        if (color_mode != 0)
+    if (program_binaries_ && !edited) // Work-in-progress edits would only fill the cache
+    {
+        QByteArray input = modules.empty() ? QByteArray("glsl") : "spirv " + QByteArray::number(color_mode_mask); // Specialization is applied at load
+        for (std::size_t stage(0); stage < source.stages.size(); stage++)
+        {
+            input += QByteArray::number(static_cast<int>(source.stages[stage].kind)); // Same text in another stage is another program
+            if (!modules.empty())
+            {
+                input.append(reinterpret_cast<const char*>(modules[stage].data()), static_cast<qsizetype>(modules[stage].size_bytes()));
+                continue;
+            }
+            for (const char *snippet : stage_sources(source.stages[stage])) input += snippet;
+        }
+        pending.cache_key = program_cache_key(input, driver_identity_);
+        if (const auto binary = load_cached_program(pending.cache_key))
         {
-            final_color = mix(final_color, color.rgb, 0.35); // Blend attribute visualization with base tint
+            const GLuint program = glCreateProgram();
+            glProgramBinary(program, binary->format, binary->data.constData(), static_cast<GLsizei>(binary->data.size()));
+            GLint linked = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            if (linked)
+            {
+                counts.cached++;
+                pending.program = program;
+                pending.from_binary = true;
+                return pending;
+            }
+            glDeleteProgram(program); // Driver changed in a way the key cannot see: compile, then overwrite the entry
+            remove_cached_program(pending.cache_key);
+            counts.rejected++;
+            qInfo() << "Cached binary of program" << pending.label << "was rejected; compiling from source";
         }
+    }
 
-        FragColor = vec4(final_color, color.a); // Output RGBA color for framebuffer
+    pending.program = glCreateProgram(); // Allocate shader program container
+    if (!pending.cache_key.isEmpty()) glProgramParameteri(pending.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    for (std::size_t stage(0); stage < source.stages.size(); stage++)
+    {
+        const GLuint shader = glCreateShader(shader_stage_type(source.stages[stage].kind)); // Create shader object for this stage
+        if (!modules.empty()) // No GLSL front end: the driver only translates the module
+        {
+            glShaderBinary(1, &shader, kShaderBinaryFormatSpirV, modules[stage].data(), static_cast<GLsizei>(modules[stage].size_bytes()));
+            const GLuint constant_id = kColorModeMaskConstantId;
+            const auto &snippets = source.stages[stage].sources;
+            const bool specialized = std::find(snippets.begin(), snippets.end(), kSpecializationSource) != snippets.end();
+            specialize_shader_(shader, "main", specialized ? 1 : 0, &constant_id, &color_mode_mask); // Ids a module lacks are an error
+        }
+        else
+        {
+            const std::vector<const char*> sources = stage_sources(source.stages[stage]);
+            glShaderSource(shader, static_cast<GLsizei>(sources.size()), sources.data(), nullptr); // Snippets are concatenated in order
+            glCompileShader(shader); // Returns at once with parallel compilation; the status is read by finish_program
+        }
+        glAttachShader(pending.program, shader); // Attach stage to program
+        glDeleteShader(shader); // Flagged for deletion; freed together with the program, its log stays readable until then
     }
-    )";
+    glLinkProgram(pending.program); // Link stages into executable program
+    return pending;
+}
+
+bool View::program_ready(const PendingProgram &pending)
+{
+    if (pending.from_binary || !shader_stats_.parallel_compile) return true; // Without the extension any query may block anyway
+    GLint complete = GL_FALSE;
+    glGetProgramiv(pending.program, kCompletionStatus, &complete); // Never blocks
+    return complete == GL_TRUE;
+}
 
-    shader_program_id = glCreateProgram(); // Allocate shader program container
-    const GLuint vertex_shader = glCreateShader(GL_VERTEX_SHADER); // Create vertex shader object
-    glShaderSource(vertex_shader, 1, &vertex_shader_source, nullptr); // Upload vertex shader source
-    glCompileShader(vertex_shader); // Compile vertex shader
-    glAttachShader(shader_program_id, vertex_shader); // Attach vertex shader to program
-    const GLuint fragment_shader = glCreateShader(GL_FRAGMENT_SHADER); // Create fragment shader object
-    glShaderSource(fragment_shader, 1, &fragment_shader_source, nullptr); // Upload fragment shader source
-    glCompileShader(fragment_shader); // Compile fragment shader
-    glAttachShader(shader_program_id, fragment_shader); // Attach fragment shader to program
-    glLinkProgram(shader_program_id); // Link shaders into executable program
-    glDeleteShader(vertex_shader); // Free compiled vertex shader (program retains copy)
-    glDeleteShader(fragment_shader); // Free compiled fragment shader
+GLuint View::finish_program(const PendingProgram &pending, ProgramCounts &counts)
+{
+    if (pending.from_binary) return pending.program;
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(pending.program, GL_LINK_STATUS, &linked); // Waits for the driver unless program_ready() said it is done
+    if (!linked) // Callers treat 0 as "feature unavailable" or "keep the previous program"
+    {
+        GLuint shaders[3] = {};
+        GLsizei shader_count = 0;
+        glGetAttachedShaders(pending.program, 3, &shader_count, shaders);
+        for (GLsizei i(0); i < shader_count; i++)
+        {
+            GLint status = GL_FALSE;
+            glGetShaderiv(shaders[i], GL_COMPILE_STATUS, &status);
+            if (status) continue;
+            char log[1024] = {};
+            glGetShaderInfoLog(shaders[i], sizeof(log), nullptr, log);
+            qWarning() << "Shader stage of" << pending.label << "failed to" << (pending.spirv ? "specialize:" : "compile:") << log;
+        }
+        char log[1024] = {};
+        glGetProgramInfoLog(pending.program, sizeof(log), nullptr, log);
+        qWarning() << "Program" << pending.label << "failed to link:" << log;
+        glDeleteProgram(pending.program);
+        return 0;
+    }
+    counts.compiled++;
+    if (pending.spirv) counts.spirv++;
 
-    uniform_location_mvp = glGetUniformLocation(shader_program_id, "mvp"); // Cache MVP uniform handle
-    uniform_location_color = glGetUniformLocation(shader_program_id, "color"); // Cache color uniform handle
-    uniform_location_model = glGetUniformLocation(shader_program_id, "model"); // Cache model matrix uniform handle
-    uniform_location_normal_matrix = glGetUniformLocation(shader_program_id, "normal_matrix"); // Cache normal matrix uniform handle
-    uniform_location_color_mode = glGetUniformLocation(shader_program_id, "color_mode"); // Cache color mode uniform handle
+    GLint binary_length = 0;
+    if (!pending.cache_key.isEmpty()) glGetProgramiv(pending.program, GL_PROGRAM_BINARY_LENGTH, &binary_length);
+    if (binary_length > 0) // Next launch skips compiling and linking this program
+    {
+        ProgramBinary binary;
+        binary.data.resize(binary_length);
+        GLenum format = 0;
+        glGetProgramBinary(pending.program, binary_length, nullptr, &format, binary.data.data());
+        binary.format = format;
+        store_cached_program(pending.cache_key, binary);
+    }
+    return pending.program;
 }
 
 void View::setup_geometry()
@@ -789,24 +1973,43 @@ void View::setup_geometry()
         -0.5f, -0.5f,  0.5f,      0.0f, -1.0f,  0.0f,    0.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &vertex_array_object); // Create VAO for cube geometry
-    glBindVertexArray(vertex_array_object); // Bind VAO to capture vertex format state
+    glGenVertexArrays(1, &vertex_array_object); // Create the single global VAO used by every draw
+    glBindVertexArray(vertex_array_object); // Bind VAO to capture the draw_id attribute state
 
-    glGenBuffers(1, &vertex_buffer_object); // Create VBO for cube vertices
-    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_object); // Bind cube VBO for data upload
-    glBufferData(GL_ARRAY_BUFFER, sizeof(unit_cube_vertices), unit_cube_vertices, GL_STATIC_DRAW); // Upload cube vertex data once
+    glGenBuffers(1, &draw_id_buffer_); // Create buffer holding 0..N-1 for the draw_id attribute
+    glBindBuffer(GL_ARRAY_BUFFER, draw_id_buffer_); // Storage is allocated in upload_frame_draws
+    glEnableVertexAttribArray(kDrawIdAttribute); // Enable draw_id attribute
+    glVertexAttribIPointer(kDrawIdAttribute, 1, GL_UNSIGNED_INT, sizeof(GLuint), nullptr); // Integer attribute, no normalization
+    glVertexAttribDivisor(kDrawIdAttribute, 1); // Advance once per instance, so base instance selects the record
 
-    constexpr GLsizei stride = 8 * sizeof(GLfloat); // 3 position + 3 normal + 2 UV
-    glEnableVertexAttribArray(0); // Enable position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, nullptr); // Describe position attribute layout
-    glEnableVertexAttribArray(1); // Enable normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(3 * sizeof(GLfloat))); // Describe normal attribute layout
-    glEnableVertexAttribArray(2); // Enable UV attribute
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(6 * sizeof(GLfloat))); // Describe UV attribute layout
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0); // Unbind VBO now that VAO stores format
+    glBindBuffer(GL_ARRAY_BUFFER, 0); // Unbind buffer now that VAO stores format
     glBindVertexArray(0); // Unbind VAO to avoid unintended modifications
 
+    glGenBuffers(1, &draw_record_buffer_); // Draw records (SSBO), rewritten on scene edits
+    glGenBuffers(1, &indirect_buffer_); // Indirect commands written by either culling path
+    glGenBuffers(1, &frame_first_index_buffer_); // Per-record LOD offsets written by either culling path
+    glGenBuffers(1, &light_buffer_); // Scene lights, uploaded with the records
+    glGenBuffers(1, &light_cluster_buffer_); // Cluster ranges and light lists, rebuilt every lit frame
+    glGenBuffers(1, &light_index_buffer_);
+    glGenBuffers(1, &bone_palette_buffer_); // Bone matrices, rewritten whenever the pose changes
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, bone_palette_buffer_);
+    const glm::mat4 identity(1.0f); // The buffer stays bindable without rigged meshes
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(glm::mat4), glm::value_ptr(identity), GL_STREAM_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    if (scene_->vertex_pool_buffer) return; // Another view of the scene already filled the shared pools
+
+    std::vector<MeshVertex> cube_vertices; // Unit cube staged for the vertex pool
+    for (std::size_t i(0); i < std::size(unit_cube_vertices); i += 8)
+    {
+        cube_vertices.push_back({{unit_cube_vertices[i], unit_cube_vertices[i + 1], unit_cube_vertices[i + 2]},
+                                 {unit_cube_vertices[i + 3], unit_cube_vertices[i + 4], unit_cube_vertices[i + 5]},
+                                 {unit_cube_vertices[i + 6], unit_cube_vertices[i + 7]}});
+    }
+    std::vector<GLuint> cube_indices(cube_vertices.size()); // Cube is stored unshared: one index per vertex
+    std::iota(cube_indices.begin(), cube_indices.end(), 0u);
+    scene_->cube_mesh = upload_mesh(encode_vertices(cube_vertices, VertexFormat::Float32), {cube_indices}); // Keep exact cube positions; one LOD
+
     constexpr GLfloat cube_edge_vertices[12 * 2 * 3] = // Line segment endpoints outlining cube edges
     {
         // Bottom rectangle
@@ -826,65 +2029,2166 @@ void View::setup_geometry()
         -0.5f, -0.5f,  0.5f,  -0.5f,  0.5f,  0.5f
     };
 
-    glGenVertexArrays(1, &edge_vertex_array_object); // Create VAO for edge lines
-    glBindVertexArray(edge_vertex_array_object); // Bind edge VAO
+    std::vector<MeshVertex> edge_vertices; // Edge endpoints staged for the vertex pool (normal/UV unused)
+    for (std::size_t i(0); i < std::size(cube_edge_vertices); i += 3)
+    {
+        edge_vertices.push_back({{cube_edge_vertices[i], cube_edge_vertices[i + 1], cube_edge_vertices[i + 2]}});
+    }
+    std::vector<GLuint> edge_indices(edge_vertices.size()); // Consecutive pairs form GL_LINES segments
+    std::iota(edge_indices.begin(), edge_indices.end(), 0u);
+    scene_->cube_edge_mesh = upload_mesh(encode_vertices(edge_vertices, VertexFormat::Float32), {edge_indices});
+}
+
+View::DrawRecord View::make_draw_record(const MeshAllocation &mesh, const glm::mat4 &model, const glm::vec4 &color, const ColorMode mode,
+                                        const int texture_slot)
+{
+    DrawRecord record; // Everything the shaders need for one draw
+    record.model = model;
+    record.normal_matrix = glm::mat4(glm::mat3(glm::transpose(glm::inverse(model)))); // Compute normal matrix for correct lighting
+    record.color = color;
+    record.bounds_min = glm::vec4(mesh.bounds_min, 0.0f);
+    record.bounds_extent = glm::vec4(mesh.bounds_extent, 0.0f);
+    record.vertex_offset = mesh.vertex_offset;
+    record.position_offset = mesh.position_offset;
+    record.occlusion_offset = mesh.occlusion_offset == kNoVertexOcclusion ? kNoVertexOcclusion : mesh.vertex_offset + mesh.occlusion_offset;
+    record.skin_offset = mesh.skin_offset == kNoVertexSkin ? kNoVertexSkin : mesh.vertex_offset + mesh.skin_offset;
+    record.format = static_cast<std::uint32_t>(mesh.format);
+    record.color_mode = static_cast<std::int32_t>(mode);
+    record.texture_slot = texture_slot;
+    return record;
+}
+
+View::CullObject View::make_cull_object(const MeshAllocation &mesh, const GLuint record, const glm::vec3 &center, const float radius)
+{
+    CullObject object;
+    object.sphere = glm::vec4(center, radius);
+    object.record_index = record;
+    object.lod_count = mesh.lod_count;
+    for (GLuint lod(0); lod < mesh.lod_count; lod++)
+    {
+        object.lod_first_index[lod] = mesh.first_index + mesh.lods[lod].first_index; // Absolute position in the index pool
+        object.lod_index_count[lod] = mesh.lods[lod].index_count;
+    }
+    return object;
+}
+
+void View::setup_culling()
+{
+    glGenBuffers(1, &cull_object_buffer_); // Cull inputs, refreshed when the scene changes
+    glGenBuffers(1, &draw_count_buffer_); // Single uint counter
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, draw_count_buffer_);
+    constexpr GLuint zero = 0;
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GLuint), &zero, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    if (surface_->gl_context()->hasExtension(QByteArrayLiteral("GL_ARB_indirect_parameters"))) // Count read by the GPU: no readback, no empty draws
+    {
+        multi_draw_elements_indirect_count_ = reinterpret_cast<MultiDrawElementsIndirectCount>(
+            surface_->gl_context()->getProcAddress("glMultiDrawElementsIndirectCountARB"));
+    }
+    if (!cull_program_id_) qWarning() << "Using CPU culling."; // Built by setup_shaders; rendering continues through the CPU path
+}
+
+void View::mark_draws_dirty()
+{
+    draw_records_dirty_ = true; // Picked up by the next publish_snapshot
+}
+
+void View::mark_scene_dirty()
+{
+    scene_->revision++; // Every view sharing the scene rebuilds its records before its next snapshot
+    for (View *view : scene_->views)
+    {
+        if (view != this) view->request_frame(); // The caller requests its own frame (with its input stamp)
+    }
+}
+
+void View::build_scene_records()
+{
+    QElapsedTimer build_timer; // Packing cost for the HUD
+    build_timer.start();
+    SceneRecords &records = scene_records_;
+    const std::vector<ImportedObject> &objects = scene_->imported_objects;
+    records.draw_records.resize(kFirstObjectRecord + objects.size()); // Records are rebuilt only when the scene changes
+    records.cull_objects.resize(kFirstObjectCullObject + objects.size()); // Cull inputs follow the records
+    records.software_meshes.resize(records.draw_records.size()); // Outline stays null: the software backend draws no lines
+    records.software_meshes[kGroundRecord] = scene_->software_cube;
+
+    // Ground plane
+    glm::mat4 Mg(1.0f); // Initialize ground model matrix
+    Mg = glm::translate(Mg, glm::vec3(0.0f, -2.0f, 0.0f));   // Slightly below origin
+    Mg = glm::scale(Mg, glm::vec3(kGroundExtent, 0.30f, kGroundExtent)); // Scale ground to desired footprint
+    records.draw_records[kGroundRecord] = make_draw_record(scene_->cube_mesh, Mg, glm::vec4(15.0f/255.0f, 43.0f/255.0f, 70.0f/255.0f, 1.0f),
+                                                           settings_.color_mode == ColorMode::Lit ? ColorMode::Lit : ColorMode::Uniform); // Lit with the objects
+    records.draw_records[kGroundEdgeRecord] = make_draw_record(scene_->cube_edge_mesh, Mg, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),
+                                                               ColorMode::Uniform); // Outline is drawn as lines, outside the multi-draw
+    records.cull_objects[0] = make_cull_object(scene_->cube_mesh, kGroundRecord, glm::vec3(0.0f, -2.0f, 0.0f),
+                                               glm::length(glm::vec3(kGroundExtent, 0.30f, kGroundExtent)) * 0.5f);
+
+    // Objects: every slot is known up front, so jobs write their ranges in place
+    const int selected = scene_->selected_object_index;
+    const ColorMode color_mode = settings_.color_mode;
+    records.lights = scene_->lights; // Binned by the renderer with the camera of each frame
+    records.point_clouds = scene_->point_clouds; // Shared octrees; only the placements are copied
+    records.occlusion_bake = scene_->last_occlusion_bake;
+    std::vector<GLuint> bone_offsets(objects.size(), 0); // First palette matrix of each rigged object (prefix sum, so serial)
+    animation_instances_.clear();
+    GLuint bone_count = 0;
+    for (std::size_t i = 0; i < objects.size(); i++)
+    {
+        if (!objects[i].skin) continue;
+        bone_offsets[i] = bone_count;
+        bone_count += static_cast<GLuint>(objects[i].skin->bone_joints.size());
+        animation_instances_.push_back({objects[i].skin.get(), objects[i].animation_clip, objects[i].animation_tick_offset});
+    }
+    records.build_jobs = frame_job_count(objects.size(), kMinRecordsPerJob);
+    run_frame_jobs(records.build_jobs, objects.size(), [&](std::size_t, const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; i++)
+        {
+            const ImportedObject &object = objects[i];
+            const int object_index = static_cast<int>(i); // Object index for coloring/selection
+            const bool is_selected = object_index == selected; // Determine selection state
+            const float r = is_selected ? 0.95f : 0.6f + 0.15f * static_cast<float>(object_index % 3); // Pick stable color ramp
+            const float g = is_selected ? 0.85f : 0.65f + 0.12f * static_cast<float>((object_index + 1) % 3); // Tweak green per index
+            const float b = is_selected ? 0.35f : 0.75f; // Accent color used when selected
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), object.translation); // Build model matrix from object state
+            model = glm::scale(model, glm::vec3(object.scale)); // Incorporate object scale into model matrix
+            const auto record = static_cast<GLuint>(kFirstObjectRecord + i); // Index doubles as base instance
+            records.draw_records[record] = make_draw_record(object.mesh, model, glm::vec4(r, g, b, 1.0f), color_mode, object.texture);
+            records.draw_records[record].flags = kDrawWireframe; // Only imported meshes get edges, not the ground
+            records.draw_records[record].bone_offset = bone_offsets[i];
+            records.software_meshes[record] = object.software_mesh;
+            records.cull_objects[kFirstObjectCullObject + i] = make_cull_object(object.mesh, record, object.translation,
+                                                                                object.radius * object.scale); // Pick sphere doubles as cull bounds
+        }
+    });
+
+    GLuint max_triangles = scene_->cube_mesh.lods[0].index_count / 3; // Coarser LODs never have more triangles than LOD 0
+    for (const auto &object : scene_->imported_objects) max_triangles = std::max(max_triangles, object.mesh.lods[0].index_count / 3);
+    records.triangle_bits = std::clamp<GLuint>(static_cast<GLuint>(std::bit_width(max_triangles - 1)), 1u, 31u);
+    records.ids_fit = (static_cast<std::uint64_t>(records.draw_records.size()) << records.triangle_bits) <= kEmptyVisibilityId; // Largest id stays below the clear value
+    records.build_ms = static_cast<double>(build_timer.nsecsElapsed()) / 1.0e6;
+    records.revision++;
+    built_scene_revision_ = scene_->revision;
+    draw_records_dirty_ = false;
+}
+
+void View::update_animation()
+{
+    if (animation_instances_.empty())
+    {
+        animation_palette_.reset(); // Nothing rigged: the renderer keeps its identity matrix
+        animation_stats_ = {};
+        return;
+    }
+    if (animation_palette_ && animation_palette_tick_ == animation_tick_ && animation_records_revision_ == scene_records_.revision) return;
+
+    auto palette = std::make_shared<std::vector<glm::mat4>>();
+    evaluate_animation_palette(animation_instances_, animation_tick_, *palette, animation_stats_);
+    if (animation_palette_ && animation_palette_tick_ != animation_tick_) // Moved limbs leave and enter shadow tiles
+    {
+        for (const ImportedObject &object : scene_->imported_objects)
+        {
+            if (object.skin) mark_shadow_caster_dirty(object);
+        }
+    }
+    animation_palette_ = std::move(palette);
+    animation_palette_revision_++;
+    animation_palette_tick_ = animation_tick_;
+    animation_records_revision_ = scene_records_.revision;
+}
+
+void View::advance_animation_clock()
+{
+    if (animation_fixed_step_)
+    {
+        animation_tick_++; // Same frames on every machine, however long each one took
+        return;
+    }
+    animation_tick_ = static_cast<std::uint64_t>(std::max<std::int64_t>(monotonic_ns() - animation_start_ns_, 0) / kAnimationStepNs);
+}
+
+void View::upload_bone_palette()
+{
+    const glm::mat4 identity(1.0f); // The buffer stays bindable without rigged objects
+    const std::vector<glm::mat4> *palette = frame_.bone_palette.get();
+    const bool empty = !palette || palette->empty();
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, bone_palette_buffer_);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>((empty ? 1 : palette->size()) * sizeof(glm::mat4)),
+                 empty ? glm::value_ptr(identity) : glm::value_ptr(palette->front()), GL_STREAM_DRAW); // Rewritten with every pose
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    uploaded_bone_palette_revision_ = frame_.bone_palette_revision;
+}
+
+void View::upload_draw_records()
+{
+    const SceneRecords &records = frame_.records;
+    ensure_draw_id_capacity(static_cast<GLuint>(records.draw_records.size())); // Base instances index the records
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, draw_record_buffer_);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(records.draw_records.size() * sizeof(DrawRecord)),
+                 records.draw_records.data(), GL_DYNAMIC_DRAW); // Rewritten on scene edits only
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, cull_object_buffer_);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(records.cull_objects.size() * sizeof(CullObject)),
+                 records.cull_objects.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    cull_objects_sorted_ = false; // Scene order again; cull_on_gpu re-sorts when asked to
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, frame_first_index_buffer_);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(records.draw_records.size() * sizeof(GLuint)),
+                 nullptr, GL_DYNAMIC_DRAW); // Filled every frame by the culling path
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, light_buffer_);
+    const ClusterLight no_light; // The buffer stays bindable without lights
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(std::max<std::size_t>(records.lights.size(), 1) * sizeof(ClusterLight)),
+                 records.lights.empty() ? &no_light : records.lights.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    ensure_indirect_capacity(static_cast<GLuint>(records.cull_objects.size())); // One slot per object covers both paths
+    attach_index_pool(); // Records change with every scene edit, including pool reallocations made in another view's context
+    uploaded_records_revision_ = records.revision;
+}
+
+void View::ensure_indirect_capacity(const GLuint command_count)
+{
+    if (command_count <= indirect_capacity_) return;
+    indirect_capacity_ = std::max(command_count, indirect_capacity_ * 2); // Amortize growth while importing
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirect_buffer_);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(indirect_capacity_ * sizeof(DrawElementsIndirectCommand)),
+                 nullptr, GL_DYNAMIC_DRAW); // Written by the GPU or by glBufferSubData each frame
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void View::ensure_draw_id_capacity(const GLuint count)
+{
+    if (count <= draw_id_capacity_) return;
+    draw_id_capacity_ = std::max(count, draw_id_capacity_ * 2); // Grow the 0..N-1 id table when the scene outgrows it
+    std::vector<GLuint> ids(draw_id_capacity_);
+    std::iota(ids.begin(), ids.end(), 0u);
+    glBindBuffer(GL_ARRAY_BUFFER, draw_id_buffer_);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(ids.size() * sizeof(GLuint)), ids.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+float View::lod_projection_scale() const
+{
+    return frame_.projection[1][1] * 0.5f * static_cast<float>(viewport_height_); // cot(fov/2) * half the viewport height
+}
+
+GLuint View::select_lod(const CullObject &object) const
+{
+    const float distance = glm::length(glm::vec3(object.sphere) - frame_.camera_position);
+    if (distance <= object.sphere.w) return 0; // Camera inside the bounds always gets full detail
+    const float pixels = object.sphere.w / distance * lod_projection_scale(); // Projected radius in pixels
+    const GLuint lod = static_cast<GLuint>(pixels < kLodPixelThresholds.x) +
+                       static_cast<GLuint>(pixels < kLodPixelThresholds.y) +
+                       static_cast<GLuint>(pixels < kLodPixelThresholds.z);
+    return std::min(lod, object.lod_count - 1);
+}
+
+void View::cull_on_gpu(const glm::mat4 &view_projection)
+{
+    const auto planes = extract_frustum_planes(view_projection);
+    const auto object_count = static_cast<GLuint>(frame_.records.cull_objects.size());
+    frame_stats_.draws_sorted = frame_.settings.sort_draws;
+    if (frame_stats_.draws_sorted)
+    {
+        sort_cull_objects();
+    }
+    else if (cull_objects_sorted_) // Back to scene order
+    {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, cull_object_buffer_);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(frame_.records.cull_objects.size() * sizeof(CullObject)),
+                        frame_.records.cull_objects.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        cull_objects_sorted_ = false;
+    }
+    // Appending keeps arrival order only, so sorting keeps one slot per object (culled ones become empty draws);
+    // without the count entry point the slots are kept anyway
+    const bool compact = !frame_stats_.draws_sorted && multi_draw_elements_indirect_count_ != nullptr;
+
+    glUseProgram(cull_program_id_); // Bind compute program
+    glUniform4fv(cull_location_frustum_planes_, 6, glm::value_ptr(planes[0]));
+    glUniform3fv(cull_location_camera_position_, 1, glm::value_ptr(frame_.camera_position));
+    glUniform1f(cull_location_lod_projection_scale_, lod_projection_scale());
+    glUniform3fv(cull_location_lod_thresholds_, 1, glm::value_ptr(kLodPixelThresholds));
+    glUniform1ui(cull_location_object_count_, object_count);
+    glUniform1i(cull_location_compact_output_, compact ? 1 : 0);
+
+    constexpr GLuint zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, draw_count_buffer_);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GLuint), &zero); // Reset the append counter
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kCullObjectBinding, cull_object_buffer_);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kDrawCommandBinding, indirect_buffer_); // Commands land straight in the indirect buffer
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kDrawCountBinding, draw_count_buffer_);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kFrameFirstIndexBinding, frame_first_index_buffer_);
+    glDispatchCompute((object_count + kCullWorkgroupSize - 1) / kCullWorkgroupSize, 1, 1);
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT); // Make commands and count visible to the draw
+
+    frame_command_count_ = static_cast<GLsizei>(object_count); // Maximum; the real count stays on the GPU
+    frame_uses_draw_count_ = compact;
+}
+
+void View::sort_cull_objects()
+{
+    QElapsedTimer sort_timer; // Key build, sort, gather and upload
+    sort_timer.start();
+    const SceneRecords &records = frame_.records;
+    sort_entries_.clear();
+    std::size_t unsorted_changes = 0; // Scene order, for comparison in the HUD
+    for (std::size_t i(0); i < records.cull_objects.size(); i++)
+    {
+        const DrawRecord &record = records.draw_records[records.cull_objects[i].record_index];
+        const float view_depth = -(frame_.view_matrix * record.model[3]).z; // Same key as the CPU path
+        const std::uint64_t key = make_render_key(record.format, view_depth);
+        if (i > 0) unsorted_changes += render_key_format(key) != render_key_format(sort_entries_.back().key);
+        sort_entries_.push_back({key, static_cast<std::uint32_t>(i)});
+    }
+    radix_sort_render_keys(sort_entries_, sort_scratch_); // O(objects); stable, so equal keys keep scene order
+
+    std::size_t sorted_changes = 0;
+    sorted_cull_objects_.resize(sort_entries_.size());
+    for (std::size_t i(0); i < sort_entries_.size(); i++)
+    {
+        sorted_cull_objects_[i] = records.cull_objects[sort_entries_[i].index];
+        if (i > 0) sorted_changes += render_key_format(sort_entries_[i].key) != render_key_format(sort_entries_[i - 1].key);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, cull_object_buffer_); // Sized by upload_draw_records for the same objects
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(sorted_cull_objects_.size() * sizeof(CullObject)),
+                    sorted_cull_objects_.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    cull_objects_sorted_ = true;
+
+    frame_stats_.sort_ms = static_cast<double>(sort_timer.nsecsElapsed()) / 1.0e6;
+    frame_stats_.sorted_draws = sort_entries_.size();
+    frame_stats_.format_switches = sorted_changes; // Culled slots are empty draws, so these count every object
+    frame_stats_.unsorted_format_switches = unsorted_changes;
+}
+
+void View::cull_on_cpu(const glm::mat4 &view_projection)
+{
+    const auto planes = extract_frustum_planes(view_projection);
+    const SceneRecords &records = frame_.records;
+    const std::size_t object_count = records.cull_objects.size();
+    const std::size_t jobs = frame_job_count(object_count, kMinCullObjectsPerJob);
+    if (frame_job_lists_.size() < jobs) frame_job_lists_.resize(jobs);
+    frame_first_indices_.assign(records.draw_records.size(), 0u);
+    frame_stats_.prep_jobs = jobs;
+
+    // Cull + LOD: each job appends the visible draws of its object range to its own list
+    QElapsedTimer stage_timer; // Per-stage times for the HUD
+    stage_timer.start();
+    run_frame_jobs(jobs, object_count, [&](const std::size_t job, const std::size_t begin, const std::size_t end)
+    {
+        std::vector<DrawElementsIndirectCommand> &commands = frame_job_lists_[job].commands;
+        commands.clear();
+        for (std::size_t i = begin; i < end; i++) // Same tests as the compute shader, evaluated per object
+        {
+            const CullObject &object = records.cull_objects[i];
+            const bool visible = std::ranges::none_of(planes, [&](const glm::vec4 &plane)
+            {
+                return glm::dot(glm::vec3(plane), glm::vec3(object.sphere)) + plane.w < -object.sphere.w;
+            });
+            if (!visible) continue;
+
+            const GLuint lod = select_lod(object);
+            DrawElementsIndirectCommand command;
+            command.count = object.lod_index_count[lod];
+            command.first_index = object.lod_first_index[lod];
+            command.base_instance = object.record_index; // draw_id attribute fetches this record
+            commands.push_back(command);
+            frame_first_indices_[object.record_index] = command.first_index; // One object per record: jobs never share a slot
+        }
+    });
+    draw_commands_.clear();
+    for (std::size_t job(0); job < jobs; job++) // Job order is scene order
+    {
+        FrameJobList &list = frame_job_lists_[job];
+        list.first = draw_commands_.size();
+        draw_commands_.insert(draw_commands_.end(), list.commands.begin(), list.commands.end());
+    }
+    frame_stats_.cull_ms = static_cast<double>(stage_timer.nsecsElapsed()) / 1.0e6;
+    frame_stats_.pack_ms = 0.0;
+
+    frame_stats_.draws_sorted = frame_.settings.sort_draws;
+    if (frame_stats_.draws_sorted)
+    {
+        const auto key_of = [&](const std::size_t i) // Key of one merged command
+        {
+            const DrawRecord &record = records.draw_records[draw_commands_[i].base_instance];
+            const float view_depth = -(frame_.view_matrix * record.model[3]).z; // Object origin distance along the view axis
+            return make_render_key(record.format, view_depth); // Format: decode branch taken by the vertex shader
+        };
+
+        // Keys + sort: each job sorts the keys of its own list (stable, so equal keys keep scene order)
+        stage_timer.restart();
+        sort_entries_.resize(draw_commands_.size());
+        run_frame_jobs(jobs, jobs, [&](const std::size_t job, std::size_t, std::size_t)
+        {
+            FrameJobList &list = frame_job_lists_[job];
+            list.keys.clear();
+            list.format_switches = 0; // Scene order, for comparison in the HUD
+            for (std::size_t i = list.first; i < list.first + list.commands.size(); i++)
+            {
+                const std::uint64_t key = key_of(i);
+                if (i > 0) // The first key of a range compares with the last command of the previous job
+                {
+                    const std::uint64_t previous = i == list.first ? key_of(i - 1) : list.keys.back().key;
+                    list.format_switches += render_key_format(key) != render_key_format(previous);
+                }
+                list.keys.push_back({key, static_cast<std::uint32_t>(i)});
+            }
+            radix_sort_render_keys(list.keys, list.scratch); // Ascending: state groups, then nearest first for early-Z
+            std::ranges::copy(list.keys, sort_entries_.begin() + static_cast<std::ptrdiff_t>(list.first));
+        });
+        std::size_t unsorted_changes = 0;
+        for (std::size_t job(0); job < jobs; job++) unsorted_changes += frame_job_lists_[job].format_switches;
+
+        // Merge the sorted runs pairwise; the left run wins ties, which reproduces one stable sort over the whole list
+        const auto run_begin = [&](const std::size_t job)
+        {
+            return sort_entries_.begin() + static_cast<std::ptrdiff_t>(job < jobs ? frame_job_lists_[job].first : sort_entries_.size());
+        };
+        for (std::size_t width(1); width < jobs; width *= 2)
+        {
+            const std::size_t pairs = (jobs + 2 * width - 1) / (2 * width);
+            run_frame_jobs(pairs, pairs, [&](const std::size_t pair, std::size_t, std::size_t)
+            {
+                const std::size_t left = pair * 2 * width;
+                if (left + width >= jobs) return; // Odd run out: already in place
+                std::inplace_merge(run_begin(left), run_begin(left + width), run_begin(std::min(left + 2 * width, jobs)),
+                                   [](const RenderKeyEntry &a, const RenderKeyEntry &b) { return a.key < b.key; });
+            });
+        }
+        frame_stats_.sort_ms = static_cast<double>(stage_timer.nsecsElapsed()) / 1.0e6;
+
+        // Pack: gather the commands into key order, counting state switches per range
+        stage_timer.restart();
+        sorted_commands_.resize(draw_commands_.size());
+        run_frame_jobs(jobs, sort_entries_.size(), [&](const std::size_t job, const std::size_t begin, const std::size_t end)
+        {
+            std::size_t changes = 0;
+            for (std::size_t i = begin; i < end; i++)
+            {
+                sorted_commands_[i] = draw_commands_[sort_entries_[i].index];
+                if (i > 0) changes += render_key_format(sort_entries_[i].key) != render_key_format(sort_entries_[i - 1].key);
+            }
+            frame_job_lists_[job].format_switches = changes;
+        });
+        std::size_t sorted_changes = 0;
+        for (std::size_t job(0); job < jobs; job++) sorted_changes += frame_job_lists_[job].format_switches;
+        draw_commands_.swap(sorted_commands_);
+        frame_stats_.pack_ms = static_cast<double>(stage_timer.nsecsElapsed()) / 1.0e6;
+
+        frame_stats_.sorted_draws = sort_entries_.size();
+        frame_stats_.format_switches = sorted_changes;
+        frame_stats_.unsorted_format_switches = unsorted_changes;
+    }
+
+    // Submit: the GL thread only uploads the merged result
+    stage_timer.restart();
+    ensure_indirect_capacity(static_cast<GLuint>(draw_commands_.size()));
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirect_buffer_);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, static_cast<GLsizeiptr>(draw_commands_.size() * sizeof(DrawElementsIndirectCommand)),
+                    draw_commands_.data());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, frame_first_index_buffer_);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(frame_first_indices_.size() * sizeof(GLuint)),
+                    frame_first_indices_.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    frame_stats_.upload_ms = static_cast<double>(stage_timer.nsecsElapsed()) / 1.0e6;
+
+    frame_command_count_ = static_cast<GLsizei>(draw_commands_.size());
+    frame_uses_draw_count_ = false;
+}
+
+void View::submit_culled_draws()
+{
+    if (frame_command_count_ <= 0) return; // Nothing survived culling
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirect_buffer_); // Source of the multi-draw commands
+    if (frame_uses_draw_count_)
+    {
+        glBindBuffer(kParameterBuffer, draw_count_buffer_); // Draw count written by the cull shader
+        multi_draw_elements_indirect_count_(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, 0,
+                                            frame_command_count_, sizeof(DrawElementsIndirectCommand));
+        glBindBuffer(kParameterBuffer, 0);
+    }
+    else
+    {
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr,
+                                    frame_command_count_, sizeof(DrawElementsIndirectCommand));
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0); // Avoid leaking indirect state
+}
+
+void View::draw_point_clouds(const glm::mat4 &view_projection)
+{
+    const std::vector<PointCloudObject> &clouds = frame_.records.point_clouds;
+    frame_stats_.point_clouds = clouds.size();
+    if (clouds.empty() || !point_program_id_) return; // Nothing imported, or the program is still compiling
+    QElapsedTimer point_timer;
+    point_timer.start();
+
+    if (!point_page_buffer_ || point_page_budget_ != frame_.settings.point_budget) // Sized for the budget plus partly filled pages
+    {
+        release_point_pages();
+        point_page_budget_ = frame_.settings.point_budget;
+        point_page_capacity_ = static_cast<GLuint>(point_page_budget_ / kPointPageSize * 5 / 4 + kPointSparePages);
+        glGenBuffers(1, &point_page_buffer_);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, point_page_buffer_);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(point_page_capacity_ * kPointPageSize * sizeof(PointCloudPoint)),
+                     nullptr, GL_DYNAMIC_DRAW); // Filled page by page as nodes are selected
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        point_free_pages_.resize(point_page_capacity_);
+        std::iota(point_free_pages_.rbegin(), point_free_pages_.rend(), 0u); // Taken from the back: low pages first
+    }
+
+    // Nodes in order of projected size until the budget is spent (CPU: the octrees live in system memory)
+    std::vector<PointCloudInstance> instances;
+    instances.reserve(clouds.size());
+    for (const PointCloudObject &cloud : clouds) instances.push_back({cloud.octree.get(), cloud.translation});
+    PointCloudSelectionStats selection_stats;
+    const std::vector<PointCloudSelection> selection = select_point_cloud_nodes(instances, view_projection, frame_.camera_position,
+                                                                                lod_projection_scale(), frame_.settings.point_budget,
+                                                                                point_page_capacity_, kPointMinSpacingPixels, selection_stats);
+    const auto node_key = [&clouds](const PointCloudSelection &node) { return clouds[node.cloud].id << 32 | node.node; };
+
+    // Stream missing nodes coarse to fine, evicting the least recently selected ones when the pages run out
+    point_tick_++;
+    std::vector<std::size_t> missing;
+    for (std::size_t i(0); i < selection.size(); i++)
+    {
+        if (const auto it = point_nodes_.find(node_key(selection[i])); it != point_nodes_.end()) it->second.last_used = point_tick_;
+        else missing.push_back(i);
+    }
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> evictable; // Last use and key, oldest at the back (built on first need)
+    bool evictable_listed = false;
+    std::size_t uploaded = 0;
+    std::size_t waiting = 0;
+    bool throttled = false; // Nodes were held back by the upload limit (not by a full cache)
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, point_page_buffer_);
+    for (const std::size_t i : missing)
+    {
+        const PointCloudOctree &octree = *clouds[selection[i].cloud].octree;
+        const PointCloudNode &node = octree.nodes[selection[i].node];
+        const std::size_t pages = (node.count + kPointPageSize - 1) / kPointPageSize;
+        if (uploaded + node.count > kPointUploadsPerFrame) // Parents keep drawing; the rest follows in the next frames
+        {
+            waiting++;
+            throttled = true;
+            continue;
+        }
+        if (point_free_pages_.size() < pages && !evictable_listed)
+        {
+            for (const auto &[key, residency] : point_nodes_)
+            {
+                if (residency.last_used != point_tick_) evictable.emplace_back(residency.last_used, key);
+            }
+            std::ranges::sort(evictable, std::greater<>());
+            evictable_listed = true;
+        }
+        while (point_free_pages_.size() < pages && !evictable.empty())
+        {
+            const auto it = point_nodes_.find(evictable.back().second);
+            evictable.pop_back();
+            point_free_pages_.insert(point_free_pages_.end(), it->second.pages.begin(), it->second.pages.end());
+            point_nodes_.erase(it);
+        }
+        if (point_free_pages_.size() < pages) // Every page holds a node of this frame
+        {
+            waiting++;
+            continue;
+        }
 
-    glGenBuffers(1, &edge_vertex_buffer_object); // Create VBO for edge vertices
-    glBindBuffer(GL_ARRAY_BUFFER, edge_vertex_buffer_object); // Bind edge VBO for upload
-    glBufferData(GL_ARRAY_BUFFER, sizeof(cube_edge_vertices), cube_edge_vertices, GL_STATIC_DRAW); // Upload line segment data
+        PointNodeResidency residency;
+        residency.last_used = point_tick_;
+        for (std::size_t page(0); page < pages; page++)
+        {
+            residency.pages.push_back(point_free_pages_.back());
+            point_free_pages_.pop_back();
+            const std::size_t first = page * kPointPageSize;
+            const std::size_t count = std::min<std::size_t>(kPointPageSize, node.count - first);
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, static_cast<GLintptr>(residency.pages.back() * kPointPageSize * sizeof(PointCloudPoint)),
+                            static_cast<GLsizeiptr>(count * sizeof(PointCloudPoint)), octree.points.data() + node.first + first);
+        }
+        uploaded += node.count;
+        point_nodes_.emplace(node_key(selection[i]), std::move(residency));
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    // One draw per resident page; base instance selects the page's placement and point spacing
+    point_commands_.clear();
+    point_draws_.clear();
+    std::size_t points_drawn = 0;
+    for (const PointCloudSelection &selected : selection)
+    {
+        const auto it = point_nodes_.find(node_key(selected));
+        if (it == point_nodes_.end()) continue; // Waiting for its upload
+        const PointCloudNode &node = clouds[selected.cloud].octree->nodes[selected.node];
+        for (std::size_t page(0); page < it->second.pages.size(); page++)
+        {
+            const auto count = static_cast<GLuint>(std::min<std::size_t>(kPointPageSize, node.count - page * kPointPageSize));
+            point_commands_.push_back({count, 1, static_cast<GLuint>(it->second.pages[page] * kPointPageSize), static_cast<GLuint>(point_commands_.size())});
+            point_draws_.emplace_back(clouds[selected.cloud].translation, selected.spacing);
+        }
+        points_drawn += node.count;
+    }
+
+    if (!point_commands_.empty())
+    {
+        if (!point_draw_buffer_) glGenBuffers(1, &point_draw_buffer_);
+        if (!point_indirect_buffer_) glGenBuffers(1, &point_indirect_buffer_);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, point_draw_buffer_);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(point_draws_.size() * sizeof(glm::vec4)), point_draws_.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, point_indirect_buffer_);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(point_commands_.size() * sizeof(DrawArraysIndirectCommand)),
+                     point_commands_.data(), GL_STREAM_DRAW); // Rebuilt every frame: the selection follows the camera
+        ensure_draw_id_capacity(static_cast<GLuint>(point_commands_.size()));
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kPointPageBinding, point_page_buffer_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kPointDrawBinding, point_draw_buffer_);
+        glUseProgram(point_program_id_);
+        glUniformMatrix4fv(point_location_view_projection_, 1, GL_FALSE, glm::value_ptr(view_projection));
+        glUniform1f(point_location_point_scale_, lod_projection_scale()); // Spacing / clip w * scale = spacing in pixels
+        glEnable(GL_PROGRAM_POINT_SIZE);
+        glMultiDrawArraysIndirect(GL_POINTS, nullptr, static_cast<GLsizei>(point_commands_.size()), 0);
+        glDisable(GL_PROGRAM_POINT_SIZE);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0); // Avoid leaking indirect state
+    }
+
+    frame_stats_.point_nodes = selection.size();
+    frame_stats_.points_drawn = points_drawn;
+    frame_stats_.point_visited_nodes = selection_stats.visited_nodes;
+    frame_stats_.point_budget_reached = selection_stats.budget_reached;
+    frame_stats_.point_missing_nodes = waiting;
+    frame_stats_.point_uploaded = uploaded;
+    frame_stats_.point_resident_pages = point_page_capacity_ - point_free_pages_.size();
+    frame_stats_.point_page_capacity = point_page_capacity_;
+    frame_stats_.point_ms = static_cast<double>(point_timer.nsecsElapsed()) / 1.0e6;
+    if (throttled) request_redraw(); // Keep streaming while the camera rests
+}
+
+void View::release_point_pages()
+{
+    if (point_page_buffer_) glDeleteBuffers(1, &point_page_buffer_);
+    point_page_buffer_ = 0;
+    point_page_capacity_ = 0;
+    point_free_pages_.clear();
+    point_nodes_.clear();
+}
 
-    glEnableVertexAttribArray(0); // Enable position attribute for lines
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), nullptr); // Describe line vertex layout
+void View::set_gpu_culling(const bool enabled)
+{
+    if (settings_.gpu_culling == enabled) return; // Skip redundant updates
+    settings_.gpu_culling = enabled;
+    request_frame(); // Next frame uses the selected path
+}
+
+void View::set_sort_draws(const bool enabled)
+{
+    if (settings_.sort_draws == enabled) return; // Skip redundant updates
+    settings_.sort_draws = enabled;
+    request_frame(); // Next frame submits in the selected order
+}
+
+void View::set_depth_prepass(const ColorMode mode, const DepthPrepass setting)
+{
+    settings_.depth_prepass_modes[static_cast<std::size_t>(mode)] = setting;
+    request_frame(); // Policy applies from the next frame
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0); // Unbind edge VBO
-    glBindVertexArray(0); // Unbind edge VAO
+bool View::use_depth_prepass() const
+{
+    if (!depth_prepass_program_id_) return false; // Program failed to build
+    switch (frame_.settings.depth_prepass_modes[static_cast<std::size_t>(frame_.settings.color_mode)])
+    {
+        case DepthPrepass::Off: return false;
+        case DepthPrepass::On: return true;
+        case DepthPrepass::Auto: return auto_prepass_active_ || frames_since_coverage_ >= kCoverageProbeFrames; // Or a coverage probe
+    }
+    return false;
 }
 
-void View::draw_cube(const glm::mat4 &model, const glm::vec4 &color, const ColorMode mode) // Draw one cube with a given transform and RGBA color
+void View::set_render_path(const RenderPath path)
 {
-    const glm::mat4 mvp = projection * view_matrix * model;    // Build the final transform: Model→View→Projection (rightmost applied first)
-    const auto normal_matrix = glm::mat3(glm::transpose(glm::inverse(model))); // Compute normal matrix for correct lighting
+    if (settings_.render_path == path) return; // Skip redundant updates
+    settings_.render_path = path;
+    request_frame(); // Next frame uses the selected path
+}
 
-    if (uniform_location_mvp >= 0) glUniformMatrix4fv(uniform_location_mvp, 1, GL_FALSE, glm::value_ptr(mvp)); // Upload MVP transform
-    if (uniform_location_model >= 0) glUniformMatrix4fv(uniform_location_model, 1, GL_FALSE, glm::value_ptr(model)); // Upload model transform
-    if (uniform_location_normal_matrix >= 0) glUniformMatrix3fv(uniform_location_normal_matrix, 1, GL_FALSE, glm::value_ptr(normal_matrix)); // Upload normal matrix
-    if (uniform_location_color >= 0) glUniform4f(uniform_location_color, color.r, color.g, color.b, color.a); // Upload base material color
-    if (uniform_location_color_mode >= 0) glUniform1i(uniform_location_color_mode, static_cast<int>(mode)); // Upload color mode selection
+void View::set_dynamic_resolution(const bool enabled)
+{
+    if (settings_.dynamic_resolution == enabled) return; // Skip redundant updates
+    settings_.dynamic_resolution = enabled;
+    request_frame(); // Scale and samples are reset by apply_render_settings
+}
 
-    glDrawArrays(GL_TRIANGLES, 0, 36);  // Draw 36 vertices (12 triangles) for one cube
+void View::set_frame_budget_ms(const double budget_ms)
+{
+    settings_.frame_budget_ms = std::max(1.0, budget_ms);
+    request_frame();
 }
 
-void View::draw_cube_edges(const glm::mat4 &model, const glm::vec4 &color)
+void View::set_adaptive_msaa(const bool enabled)
 {
-    const glm::mat4 mvp = projection * view_matrix * model; // Compute edge MVP transform
-    const auto normal_matrix = glm::mat3(glm::transpose(glm::inverse(model))); // Reuse model normal matrix for completeness
+    if (settings_.adaptive_msaa == enabled) return; // Skip redundant updates
+    settings_.adaptive_msaa = enabled;
+    request_frame();
+}
 
-    glBindVertexArray(edge_vertex_array_object); // Bind edge VAO for drawing
-    if (uniform_location_mvp >= 0) glUniformMatrix4fv(uniform_location_mvp, 1, GL_FALSE, glm::value_ptr(mvp)); // Upload MVP transform
-    if (uniform_location_model >= 0) glUniformMatrix4fv(uniform_location_model, 1, GL_FALSE, glm::value_ptr(model)); // Upload model transform
-    if (uniform_location_normal_matrix >= 0) glUniformMatrix3fv(uniform_location_normal_matrix, 1, GL_FALSE, glm::value_ptr(normal_matrix)); // Upload normal matrix
-    if (uniform_location_color >= 0) glUniform4f(uniform_location_color, color.r, color.g, color.b, color.a); // Upload wireframe color
-    const auto previous_mode = static_cast<GLint>(color_mode_); // Preserve current color mode
-    if (uniform_location_color_mode >= 0) glUniform1i(uniform_location_color_mode, static_cast<int>(ColorMode::Uniform)); // Force uniform color for edges
-    glDrawArrays(GL_LINES, 0, 12 * 2); // Render 12 line segments (24 vertices)
-    if (uniform_location_color_mode >= 0) glUniform1i(uniform_location_color_mode, previous_mode); // Restore previous color mode
-    glBindVertexArray(vertex_array_object); // Rebind default VAO for subsequent draws
+void View::set_anti_aliasing(const AntiAliasing mode)
+{
+    if (settings_.anti_aliasing == mode) return; // Skip redundant updates
+    settings_.anti_aliasing = mode;
+    request_frame(); // The scene target is reallocated on the next frame
+}
+
+void View::set_shadows(const bool enabled)
+{
+    if (settings_.shadows == enabled) return;
+    settings_.shadows = enabled; // The atlas is kept; it only stops being sampled and updated
+    request_frame();
+}
+
+void View::set_wireframe(const bool enabled)
+{
+    if (settings_.wireframe == enabled) return;
+    settings_.wireframe = enabled; // Records carry the per-draw flag; only the program and a uniform change
+    request_frame();
+}
+
+void View::set_point_budget(const std::size_t points)
+{
+    const std::size_t budget = std::clamp<std::size_t>(points, 100'000, 100'000'000);
+    if (settings_.point_budget == budget) return;
+    settings_.point_budget = budget; // The renderer resizes its page cache with the next frame
+    request_frame();
+}
+
+void View::set_light_count(const int count)
+{
+    const auto light_count = static_cast<std::size_t>(std::max(0, count));
+    if (light_count == scene_->lights.size()) return;
+    scene_->lights = make_demo_lights(light_count, kGroundExtent, kGroundPlaneY);
+    mark_scene_dirty(); // Lights travel with the records of every view
+    request_frame();
+}
+
+void View::set_hud_visible(const bool visible)
+{
+    if (settings_.hud_visible == visible) return; // Skip redundant updates
+    settings_.hud_visible = visible;
+    request_frame(); // Repaint with or without the overlay
+}
+
+void View::apply_render_settings(const RenderSettings &previous)
+{
+    const RenderSettings &settings = frame_.settings;
+    if (settings.anti_aliasing != previous.anti_aliasing)
+    {
+        preferred_samples_ = std::min(anti_aliasing_samples(settings.anti_aliasing), max_samples_);
+        scene_samples_ = preferred_samples_;
+        smoothed_gpu_ms_ = 0.0; // Cost changed; let the governor measure again
+    }
+    if (settings.dynamic_resolution != previous.dynamic_resolution)
+    {
+        if (!settings.dynamic_resolution) // Back to full resolution and the preferred MSAA level
+        {
+            render_scale_ = 1.0f;
+            scene_samples_ = preferred_samples_;
+        }
+        smoothed_gpu_ms_ = 0.0;
+    }
+    if (settings.adaptive_msaa != previous.adaptive_msaa && !settings.adaptive_msaa)
+    {
+        scene_samples_ = preferred_samples_; // Only the scale adapts from now on
+    }
+    if (settings.frame_budget_ms != previous.frame_budget_ms)
+    {
+        smoothed_gpu_ms_ = 0.0; // Re-evaluate against the new budget from fresh measurements
+    }
+}
+
+void View::set_threaded_rendering(const bool enabled)
+{
+    if (threaded_rendering_ == enabled) return; // Skip redundant updates
+    threaded_rendering_ = enabled;
+    if (!surface_->gl_initialized()) return; // initializeGL starts the thread
+    if (enabled)
+    {
+        start_render_thread();
+    }
+    else
+    {
+        stop_render_thread();
+        surface_->schedule_paint(); // Paint from paintEvent again
+    }
+}
+
+void View::request_frame(const std::int64_t input_ns)
+{
+    if (input_ns > 0 && pending_input_ns_ == 0) pending_input_ns_ = input_ns; // Oldest input waiting for a frame
+    if (!renderer_)
+    {
+        surface_->schedule_paint(); // paintGL publishes and renders on the GUI thread
+        return;
+    }
+    publish_snapshot(); // The render thread only ever reads published state
+    start_threaded_frame();
+}
+
+void View::request_redraw()
+{
+    if (renderer_) redraw_requested_ = true; // Picked up by the GUI thread when the current frame is on screen
+    else surface_->schedule_paint();
+}
+
+void View::publish_snapshot()
+{
+    if (draw_records_dirty_ || built_scene_revision_ != scene_->revision) build_scene_records(); // Scene edits only; camera moves reuse the records
+    update_animation(); // Outside the lock: the renderer keeps drawing the previous pose meanwhile
+
+    QMutexLocker lock(&snapshot_mutex_);
+    SceneSnapshot &snapshot = published_snapshot_;
+    snapshot.settings = settings_;
+    snapshot.view_matrix = build_view_matrix();
+    snapshot.projection = projection;
+    snapshot.camera_position = cam_position;
+    if (snapshot.records.revision != scene_records_.revision) snapshot.records = scene_records_; // Copy on change only
+    if (snapshot.input_ns == 0) snapshot.input_ns = pending_input_ns_; // Keep the oldest input if the renderer lags behind
+    pending_input_ns_ = 0;
+    snapshot.latency = latency_;
+    snapshot.threaded = renderer_ != nullptr;
+    snapshot.shadow_dirty_tiles |= std::exchange(shadow_dirty_tiles_, 0); // Accumulates if the renderer lags behind
+    snapshot.startup = startup_;
+    snapshot.bone_palette = animation_palette_; // Shared, immutable once published
+    snapshot.bone_palette_revision = animation_palette_revision_;
+    snapshot.animation = animation_stats_;
+    snapshot.animation_tick = animation_palette_tick_;
+    CaptureRequest &capture = snapshot.capture; // Screenshots accumulate if the renderer lags behind
+    capture.recording = capture_request_.recording;
+    capture.directory = capture_request_.directory;
+    capture.format = capture_request_.format;
+    capture.session = capture_request_.session;
+    capture.screenshots.insert(capture.screenshots.end(), capture_request_.screenshots.begin(), capture_request_.screenshots.end());
+    capture_request_.screenshots.clear();
+    if (const ShaderReload *reload = shader_reload())
+    {
+        snapshot.shader_overrides = reload->overrides();
+        snapshot.shader_revision = reload->revision();
+    }
+    snapshot.textures.count = scene_->textures.size();
+    snapshot.textures.decoded = static_cast<std::size_t>(std::ranges::count_if(scene_->textures, [](const SceneTexture &texture) { return texture.texture != 0; }));
+    snapshot.textures.resident_bytes = scene_->texture_resident_bytes;
+    snapshot.textures.budget_bytes = scene_->texture_budget_bytes;
+    snapshot.textures.uploaded_bytes = scene_->texture_uploaded_bytes;
+    snapshot.textures.evicted_levels = scene_->texture_evicted_levels;
+    snapshot.textures.entries.clear();
+    for (const SceneTexture &texture : scene_->textures)
+    {
+        const TextureResidency &residency = texture.residency;
+        if (residency.level_count == 0) continue; // Still decoding
+        snapshot.textures.entries.push_back({QFileInfo(texture.path).fileName(), residency.format, residency.width, residency.height,
+                                             texture_resident_bytes(residency.format, residency.width, residency.height, residency.level_count, 0),
+                                             texture_resident_bytes(TextureFormat::Rgba8, residency.width, residency.height, residency.level_count, 0),
+                                             texture.decoded.encode_ms, texture.decoded.from_cache});
+    }
+    snapshot_pending_ = true;
+}
+
+void View::consume_snapshot()
+{
+    const RenderSettings previous = frame_.settings;
+    {
+        QMutexLocker lock(&snapshot_mutex_);
+        if (!snapshot_pending_) return; // Redraw of the current snapshot (HUD catch-up, governor)
+        std::swap(frame_, published_snapshot_); // The GUI thread overwrites the old front buffer next time
+        published_snapshot_.input_ns = 0; // Reported by the frame that rendered it
+        published_snapshot_.shadow_dirty_tiles = 0; // Handed over below
+        published_snapshot_.capture.screenshots.clear(); // Same
+        snapshot_pending_ = false;
+    }
+    shadow_pending_tiles_ |= frame_.shadow_dirty_tiles; // Kept until a lit frame re-renders them
+    capture_screenshots_.insert(capture_screenshots_.end(), frame_.capture.screenshots.begin(), frame_.capture.screenshots.end()); // Kept until a slot is free
+    frame_.capture.screenshots.clear(); // A redraw of this snapshot must not write them again
+    apply_render_settings(previous);
+}
+
+void View::start_render_thread()
+{
+    // The hand-shakes rely on QOpenGLWidget composition; the window backend presents from paintGL on the GUI thread
+    if (renderer_ || !threaded_rendering_ || !widget_surface_ || !surface_->gl_initialized()) return;
+
+    render_thread_ = std::make_unique<QThread>();
+    render_thread_->setObjectName(QStringLiteral("Render thread"));
+    renderer_ = std::make_unique<FrameRenderer>(this);
+    renderer_->moveToThread(render_thread_.get());
+    connect(this, &View::renderRequested, renderer_.get(), &FrameRenderer::render); // Queued: runs on the render thread
+    connect(renderer_.get(), &FrameRenderer::contextWanted, this, [this] { if (renderer_) renderer_->grab_context(surface_->gl_context()); });
+    connect(renderer_.get(), &FrameRenderer::frameRendered, this, &View::on_frame_rendered);
+    render_thread_->start();
+
+    frame_in_flight_ = false;
+    frame_presenting_ = false;
+    frame_wanted_ = false;
+    request_frame(); // First frame of the new mode
+}
+
+void View::stop_render_thread()
+{
+    if (!renderer_) return;
+    if (render_lock_depth_ > 0) renderer_->unlock(); // A pending resize release would otherwise keep the frame in flight waiting
+    render_lock_depth_ = 0;
+    renderer_->prepare_exit(); // A frame in progress finishes and returns the context; one waiting for it gives up
+    render_thread_->quit(); // Queued render requests are dropped with the event loop
+    render_thread_->wait();
+    renderer_.reset();
+    render_thread_.reset();
+
+    frame_in_flight_ = false;
+    frame_presenting_ = false;
+    frame_wanted_ = false;
+    redraw_requested_ = false;
+}
+
+void View::lock_renderer(const bool need_context)
+{
+    if (!renderer_) return;
+    if (render_lock_depth_++ > 0) return; // Already held by an enclosing GUI operation
+    if (need_context) renderer_->lock_with_context(surface_->gl_context());
+    else renderer_->lock();
+}
+
+void View::unlock_renderer()
+{
+    if (!renderer_ || render_lock_depth_ == 0) return;
+    if (--render_lock_depth_ == 0) renderer_->unlock();
+}
+
+void View::begin_gui_gl()
+{
+    for (View *view : scene_->views) // The pools are shared, so no renderer of the scene may draw during the edit
+    {
+        view->lock_renderer(view == this); // No-op when rendering on the GUI thread; only our context has to come home
+    }
+    surface_->make_current();
+}
+
+void View::end_gui_gl()
+{
+    if (scene_->views.size() > 1 && gl_functions_) glFinish(); // Other contexts may only read the shared pools once the edit completed
+    surface_->done_current();
+    for (View *view : scene_->views)
+    {
+        if (view->renderer_) view->publish_snapshot(); // The next frame must not use records that point at the old pool layout
+        view->unlock_renderer();
+    }
+}
+
+void View::start_threaded_frame()
+{
+    if (frame_in_flight_ || frame_presenting_) // At most one frame ahead of composition; later changes coalesce
+    {
+        frame_wanted_ = true;
+        return;
+    }
+    frame_in_flight_ = true;
+    frame_wanted_ = false;
+    emit renderRequested();
+}
+
+void View::on_frame_rendered()
+{
+    if (!renderer_) return; // Late signal from a stopped renderer
+    frame_in_flight_ = false;
+    frame_presenting_ = true;
+    surface_->schedule_paint(); // Compose the widget framebuffer; paintEvent itself does not draw in this mode
+}
+
+void View::on_frame_swapped()
+{
+    unlock_renderer(); // Taken in aboutToCompose
+
+    double latency_ms = -1.0;
+    if (const std::int64_t input_ns = presented_input_ns_.exchange(0); input_ns > 0)
+    {
+        latency_ms = static_cast<double>(monotonic_ns() - input_ns) / 1.0e6;
+        const std::size_t mode = renderer_ ? 1 : 0;
+        latency_.last_ms = latency_ms;
+        double &average = latency_.average_ms[mode];
+        average = latency_.samples[mode]++ ? average + kLatencyAverageWeight * (latency_ms - average) : latency_ms;
+    }
+    emit framePresented(latency_ms);
+    if (startup_.first_frame_ms < 0.0)
+    {
+        startup_.first_frame_ms = static_cast<double>(monotonic_ns() - process_start_ns) / 1.0e6;
+        qInfo().nospace() << "Time to first frame: " << startup_.first_frame_ms << " ms (shader programs " << startup_.shader_ms << " ms)";
+        request_frame(); // Let the HUD show it
+    }
+    stream_textures(); // One step per presented frame, so detail arrives coarse to fine
+    if (animation_playing_ && !animation_instances_.empty())
+    {
+        advance_animation_clock();
+        request_frame(); // Keep presenting while something moves
+    }
+
+    if (!renderer_) return;
+    frame_presenting_ = false;
+    if (redraw_requested_.exchange(false)) frame_wanted_ = true;
+    if (frame_wanted_) start_threaded_frame();
+}
+
+bool View::create_render_target(RenderTarget &target, const int width, const int height, const GLenum color_format, const bool with_depth)
+{
+    target.width = width;
+    target.height = height;
+
+    glGenTextures(1, &target.color_texture); // Color attachment, sampled with texelFetch by later passes
+    glBindTexture(GL_TEXTURE_2D, target.color_texture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, color_format, width, height); // Immutable storage, single mip
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    if (with_depth)
+    {
+        glGenTextures(1, &target.depth_texture); // Depth attachment, also readable by later passes
+        glBindTexture(GL_TEXTURE_2D, target.depth_texture);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT24, width, height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &target.framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.color_texture, 0);
+    if (with_depth) glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, target.depth_texture, 0);
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, surface_->default_framebuffer()); // QOpenGLWidget renders into its own FBO, QOpenGLWindow into 0
+
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        qWarning() << "Offscreen render target incomplete, status" << Qt::hex << status;
+        destroy_render_target(target);
+        return false;
+    }
+    return true;
+}
+
+void View::destroy_render_target(RenderTarget &target)
+{
+    if (target.framebuffer) glDeleteFramebuffers(1, &target.framebuffer); target.framebuffer = 0;
+    if (target.color_texture) glDeleteTextures(1, &target.color_texture); target.color_texture = 0;
+    if (target.depth_texture) glDeleteTextures(1, &target.depth_texture); target.depth_texture = 0;
+    target.width = 0;
+    target.height = 0;
+}
+
+bool View::ensure_visibility_target()
+{
+    if (visibility_target_.framebuffer && visibility_target_.width == framebuffer_width_ &&
+        visibility_target_.height == framebuffer_height_) return true; // Still matches the widget
+    destroy_render_target(visibility_target_);
+    return create_render_target(visibility_target_, framebuffer_width_, framebuffer_height_, GL_R32UI);
+}
+
+bool View::ensure_scene_target()
+{
+    const int samples = scene_samples_ > 1 ? scene_samples_ : 0; // 0: render into the single-sample target directly
+    const bool size_matches = scene_target_.framebuffer && scene_target_.width == framebuffer_width_ &&
+                              scene_target_.height == framebuffer_height_;
+    const bool samples_match = samples == 0 ? !scene_msaa_target_.framebuffer : scene_msaa_target_.samples == samples;
+    if (size_matches && samples_match) return true; // Scale changes only move the viewport, nothing is reallocated
+
+    destroy_scene_target();
+    if (!create_render_target(scene_target_, framebuffer_width_, framebuffer_height_, GL_RGBA8)) return false;
+    glBindTexture(GL_TEXTURE_2D, scene_target_.color_texture); // FXAA samples between texels and must not wrap
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    if (samples == 0) return true;
+
+    MultisampleTarget &target = scene_msaa_target_;
+    target.width = framebuffer_width_;
+    target.height = framebuffer_height_;
+    target.samples = samples;
+    glGenRenderbuffers(1, &target.color_renderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, target.color_renderbuffer);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8, target.width, target.height);
+    glGenRenderbuffers(1, &target.depth_renderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, target.depth_renderbuffer);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH_COMPONENT24, target.width, target.height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &target.framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target.color_renderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, target.depth_renderbuffer);
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, surface_->default_framebuffer());
+
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        qWarning() << "Multisampled scene target incomplete, status" << Qt::hex << status << "- continuing without MSAA";
+        if (target.framebuffer) glDeleteFramebuffers(1, &target.framebuffer);
+        glDeleteRenderbuffers(1, &target.color_renderbuffer);
+        glDeleteRenderbuffers(1, &target.depth_renderbuffer);
+        target = MultisampleTarget{};
+        scene_samples_ = 1;
+        preferred_samples_ = 1; // Do not retry every frame
+        max_samples_ = 1;
+    }
+    return true;
+}
+
+void View::destroy_scene_target()
+{
+    destroy_render_target(scene_target_);
+    MultisampleTarget &target = scene_msaa_target_;
+    if (target.framebuffer) glDeleteFramebuffers(1, &target.framebuffer);
+    if (target.color_renderbuffer) glDeleteRenderbuffers(1, &target.color_renderbuffer);
+    if (target.depth_renderbuffer) glDeleteRenderbuffers(1, &target.depth_renderbuffer);
+    target = MultisampleTarget{};
+}
+
+GLuint View::scene_framebuffer() const
+{
+    if (scene_msaa_target_.framebuffer) return scene_msaa_target_.framebuffer;
+    if (scene_target_.framebuffer) return scene_target_.framebuffer;
+    return surface_->default_framebuffer(); // Target allocation failed: render at full size into the widget
+}
+
+void View::present_scene()
+{
+    if (!scene_target_.framebuffer) return; // Scene was drawn straight into the widget framebuffer
+
+    if (scene_msaa_target_.framebuffer) // Multisampled blits cannot scale, so resolve at the render size first
+    {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, scene_msaa_target_.framebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, scene_target_.framebuffer);
+        glBlitFramebuffer(0, 0, render_width_, render_height_, 0, 0, render_width_, render_height_, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+
+    const bool scaled = render_width_ != framebuffer_width_ || render_height_ != framebuffer_height_;
+    GLuint upscale_source = scene_target_.framebuffer; // Single-sample color of the render area
+    if (fxaa_active())
+    {
+        if (!scaled)
+        {
+            apply_fxaa(surface_->default_framebuffer(), framebuffer_width_, framebuffer_height_); // Straight into the widget
+            glViewport(0, 0, framebuffer_width_, framebuffer_height_);
+            return;
+        }
+        if (post_target_.width != framebuffer_width_ || post_target_.height != framebuffer_height_)
+        {
+            destroy_render_target(post_target_);
+            static_cast<void>(create_render_target(post_target_, framebuffer_width_, framebuffer_height_, GL_RGBA8, false));
+        }
+        if (post_target_.framebuffer) // Anti-alias at the render size, before upscaling
+        {
+            apply_fxaa(post_target_.framebuffer, render_width_, render_height_);
+            upscale_source = post_target_.framebuffer;
+        }
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, upscale_source);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, surface_->default_framebuffer());
+    glBlitFramebuffer(0, 0, render_width_, render_height_, 0, 0, framebuffer_width_, framebuffer_height_,
+                      GL_COLOR_BUFFER_BIT, scaled ? GL_LINEAR : GL_NEAREST); // Bilinear upscale of the render area
+    glBindFramebuffer(GL_FRAMEBUFFER, surface_->default_framebuffer()); // QPainter (HUD) draws into the widget at full resolution
+    glViewport(0, 0, framebuffer_width_, framebuffer_height_);
+}
+
+void View::capture_screenshot(const QString &path)
+{
+    if (backend_ == Backend::Software)
+    {
+        qWarning() << "Screenshots need an OpenGL backend (use --render with the software backend)";
+        return;
+    }
+    capture_request_.screenshots.push_back(capture_target(path));
+    request_frame();
+}
+
+void View::set_animation_playing(const bool playing)
+{
+    if (playing == animation_playing_) return;
+    animation_playing_ = playing;
+    if (playing) animation_start_ns_ = monotonic_ns() - static_cast<std::int64_t>(animation_tick_) * kAnimationStepNs; // Resume where it paused
+    request_frame();
+}
+
+void View::set_animation_fixed_step(const bool fixed_step)
+{
+    if (fixed_step == animation_fixed_step_) return;
+    animation_fixed_step_ = fixed_step;
+    if (!fixed_step) animation_start_ns_ = monotonic_ns() - static_cast<std::int64_t>(animation_tick_) * kAnimationStepNs; // No jump back to wall-clock time
+}
+
+void View::restart_animation()
+{
+    animation_tick_ = 0;
+    animation_start_ns_ = monotonic_ns();
+    request_frame();
+}
+
+void View::set_capture_recording(const bool recording, const QString &directory, const CaptureFormat format)
+{
+    if (recording == capture_request_.recording) return;
+    if (recording)
+    {
+        if (backend_ == Backend::Software)
+        {
+            qWarning() << "Recording needs an OpenGL backend";
+            return;
+        }
+        if (!QDir().mkpath(directory))
+        {
+            qWarning() << "Cannot create capture directory" << directory;
+            return;
+        }
+        capture_request_.directory = QDir(directory).absolutePath();
+        capture_request_.format = format;
+        capture_request_.session++; // Frame numbers restart at 0
+        qInfo() << "Recording frames to" << capture_request_.directory;
+    }
+    else
+    {
+        qInfo() << "Recording stopped:" << capture_frames_.load() << "frames read back," << capture_skipped_.load()
+                << "skipped (ring or encoders full)";
+    }
+    capture_request_.recording = recording;
+    request_frame();
+}
+
+void View::capture_frame()
+{
+    collect_captures(); // Free the slots whose readback finished first, so a steady recording keeps reusing them
+
+    const CaptureRequest &request = frame_.capture;
+    if (request.recording && request.session != capture_session_) // First frame of a new recording
+    {
+        capture_session_ = request.session;
+        capture_frames_ = 0;
+        capture_skipped_ = 0;
+    }
+
+    const auto draining = [this]
+    {
+        return std::ranges::any_of(capture_slots_, [](const CaptureSlot &slot) { return slot.fence || !slot.targets.empty(); });
+    };
+    if (!request.recording && capture_screenshots_.empty())
+    {
+        if (draining()) request_redraw(); // Idle scene: keep polling until the last frames reach the encoders
+        return;
+    }
+
+    CaptureSlot &slot = capture_slots_[capture_slot_index_];
+    if (slot.in_use.load(std::memory_order_acquire)) // Oldest readback still in flight, or waiting for an encoder: never stall
+    {
+        if (request.recording) capture_skipped_++;
+        request_redraw(); // Screenshots and the skipped frame's successor get another chance
+        return;
+    }
+
+    const int width = framebuffer_width_;
+    const int height = framebuffer_height_;
+    const auto bytes = static_cast<GLsizeiptr>(width) * height * 4; // BGRA8
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    if (slot.capacity < bytes) // Immutable storage: replace the idle slot's buffer with a larger one
+    {
+        if (slot.buffer)
+        {
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            glDeleteBuffers(1, &slot.buffer);
+        }
+        constexpr GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT; // Mapped once; encoders read it in place
+        glGenBuffers(1, &slot.buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glBufferStorage(GL_PIXEL_PACK_BUFFER, bytes, nullptr, flags | GL_CLIENT_STORAGE_BIT); // Read by the CPU only: prefer host memory
+        slot.pixels = static_cast<const std::uint8_t*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, flags));
+        slot.capacity = bytes;
+        if (!slot.pixels)
+        {
+            qWarning() << "Cannot map the frame capture buffer; capture disabled for this frame";
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            glDeleteBuffers(1, &slot.buffer);
+            slot.buffer = 0;
+            slot.capacity = 0;
+            return;
+        }
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, surface_->default_framebuffer()); // The presented frame, before the HUD
+    glReadPixels(0, 0, width, height, GL_BGRA, GL_UNSIGNED_BYTE, nullptr); // Into the pack buffer: queued, returns at once
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, surface_->default_framebuffer()); // HUD target
+    glMemoryBarrier(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT); // Not a coherent mapping: make the copy visible once the fence signals
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.width = width;
+    slot.height = height;
+    slot.targets = std::exchange(capture_screenshots_, {});
+    if (request.recording) slot.targets.push_back({capture_frame_path(request.directory, capture_frames_++, width, height, request.format), request.format});
+    slot.in_use.store(true, std::memory_order_relaxed);
+    capture_slot_index_ = (capture_slot_index_ + 1) % kCaptureSlots;
+}
+
+void View::collect_captures()
+{
+    for (std::size_t k(0); k < kCaptureSlots; k++) // Oldest first, so the encoders start frames in order
+    {
+        CaptureSlot &slot = capture_slots_[(capture_slot_index_ + k) % kCaptureSlots];
+        if (!slot.fence) continue;
+        const GLenum status = glClientWaitSync(slot.fence, 0, 0); // Zero timeout: a status poll
+        if (status == GL_TIMEOUT_EXPIRED) continue;
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        if (status == GL_WAIT_FAILED)
+        {
+            qWarning() << "Frame capture fence failed; dropping" << slot.targets.size() << "files";
+            slot.targets.clear();
+            slot.in_use.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        capture_writer_.write(slot.pixels, slot.width, slot.height, std::exchange(slot.targets, {}), slot.in_use);
+    }
+}
+
+void View::release_capture_slots()
+{
+    for (CaptureSlot &slot : capture_slots_) // Frames read back but not handed over yet: finish them rather than lose them
+    {
+        if (!slot.fence) continue;
+        static_cast<void>(glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000)); // Up to a second
+    }
+    collect_captures();
+    capture_writer_.wait(); // Encoders read the mapped buffers
+    for (CaptureSlot &slot : capture_slots_)
+    {
+        if (slot.fence) glDeleteSync(slot.fence); // Timed out above
+        slot.fence = nullptr;
+        if (slot.buffer)
+        {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            glDeleteBuffers(1, &slot.buffer);
+        }
+        slot.buffer = 0;
+        slot.capacity = 0;
+        slot.pixels = nullptr;
+        slot.targets.clear();
+        slot.in_use.store(false, std::memory_order_relaxed);
+    }
+}
+
+bool View::fxaa_active() const
+{
+    return frame_.settings.anti_aliasing == AntiAliasing::Fxaa && fxaa_program_id_ && scene_target_.framebuffer;
+}
+
+void View::apply_fxaa(const GLuint framebuffer, const int width, const int height)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, width, height);
+    glDisable(GL_DEPTH_TEST); // Fullscreen pass; the widget depth buffer is never cleared
+    glUseProgram(fxaa_program_id_);
+    const float texture_width = static_cast<float>(scene_target_.width);
+    const float texture_height = static_cast<float>(scene_target_.height);
+    glUniform2f(fxaa_location_texel_size_, 1.0f / texture_width, 1.0f / texture_height);
+    glUniform2f(fxaa_location_uv_max_, (static_cast<float>(render_width_) - 0.5f) / texture_width,
+                (static_cast<float>(render_height_) - 0.5f) / texture_height); // Keep taps inside the render area
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, scene_target_.color_texture);
+    glBindVertexArray(vertex_array_object); // Core profile needs a VAO even without attributes
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+    glEnable(GL_DEPTH_TEST);
+}
+
+double View::anti_aliasing_memory_mb(const AntiAliasing mode) const
+{
+    constexpr double bytes_per_sample = 4.0 + 4.0; // RGBA8 color + 24-bit depth (padded to 32 bits)
+    const double pixels = static_cast<double>(framebuffer_width_) * framebuffer_height_;
+    double bytes = pixels * bytes_per_sample; // Single-sample scene target (render target or MSAA resolve target)
+    const int samples = std::min(anti_aliasing_samples(mode), max_samples_);
+    if (samples > 1) bytes += pixels * bytes_per_sample * samples; // Multisampled renderbuffers
+    if (mode == AntiAliasing::Fxaa && frame_.settings.dynamic_resolution) bytes += pixels * 4.0; // FXAA output before the upscale
+    return bytes / (1024.0 * 1024.0);
+}
+
+void View::update_resolution_governor(const double gpu_ms)
+{
+    const RenderSettings &settings = frame_.settings;
+    if (!settings.dynamic_resolution || gpu_ms <= 0.0) return; // Fixed settings are applied by apply_render_settings
+    smoothed_gpu_ms_ = smoothed_gpu_ms_ > 0.0 ? 0.7 * smoothed_gpu_ms_ + 0.3 * gpu_ms : gpu_ms; // Damp single-frame spikes
+
+    float scale = render_scale_;
+    int samples = scene_samples_;
+    if (smoothed_gpu_ms_ > settings.frame_budget_ms) // Over budget: shed pixels first, then MSAA samples
+    {
+        if (scale > kMinRenderScale)
+        {
+            // Cost follows the pixel count, i.e. scale squared; jump straight to the scale that should fit
+            const double fit = scale * std::sqrt(kGovernorTarget * settings.frame_budget_ms / smoothed_gpu_ms_);
+            const float stepped = std::floor(static_cast<float>(fit) / kRenderScaleStep + 1.0e-3f) * kRenderScaleStep;
+            scale = std::max(kMinRenderScale, std::min(stepped, scale - kRenderScaleStep));
+        }
+        else if (settings.adaptive_msaa && samples > 1)
+        {
+            samples /= 2;
+        }
+    }
+    else if (settings.adaptive_msaa && samples < preferred_samples_) // Samples were the last thing shed, so restore them first
+    {
+        if (smoothed_gpu_ms_ < kGovernorSamplesUpHeadroom * settings.frame_budget_ms) samples = std::min(samples * 2, preferred_samples_);
+    }
+    else if (scale < 1.0f && smoothed_gpu_ms_ < kGovernorScaleUpHeadroom * settings.frame_budget_ms)
+    {
+        scale = std::min(1.0f, scale + kRenderScaleStep); // One step (10-20% more pixels) stays inside the headroom
+    }
+
+    if (scale == render_scale_ && samples == scene_samples_) return;
+    render_scale_ = std::round(scale / kRenderScaleStep) * kRenderScaleStep; // Keep exact multiples of the step
+    scene_samples_ = samples;
+    smoothed_gpu_ms_ = 0.0; // Measurements at the old settings no longer apply
+    request_redraw(); // Keep converging even when the scene is idle
+}
+
+void View::render_visibility(const glm::mat4 &view_projection, const QueryFrame &queries)
+{
+    // Pass 1: rasterize ids; the depth test leaves the nearest triangle per pixel and nothing is shaded
+    glBindFramebuffer(GL_FRAMEBUFFER, visibility_target_.framebuffer);
+    glViewport(0, 0, render_width_, render_height_); // Target is full size; the scaled area is used
+    constexpr GLuint empty_id[4] = {kEmptyVisibilityId, 0u, 0u, 0u};
+    constexpr GLfloat far_depth = 1.0f;
+    glClearBufferuiv(GL_COLOR, 0, empty_id);
+    glClearBufferfv(GL_DEPTH, 0, &far_depth);
+
+    glUseProgram(visibility_program_id_);
+    glUniformMatrix4fv(visibility_location_view_projection_, 1, GL_FALSE, glm::value_ptr(view_projection));
+    glUniform1ui(visibility_location_triangle_bits_, frame_.records.triangle_bits);
+    glBeginQuery(GL_SAMPLES_PASSED, queries.geometry); // Fragments forward shading would have paid for
+    submit_culled_draws(); // Same commands as the forward path
+    glEndQuery(GL_SAMPLES_PASSED);
+
+    // Pass 2: one fullscreen triangle shades every covered pixel exactly once
+    glBindFramebuffer(GL_FRAMEBUFFER, scene_framebuffer());
+    glViewport(0, 0, render_width_, render_height_);
+    glUseProgram(resolve_program_id_);
+    const glm::mat4 inverse_view_projection = glm::inverse(view_projection);
+    glUniformMatrix4fv(resolve_location_inverse_view_projection_, 1, GL_FALSE, glm::value_ptr(inverse_view_projection));
+    glUniform2f(resolve_location_viewport_size_, static_cast<float>(render_width_), static_cast<float>(render_height_));
+    glUniform1ui(resolve_location_triangle_bits_, frame_.records.triangle_bits);
+    glUniform1i(resolve_location_wireframe_, frame_.settings.wireframe ? 1 : 0); // Edges from the barycentrics the resolve computes anyway
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, visibility_target_.color_texture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, visibility_target_.depth_texture);
+
+    glBeginQuery(GL_SAMPLES_PASSED, queries.resolve); // Empty pixels are discarded and not counted
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glEndQuery(GL_SAMPLES_PASSED);
+
+    glBindTexture(GL_TEXTURE_2D, 0); // Unit 1
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void View::collect_frame_queries()
+{
+    QueryFrame &queries = query_frames_[query_frame_index_ ^ 1]; // Slot issued by the previous frame
+    if (!queries.pending) return;
+
+    GLuint available = GL_FALSE;
+    const bool two_pass = queries.path == RenderPath::VisibilityBuffer || queries.depth_prepass; // Depth resolved before shading
+    glGetQueryObjectuiv(queries.gpu_time, GL_QUERY_RESULT_AVAILABLE, &available); // Timer ends last; queries complete in issue order
+    if (!available) return; // Keep showing older numbers rather than stalling
+
+    GLuint64 gpu_nanoseconds = 0;
+    glGetQueryObjectui64v(queries.gpu_time, GL_QUERY_RESULT, &gpu_nanoseconds);
+    frame_stats_.gpu_frame_ms = static_cast<double>(gpu_nanoseconds) / 1.0e6;
+    AntiAliasingTiming &timing = anti_aliasing_timings_[static_cast<std::size_t>(queries.fxaa ? AntiAliasing::Fxaa : msaa_option(queries.samples))];
+    timing.gpu_ms = frame_stats_.gpu_frame_ms; // Filed under what actually ran (the governor may have lowered MSAA)
+    timing.render_scale = queries.render_scale;
+    timing.measured = true;
+
+    GLuint64 geometry_samples = 0;
+    glGetQueryObjectui64v(queries.geometry, GL_QUERY_RESULT, &geometry_samples);
+    frame_stats_.path = queries.path;
+    frame_stats_.depth_prepass = queries.depth_prepass;
+    const int geometry_samples_per_pixel = queries.path == RenderPath::VisibilityBuffer ? 1 : queries.samples; // Id target is single-sampled
+    frame_stats_.rasterized_fragments = static_cast<double>(geometry_samples) / geometry_samples_per_pixel; // Fragment shader runs per pixel, not per sample
+    frame_stats_.shaded_pixels = 0.0;
+    if (two_pass)
+    {
+        GLuint64 resolve_samples = 0;
+        glGetQueryObjectui64v(queries.resolve, GL_QUERY_RESULT, &resolve_samples);
+        frame_stats_.shaded_pixels = static_cast<double>(resolve_samples) / queries.samples; // Both second passes draw into the MSAA scene target
+    }
+    queries.pending = false;
+
+    // Fragments per pixel covered by geometry in both states, so the hysteresis compares like with like. Two-pass frames
+    // measure the coverage; single-pass frames reuse the latest share of the render area (it changes slowly)
+    if (two_pass)
+    {
+        covered_share_ = queries.render_pixels > 0.0 ? frame_stats_.shaded_pixels / queries.render_pixels : 0.0;
+        frames_since_coverage_ = 0;
+    }
+    else
+    {
+        frames_since_coverage_ = std::min(frames_since_coverage_ + 1, kCoverageProbeFrames); // Saturated: Uniform runs single-pass forever
+    }
+    const double pixels = covered_share_ * queries.render_pixels;
+    frame_stats_.overdraw = pixels > 0.0 ? frame_stats_.rasterized_fragments / pixels : 0.0;
+    if (frame_stats_.overdraw > kPrepassEnableOverdraw) auto_prepass_active_ = true;
+    else if (frame_stats_.overdraw < kPrepassDisableOverdraw) auto_prepass_active_ = false;
+
+    update_resolution_governor(frame_stats_.gpu_frame_ms);
+}
+
+QStringList View::hud_lines() const
+{
+    const auto millions = [](const double value) { return QString::number(value / 1.0e6, 'f', 2) + QStringLiteral(" M"); };
+
+    QStringList lines;
+    lines << QStringLiteral("CPU frame: %1 ms").arg(frame_stats_.cpu_frame_ms, 0, 'f', 2);
+    if (backend_ == Backend::Software) // No GPU passes, queries or programs: the tiled rasterizer's own numbers instead
+    {
+        const SoftwareFrameStats &software = frame_stats_.software;
+        lines << QStringLiteral("Input to frame: %1 ms (avg %2 ms)").arg(frame_.latency.last_ms, 0, 'f', 1).arg(frame_.latency.average_ms[0], 0, 'f', 1);
+        lines << QStringLiteral("Presentation: software rasterizer, %1x%2 in %3 tiles on %4 jobs")
+                     .arg(frame_stats_.render_width).arg(frame_stats_.render_height)
+                     .arg(static_cast<qint64>(software.tiles)).arg(static_cast<qint64>(software.jobs));
+        lines << QStringLiteral("Passes: transform %1 ms, clip and bin %2 ms, raster and shade %3 ms")
+                     .arg(software.transform_ms, 0, 'f', 2).arg(software.bin_ms, 0, 'f', 2).arg(software.raster_ms, 0, 'f', 2);
+        lines << QStringLiteral("Triangles: %1 submitted, %2 binned (%3 near-clipped), %4 tile entries")
+                     .arg(millions(static_cast<double>(software.triangles))).arg(millions(static_cast<double>(software.binned_triangles)))
+                     .arg(static_cast<qint64>(software.clipped_triangles)).arg(millions(static_cast<double>(software.bin_entries)));
+        if (frame_stats_.lit) lines << QStringLiteral("Lights: %1 (clustered, no shadows)").arg(static_cast<qint64>(frame_.records.lights.size()));
+        if (!frame_.records.point_clouds.empty()) lines << QStringLiteral("Point clouds: %1 not drawn (GL backends only)").arg(static_cast<qint64>(frame_.records.point_clouds.size()));
+        return lines;
+    }
+    lines << QStringLiteral("GPU frame: %1 ms (budget %2 ms)").arg(frame_stats_.gpu_frame_ms, 0, 'f', 2).arg(frame_.settings.frame_budget_ms, 0, 'f', 1);
+    const LatencyStats &latency = frame_.latency; // Measured on the GUI thread, delivered with the snapshot
+    const auto average = [&latency](const std::size_t mode)
+    {
+        return latency.samples[mode] ? QStringLiteral("%1 ms").arg(latency.average_ms[mode], 0, 'f', 1) : QStringLiteral("-");
+    };
+    lines << QStringLiteral("Input to frame: %1 ms on the %2 thread (avg GUI %3, render %4)")
+                 .arg(latency.last_ms, 0, 'f', 1)
+                 .arg(frame_.threaded ? QStringLiteral("render") : QStringLiteral("GUI"))
+                 .arg(average(0)).arg(average(1));
+    lines << QStringLiteral("Presentation: %1, swap interval %2")
+                 .arg(backend_ == Backend::Window ? QStringLiteral("native window") : QStringLiteral("composited widget"))
+                 .arg(swap_interval_);
+    const StartupStats &startup = frame_.startup;
+    lines << QStringLiteral("Startup: first frame %1, programs %2 ms (%3 cached, %4 compiled, %5 from SPIR-V, %6 rejected)")
+                 .arg(startup.first_frame_ms >= 0.0 ? QStringLiteral("%1 ms").arg(startup.first_frame_ms, 0, 'f', 0) : QStringLiteral("-"))
+                 .arg(startup.shader_ms, 0, 'f', 1).arg(static_cast<qint64>(startup.programs.cached))
+                 .arg(static_cast<qint64>(startup.programs.compiled)).arg(static_cast<qint64>(startup.programs.spirv))
+                 .arg(static_cast<qint64>(startup.programs.rejected));
+    lines << QStringLiteral("Shaders: %1 compiling, %2 built (last %3 ms), %4 failed, parallel compile %5, revision %6")
+                 .arg(static_cast<qint64>(shader_stats_.pending)).arg(static_cast<qint64>(shader_stats_.built))
+                 .arg(shader_stats_.last_build_ms, 0, 'f', 1).arg(static_cast<qint64>(shader_stats_.failed))
+                 .arg(shader_stats_.parallel_compile ? QStringLiteral("on") : QStringLiteral("off"))
+                 .arg(static_cast<qint64>(shader_stats_.revision));
+    lines << QStringLiteral("Resolution: %1% (%2x%3 of %4x%5), MSAA %6x%7")
+                 .arg(qRound(frame_stats_.render_scale * 100.0f))
+                 .arg(frame_stats_.render_width).arg(frame_stats_.render_height)
+                 .arg(framebuffer_width_).arg(framebuffer_height_)
+                 .arg(frame_stats_.samples)
+                 .arg((frame_stats_.fxaa ? QStringLiteral(" + FXAA") : QString()) +
+                      (frame_.settings.dynamic_resolution ? QStringLiteral(", dynamic") : QStringLiteral(", fixed")));
+    static const std::array<QString, kAntiAliasingCount> anti_aliasing_names{QStringLiteral("MSAA 1x"), QStringLiteral("MSAA 2x"), QStringLiteral("MSAA 4x"),
+                                                            QStringLiteral("MSAA 8x"), QStringLiteral("FXAA")};
+    const auto running = static_cast<std::size_t>(frame_stats_.fxaa ? AntiAliasing::Fxaa : msaa_option(frame_stats_.samples));
+    lines << QStringLiteral("  AA        GPU ms         Memory");
+    for (std::size_t i = 0; i < anti_aliasing_names.size(); ++i) // Last measurement of every option, to compare per machine
+    {
+        const AntiAliasingTiming &timing = anti_aliasing_timings_[i];
+        const QString gpu = timing.measured ? QStringLiteral("%1 @%2%").arg(timing.gpu_ms, 6, 'f', 2).arg(qRound(timing.render_scale * 100.0f))
+                                            : QStringLiteral("     -");
+        lines << QStringLiteral("%1 %2 %3 %4 MB")
+                     .arg(i == running ? QStringLiteral(">") : QStringLiteral(" "))
+                     .arg(anti_aliasing_names[i], -9)
+                     .arg(gpu, -14)
+                     .arg(anti_aliasing_memory_mb(static_cast<AntiAliasing>(i)), 6, 'f', 1);
+    }
+    const bool gpu_culled = frame_.settings.gpu_culling && cull_program_id_;
+    lines << QStringLiteral("Culling: %1").arg(gpu_culled ? QStringLiteral("GPU") : QStringLiteral("CPU"));
+    if (frame_stats_.draws_sorted)
+    {
+        lines << QStringLiteral("Draw sort: %1 ms for %2 %3, vertex format switches %4 (unsorted %5)")
+                     .arg(frame_stats_.sort_ms, 0, 'f', 3)
+                     .arg(static_cast<qint64>(frame_stats_.sorted_draws))
+                     .arg(gpu_culled ? QStringLiteral("objects, one slot each") : QStringLiteral("keys"))
+                     .arg(static_cast<qint64>(frame_stats_.format_switches))
+                     .arg(static_cast<qint64>(frame_stats_.unsorted_format_switches));
+    }
+    else
+    {
+        lines << QStringLiteral("Draw sort: off");
+    }
+    if (gpu_culled)
+    {
+        lines << QStringLiteral("Frame prep: on the GPU; sort %1 ms; records %2 ms (%3 jobs)")
+                     .arg(frame_stats_.draws_sorted ? frame_stats_.sort_ms : 0.0, 0, 'f', 3)
+                     .arg(frame_.records.build_ms, 0, 'f', 3).arg(static_cast<qint64>(frame_.records.build_jobs));
+    }
+    else
+    {
+        lines << QStringLiteral("Frame prep: %1 jobs, cull %2, sort %3, pack %4, upload %5 ms; records %6 ms (%7 jobs)")
+                     .arg(static_cast<qint64>(frame_stats_.prep_jobs))
+                     .arg(frame_stats_.cull_ms, 0, 'f', 3)
+                     .arg(frame_stats_.draws_sorted ? frame_stats_.sort_ms : 0.0, 0, 'f', 3)
+                     .arg(frame_stats_.pack_ms, 0, 'f', 3)
+                     .arg(frame_stats_.upload_ms, 0, 'f', 3)
+                     .arg(frame_.records.build_ms, 0, 'f', 3).arg(static_cast<qint64>(frame_.records.build_jobs));
+    }
+    if (frame_stats_.lit)
+    {
+        lines << QStringLiteral("Lights: %1 of %2 visible, %3x%4x%5 clusters, %6 occupied, %7 avg / %8 max per cluster, binning %9 ms")
+                     .arg(static_cast<qint64>(frame_stats_.visible_lights)).arg(static_cast<qint64>(frame_.records.lights.size()))
+                     .arg(kClusterGridX).arg(kClusterGridY).arg(kClusterGridZ)
+                     .arg(static_cast<qint64>(frame_stats_.occupied_clusters))
+                     .arg(frame_stats_.average_lights_per_cluster, 0, 'f', 1)
+                     .arg(static_cast<qint64>(frame_stats_.max_lights_per_cluster))
+                     .arg(frame_stats_.light_binning_ms, 0, 'f', 3);
+        if (frame_.settings.shadows && shadow_atlas_texture_)
+        {
+            lines << QStringLiteral("Shadows: %1x%1 atlas, %2x%2 tiles; this frame %3 tiles, %4 draws, %5 ms (%6 tile updates total)")
+                         .arg(kShadowAtlasSize).arg(kShadowTilesPerSide)
+                         .arg(static_cast<qint64>(frame_stats_.shadow_tiles)).arg(static_cast<qint64>(frame_stats_.shadow_draws))
+                         .arg(frame_stats_.shadow_ms, 0, 'f', 3).arg(static_cast<qint64>(shadow_tile_updates_));
+        }
+        else
+        {
+            lines << QStringLiteral("Shadows: off");
+        }
+    }
+    const AmbientOcclusionBake &occlusion_bake = frame_.records.occlusion_bake;
+    if (occlusion_bake.from_cache)
+    {
+        lines << QStringLiteral("AO bake: last import from cache");
+    }
+    else if (occlusion_bake.rays > 0)
+    {
+        lines << QStringLiteral("AO bake: last import %1 Mrays/s (%2 rays, %3 ms on %4 jobs, BVH %5 ms)")
+                     .arg(occlusion_bake.rays_per_second() / 1.0e6, 0, 'f', 2).arg(static_cast<qint64>(occlusion_bake.rays))
+                     .arg(occlusion_bake.trace_ms, 0, 'f', 1).arg(static_cast<qint64>(occlusion_bake.jobs))
+                     .arg(occlusion_bake.build_ms, 0, 'f', 1);
+    }
+    if (frame_stats_.point_clouds > 0)
+    {
+        lines << QStringLiteral("Points: %1 of %2 budget in %3 nodes (%4 visited)%5, %6 clouds")
+                     .arg(millions(static_cast<double>(frame_stats_.points_drawn)))
+                     .arg(millions(static_cast<double>(frame_.settings.point_budget)))
+                     .arg(static_cast<qint64>(frame_stats_.point_nodes)).arg(static_cast<qint64>(frame_stats_.point_visited_nodes))
+                     .arg(frame_stats_.point_budget_reached ? QStringLiteral(", budget reached") : QString())
+                     .arg(static_cast<qint64>(frame_stats_.point_clouds));
+        lines << QStringLiteral("Point cache: %1 / %2 pages, %3 uploaded, %4 nodes waiting, %5 ms")
+                     .arg(static_cast<qint64>(frame_stats_.point_resident_pages)).arg(static_cast<qint64>(frame_stats_.point_page_capacity))
+                     .arg(millions(static_cast<double>(frame_stats_.point_uploaded)))
+                     .arg(static_cast<qint64>(frame_stats_.point_missing_nodes)).arg(frame_stats_.point_ms, 0, 'f', 2);
+    }
+    if (const TextureStats &textures = frame_.textures; textures.count > 0)
+    {
+        constexpr double megabyte = 1024.0 * 1024.0;
+        lines << QStringLiteral("Textures: %1 of %2 decoded, %3 / %4 MB resident, %5 MB uploaded, %6 levels evicted")
+                     .arg(static_cast<qint64>(textures.decoded)).arg(static_cast<qint64>(textures.count))
+                     .arg(static_cast<double>(textures.resident_bytes) / megabyte, 0, 'f', 1)
+                     .arg(static_cast<double>(textures.budget_bytes) / megabyte, 0, 'f', 0)
+                     .arg(static_cast<double>(textures.uploaded_bytes) / megabyte, 0, 'f', 1)
+                     .arg(static_cast<qint64>(textures.evicted_levels));
+        for (const TextureStats::Entry &entry : textures.entries)
+        {
+            const double saved = entry.rgba8_bytes > 0 ? 100.0 * (1.0 - static_cast<double>(entry.bytes) / static_cast<double>(entry.rgba8_bytes)) : 0.0;
+            lines << QStringLiteral("  %1: %2x%3 %4, %5 MB (RGBA8 %6 MB, %7% saved), %8")
+                         .arg(entry.name).arg(entry.width).arg(entry.height).arg(QString::fromLatin1(texture_format_name(entry.format)))
+                         .arg(static_cast<double>(entry.bytes) / megabyte, 0, 'f', 2)
+                         .arg(static_cast<double>(entry.rgba8_bytes) / megabyte, 0, 'f', 2)
+                         .arg(saved, 0, 'f', 0)
+                         .arg(entry.from_cache ? QStringLiteral("from cache")
+                                               : entry.format == TextureFormat::Rgba8 ? QStringLiteral("uncompressed")
+                                                                                      : QStringLiteral("encoded in %1 ms").arg(entry.encode_ms, 0, 'f', 1));
+        }
+    }
+    if (frame_stats_.path == RenderPath::VisibilityBuffer || frame_stats_.depth_prepass)
+    {
+        const double removed = std::max(0.0, frame_stats_.rasterized_fragments - frame_stats_.shaded_pixels); // Shading work forward would repeat
+        const double share = frame_stats_.rasterized_fragments > 0.0 ? 100.0 * removed / frame_stats_.rasterized_fragments : 0.0;
+        lines << (frame_stats_.depth_prepass ? QStringLiteral("Path: forward + depth pre-pass") : QStringLiteral("Path: visibility buffer"));
+        lines << QStringLiteral("Single pass would shade: %1 fragments").arg(millions(frame_stats_.rasterized_fragments));
+        lines << QStringLiteral("Shaded: %1 pixels").arg(millions(frame_stats_.shaded_pixels));
+        lines << QStringLiteral("Overdraw removed: %1 (%2%)").arg(millions(removed)).arg(share, 0, 'f', 1);
+    }
+    else
+    {
+        lines << QStringLiteral("Path: forward");
+        lines << QStringLiteral("Shaded: %1 fragments").arg(millions(frame_stats_.rasterized_fragments));
+    }
+    lines << QStringLiteral("Overdraw: %1x%2").arg(frame_stats_.overdraw, 0, 'f', 2)
+                 .arg(frame_stats_.path == RenderPath::VisibilityBuffer || frame_stats_.depth_prepass ? QString() : QStringLiteral(" (coverage of an earlier frame)"));
+    if (frame_.settings.render_path == RenderPath::VisibilityBuffer && frame_stats_.path == RenderPath::Forward)
+    {
+        lines << QStringLiteral("Visibility buffer unavailable (ids exceed 32 bits or shaders failed)");
+    }
+    if (frame_.capture.recording || capture_writer_.active() > 0)
+    {
+        lines << QStringLiteral("Capture: %1 frames read back, %2 skipped, %3 encoding, %4 files written%5")
+                     .arg(static_cast<qint64>(capture_frames_.load())).arg(static_cast<qint64>(capture_skipped_.load()))
+                     .arg(capture_writer_.active()).arg(static_cast<qint64>(capture_writer_.written()))
+                     .arg(capture_writer_.failed() ? QStringLiteral(" (%1 failed)").arg(static_cast<qint64>(capture_writer_.failed())) : QString());
+    }
+    if (frame_.animation.instances > 0)
+    {
+        lines << QStringLiteral("Animation: %1 instances, %2 bones, pose %3 ms on %4 jobs, tick %5")
+                     .arg(frame_.animation.instances).arg(frame_.animation.bones).arg(frame_.animation.evaluate_ms, 0, 'f', 3)
+                     .arg(frame_.animation.jobs).arg(static_cast<qint64>(frame_.animation_tick));
+    }
+    return lines;
+}
+
+void View::bin_lights()
+{
+    QElapsedTimer binning_timer;
+    binning_timer.start();
+    build_light_clusters(frame_.records.lights, frame_.view_matrix, frame_.projection, kNearPlane, kFarPlane, light_clusters_);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, light_cluster_buffer_);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(light_clusters_.ranges.size() * sizeof(glm::uvec2)),
+                 light_clusters_.ranges.data(), GL_STREAM_DRAW); // Orphaned every frame
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, light_index_buffer_);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(light_clusters_.indices.size() * sizeof(std::uint32_t)),
+                 light_clusters_.indices.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    frame_stats_.light_binning_ms = static_cast<double>(binning_timer.nsecsElapsed()) / 1.0e6;
+    frame_stats_.visible_lights = light_clusters_.visible_lights;
+    frame_stats_.occupied_clusters = light_clusters_.occupied_clusters;
+    frame_stats_.max_lights_per_cluster = light_clusters_.max_lights_per_cluster;
+    std::size_t entries = 0;
+    for (const glm::uvec2 &range : light_clusters_.ranges) entries += range.y;
+    frame_stats_.average_lights_per_cluster = light_clusters_.occupied_clusters
+        ? static_cast<double>(entries) / static_cast<double>(light_clusters_.occupied_clusters) : 0.0;
+}
+
+void View::set_lighting_uniforms(const GLuint program, const LightingLocations &locations)
+{
+    if (!program) return;
+    const glm::vec2 depth_scale_bias = cluster_depth_scale_bias(kNearPlane, kFarPlane);
+    if (locations.view >= 0) glProgramUniformMatrix4fv(program, locations.view, 1, GL_FALSE, glm::value_ptr(frame_.view_matrix));
+    if (locations.viewport_size >= 0) glProgramUniform2f(program, locations.viewport_size, static_cast<float>(render_width_), static_cast<float>(render_height_));
+    if (locations.depth_scale_bias >= 0) glProgramUniform2f(program, locations.depth_scale_bias, depth_scale_bias.x, depth_scale_bias.y);
+    if (locations.eye >= 0) glProgramUniform3fv(program, locations.eye, 1, glm::value_ptr(frame_.camera_position));
+    const glm::mat4 shadow_matrix = glm::translate(glm::mat4(1.0f), glm::vec3(0.5f)) * glm::scale(glm::mat4(1.0f), glm::vec3(0.5f)) *
+                                    shadow_view_projection(); // NDC to texture coordinates and depth
+    if (locations.shadow_matrix >= 0) glProgramUniformMatrix4fv(program, locations.shadow_matrix, 1, GL_FALSE, glm::value_ptr(shadow_matrix));
+    if (locations.shadows_enabled >= 0) glProgramUniform1i(program, locations.shadows_enabled, frame_.settings.shadows && shadow_atlas_texture_ ? 1 : 0);
+}
+
+void View::mark_shadow_tiles_dirty(const std::uint64_t tiles)
+{
+    for (View *view : scene_->views) view->shadow_dirty_tiles_ |= tiles; // Every view keeps its own atlas
+}
+
+void View::mark_shadow_caster_dirty(const ImportedObject &object)
+{
+    mark_shadow_tiles_dirty(shadow_tiles_of(object.translation, object.radius * object.scale)); // Same sphere as culling
+}
+
+bool View::ensure_shadow_atlas()
+{
+    if (shadow_atlas_texture_) return true;
+
+    glGenTextures(1, &shadow_atlas_texture_);
+    glBindTexture(GL_TEXTURE_2D, shadow_atlas_texture_);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT24, kShadowAtlasSize, kShadowAtlasSize);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); // Bilinear compare results (smoother PCF)
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &shadow_framebuffer_);
+    glBindFramebuffer(GL_FRAMEBUFFER, shadow_framebuffer_);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, shadow_atlas_texture_, 0);
+    glDrawBuffer(GL_NONE); // Depth only
+    glReadBuffer(GL_NONE);
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, scene_framebuffer());
+
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        qWarning() << "Shadow atlas framebuffer incomplete, status" << Qt::hex << status;
+        glDeleteFramebuffers(1, &shadow_framebuffer_);
+        shadow_framebuffer_ = 0;
+        glDeleteTextures(1, &shadow_atlas_texture_);
+        shadow_atlas_texture_ = 0;
+        return false;
+    }
+    glGenBuffers(1, &shadow_indirect_buffer_);
+    shadow_pending_tiles_ = kAllShadowTiles; // Nothing rendered yet
+    return true;
+}
+
+void View::update_shadow_atlas()
+{
+    frame_stats_.shadow_tiles = 0;
+    frame_stats_.shadow_draws = 0;
+    frame_stats_.shadow_ms = 0.0;
+    if (!frame_.settings.shadows || !depth_prepass_program_id_ || !ensure_shadow_atlas()) return;
+    if (!shadow_pending_tiles_) return; // Static casters: the cached atlas is sampled as it is, whatever the camera does
+
+    QElapsedTimer shadow_timer;
+    shadow_timer.start();
+    const SceneRecords &records = frame_.records;
+    shadow_object_tiles_.resize(records.cull_objects.size());
+    for (std::size_t i(0); i < records.cull_objects.size(); i++) // Bounds of every caster, once per update
+    {
+        const glm::vec4 &sphere = records.cull_objects[i].sphere;
+        shadow_object_tiles_[i] = shadow_tiles_of(glm::vec3(sphere), sphere.w) & shadow_pending_tiles_;
+    }
+
+    struct TileBatch // Commands of one tile inside shadow_commands_
+    {
+        int tile = 0;
+        std::size_t first = 0;
+        std::size_t count = 0;
+    };
+    std::vector<TileBatch> batches;
+    shadow_commands_.clear();
+    for (int tile(0); tile < kShadowTilesPerSide * kShadowTilesPerSide; tile++)
+    {
+        const std::uint64_t bit = std::uint64_t{1} << tile;
+        if (!(shadow_pending_tiles_ & bit)) continue;
+        TileBatch batch{tile, shadow_commands_.size(), 0};
+        for (std::size_t i(0); i < records.cull_objects.size(); i++)
+        {
+            if (!(shadow_object_tiles_[i] & bit)) continue;
+            const CullObject &object = records.cull_objects[i];
+            DrawElementsIndirectCommand command; // Full detail: the atlas outlives the camera distance it was drawn at
+            command.count = object.lod_index_count[0];
+            command.first_index = object.lod_first_index[0];
+            command.base_instance = object.record_index;
+            shadow_commands_.push_back(command);
+        }
+        batch.count = shadow_commands_.size() - batch.first;
+        batches.push_back(batch);
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, shadow_indirect_buffer_);
+    const auto command_count = static_cast<GLuint>(shadow_commands_.size());
+    if (command_count > shadow_indirect_capacity_)
+    {
+        shadow_indirect_capacity_ = std::max(command_count, shadow_indirect_capacity_ * 2);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(shadow_indirect_capacity_ * sizeof(DrawElementsIndirectCommand)),
+                     nullptr, GL_DYNAMIC_DRAW);
+    }
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, static_cast<GLsizeiptr>(shadow_commands_.size() * sizeof(DrawElementsIndirectCommand)),
+                    shadow_commands_.data());
+
+    glBindFramebuffer(GL_FRAMEBUFFER, shadow_framebuffer_);
+    glViewport(0, 0, kShadowAtlasSize, kShadowAtlasSize); // One projection for the whole atlas; tiles are scissor rectangles
+    glEnable(GL_SCISSOR_TEST);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(2.0f, 4.0f); // Slope-scaled bias against self-shadowing
+    glUseProgram(depth_prepass_program_id_); // Position-only stream, no fragment shader
+    glUniformMatrix4fv(depth_prepass_location_view_projection_, 1, GL_FALSE, glm::value_ptr(shadow_view_projection()));
+    constexpr int tile_size = kShadowAtlasSize / kShadowTilesPerSide;
+    constexpr GLfloat far_depth = 1.0f;
+    for (const TileBatch &batch : batches)
+    {
+        glScissor(batch.tile % kShadowTilesPerSide * tile_size, batch.tile / kShadowTilesPerSide * tile_size, tile_size, tile_size);
+        glClearBufferfv(GL_DEPTH, 0, &far_depth); // Clears are scissored too
+        if (batch.count == 0) continue;
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                    reinterpret_cast<const void*>(batch.first * sizeof(DrawElementsIndirectCommand)),
+                                    static_cast<GLsizei>(batch.count), sizeof(DrawElementsIndirectCommand));
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, scene_framebuffer()); // Back to the scene passes
+    glViewport(0, 0, render_width_, render_height_);
+
+    frame_stats_.shadow_tiles = batches.size();
+    frame_stats_.shadow_draws = shadow_commands_.size();
+    frame_stats_.shadow_ms = static_cast<double>(shadow_timer.nsecsElapsed()) / 1.0e6;
+    shadow_tile_updates_ += batches.size();
+    shadow_pending_tiles_ = 0;
+}
+
+int View::request_texture(const QString &path)
+{
+    const QString absolute_path = QFileInfo(path).absoluteFilePath();
+    for (std::size_t i(0); i < scene_->textures.size(); i++) // Objects sharing an image share its slot and its GPU memory
+    {
+        if (scene_->textures[i].path == absolute_path) return static_cast<int>(i);
+    }
+    if (!QFileInfo::exists(absolute_path))
+    {
+        qWarning() << "Texture not found:" << absolute_path;
+        return -1;
+    }
+    if (scene_->textures.size() >= kMaterialTextureSlots)
+    {
+        qWarning() << "All" << kMaterialTextureSlots << "texture slots are in use; drawing untextured:" << absolute_path;
+        return -1;
+    }
+
+    const std::size_t slot = scene_->textures.size();
+    scene_->textures.push_back({absolute_path, {}, {}, 0}); // Caller holds begin_gui_gl: renderers read the slot table
+    const std::uint64_t generation = scene_->texture_generation;
+    TextureCompression compression = scene_->texture_compression;
+    if (compression == TextureCompression::Bc1Bc3 && !s3tc_supported_) compression = TextureCompression::Bc7; // Core since 4.2
+    const std::weak_ptr<SharedScene> weak_scene = scene_; // Any view still showing the scene may take the result
+    QThreadPool::globalInstance()->start([weak_scene, absolute_path, slot, generation, compression]
+    {
+        auto decoded = std::make_shared<DecodedTexture>(load_texture(absolute_path, compression)); // Worker thread: no GL, no widgets
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [weak_scene, slot, generation, decoded]
+        {
+            const auto scene = weak_scene.lock(); // Back on the GUI thread
+            if (!scene || scene->views.empty()) return; // Every view was closed while decoding
+            scene->views.front()->on_texture_decoded(slot, generation, std::move(*decoded));
+        }, Qt::QueuedConnection);
+    });
+    return static_cast<int>(slot);
+}
+
+void View::on_texture_decoded(const std::size_t slot, const std::uint64_t generation, DecodedTexture decoded)
+{
+    if (generation != scene_->texture_generation || slot >= scene_->textures.size()) return; // Scene was reset meanwhile
+    if (decoded.mips.empty())
+    {
+        qWarning() << "Texture decode failed:" << scene_->textures[slot].path << decoded.error;
+        return; // The slot keeps the white fallback
+    }
+    if (decoded.from_cache)
+    {
+        qInfo().nospace() << "Texture loaded from cache: " << decoded.mips.front().width << "x" << decoded.mips.front().height << " "
+                          << texture_format_name(decoded.format) << " in " << decoded.decode_ms << " ms";
+    }
+    else
+    {
+        qInfo().nospace() << "Texture decoded: " << decoded.mips.front().width << "x" << decoded.mips.front().height << ", "
+                          << decoded.mips.size() << " levels in " << decoded.decode_ms << " ms; " << texture_format_name(decoded.format)
+                          << " encode " << decoded.encode_ms << " ms on " << decoded.encode_jobs << " jobs";
+    }
+
+    begin_gui_gl();
+    SceneTexture &texture = scene_->textures[slot];
+    texture.decoded = std::move(decoded);
+    TextureResidency &residency = texture.residency;
+    residency.format = texture.decoded.format;
+    residency.width = texture.decoded.mips.front().width;
+    residency.height = texture.decoded.mips.front().height;
+    residency.level_count = static_cast<std::uint32_t>(texture.decoded.mips.size());
+    residency.resident_level = residency.level_count; // Nothing on the GPU yet
+    residency.wanted_level = residency.level_count - 1;
+    restream_texture(texture, base_mip_level(residency, kMinResidentTextureSize)); // Small base at once; detail streams in with demand
+    end_gui_gl();
+    for (View *view : scene_->views) view->request_frame();
+}
+
+void View::restream_texture(SceneTexture &texture, const std::uint32_t resident_level)
+{
+    TextureResidency &residency = texture.residency;
+    const std::uint32_t old_level = residency.resident_level;
+    if (resident_level == old_level || resident_level >= residency.level_count) return;
+
+    GLuint replacement = 0; // Immutable storage cannot change its level count: allocate anew and carry the kept levels over
+    glGenTextures(1, &replacement);
+    glBindTexture(GL_TEXTURE_2D, replacement);
+    const GLenum internal_format = texture_internal_format(residency.format);
+    glTexStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(residency.level_count - resident_level), internal_format,
+                   texture.decoded.mips[resident_level].width, texture.decoded.mips[resident_level].height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Mip rows are tightly packed
+    std::size_t uploaded = 0;
+    for (std::uint32_t level(resident_level); level < residency.level_count; level++)
+    {
+        const TextureMip &mip = texture.decoded.mips[level];
+        const auto target_level = static_cast<GLint>(level - resident_level);
+        if (texture.texture && level >= old_level) // Already on the GPU: copy instead of uploading again
+        {
+            glCopyImageSubData(texture.texture, GL_TEXTURE_2D, static_cast<GLint>(level - old_level), 0, 0, 0,
+                               replacement, GL_TEXTURE_2D, target_level, 0, 0, 0, mip.width, mip.height, 1);
+        }
+        else
+        {
+            if (residency.format == TextureFormat::Rgba8)
+            {
+                glTexSubImage2D(GL_TEXTURE_2D, target_level, 0, 0, mip.width, mip.height, GL_RGBA, GL_UNSIGNED_BYTE, mip.data.data());
+            }
+            else // Blocks go up as encoded; the driver never sees the RGBA8 texels
+            {
+                glCompressedTexSubImage2D(GL_TEXTURE_2D, target_level, 0, 0, mip.width, mip.height, internal_format,
+                                          static_cast<GLsizei>(mip.data.size()), mip.data.data());
+            }
+            uploaded += mip.data.size();
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (texture.texture)
+    {
+        scene_->texture_resident_bytes -= texture_resident_bytes(residency.format, residency.width, residency.height, residency.level_count, old_level);
+        glDeleteTextures(1, &texture.texture);
+        if (resident_level > old_level) scene_->texture_evicted_levels += resident_level - old_level;
+    }
+    texture.texture = replacement;
+    residency.resident_level = resident_level;
+    scene_->texture_resident_bytes += texture_resident_bytes(residency.format, residency.width, residency.height, residency.level_count, resident_level);
+    scene_->texture_uploaded_bytes += uploaded;
+}
+
+void View::stream_textures()
+{
+    if (std::ranges::none_of(scene_->textures, [](const SceneTexture &texture) { return texture.residency.level_count > 0; })) return;
+
+    std::vector<float> demand(scene_->textures.size(), 0.0f); // Largest size any view of the scene shows each texture at
+    for (View *view : scene_->views)
+    {
+        QMutexLocker lock(&view->texture_demand_mutex_);
+        for (std::size_t i(0); i < std::min(demand.size(), view->texture_demand_.size()); i++)
+        {
+            demand[i] = std::max(demand[i], view->texture_demand_[i]);
+        }
+    }
+
+    const std::uint64_t tick = ++scene_->texture_stream_tick;
+    std::vector<TextureResidency> residency;
+    residency.reserve(scene_->textures.size());
+    for (std::size_t i(0); i < scene_->textures.size(); i++)
+    {
+        TextureResidency &state = scene_->textures[i].residency; // Planner-only state: renderers never read it
+        if (state.level_count > 0)
+        {
+            if (demand[i] > 0.0f)
+            {
+                state.last_used = tick;
+                state.wanted_level = wanted_mip_level(state, demand[i]);
+            }
+            else
+            {
+                state.wanted_level = state.level_count - 1; // Off screen: its detail is the first to go
+            }
+        }
+        residency.push_back(state);
+    }
+
+    const auto changes = plan_texture_residency(residency, scene_->texture_budget_bytes, kTextureStreamBytesPerStep, kMinResidentTextureSize);
+    if (changes.empty()) return;
+    begin_gui_gl();
+    for (const ResidencyChange &change : changes) restream_texture(scene_->textures[change.texture], change.resident_level);
+    end_gui_gl();
+    for (View *view : scene_->views) view->request_frame(); // The next step runs once these levels were drawn
+}
+
+void View::measure_texture_demand(const glm::mat4 &view_projection)
+{
+    std::vector<float> demand(scene_->textures.size(), 0.0f);
+    const ColorMode mode = frame_.settings.color_mode;
+    if (!demand.empty() && (mode == ColorMode::Uniform || mode == ColorMode::Lit)) // The only modes that sample textures
+    {
+        const auto planes = extract_frustum_planes(view_projection);
+        const float pixels_per_unit = lod_projection_scale(); // Same projection of bounds as the LOD selection
+        for (const CullObject &object : frame_.records.cull_objects)
+        {
+            const int slot = frame_.records.draw_records[object.record_index].texture_slot;
+            if (slot < 0 || static_cast<std::size_t>(slot) >= demand.size()) continue;
+            const glm::vec3 center(object.sphere);
+            if (std::ranges::any_of(planes, [&](const glm::vec4 &plane) { return glm::dot(glm::vec3(plane), center) + plane.w < -object.sphere.w; }))
+            {
+                continue; // Outside the frustum: no demand from this view
+            }
+            const float distance = std::max(glm::length(center - frame_.camera_position) - object.sphere.w, kNearPlane);
+            demand[slot] = std::max(demand[slot], 2.0f * object.sphere.w * pixels_per_unit / distance);
+        }
+    }
+    QMutexLocker lock(&texture_demand_mutex_);
+    texture_demand_ = std::move(demand);
+}
+
+void View::bind_material_textures()
+{
+    if (!fallback_texture_)
+    {
+        constexpr std::uint8_t white[4]{255, 255, 255, 255};
+        glGenTextures(1, &fallback_texture_);
+        glBindTexture(GL_TEXTURE_2D, fallback_texture_);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, 1, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, white);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+    for (std::size_t slot(0); slot < kMaterialTextureSlots; slot++) // Every sampler of the array needs a complete texture
+    {
+        const GLuint texture = slot < scene_->textures.size() && scene_->textures[slot].texture ? scene_->textures[slot].texture : fallback_texture_;
+        glActiveTexture(GL_TEXTURE0 + kMaterialTextureUnit + static_cast<GLuint>(slot));
+        glBindTexture(GL_TEXTURE_2D, texture);
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void View::delete_scene_textures()
+{
+    for (SceneTexture &texture : scene_->textures)
+    {
+        if (texture.texture) glDeleteTextures(1, &texture.texture);
+    }
+    scene_->textures.clear();
+    scene_->texture_generation++; // Decodes still in flight land in a slot that no longer exists
+    scene_->texture_resident_bytes = 0;
+}
+
+void View::set_texture_budget_mb(const int megabytes)
+{
+    const std::size_t budget = static_cast<std::size_t>(std::clamp(megabytes, 16, 4096)) << 20;
+    if (budget == scene_->texture_budget_bytes) return;
+    scene_->texture_budget_bytes = budget;
+    stream_textures(); // A lower budget evicts right away; a higher one lets detail stream in again
+    for (View *view : scene_->views) view->request_frame();
+}
+
+void View::draw_hud()
+{
+    QOpenGLPaintDevice device(QSize(framebuffer_width_, framebuffer_height_)); // Paints over the finished GL frame in the bound widget framebuffer, from either thread
+    device.setDevicePixelRatio(device_pixel_ratio_);
+    QPainter painter(&device);
+    paint_hud(painter);
+    painter.end();
 }
 
-void View::draw_mesh(const ImportedObject &object, const glm::mat4 &model, const glm::vec4 &color, const ColorMode mode)
+void View::paint_hud(QPainter &painter) const
 {
-    if (object.vertex_count <= 0) return; // Skip empty meshes
-    const glm::mat4 scaled_model = glm::scale(model, glm::vec3(object.scale)); // Incorporate object scale into model matrix
-    const glm::mat4 mvp = projection * view_matrix * scaled_model; // Compose MVP for object instance
-    const auto normal_matrix = glm::mat3(glm::transpose(glm::inverse(scaled_model))); // Normal matrix after applying scale
-    glBindVertexArray(object.vao); // Bind object's VAO to draw its geometry
-    if (uniform_location_mvp >= 0) glUniformMatrix4fv(uniform_location_mvp, 1, GL_FALSE, glm::value_ptr(mvp)); // Upload MVP transform
-    if (uniform_location_model >= 0) glUniformMatrix4fv(uniform_location_model, 1, GL_FALSE, glm::value_ptr(scaled_model)); // Upload model transform
-    if (uniform_location_normal_matrix >= 0) glUniformMatrix3fv(uniform_location_normal_matrix, 1, GL_FALSE, glm::value_ptr(normal_matrix)); // Upload normal matrix
-    if (uniform_location_color >= 0) glUniform4f(uniform_location_color, color.r, color.g, color.b, color.a); // Upload base color
-    if (uniform_location_color_mode >= 0) glUniform1i(uniform_location_color_mode, static_cast<int>(mode)); // Upload color mode
-    glDrawArrays(GL_TRIANGLES, 0, object.vertex_count); // Issue draw call for mesh
-    glBindVertexArray(0); // Unbind VAO to avoid leaking state
+    const QString text = hud_lines().join(QLatin1Char('\n'));
+    const QFontMetrics metrics(hud_font_);
+    const QSize size(framebuffer_width_, framebuffer_height_); // Widget geometry is GUI-thread state; use the framebuffer
+    const QRect text_rect = metrics.boundingRect(QRect(0, 0, qRound(size.width() / device_pixel_ratio_), qRound(size.height() / device_pixel_ratio_)),
+                                                 Qt::AlignLeft | Qt::AlignTop, text);
+
+    painter.setFont(hud_font_);
+    painter.fillRect(text_rect.translated(8, 8).adjusted(-6, -4, 6, 4), QColor(0, 0, 0, 150)); // Keeps text readable on any color mode
+    painter.setPen(Qt::white);
+    painter.drawText(text_rect.translated(8, 8), Qt::AlignLeft | Qt::AlignTop, text);
 }
 
 bool View::compute_ray(const QPoint &position, glm::vec3 &origin, glm::vec3 &direction) const
@@ -930,9 +4234,9 @@ int View::pick_object(const QPoint &position) const
     int best_index = -1; // Track the closest hit object index
     float closest_t = std::numeric_limits<float>::max(); // Track nearest intersection distance
 
-    for (std::size_t i(0); i < imported_objects_.size(); i++) // Iterate through scene objects
+    for (std::size_t i(0); i < scene_->imported_objects.size(); i++) // Iterate through scene objects
     {
-        const auto &object = imported_objects_[i]; // Reference current object
+        const auto &object = scene_->imported_objects[i]; // Reference current object
         const glm::vec3 center = object.translation; // Sphere center at object position
         const float radius = object.radius * object.scale; // Sphere radius scaled with object
         const glm::vec3 origin_center = origin - center; // Vector from sphere center to ray origin
@@ -1,14 +1,34 @@
 #ifndef VIEW_3D_H // Guard against multiple inclusion
 #define VIEW_3D_H // Begin include guard
 
-#include <QOpenGLWidget>    // QOpenGLWidget base class (custom GL widget)
+#include <QWidget>    // Base class; hosts the GL surface of the selected backend
 #include <QOpenGLFunctions_4_5_Core>    // Provides GL 4.5 core functions after initializeOpenGLFunctions()
 
 #include <glm/glm.hpp>  // GLM core types (mat4, vec4, vec3, etc.)
 #include <glm/gtc/matrix_transform.hpp> // GLM transformations (translate, rotate, scale, ortho)
 #include <glm/gtc/type_ptr.hpp> // glm::value_ptr for sending matrices to shader
 
+#include "ambient_occlusion.h" // Import-time occlusion bake and its statistics
+#include "frame_capture.h" // Screenshot and recording requests, the encoder pool
+#include "light_clusters.h" // Scene lights and their per-frame cluster binning
+#include "mesh_encoding.h" // Vertex formats stored in the shared geometry pool
+#include "point_cloud.h" // Octrees of imported scans and the per-frame node selection
+#include "render_keys.h" // Sort keys of the per-frame draw list
+#include "shader_sources.h" // Program sources, explicit uniform locations and embedded SPIR-V
+#include "skeletal_animation.h" // Rigged mesh assets, the animation clock step and the bone palette evaluation
+#include "software_rasterizer.h" // CPU backend: meshes, frame description and statistics
+#include "texture_compression.h" // Decoded and block-compressed mip chains, the residency planner
+
+#include <QFont> // HUD font, resolved once on the GUI thread
+#include <QImage> // Frames of the software backend
+#include <QMutex> // Guards the snapshot handed from the GUI thread to the renderer
 #include <QString> // Qt string helper used for UI communication
+#include <QStringList> // Lines of the frame HUD
+#include <array> // Fixed-size LOD tables and frustum planes
+#include <atomic> // Flags shared with the render thread
+#include <cstdint> // Fixed-width integers mirrored by std430 shader blocks
+#include <memory> // Owned render thread and renderer
+#include <unordered_map> // Resident point cloud nodes
 #include <vector> // STL container storing imported objects
 
 // NOLINTNEXTLINE(readability-duplicate-include)
@@ -24,8 +44,13 @@ QT_BEGIN_NAMESPACE // Required by Qt build system for namespace handling
 QT_END_NAMESPACE // Complement QT_BEGIN_NAMESPACE
 
 class QOpenGLShaderProgram; // Forward declare shader program (a unique_ptr is kept to it)
+class QThread; // Render thread (threaded rendering mode)
+class FrameRenderer; // Renders frames of a View on the render thread
+class QPainter; // HUD painting (GL paint device or the software surface)
+class RenderSurface; // GL context owner and presenter of the selected backend
+class WidgetRenderSurface; // QOpenGLWidget backend (render thread hand-shakes)
 
-class View final : public QOpenGLWidget, protected QOpenGLFunctions_4_5_Core // Class View inherits QOpenGLWidget and QOpenGLFunctions_4_5_Core
+class View final : public QWidget, protected QOpenGLFunctions_4_5_Core // Class View inherits QWidget and QOpenGLFunctions_4_5_Core
 {
     Q_OBJECT // Enable signals/slots for this widget
 
@@ -36,86 +61,794 @@ public: // Public interface exposed to UI
         Position = 1, // Color changes with world position
         Normal = 2, // Color shows surface direction
         UV = 3, // Color shows texture coordinates
-        PositionNormal = 4 // Color mixes position and normal
+        PositionNormal = 4, // Color mixes position and normal
+        Lit = 5, // Blinn-Phong shading by the scene lights (clustered forward)
+        AmbientOcclusion = 6 // Per-vertex ambient occlusion baked at import (white on meshes without a bake)
+    };
+    static constexpr int kColorModeCount = static_cast<int>(ColorMode::AmbientOcclusion) + 1; // Bound for combo indices and per-mode tables
+
+    enum class RenderPath : int
+    {
+        Forward = 0, // Shade every fragment while rasterizing the scene
+        VisibilityBuffer = 1 // Rasterize draw/triangle ids only, then shade each pixel once in a resolve pass
     };
 
-    explicit View(QWidget *parent = nullptr);   // Constructor
+    enum class DepthPrepass : int
+    {
+        Off = 0, // Single forward pass
+        Auto = 1, // Pre-pass while the measured overdraw is high
+        On = 2 // Always lay down depth first, then shade with GL_EQUAL
+    };
+
+    enum class AntiAliasing : int
+    {
+        Msaa1 = 0, // Single-sample scene target, no anti-aliasing
+        Msaa2 = 1, // Multisampled scene target
+        Msaa4 = 2,
+        Msaa8 = 3,
+        Fxaa = 4 // Single-sample scene target + FXAA post-process pass
+    };
+    static constexpr int kAntiAliasingCount = static_cast<int>(AntiAliasing::Fxaa) + 1; // Same, for the anti-aliasing options
+
+    enum class Backend : int
+    {
+        Widget = 0, // QOpenGLWidget: rendered into an FBO and composited by Qt (supports the render thread)
+        Window = 1, // QOpenGLWindow in a window container: rendered into the native default framebuffer, no composition blit
+        Software = 2 // Plain widget painted from the tiled CPU rasterizer: no OpenGL at all (VMs without GL 4.5, headless image tests)
+    };
+
+    // Constructor; the backend is fixed for the view's lifetime. A view created with share_scene_with draws the same
+    // objects from the same GPU buffers, starting with that view's render settings.
+    explicit View(QWidget *parent = nullptr, Backend backend = default_backend(), View *share_scene_with = nullptr);
     ~View() override;   // Destructor
 
     // Quick setters used by the toolbar (apply + repaint)
-    void set_cam_position(float x, float y, float z) { cam_position = {x,y,z}; emit_camera_state(); update(); }
-    void set_cam_rotation(float x, float y, float z) { cam_rotation_degree = {x,y,z}; emit_camera_state(); update(); }
+    void set_cam_position(float x, float y, float z) { cam_position = {x,y,z}; emit_camera_state(); request_frame(); }
+    void set_cam_rotation(float x, float y, float z) { cam_rotation_degree = {x,y,z}; emit_camera_state(); request_frame(); }
     bool load_object(const QString &file_path); // Import OBJ mesh into scene
     void set_color_mode(ColorMode mode); // Update fragment shading data-source
+    void set_gpu_culling(bool enabled); // Choose compute-shader culling/LOD (true) or the CPU reference path
+    [[nodiscard]] bool gpu_culling() const { return settings_.gpu_culling; } // Current culling path
+    void set_sort_draws(bool enabled); // Radix-sort the draws by vertex format and front-to-back depth (both culling paths)
+    [[nodiscard]] bool sort_draws() const { return settings_.sort_draws; } // Current sorting switch
+    void set_depth_prepass(ColorMode mode, DepthPrepass setting); // Depth pre-pass policy of the forward path for one color mode
+    [[nodiscard]] DepthPrepass depth_prepass(ColorMode mode) const { return settings_.depth_prepass_modes[static_cast<std::size_t>(mode)]; }
+    void set_render_path(RenderPath path); // Choose forward shading or the visibility buffer
+    [[nodiscard]] RenderPath render_path() const { return settings_.render_path; } // Current render path
+    void set_dynamic_resolution(bool enabled); // Let the frame-time governor scale the offscreen scene target
+    [[nodiscard]] bool dynamic_resolution() const { return settings_.dynamic_resolution; } // Current governor switch
+    void set_frame_budget_ms(double budget_ms); // GPU frame time the governor aims to stay under
+    [[nodiscard]] double frame_budget_ms() const { return settings_.frame_budget_ms; } // Current frame-time budget
+    void set_adaptive_msaa(bool enabled); // Allow the governor to lower MSAA once the scale is at its minimum
+    [[nodiscard]] bool adaptive_msaa() const { return settings_.adaptive_msaa; } // Current MSAA adaptation switch
+    void set_anti_aliasing(AntiAliasing mode); // Choose the MSAA level of the scene target or the FXAA pass
+    [[nodiscard]] AntiAliasing anti_aliasing() const { return settings_.anti_aliasing; } // Current anti-aliasing option
+    void set_shadows(bool enabled); // Shadow the sun of the Lit color source from the cached shadow atlas
+    [[nodiscard]] bool shadows() const { return settings_.shadows; } // Current shadow switch
+    void set_wireframe(bool enabled); // Draw the triangle edges of imported meshes over their shading (same draws, both paths)
+    [[nodiscard]] bool wireframe() const { return settings_.wireframe; } // Current wireframe switch
+    void set_light_count(int count); // Replace the scene lights with a demo rig of this many point/spot lights (all viewports)
+    [[nodiscard]] int light_count() const { return static_cast<int>(scene_->lights.size()); } // Lights in the scene
+    void set_texture_budget_mb(int megabytes); // GPU memory for streamed texture mips (all viewports); lowering it evicts at once
+    [[nodiscard]] int texture_budget_mb() const { return static_cast<int>(scene_->texture_budget_bytes >> 20); } // Current budget
+    void set_texture_compression(TextureCompression compression) { scene_->texture_compression = compression; } // Block format of later imports
+    [[nodiscard]] TextureCompression texture_compression() const { return scene_->texture_compression; } // Current import format
+    void set_point_budget(std::size_t points); // Points drawn per frame over every point cloud (also sizes the view's page cache)
+    [[nodiscard]] std::size_t point_budget() const { return settings_.point_budget; } // Current point budget
+    void set_bake_ambient_occlusion(bool enabled) { scene_->bake_ambient_occlusion = enabled; } // Bake per-vertex occlusion on later imports
+    [[nodiscard]] bool bake_ambient_occlusion() const { return scene_->bake_ambient_occlusion; } // Current import switch
+    [[nodiscard]] bool occlusion_bakes_pending() const { return scene_->occlusion_bakes_pending > 0; } // Imports still baking on worker threads
+    void set_hud_visible(bool visible); // Show or hide the frame statistics overlay
+    [[nodiscard]] bool hud_visible() const { return settings_.hud_visible; } // Current overlay state
+    void set_threaded_rendering(bool enabled); // Render on a dedicated thread that borrows the GL context per frame
+    [[nodiscard]] bool threaded_rendering() const { return threaded_rendering_; } // Current rendering thread choice
+
+    [[nodiscard]] Backend backend() const { return backend_; } // Presentation backend chosen at construction
+    static void set_default_backend(Backend backend); // Backend of views constructed afterwards (main.cpp)
+    static void set_shader_directory(const QString &directory); // Hot-reload shader snippets from this directory (main.cpp, before the first view)
+    [[nodiscard]] static Backend default_backend(); // Widget unless changed
+
+    void capture_screenshot(const QString &path); // Write the next rendered frame (without the HUD) to this file; GL backends only
+    void set_capture_recording(bool recording, const QString &directory = QString(), CaptureFormat format = CaptureFormat::Image); // Write every rendered frame
+    [[nodiscard]] bool capture_recording() const { return capture_request_.recording; } // Current recording state
+
+    void set_animation_playing(bool playing); // Advance the animation clock with every presented frame (paused: the pose holds)
+    [[nodiscard]] bool animation_playing() const { return animation_playing_; }
+    void set_animation_fixed_step(bool fixed_step); // One clock tick per presented frame instead of wall-clock time (benchmarks)
+    [[nodiscard]] bool animation_fixed_step() const { return animation_fixed_step_; }
+    void restart_animation(); // Clock back to tick 0: every instance replays from its start pose
 
     void reset_all(); // Clear scene and restore defaults
+    [[nodiscard]] QImage render_image(const QSize &size); // Software backend: draw the scene at this size without showing the view (null elsewhere)
 
 signals: // Qt signal definitions follow
     void cameraPositionChanged(float x, float y, float z); // Signal toolbar when camera position updates
     void cameraRotationChanged(float x, float y, float z); // Signal toolbar when camera rotation updates
+    void renderRequested(); // Queued to the render thread: draw the latest snapshot
+    void framePresented(double latency_ms); // A frame reached the screen; input latency it showed, or -1 without input
 
 private: // Internal helpers and state
+    friend class FrameRenderer; // Calls render_frame() on the render thread
+    friend class WidgetRenderSurface; // Forwards GL callbacks; checks renderer_ before painting
+    friend class WindowRenderSurface; // Forwards GL callbacks
+    friend class SoftwareRenderSurface; // Forwards paint and resize events
+
+    static constexpr std::size_t kMaxMeshLods = 4; // LOD levels per mesh (matches the uvec4 tables of the cull shader)
+
+    struct LodRange // One level of detail inside a mesh's index range
+    {
+        GLuint first_index = 0; // Offset relative to MeshAllocation::first_index
+        GLuint index_count = 0; // Indices of this level
+    };
+
+    struct MeshAllocation // Location of one mesh inside the shared geometry pools
+    {
+        VertexFormat format = VertexFormat::Float32; // Encoding of the mesh vertices
+        GLuint vertex_offset = 0; // First 32-bit word of the mesh in the vertex pool
+        GLuint vertex_words = 0; // Number of 32-bit words occupied in the vertex pool
+        GLuint position_offset = 0; // First 32-bit word of the mesh in the position pool
+        GLuint position_words = 0; // Number of 32-bit words occupied in the position pool
+        GLuint first_index = 0; // First index of the mesh in the index pool
+        GLuint index_count = 0; // Number of indices over all LOD levels
+        std::array<LodRange, kMaxMeshLods> lods{}; // LOD 0 is full detail; all levels share the vertex range
+        GLuint lod_count = 1; // Number of valid entries in lods
+        glm::vec3 bounds_min{0.0f}; // Dequantization origin for packed formats
+        glm::vec3 bounds_extent{1.0f}; // Dequantization scale for packed formats
+        GLuint occlusion_offset = kNoVertexOcclusion; // Baked occlusion stream, relative to vertex_offset (inside vertex_words)
+        GLuint skin_offset = kNoVertexSkin; // Bone indices and weights of rigged meshes, relative to vertex_offset (inside vertex_words)
+    };
+
+    struct alignas(16) DrawRecord // std430 mirror of the per-draw record read by the vertex shader
+    {
+        glm::mat4 model{1.0f}; // Model matrix of the draw
+        glm::mat4 normal_matrix{1.0f}; // Upper 3x3 holds the normal matrix (mat4 keeps std430 columns aligned)
+        glm::vec4 color{1.0f}; // Base material color
+        glm::vec4 bounds_min{0.0f}; // xyz: dequantization origin of the mesh
+        glm::vec4 bounds_extent{1.0f}; // xyz: dequantization scale of the mesh
+        std::uint32_t vertex_offset = 0; // First vertex word of the mesh in the vertex pool
+        std::uint32_t format = 0; // VertexFormat used to decode the mesh
+        std::int32_t color_mode = 0; // ColorMode applied by the fragment shader
+        std::uint32_t position_offset = 0; // First word of the mesh in the position-only pool
+        std::uint32_t occlusion_offset = kNoVertexOcclusion; // First word of the baked occlusion stream in the vertex pool
+        std::int32_t texture_slot = -1; // Material texture slot sampled as albedo (-1: none)
+        std::uint32_t flags = 0; // kDrawWireframe (shader_sources.h)
+        std::uint32_t skin_offset = kNoVertexSkin; // First word of the skin stream in the vertex pool (rigged meshes only)
+        std::uint32_t bone_offset = 0; // First matrix of the draw's bones in the bone palette
+        std::uint32_t padding0 = 0; // Keeps the std430 array stride a multiple of 16 bytes
+        std::uint32_t padding1 = 0;
+        std::uint32_t padding2 = 0;
+    };
+    static_assert(sizeof(DrawRecord) == 224, "DrawRecord must match the std430 layout in the vertex shader");
+
+    struct DrawArraysIndirectCommand // Layout mandated by glMultiDrawArraysIndirect (point cloud pages)
+    {
+        GLuint count = 0; // Points of the page
+        GLuint instance_count = 1; // Always one instance per page
+        GLuint first = 0; // First point slot of the page
+        GLuint base_instance = 0; // Page draw index (feeds the draw_id attribute)
+    };
+
+    struct DrawElementsIndirectCommand // Layout mandated by glMultiDrawElementsIndirect
+    {
+        GLuint count = 0; // Index count
+        GLuint instance_count = 1; // Always one instance per record
+        GLuint first_index = 0; // First index inside the index pool
+        GLint base_vertex = 0; // Unused: vertex offsets are applied by the shader per format
+        GLuint base_instance = 0; // Draw record index (feeds the draw_id attribute)
+    };
+
+    struct alignas(16) CullObject // std430 mirror of one entry read by the culling compute shader
+    {
+        glm::vec4 sphere{0.0f}; // xyz: world-space center, w: radius
+        glm::uvec4 lod_first_index{0u}; // Absolute first index of each LOD in the index pool
+        glm::uvec4 lod_index_count{0u}; // Index count of each LOD
+        std::uint32_t record_index = 0; // Draw record the command must reference
+        std::uint32_t lod_count = 1; // Valid LOD entries
+        std::uint32_t padding0 = 0; // Keeps the entry a multiple of 16 bytes
+        std::uint32_t padding1 = 0;
+    };
+    static_assert(sizeof(CullObject) == 64, "CullObject must match the std430 layout in the culling shader");
+
+    struct RenderTarget // Offscreen framebuffer whose attachments can be sampled by later passes
+    {
+        GLuint framebuffer = 0; // Framebuffer object
+        GLuint color_texture = 0; // Color attachment 0
+        GLuint depth_texture = 0; // Depth attachment (DEPTH_COMPONENT24)
+        int width = 0; // Size in device pixels
+        int height = 0;
+    };
+
+    struct MultisampleTarget // Multisampled renderbuffers; resolved into a RenderTarget before sampling or upscaling
+    {
+        GLuint framebuffer = 0; // Framebuffer object
+        GLuint color_renderbuffer = 0; // RGBA8 color samples
+        GLuint depth_renderbuffer = 0; // DEPTH_COMPONENT24 samples
+        int width = 0; // Size in device pixels
+        int height = 0;
+        int samples = 0; // Samples per pixel
+    };
+
+    struct LightingLocations // Uniforms of the lit shading, present in the forward and resolve programs
+    {
+        GLint view = -1; // World to view (cluster depth)
+        GLint viewport_size = -1; // Render area in pixels (cluster tile)
+        GLint depth_scale_bias = -1; // Exponential slice mapping
+        GLint eye = -1; // World-space camera position (specular)
+        GLint shadow_matrix = -1; // World to shadow atlas coordinates
+        GLint shadows_enabled = -1; // Sample the atlas for the sun
+    };
+
+    struct ShadingVariant // Forward and resolve programs specialized for one ColorMode (shader_sources.h)
+    {
+        bool requested = false; // Build issued; programs stay 0 until linked, and on failure
+        GLuint forward = 0;
+        GLint forward_view_projection = -1;
+        LightingLocations forward_lighting;
+        GLuint resolve = 0;
+        GLint resolve_inverse_view_projection = -1;
+        GLint resolve_viewport_size = -1;
+        GLint resolve_triangle_bits = -1;
+        GLint resolve_wireframe = -1;
+        LightingLocations resolve_lighting;
+    };
+
+    struct QueryFrame // Occlusion queries of one frame; read back a frame later to avoid stalling
+    {
+        GLuint geometry = 0; // Samples passing the depth test while rasterizing the scene
+        GLuint resolve = 0; // Pixels shaded by the visibility resolve pass
+        bool pending = false; // Queries were issued and not read back yet
+        RenderPath path = RenderPath::Forward; // Path the queries measured
+        bool depth_prepass = false; // Forward frame split into depth and GL_EQUAL color passes (uses both queries)
+        GLuint gpu_time = 0; // GL_TIME_ELAPSED of the scene passes and the upscale
+        int samples = 1; // MSAA samples of the scene target this frame (queries count samples)
+        double render_pixels = 1.0; // Pixels of the scaled render area this frame
+        float render_scale = 1.0f; // Resolution scale of this frame
+        bool fxaa = false; // FXAA pass ran this frame
+    };
+
+    struct AntiAliasingTiming // Last GPU frame time measured with one anti-aliasing option
+    {
+        double gpu_ms = 0.0; // GPU frame time
+        float render_scale = 1.0f; // Resolution scale it was measured at
+        bool measured = false; // Option has run since start-up
+    };
+
+    struct FrameStats // Numbers shown by the frame HUD
+    {
+        double cpu_frame_ms = 0.0; // CPU time spent inside paintGL (or render_frame on the render thread)
+        double gpu_frame_ms = 0.0; // GPU time of the scene passes and the upscale
+        float render_scale = 1.0f; // Resolution scale the numbers below were measured at
+        int render_width = 1; // Scaled render area in device pixels
+        int render_height = 1;
+        int samples = 1; // MSAA samples of the scene target
+        bool fxaa = false; // FXAA pass ran
+        RenderPath path = RenderPath::Forward; // Path measured by the query results below
+        double rasterized_fragments = 0.0; // Fragments passing the depth test (what forward shading pays for)
+        double shaded_pixels = 0.0; // Pixels shaded after depth was resolved (visibility resolve or pre-pass color pass)
+        bool depth_prepass = false; // Numbers above come from a forward frame with depth pre-pass
+        double overdraw = 0.0; // Rasterized fragments per pixel covered by geometry (single-pass frames use an earlier coverage)
+        bool draws_sorted = false; // The draw list of this frame went through the radix sort
+        double sort_ms = 0.0; // Key build + per-job radix sort + merge time
+        std::size_t prep_jobs = 1; // Jobs the CPU culling path was split into
+        double cull_ms = 0.0; // Frustum test + LOD selection over all objects, merged into one list
+        double pack_ms = 0.0; // Gather of the commands into key order
+        double upload_ms = 0.0; // Command and LOD-offset upload (GL thread)
+        std::size_t sorted_draws = 0; // Keys sorted this frame (visible draws on the CPU path, all objects on the GPU path)
+        std::size_t format_switches = 0; // Adjacent draws with different vertex formats, in submission order
+        std::size_t unsorted_format_switches = 0; // Same count for the unsorted (scene) order
+        bool lit = false; // Lights were binned and shaded this frame
+        double light_binning_ms = 0.0; // Cluster binning + upload
+        std::size_t visible_lights = 0; // Lights overlapping the frustum
+        std::size_t occupied_clusters = 0; // Clusters with at least one light
+        std::size_t max_lights_per_cluster = 0; // Longest per-fragment light loop
+        double average_lights_per_cluster = 0.0; // Over occupied clusters
+        std::size_t shadow_tiles = 0; // Shadow atlas tiles re-rendered this frame (0 while the scene is static)
+        std::size_t shadow_draws = 0; // Caster draws issued for them
+        double shadow_ms = 0.0; // CPU time of the tile update
+        std::size_t point_clouds = 0; // Clouds in the scene
+        std::size_t point_nodes = 0; // Octree nodes selected this frame
+        std::size_t points_drawn = 0; // Points of the selected nodes that were resident
+        std::size_t point_visited_nodes = 0; // Nodes tested against the frustum
+        bool point_budget_reached = false; // More detail was visible than the budget allowed
+        std::size_t point_missing_nodes = 0; // Selected nodes still waiting for their upload (parents draw meanwhile)
+        std::size_t point_uploaded = 0; // Points uploaded this frame
+        std::size_t point_resident_pages = 0; // Pages in use after this frame
+        std::size_t point_page_capacity = 0; // Pages of the view's cache
+        double point_ms = 0.0; // Selection, uploads and draw list
+        SoftwareFrameStats software; // Passes of the software backend
+    };
+
     struct ImportedObject
     {
-        GLuint vao = 0; // VAO handle for mesh
-        GLuint vbo = 0; // VBO handle storing interleaved attributes
-        GLsizei vertex_count = 0; // Number of vertices to render
+        MeshAllocation mesh; // Vertex/index ranges of the mesh in the geometry pools
         glm::vec3 translation{}; // World-space position of mesh
         float base_footprint = 1.0f; // Base footprint used for placement spacing
         float radius = 1.0f; // Bounding radius used for picking
         float scale = 1.0f; // Current uniform scale factor
+        int texture = -1; // Diffuse texture (index into SharedScene::textures), -1 when untextured
+        std::shared_ptr<const SoftwareMesh> software_mesh; // Full-detail CPU copy drawn by the software backend (null on the GL backends)
+        QString source_path; // Imported file; later imports of a rigged file become instances sharing mesh and skin
+        std::shared_ptr<const SkinnedAsset> skin; // Skeleton and clips of rigged meshes (null: static)
+        std::uint64_t mesh_id = 0; // Key of the background occlusion bake; instances of a rigged file share it with the mesh
+        int animation_clip = 0; // Clip the instance plays
+        std::uint64_t animation_tick_offset = 0; // Phase of the instance on the animation clock
+    };
+
+    struct SceneTexture // Diffuse texture shared by every object importing the same image
+    {
+        QString path; // Source image (deduplication key)
+        DecodedTexture decoded; // Full CPU mip chain; GPU levels are streamed from it (empty until decoded)
+        TextureResidency residency; // Planner state; level_count stays 0 until decoded
+        GLuint texture = 0; // Immutable storage holding levels resident_level..last (0 until decoded)
+    };
+
+    struct PointCloudObject // Imported scan; the octree never changes, so records share it instead of copying points
+    {
+        std::shared_ptr<const PointCloudOctree> octree; // Built on a worker thread (read_point_cloud)
+        glm::vec3 translation{0.0f}; // World position of the cloud origin
+        float base_footprint = 1.0f; // Placement spacing (same rule as ImportedObject)
+        std::uint64_t id = 0; // Key of the views' page caches; unique within the scene
+    };
+
+    static constexpr std::size_t kCaptureSlots = 6; // Pack buffers in the capture ring (frames read back or waiting to be encoded)
+
+    struct CaptureSlot // One pack buffer of the capture ring, persistently mapped
+    {
+        GLuint buffer = 0; // GL_PIXEL_PACK_BUFFER with immutable storage
+        GLsizeiptr capacity = 0; // Bytes allocated (grows with the framebuffer)
+        const std::uint8_t *pixels = nullptr; // Persistent read mapping of the whole buffer
+        GLsync fence = nullptr; // Signaled once the readback into the buffer finished (null: no copy in flight)
+        int width = 0; // Frame held by the slot
+        int height = 0;
+        std::vector<CaptureTarget> targets; // Files the frame goes to (empty once handed to the encoders)
+        std::atomic<bool> in_use{false}; // From the readback until an encoder copied the pixels out
+    };
+
+    struct PointNodeResidency // Pages of a view's point cache holding one octree node
+    {
+        std::vector<GLuint> pages; // Page indices in point_page_buffer_, in point order
+        std::uint64_t last_used = 0; // point_tick_ of the latest frame that selected the node
+    };
+
+    // Content and geometry pools of a scene drawn by one or more views. The views' contexts share objects, so every view
+    // reads the same pools; VAOs, framebuffers, records and culling output are container or per-view objects and stay per view.
+    struct SharedScene
+    {
+        std::vector<ImportedObject> imported_objects; // List of scene meshes
+        int selected_object_index = -1; // Index of selected object (highlighted in every view)
+        std::uint64_t revision = 1; // Bumped on every scene edit; views rebuild their records when it changes
+        std::vector<View*> views; // Views drawing the scene (GUI thread)
+        GLuint vertex_pool_buffer = 0; // SSBO holding encoded vertices of every mesh
+        GLuint position_pool_buffer = 0; // SSBO holding the position-only stream of every mesh
+        GLuint index_pool_buffer = 0; // Element buffer (also readable as SSBO) holding indices of every mesh
+        GLsizeiptr vertex_pool_capacity = 0; // Allocated bytes of the vertex pool
+        GLsizeiptr position_pool_capacity = 0; // Allocated bytes of the position pool
+        GLsizeiptr index_pool_capacity = 0; // Allocated bytes of the index pool
+        GLuint vertex_pool_used_words = 0; // Words in use at the front of the vertex pool
+        GLuint position_pool_used_words = 0; // Words in use at the front of the position pool
+        GLuint index_pool_used = 0; // Indices in use at the front of the index pool
+        MeshAllocation cube_mesh; // Unit cube triangles (ground plane)
+        MeshAllocation cube_edge_mesh; // Unit cube edge lines (ground outline)
+        std::shared_ptr<const SoftwareMesh> software_cube; // Ground mesh of the software backend
+        std::vector<ClusterLight> lights; // Point and spot lights used by ColorMode::Lit
+        bool bake_ambient_occlusion = true; // Import stage switch (load_object)
+        TextureCompression texture_compression = TextureCompression::Bc1Bc3; // Block format of textures requested later
+        std::vector<SceneTexture> textures; // Diffuse textures; the index doubles as sampler slot (edited under begin_gui_gl only)
+        std::uint64_t texture_generation = 0; // Bumped when textures are dropped; decodes of older generations are discarded
+        std::uint64_t texture_stream_tick = 0; // LRU clock, advanced by every streaming step
+        std::size_t texture_budget_bytes = std::size_t{256} << 20; // GPU memory the resident mip levels may use
+        std::size_t texture_resident_bytes = 0; // GPU memory in use by resident levels
+        std::uint64_t texture_uploaded_bytes = 0; // Level bytes uploaded since start-up (HUD)
+        std::uint64_t texture_evicted_levels = 0; // Levels dropped to stay inside the budget (HUD)
+        AmbientOcclusionBake last_occlusion_bake; // Statistics of the latest bake or cache hit (values moved into the mesh)
+        std::uint64_t next_mesh_id = 1; // Next ImportedObject::mesh_id
+        std::size_t occlusion_bakes_pending = 0; // Bakes still running on worker threads
+        std::vector<PointCloudObject> point_clouds; // Faceless OBJ imports, drawn as points (GUI thread; renderers read the records)
+        std::uint64_t point_cloud_generation = 0; // Bumped when clouds are dropped; imports of older generations are discarded
+        std::uint64_t next_point_cloud_id = 1; // Next PointCloudObject::id
+    };
+
+    struct RenderSettings // User options edited on the GUI thread; each frame renders with the copy in its snapshot
+    {
+        ColorMode color_mode = ColorMode::Uniform; // Active color mode enumeration
+        bool gpu_culling = true; // Compute-shader culling (false: CPU reference path)
+        bool sort_draws = true; // Submit the draws in render-key order (GPU culling sorts the objects and drops compaction)
+        RenderPath render_path = RenderPath::Forward; // Forward shading or visibility buffer
+        std::array<DepthPrepass, kColorModeCount> depth_prepass_modes{DepthPrepass::Off, DepthPrepass::Auto, DepthPrepass::Auto, DepthPrepass::Auto,
+                                                        DepthPrepass::Auto, DepthPrepass::Auto, DepthPrepass::Auto}; // Policy per ColorMode
+        bool dynamic_resolution = true; // Governor switch; off renders at full resolution and preferred MSAA
+        bool adaptive_msaa = true; // Governor may trade MSAA samples after the scale reaches its minimum
+        double frame_budget_ms = 16.7; // GPU frame-time budget
+        AntiAliasing anti_aliasing = AntiAliasing::Msaa8; // MSAA level of the scene target or FXAA
+        bool hud_visible = true; // Overlay with per-frame statistics
+        bool shadows = true; // Sun shadows from the cached atlas (Lit color source)
+        bool wireframe = false; // Edges of imported meshes over their shading
+        std::size_t point_budget = 5'000'000; // Points drawn per frame over every point cloud
+    };
+
+    struct SceneRecords // Draw records and cull inputs of the scene; rebuilt on scene edits only
+    {
+        std::uint64_t revision = 0; // Bumped on every rebuild; the renderer uploads when it changes
+        std::vector<DrawRecord> draw_records; // One record per draw (ground, outline, objects)
+        std::vector<CullObject> cull_objects; // Inputs of both culling paths
+        std::vector<std::shared_ptr<const SoftwareMesh>> software_meshes; // Per draw record, software backend only (null: not drawn)
+        std::vector<ClusterLight> lights; // Scene lights (binned per frame with the snapshot camera)
+        std::vector<PointCloudObject> point_clouds; // Clouds to draw (the octrees are shared, not copied)
+        AmbientOcclusionBake occlusion_bake; // Latest import bake statistics (HUD)
+        GLuint triangle_bits = 1; // Low bits of a visibility id reserved for the triangle (sized by the largest mesh)
+        bool ids_fit = true; // Records and triangles fit the 32-bit id; otherwise the forward path is used
+        double build_ms = 0.0; // Time spent packing the records (HUD)
+        std::size_t build_jobs = 1; // Jobs the packing was split into
+    };
+
+    struct FrameJobList // Output of one frame-preparation job; lists are merged in job order, matching a serial pass
+    {
+        std::vector<DrawElementsIndirectCommand> commands; // Visible draws of the job's objects, in scene order
+        std::vector<RenderKeyEntry> keys; // Sort keys of those draws (indices into the merged list)
+        std::vector<RenderKeyEntry> scratch; // Radix sort ping-pong buffer of the job
+        std::size_t first = 0; // Position of the job's commands in the merged list
+        std::size_t format_switches = 0; // Vertex format switches counted by the job
+    };
+
+    struct LatencyStats // Input-to-frame latency, from the input handler to the frameSwapped of the frame showing it
+    {
+        double last_ms = 0.0; // Latest measurement
+        std::array<double, 2> average_ms{}; // Running average while rendering on the GUI thread [0] or the render thread [1]
+        std::array<std::uint64_t, 2> samples{}; // Measurements behind each average
+    };
+
+    struct ProgramCounts // How shader programs were obtained
+    {
+        std::size_t cached = 0; // Loaded with glProgramBinary
+        std::size_t compiled = 0; // Compiled from source (cache miss, rejected binary or no binary support)
+        std::size_t spirv = 0; // Of those, built from the embedded SPIR-V instead of GLSL
+        std::size_t rejected = 0; // Cached binaries the driver refused
+    };
+
+    struct StartupStats // Shader setup and time to first frame, shown by the HUD
+    {
+        double shader_ms = 0.0; // Every program of initializeGL, cached or compiled
+        ProgramCounts programs; // Programs of initializeGL
+        double first_frame_ms = -1.0; // Process start to the first presented frame (-1 until then)
     };
 
+    struct ShaderStats // Programs built in the background after startup (renderer side, shown by the HUD)
+    {
+        bool parallel_compile = false; // GL_KHR/ARB_parallel_shader_compile: the driver compiles on its own threads
+        ProgramCounts programs; // Variants and hot reloads
+        std::size_t pending = 0; // Compiling now
+        std::size_t built = 0; // Installed since startup
+        std::size_t failed = 0; // Failed to compile or link; the previous program kept drawing
+        double last_build_ms = 0.0; // Issue to install of the latest program (includes the frames in between)
+        std::uint64_t revision = 0; // Hot-reload revision of the installed sources
+    };
+
+    struct PendingProgram // Program whose compile and link were issued; finished once the driver reports completion
+    {
+        GLuint program = 0;
+        ShaderProgramId id = ShaderProgramId::Forward;
+        std::uint32_t color_mode_mask = kAllColorModes; // Specialization of the forward/resolve variants
+        QByteArray label; // Log name
+        QByteArray cache_key; // Binary stored once linked (empty: not cached)
+        bool from_binary = false; // Loaded from the program cache, already linked
+        bool spirv = false; // Stages are specialized SPIR-V modules
+        std::uint64_t revision = 0; // Hot-reload revision of the sources
+        std::int64_t start_ns = 0; // Issue time (monotonic clock)
+    };
+
+    struct TextureStats // Texture streaming state shown by the HUD (copied from the scene with every snapshot)
+    {
+        struct Entry // One decoded texture
+        {
+            QString name; // File name
+            TextureFormat format = TextureFormat::Rgba8;
+            int width = 0;
+            int height = 0;
+            std::size_t bytes = 0; // Full mip chain in its format
+            std::size_t rgba8_bytes = 0; // Same chain uncompressed
+            double encode_ms = 0.0;
+            bool from_cache = false;
+        };
+        std::vector<Entry> entries; // Memory saving per texture
+        std::size_t count = 0; // Textures requested by imports
+        std::size_t decoded = 0; // Textures with resident levels
+        std::size_t resident_bytes = 0;
+        std::size_t budget_bytes = 0;
+        std::uint64_t uploaded_bytes = 0;
+        std::uint64_t evicted_levels = 0;
+    };
+
+    struct SceneSnapshot // Everything a frame reads from the GUI side; double-buffered between GUI and render thread
+    {
+        RenderSettings settings; // Options in effect for the frame
+        glm::mat4 view_matrix{1.0f}; // Camera
+        glm::mat4 projection{1.0f};
+        glm::vec3 camera_position{0.0f}; // World-space eye (LOD selection)
+        SceneRecords records; // Copied only when its revision changed
+        std::int64_t input_ns = 0; // Oldest input folded into this snapshot (monotonic clock, 0 = none)
+        LatencyStats latency; // Shown by the HUD
+        bool threaded = false; // Rendered on the render thread
+        std::uint64_t shadow_dirty_tiles = 0; // Shadow atlas tiles touched by scene edits since the last consumed snapshot
+        TextureStats textures; // Streaming state for the HUD
+        StartupStats startup; // Shown by the HUD
+        std::shared_ptr<const ShaderOverrides> shader_overrides; // Hot-reloaded snippets (null: built-in sources)
+        std::uint64_t shader_revision = 0; // Changes with every edit of a shader file
+        CaptureRequest capture; // Recording state; screenshots accumulate until the renderer consumes them
+        std::shared_ptr<const std::vector<glm::mat4>> bone_palette; // Bone matrices of every rigged object (null: none)
+        std::uint64_t bone_palette_revision = 0; // Changes with every evaluated pose
+        AnimationStats animation; // Latest pose evaluation (HUD)
+        std::uint64_t animation_tick = 0; // Clock tick of that pose
+    };
+
+    using QOpenGLFunctions_4_5_Core::glActiveTexture; // Expose texture unit selection helper
     using QOpenGLFunctions_4_5_Core::glAttachShader; // Expose shader attachment helper
+    using QOpenGLFunctions_4_5_Core::glBeginQuery; // Expose query start helper
     using QOpenGLFunctions_4_5_Core::glBindBuffer; // Expose buffer binding helper
+    using QOpenGLFunctions_4_5_Core::glBindBufferBase; // Expose indexed (SSBO) binding helper
+    using QOpenGLFunctions_4_5_Core::glBindFramebuffer; // Expose framebuffer binding helper
+    using QOpenGLFunctions_4_5_Core::glBindRenderbuffer; // Expose renderbuffer binding helper
+    using QOpenGLFunctions_4_5_Core::glBindTexture; // Expose texture binding helper
     using QOpenGLFunctions_4_5_Core::glBindVertexArray; // Expose VAO binding helper
+    using QOpenGLFunctions_4_5_Core::glBlitFramebuffer; // Expose framebuffer copy/resolve/scale helper
     using QOpenGLFunctions_4_5_Core::glBufferData; // Expose buffer upload helper
+    using QOpenGLFunctions_4_5_Core::glBufferStorage; // Expose immutable buffer allocation helper (persistently mapped capture ring)
+    using QOpenGLFunctions_4_5_Core::glBufferSubData; // Expose partial buffer upload helper
+    using QOpenGLFunctions_4_5_Core::glCheckFramebufferStatus; // Expose framebuffer completeness check
     using QOpenGLFunctions_4_5_Core::glClear; // Expose framebuffer clear helper
+    using QOpenGLFunctions_4_5_Core::glClearBufferfv; // Expose per-attachment float clear helper
+    using QOpenGLFunctions_4_5_Core::glClearBufferuiv; // Expose per-attachment integer clear helper
     using QOpenGLFunctions_4_5_Core::glClearColor; // Expose clear color setter
+    using QOpenGLFunctions_4_5_Core::glClientWaitSync; // Expose fence status poll (capture readbacks)
+    using QOpenGLFunctions_4_5_Core::glColorMask; // Expose color write mask setter
     using QOpenGLFunctions_4_5_Core::glCompileShader; // Expose shader compilation helper
+    using QOpenGLFunctions_4_5_Core::glCompressedTexSubImage2D; // Expose compressed texture level upload helper
+    using QOpenGLFunctions_4_5_Core::glCopyBufferSubData; // Expose buffer-to-buffer copy helper
+    using QOpenGLFunctions_4_5_Core::glCopyImageSubData; // Expose texture-to-texture copy helper (kept mip levels)
     using QOpenGLFunctions_4_5_Core::glCreateProgram; // Expose program creation helper
     using QOpenGLFunctions_4_5_Core::glCreateShader; // Expose shader creation helper
     using QOpenGLFunctions_4_5_Core::glDeleteBuffers; // Expose buffer destruction helper
+    using QOpenGLFunctions_4_5_Core::glDeleteFramebuffers; // Expose framebuffer destruction helper
     using QOpenGLFunctions_4_5_Core::glDeleteProgram; // Expose program destruction helper
+    using QOpenGLFunctions_4_5_Core::glDeleteQueries; // Expose query destruction helper
+    using QOpenGLFunctions_4_5_Core::glDeleteRenderbuffers; // Expose renderbuffer destruction helper
     using QOpenGLFunctions_4_5_Core::glDeleteShader; // Expose shader destruction helper
+    using QOpenGLFunctions_4_5_Core::glDeleteSync; // Expose fence destruction helper
+    using QOpenGLFunctions_4_5_Core::glDeleteTextures; // Expose texture destruction helper
     using QOpenGLFunctions_4_5_Core::glDeleteVertexArrays; // Expose VAO destruction helper
-    using QOpenGLFunctions_4_5_Core::glDrawArrays; // Expose array drawing helper
+    using QOpenGLFunctions_4_5_Core::glDepthFunc; // Expose depth comparison setter
+    using QOpenGLFunctions_4_5_Core::glDepthMask; // Expose depth write toggle
+    using QOpenGLFunctions_4_5_Core::glDisable; // Expose capability disabling helper
+    using QOpenGLFunctions_4_5_Core::glDispatchCompute; // Expose compute dispatch helper
+    using QOpenGLFunctions_4_5_Core::glDrawArrays; // Expose non-indexed draw helper (fullscreen passes)
+    using QOpenGLFunctions_4_5_Core::glDrawBuffer; // Expose color output selection helper (depth-only targets)
+    using QOpenGLFunctions_4_5_Core::glDrawElementsInstancedBaseInstance; // Expose single indexed draw with record index
     using QOpenGLFunctions_4_5_Core::glEnable; // Expose capability toggling helper
     using QOpenGLFunctions_4_5_Core::glEnableVertexAttribArray; // Expose attribute enable helper
+    using QOpenGLFunctions_4_5_Core::glEndQuery; // Expose query end helper
+    using QOpenGLFunctions_4_5_Core::glFenceSync; // Expose fence insertion helper (capture readbacks)
+    using QOpenGLFunctions_4_5_Core::glFinish; // Expose completion wait (shared objects edited for other contexts)
+    using QOpenGLFunctions_4_5_Core::glFramebufferRenderbuffer; // Expose renderbuffer attachment helper
+    using QOpenGLFunctions_4_5_Core::glFramebufferTexture2D; // Expose texture attachment helper
     using QOpenGLFunctions_4_5_Core::glGenBuffers; // Expose buffer generation helper
+    using QOpenGLFunctions_4_5_Core::glGenFramebuffers; // Expose framebuffer generation helper
+    using QOpenGLFunctions_4_5_Core::glGenQueries; // Expose query generation helper
+    using QOpenGLFunctions_4_5_Core::glGenRenderbuffers; // Expose renderbuffer generation helper
+    using QOpenGLFunctions_4_5_Core::glGenTextures; // Expose texture generation helper
     using QOpenGLFunctions_4_5_Core::glGenVertexArrays; // Expose VAO generation helper
+    using QOpenGLFunctions_4_5_Core::glGetAttachedShaders; // Expose program stage enumeration (compile logs after an asynchronous link)
+    using QOpenGLFunctions_4_5_Core::glGetIntegerv; // Expose implementation limit query helper
+    using QOpenGLFunctions_4_5_Core::glGetProgramBinary; // Expose linked program retrieval helper (program cache)
+    using QOpenGLFunctions_4_5_Core::glGetProgramInfoLog; // Expose program log query helper
+    using QOpenGLFunctions_4_5_Core::glGetProgramInterfaceiv; // Expose active resource count helper (SPIR-V uniforms)
+    using QOpenGLFunctions_4_5_Core::glGetProgramResourceiv; // Expose resource property query helper (SPIR-V uniforms)
+    using QOpenGLFunctions_4_5_Core::glGetProgramiv; // Expose program status query helper
+    using QOpenGLFunctions_4_5_Core::glGetQueryObjectui64v; // Expose 64-bit query result helper
+    using QOpenGLFunctions_4_5_Core::glGetQueryObjectuiv; // Expose query availability helper
+    using QOpenGLFunctions_4_5_Core::glGetShaderInfoLog; // Expose shader log query helper
+    using QOpenGLFunctions_4_5_Core::glGetShaderiv; // Expose shader status query helper
+    using QOpenGLFunctions_4_5_Core::glGetString; // Expose driver identification helper
     using QOpenGLFunctions_4_5_Core::glGetUniformLocation; // Expose uniform lookup helper
     using QOpenGLFunctions_4_5_Core::glLineWidth; // Expose line width state helper
     using QOpenGLFunctions_4_5_Core::glLinkProgram; // Expose program linking helper
+    using QOpenGLFunctions_4_5_Core::glMapBufferRange; // Expose buffer mapping helper (capture ring)
+    using QOpenGLFunctions_4_5_Core::glMemoryBarrier; // Expose shader-write visibility helper
+    using QOpenGLFunctions_4_5_Core::glMultiDrawArraysIndirect; // Expose non-indexed multi-draw helper (point cloud pages)
+    using QOpenGLFunctions_4_5_Core::glMultiDrawElementsIndirect; // Expose multi-draw submission helper
+    using QOpenGLFunctions_4_5_Core::glPixelStorei; // Expose pixel unpack alignment setter
+    using QOpenGLFunctions_4_5_Core::glPolygonOffset; // Expose depth bias helper (shadow casters)
+    using QOpenGLFunctions_4_5_Core::glProgramBinary; // Expose linked program reload helper (program cache)
+    using QOpenGLFunctions_4_5_Core::glProgramParameteri; // Expose program parameter setter (binary retrievable hint)
+    using QOpenGLFunctions_4_5_Core::glProgramUniform1i; // Expose integer uniform setter for an unbound program
+    using QOpenGLFunctions_4_5_Core::glProgramUniform2f; // Expose vec2 uniform setter for an unbound program
+    using QOpenGLFunctions_4_5_Core::glProgramUniform3fv; // Expose vec3 uniform setter for an unbound program
+    using QOpenGLFunctions_4_5_Core::glProgramUniformMatrix4fv; // Expose mat4 uniform setter for an unbound program
+    using QOpenGLFunctions_4_5_Core::glReadBuffer; // Expose read source selection helper (depth-only targets)
+    using QOpenGLFunctions_4_5_Core::glReadPixels; // Expose framebuffer readback helper (into the capture ring)
+    using QOpenGLFunctions_4_5_Core::glRenderbufferStorageMultisample; // Expose multisampled renderbuffer allocation helper
+    using QOpenGLFunctions_4_5_Core::glScissor; // Expose scissor rectangle setter (atlas tiles)
+    using QOpenGLFunctions_4_5_Core::glShaderBinary; // Expose SPIR-V module upload helper
     using QOpenGLFunctions_4_5_Core::glShaderSource; // Expose shader source upload helper
+    using QOpenGLFunctions_4_5_Core::glTexParameteri; // Expose texture parameter setter
+    using QOpenGLFunctions_4_5_Core::glTexStorage2D; // Expose immutable texture allocation helper
+    using QOpenGLFunctions_4_5_Core::glTexSubImage2D; // Expose texture level upload helper
+    using QOpenGLFunctions_4_5_Core::glUniform1f; // Expose float uniform setter
     using QOpenGLFunctions_4_5_Core::glUniform1i; // Expose integer uniform setter
-    using QOpenGLFunctions_4_5_Core::glUniform4f; // Expose vec4 uniform setter
-    using QOpenGLFunctions_4_5_Core::glUniformMatrix3fv; // Expose mat3 uniform setter
+    using QOpenGLFunctions_4_5_Core::glUniform1ui; // Expose unsigned uniform setter
+    using QOpenGLFunctions_4_5_Core::glUniform2f; // Expose vec2 uniform setter
+    using QOpenGLFunctions_4_5_Core::glUniform3f; // Expose vec3 uniform setter
+    using QOpenGLFunctions_4_5_Core::glUniform3fv; // Expose vec3 array uniform setter
+    using QOpenGLFunctions_4_5_Core::glUniform4fv; // Expose vec4 array uniform setter
     using QOpenGLFunctions_4_5_Core::glUniformMatrix4fv; // Expose mat4 uniform setter
+    using QOpenGLFunctions_4_5_Core::glUnmapBuffer; // Expose buffer unmapping helper (capture ring)
     using QOpenGLFunctions_4_5_Core::glUseProgram; // Expose program binding helper
-    using QOpenGLFunctions_4_5_Core::glVertexAttribPointer; // Expose attribute layout helper
+    using QOpenGLFunctions_4_5_Core::glVertexAttribDivisor; // Expose instanced attribute rate helper
+    using QOpenGLFunctions_4_5_Core::glVertexAttribIPointer; // Expose integer attribute layout helper
     using QOpenGLFunctions_4_5_Core::glViewport; // Expose viewport setter
 
     GLuint shader_program_id = 0;   // OpenGL shader program ID (compiled+linked GLSL program); it identifies the linked vertex + fragment shader pair used for rendering
-    GLint uniform_location_mvp = -1;    // Uniform location for MVP matrix (cached after link)
-    GLint uniform_location_color = -1;  // Uniform location for per-draw color (cached after link)
-    GLint uniform_location_model = -1; // Cached handle for model matrix uniform
-    GLint uniform_location_normal_matrix = -1; // Cached handle for normal matrix uniform
-    GLint uniform_location_color_mode = -1; // Cached handle for color mode uniform
+    std::array<ShadingVariant, kColorModeCount> shading_variants_{}; // One per ColorMode, built on first use; shader_program_id and resolve_program_id_ alias the frame's one
+    ShadingVariant generic_shading_; // Every color mode; built at startup and drawn while a variant compiles
+    std::vector<PendingProgram> pending_programs_; // Background builds polled at the start of every frame
+    std::shared_ptr<const ShaderOverrides> shader_overrides_; // Sources of the installed programs (null: built-in)
+    ShaderStats shader_stats_; // Renderer side
+    GLint uniform_location_view_projection = -1; // Uniform location for the shared view-projection matrix (cached after link)
+
+    // Visibility buffer (id rasterization + deferred resolve)
+    GLuint visibility_program_id_ = 0; // Pulling vertex shader + fragment shader writing packed ids
+    GLint visibility_location_view_projection_ = -1; // Cached handle for the id pass camera uniform
+    GLint visibility_location_triangle_bits_ = -1; // Cached handle for the id split uniform (id pass)
+    GLuint resolve_program_id_ = 0; // Fullscreen pass rebuilding attributes from the pools
+    GLint resolve_location_inverse_view_projection_ = -1; // Cached handle for the pixel ray uniform
+    GLint resolve_location_viewport_size_ = -1; // Cached handle for the target size uniform
+    GLint resolve_location_triangle_bits_ = -1; // Cached handle for the id split uniform (resolve)
+    GLint resolve_location_wireframe_ = -1; // Cached handle for the wireframe switch (resolve)
+    // Wireframe overlay of the forward path (geometry stage; built on first use, every color mode)
+    bool wireframe_requested_ = false; // Build issued
+    GLuint wireframe_program_id_ = 0; // 0 until linked: the frame is drawn without edges meanwhile
+    GLint wireframe_location_view_projection_ = -1; // Cached handle for the camera uniform
+    GLint wireframe_location_viewport_size_ = -1; // Cached handle for the target size uniform (edge distances in pixels)
+    LightingLocations wireframe_lighting_locations_; // Lit uniforms of wireframe_program_id_
+    // Point clouds: selected octree nodes are streamed into fixed-size pages of one buffer and drawn with one multi-draw
+    bool point_program_requested_ = false; // Build issued by the first frame with a cloud
+    GLuint point_program_id_ = 0; // 0 until linked: clouds are not drawn meanwhile
+    GLint point_location_view_projection_ = -1; // Cached handle for the camera uniform
+    GLint point_location_point_scale_ = -1; // Cached handle for the spacing-to-pixels uniform
+    GLuint point_page_buffer_ = 0; // SSBO of kPointPageSize-point pages
+    GLuint point_page_capacity_ = 0; // Pages allocated (sized from the point budget)
+    std::size_t point_page_budget_ = 0; // Point budget the pages were sized for
+    std::vector<GLuint> point_free_pages_; // Pages holding no node
+    std::unordered_map<std::uint64_t, PointNodeResidency> point_nodes_; // Resident nodes by cloud id (high bits) and node index
+    std::uint64_t point_tick_ = 0; // LRU clock, advanced by every frame drawing clouds
+    GLuint point_draw_buffer_ = 0; // SSBO: translation and spacing of every page draw
+    GLuint point_indirect_buffer_ = 0; // DrawArraysIndirectCommand per page draw
+    std::vector<DrawArraysIndirectCommand> point_commands_; // Page draws of this frame (reused every frame)
+    std::vector<glm::vec4> point_draws_; // Their translation and spacing
+    RenderTarget visibility_target_; // R32UI ids + depth, sized to the widget framebuffer
+    GLuint frame_first_index_buffer_ = 0; // SSBO: index-pool offset of the LOD each record drew this frame
+    std::vector<GLuint> frame_first_indices_; // CPU culling path copy of the above
+    // Clustered lighting (ColorMode::Lit)
+    LightingLocations forward_lighting_locations_; // Lit uniforms of shader_program_id
+    LightingLocations resolve_lighting_locations_; // Lit uniforms of resolve_program_id_
+    GLuint light_buffer_ = 0; // SSBO: ClusterLight per scene light (uploaded with the records)
+    GLuint light_cluster_buffer_ = 0; // SSBO: offset/count per cluster, rebuilt every lit frame
+    GLuint light_index_buffer_ = 0; // SSBO: light indices of all clusters
+    LightClusters light_clusters_; // CPU binning output (reused every frame)
+    // Cached sun shadows: one fixed light-space projection, re-rendered per tile when casters change
+    GLuint shadow_atlas_texture_ = 0; // DEPTH_COMPONENT24 atlas with hardware depth compare
+    GLuint shadow_framebuffer_ = 0; // Depth-only framebuffer of the atlas
+    GLuint shadow_indirect_buffer_ = 0; // Caster commands of the tiles being updated
+    GLuint shadow_indirect_capacity_ = 0; // Commands the buffer can hold
+    std::vector<DrawElementsIndirectCommand> shadow_commands_; // Caster commands, tile after tile
+    std::vector<std::uint64_t> shadow_object_tiles_; // Atlas tiles covered by each cull object (this update)
+    std::uint64_t shadow_dirty_tiles_ = 0; // GUI thread: tiles touched by edits, not yet published
+    std::uint64_t shadow_pending_tiles_ = 0; // Renderer: tiles to re-render before the atlas is sampled again
+    std::uint64_t shadow_tile_updates_ = 0; // Renderer: tiles re-rendered since start-up (HUD)
+    // Streamed material textures (the textures themselves are shared by the scene)
+    GLuint fallback_texture_ = 0; // 1x1 white, bound to slots whose texture is not decoded yet
+    bool s3tc_supported_ = false; // GL_EXT_texture_compression_s3tc (BC1/BC3); BC7 is core
+    QMutex texture_demand_mutex_; // Renderer writes the demand, the GUI thread reads it for streaming
+    std::vector<float> texture_demand_; // Largest on-screen size in pixels per texture slot in the latest frame
+    // Depth pre-pass (position-only stream)
+    GLuint depth_prepass_program_id_ = 0; // Vertex-only program reading the position pool
+    GLint depth_prepass_location_view_projection_ = -1; // Cached handle for the pre-pass camera uniform
+    bool auto_prepass_active_ = false; // Auto policy state (hysteresis on the overdraw estimate)
+    double covered_share_ = 1.0; // Share of the render area covered by geometry, from the latest two-pass frame (overdraw denominator)
+    static constexpr int kCoverageProbeFrames = 60; // Auto pre-pass off: one pre-pass frame this often re-measures the covered pixels
+    int frames_since_coverage_ = kCoverageProbeFrames; // Single-pass frames since then, saturated (starts due, so Auto probes at once)
+
+    int framebuffer_width_ = 1; // Widget framebuffer size in device pixels
+    int framebuffer_height_ = 1;
+    qreal device_pixel_ratio_ = 1.0; // Device pixels per widget pixel (HUD painting)
+
+    // Dynamic resolution (offscreen scene target upscaled into the widget, governed by GPU frame time)
+    RenderTarget scene_target_; // Single-sample scene color: render target at 1x MSAA, resolve target otherwise
+    MultisampleTarget scene_msaa_target_; // Render target while scene_samples_ > 1
+    float render_scale_ = 1.0f; // Fraction of the framebuffer size rendered per axis
+    int scene_samples_ = 1; // Current MSAA samples of the scene target
+    int preferred_samples_ = 1; // MSAA level used when the budget allows it (clamped to GL_MAX_SAMPLES)
+    int max_samples_ = 1; // GL_MAX_SAMPLES
+    int render_width_ = 1; // Scaled render area in device pixels (bottom-left corner of the targets)
+    int render_height_ = 1;
+    double smoothed_gpu_ms_ = 0.0; // Averaged GPU frame time fed to the governor (0 = restart averaging)
+
+    // Anti-aliasing (MSAA level of the scene target, or FXAA over the single-sample target)
+    GLuint fxaa_program_id_ = 0; // Fullscreen FXAA pass reading the scene color
+    GLint fxaa_location_texel_size_ = -1; // Cached handle for 1 / target size
+    GLint fxaa_location_uv_max_ = -1; // Cached handle for the last texel center of the render area
+    RenderTarget post_target_; // FXAA output at the render size when it still needs upscaling (color only)
+    std::array<AntiAliasingTiming, kAntiAliasingCount> anti_aliasing_timings_{}; // Indexed by AntiAliasing, shown side by side in the HUD
+
+    // Frame HUD
+    QFont hud_font_; // Fixed-pitch system font (looked up on the GUI thread)
+    bool hud_catch_up_frame_ = false; // Next frame only exists to display the queries of the previous one
+    std::array<QueryFrame, 2> query_frames_{}; // Ping-pong so results are read one frame after issue
+    std::size_t query_frame_index_ = 0; // Slot written by the current frame
+    FrameStats frame_stats_; // Latest numbers shown by the HUD
+
+    // Frame capture (readback through the pack buffer ring, encoding on the writer's threads)
+    CaptureRequest capture_request_; // GUI thread: recording state and screenshots not yet published
+    std::array<CaptureSlot, kCaptureSlots> capture_slots_{}; // Renderer side
+    std::size_t capture_slot_index_ = 0; // Slot the next readback goes to
+    std::vector<CaptureTarget> capture_screenshots_; // Renderer: screenshots waiting for a free slot
+    std::uint64_t capture_session_ = 0; // Recording the frame numbers belong to
+    std::atomic<std::uint64_t> capture_frames_{0}; // Frames of that recording read back (logged by the GUI thread)
+    std::atomic<std::uint64_t> capture_skipped_{0}; // Frames of that recording dropped: ring or encoders full
+    CaptureWriter capture_writer_; // Encoder pool; outlives every mapped slot
+
+    // Skeletal animation (poses evaluated on the GUI thread's frame jobs, skinning in the pulling vertex shaders)
+    bool animation_playing_ = true; // Clock advances with presented frames
+    bool animation_fixed_step_ = false; // One tick per presented frame instead of wall-clock time
+    std::uint64_t animation_tick_ = 0; // Current clock tick (kAnimationStepSeconds each)
+    std::int64_t animation_start_ns_ = 0; // Wall-clock time of tick 0 (real-time clock)
+    std::vector<AnimationInstance> animation_instances_; // Rigged objects in record order, rebuilt with scene_records_
+    std::shared_ptr<const std::vector<glm::mat4>> animation_palette_; // Latest evaluated palette, handed to the snapshots
+    std::uint64_t animation_palette_revision_ = 0; // Bumped by every evaluation
+    std::uint64_t animation_palette_tick_ = 0; // Tick of that palette
+    std::uint64_t animation_records_revision_ = 0; // SceneRecords revision of that palette
+    AnimationStats animation_stats_; // Latest evaluation
+    GLuint bone_palette_buffer_ = 0; // SSBO with the bone matrices of the current frame
+    std::uint64_t uploaded_bone_palette_revision_ = 0; // Palette revision in the buffer
+
+    // GPU culling (compute shader writing indirect commands)
+    using MultiDrawElementsIndirectCount = void (QOPENGLF_APIENTRYP)(GLenum mode, GLenum type, const void *indirect,
+                                                                     GLintptr draw_count, GLsizei max_draw_count, GLsizei stride);
+    GLuint cull_program_id_ = 0; // Compute program: frustum cull, LOD select, command generation
+    GLint cull_location_frustum_planes_ = -1; // Cached handle for frustum planes uniform
+    GLint cull_location_camera_position_ = -1; // Cached handle for camera position uniform
+    GLint cull_location_lod_projection_scale_ = -1; // Cached handle for LOD pixel scale uniform
+    GLint cull_location_lod_thresholds_ = -1; // Cached handle for LOD pixel thresholds uniform
+    GLint cull_location_object_count_ = -1; // Cached handle for object count uniform
+    GLint cull_location_compact_output_ = -1; // Cached handle for compaction switch uniform
+    MultiDrawElementsIndirectCount multi_draw_elements_indirect_count_ = nullptr; // GL_ARB_indirect_parameters entry point (null when unsupported)
+    GLuint cull_object_buffer_ = 0; // SSBO with one CullObject per triangle draw
+    GLuint draw_count_buffer_ = 0; // Atomic draw counter, also the indirect parameter buffer
+    GLuint indirect_capacity_ = 0; // Commands the indirect buffer can hold
+    bool draw_records_dirty_ = true; // Records/cull objects must be rebuilt before the next snapshot
+    std::uint64_t uploaded_records_revision_ = 0; // SceneRecords revision currently in the GPU buffers
+    int viewport_height_ = 1; // Viewport height in pixels, used for screen-size LOD selection
+    GLsizei frame_command_count_ = 0; // Commands written for this frame (upper bound when the GPU compacts)
+    bool frame_uses_draw_count_ = false; // This frame reads its draw count from draw_count_buffer_
 
     // Raw GL objects
-    GLuint vertex_array_object = 0;   // Vertex Array Object handle
-    GLuint vertex_buffer_object = 0;   // Vertex Buffer Object handle
-    GLuint edge_vertex_array_object = 0;   // Wireframe VAO
-    GLuint edge_vertex_buffer_object = 0;  // Wireframe VBO
+    GLuint vertex_array_object = 0;   // Single global VAO: index pool + draw_id attribute, no vertex attributes
+    GLuint draw_record_buffer_ = 0; // SSBO with one DrawRecord per draw of the current frame
+    GLuint draw_id_buffer_ = 0; // Instanced attribute buffer holding 0..N-1 (indexed through base instance)
+    GLuint indirect_buffer_ = 0; // Indirect command buffer for the frame multi-draw
+    GLuint draw_id_capacity_ = 0; // Number of ids stored in draw_id_buffer_
+    std::vector<DrawElementsIndirectCommand> draw_commands_; // Per-frame triangle draw commands (CPU culling path)
+    std::vector<RenderKeyEntry> sort_entries_; // Keys of the visible draws, or of all objects under GPU culling (reused every frame)
+    std::vector<RenderKeyEntry> sort_scratch_; // Radix sort ping-pong buffer
+    std::vector<DrawElementsIndirectCommand> sorted_commands_; // draw_commands_ permuted into key order
+    std::vector<CullObject> sorted_cull_objects_; // Cull inputs in key order (GPU culling with sorting)
+    bool cull_objects_sorted_ = false; // cull_object_buffer_ holds sorted_cull_objects_ rather than the scene order
+    std::vector<FrameJobList> frame_job_lists_; // Per-job outputs of the CPU culling path (reused every frame)
 
-    std::vector<ImportedObject> imported_objects_; // List of scene meshes
-    int selected_object_index_ = -1; // Index of selected object
+    std::shared_ptr<SharedScene> scene_; // Objects, selection and geometry pools (shared with the other viewports)
+    std::uint64_t built_scene_revision_ = 0; // SharedScene::revision scene_records_ was built from
     bool dragging_object_ = false; // Indicates active object drag
     glm::vec3 drag_offset_{}; // Offset between drag ray and object center
 
     glm::mat4 projection{};  // Projection matrix
-    glm::mat4 view_matrix{}; // View matrix (camera)
 
     glm::vec3 cam_position = {3.0f, 3.5f, 15.0f};      // Camera position vector
     glm::vec3 cam_rotation_degree = { -15.0f, 15.0f, 0.0f }; // Camera Euler rotation in degrees
@@ -125,27 +858,153 @@ private: // Internal helpers and state
     bool rotating = false;   // LMB: orbit camera
     bool panning = false;   // RMB: pan camera
     bool scrolling_navigation_ = false; // Middle-mouse orbit state
-    ColorMode color_mode_ = ColorMode::Uniform; // Active color mode enumeration
+
+    // GUI-side state and the snapshot handed to the renderer
+    RenderSettings settings_; // Options as edited by the toolbar
+    SceneRecords scene_records_; // Records built from the shared objects with this view's settings (GUI thread)
+    QMutex snapshot_mutex_; // Guards published_snapshot_ and snapshot_pending_
+    SceneSnapshot published_snapshot_; // Back buffer: latest state published by the GUI thread
+    bool snapshot_pending_ = false; // published_snapshot_ holds state the renderer has not consumed yet
+    SceneSnapshot frame_; // Front buffer: state the current frame renders (renderer side only)
+    std::int64_t pending_input_ns_ = 0; // Oldest input not yet published (monotonic clock, 0 = none)
+    std::atomic<std::int64_t> presented_input_ns_{0}; // Input shown by the last rendered frame, awaiting frameSwapped
+    LatencyStats latency_; // Measured on the GUI thread
+    StartupStats startup_; // GUI thread: filled by initializeGL and the first presented frame
+    QByteArray driver_identity_; // GL vendor, renderer and version (part of every program cache key)
+    bool program_binaries_ = false; // The driver offers at least one program binary format
+    using SpecializeShader = void (QOPENGLF_APIENTRYP)(GLuint shader, const GLchar *entry_point, GLuint constant_count,
+                                                       const GLuint *constant_index, const GLuint *constant_value);
+    using MaxShaderCompilerThreads = void (QOPENGLF_APIENTRYP)(GLuint count);
+    SpecializeShader specialize_shader_ = nullptr; // GL 4.6 / GL_ARB_gl_spirv entry point (null: compile the GLSL)
+
+    // Presentation
+    const Backend backend_; // Set by the constructor
+    bool gl_functions_ = false; // initializeOpenGLFunctions succeeded (never on the software backend)
+    RenderSurface *surface_ = nullptr; // Owned through its widget (a child of this view)
+    WidgetRenderSurface *widget_surface_ = nullptr; // Same surface on the widget backend, null otherwise
+    int swap_interval_ = 1; // Swap interval the context was created with (HUD)
+    SoftwareRasterizer software_rasterizer_; // Software backend: scratch buffers kept between frames
+    QImage software_image_; // Software backend: latest frame, painted by the surface
+
+    // Render thread
+    bool threaded_rendering_ = false; // User switch; the thread runs once GL is initialized
+    std::unique_ptr<QThread> render_thread_; // Runs renderer_ (null on GUI-thread rendering)
+    std::unique_ptr<FrameRenderer> renderer_; // Borrows the context per frame
+    int render_lock_depth_ = 0; // Nesting of GUI-side renderer locks (compose, resize, uploads)
+    bool frame_in_flight_ = false; // A render request is queued or running
+    bool frame_presenting_ = false; // Rendered frame waiting for frameSwapped; the next one starts after it
+    bool frame_wanted_ = false; // State changed while a frame was in flight
+    std::atomic<bool> redraw_requested_{false}; // Renderer wants another frame without new GUI state (HUD, governor)
 
     void emit_camera_state(); // Emit signals with current camera state
     [[nodiscard]] glm::mat4 build_view_matrix() const; // Construct camera view matrix
     void update_projection(int w, int h); // Recalculate projection matrix
 
     void setup_shaders();   // Create, compile, link shaders; fetch uniform locations
-    void setup_geometry();  // Create VAO/VBO and upload unit-cube vertex data
-    void draw_cube(const glm::mat4 &model, const glm::vec4 &color, ColorMode mode);  // Set uniforms and draw 36 vertices for one cube
-    void draw_cube_edges(const glm::mat4 &model, const glm::vec4 &color); // Draw cube wireframe
-    void draw_mesh(const ImportedObject &object, const glm::mat4 &model, const glm::vec4 &color, ColorMode mode); // Draw imported mesh instance
+    [[nodiscard]] PendingProgram begin_program(ShaderProgramId id, std::uint32_t color_mode_mask, ProgramCounts &counts); // Cache lookup, else issue compile and link
+    [[nodiscard]] bool program_ready(const PendingProgram &pending); // Completion status without blocking (always true without parallel compile)
+    [[nodiscard]] GLuint finish_program(const PendingProgram &pending, ProgramCounts &counts); // Link status and binary store; 0 (with a warning) on failure
+    void install_program(ShaderProgramId id, std::uint32_t color_mode_mask, GLuint program); // Replace the program's slot and refresh its uniform locations
+    [[nodiscard]] ShadingVariant &shading_variant(std::uint32_t color_mode_mask); // Slot of a forward/resolve specialization
+    [[nodiscard]] GLint uniform_location(GLuint program, const char *name, GLint location); // By name, else the explicit location if active
+    void use_shading_variant(ColorMode mode); // Renderer: request the mode's programs once, alias the ready ones (generic meanwhile)
+    void poll_programs(); // Renderer: finish and install background builds that completed
+    void reload_shaders(); // Renderer: rebuild every program from the snapshot's edited sources
+    [[nodiscard]] bool create_render_target(RenderTarget &target, int width, int height, GLenum color_format, bool with_depth = true); // Allocate color (+ depth) textures and their framebuffer
+    void destroy_render_target(RenderTarget &target); // Release a render target (safe on empty targets)
+    [[nodiscard]] bool ensure_visibility_target(); // (Re)create the id target when the framebuffer size changes
+    void render_visibility(const glm::mat4 &view_projection, const QueryFrame &queries); // Id pass into the target, then resolve into the scene framebuffer
+    [[nodiscard]] bool ensure_scene_target(); // (Re)create the scene targets for the framebuffer size and MSAA level
+    void destroy_scene_target(); // Release the scene targets (safe when empty)
+    [[nodiscard]] GLuint scene_framebuffer() const; // Framebuffer the scene passes draw into this frame
+    void present_scene(); // Resolve MSAA, run FXAA if selected and upscale the render area into the widget framebuffer
+    void capture_frame(); // Read the presented frame into the capture ring when recording or asked for a screenshot
+    void collect_captures(); // Hand slots whose readback finished to the encoders (never waits on a fence)
+    void release_capture_slots(); // Wait for the encoders, then unmap and delete the ring (context current)
+    [[nodiscard]] bool fxaa_active() const; // FXAA selected and its program and source target exist
+    void apply_fxaa(GLuint framebuffer, int width, int height); // FXAA over the scene color into the given framebuffer
+    [[nodiscard]] double anti_aliasing_memory_mb(AntiAliasing mode) const; // Scene target memory an option needs at the current size
+    void update_resolution_governor(double gpu_ms); // Adjust scale (then MSAA) to keep the GPU time inside the budget
+    void collect_frame_queries(); // Read back the previous frame's queries into frame_stats_
+    [[nodiscard]] bool use_depth_prepass() const; // Policy of the current color mode applied to the latest overdraw estimate
+    [[nodiscard]] QStringList hud_lines() const; // Text of the frame HUD
+    void draw_hud(); // Paint the frame HUD over the finished frame
+    void paint_hud(QPainter &painter) const; // HUD text box, shared by the GL paint device and the software surface
+    void bin_lights(); // Bin the snapshot lights into the cluster grid and upload the lists (lit frames only)
+    void set_lighting_uniforms(GLuint program, const LightingLocations &locations); // Camera and grid uniforms of the lit shading
+    void mark_shadow_tiles_dirty(std::uint64_t tiles); // GUI thread: every view of the scene re-renders these atlas tiles
+    void mark_shadow_caster_dirty(const ImportedObject &object); // GUI thread: tiles under an object's current bounds
+    [[nodiscard]] bool ensure_shadow_atlas(); // Create the atlas on first use (all tiles pending)
+    void update_shadow_atlas(); // Re-render pending atlas tiles from the snapshot records; nothing when none are pending
+    [[nodiscard]] int request_texture(const QString &path); // GUI thread: slot of an image, decoding it on a worker thread on first use
+    void on_texture_decoded(std::size_t slot, std::uint64_t generation, DecodedTexture decoded); // GUI thread: upload the base levels
+    void restream_texture(SceneTexture &texture, std::uint32_t resident_level); // GUI GL: reallocate with a new finest level
+    void stream_textures(); // GUI thread: one streaming step from the demand of every view of the scene
+    void measure_texture_demand(const glm::mat4 &view_projection); // Renderer: on-screen size of every textured object
+    void bind_material_textures(); // Renderer: bind every texture slot (fallback for textures still decoding)
+    void delete_scene_textures(); // GUI GL: drop every texture and ignore decodes in flight
+    void setup_geometry();  // Create the global VAO and geometry pools; upload the unit cube and its edges
+    [[nodiscard]] MeshAllocation upload_mesh(const EncodedVertices &vertices, const std::vector<std::vector<GLuint>> &lod_indices); // Append a mesh and its LODs to the geometry pools
+    void grow_pool_buffer(GLuint &buffer, GLsizeiptr &capacity, GLsizeiptr used_bytes, GLsizeiptr required_bytes); // Reallocate a pool buffer keeping its contents
+    void compact_geometry_pool(); // Repack live meshes at the front of the pools after a deletion
+    void attach_index_pool(); // Bind the current index pool as element buffer of the global VAO
+    [[nodiscard]] static DrawRecord make_draw_record(const MeshAllocation &mesh, const glm::mat4 &model, const glm::vec4 &color, ColorMode mode,
+                                                     int texture_slot = -1); // Pack one per-draw record
+    [[nodiscard]] static CullObject make_cull_object(const MeshAllocation &mesh, GLuint record, const glm::vec3 &center, float radius); // Pack the cull input of a record
+    void setup_culling(); // Compile the culling compute shader and resolve GL_ARB_indirect_parameters
+    void mark_draws_dirty(); // View settings stored in the records changed: rebuild them before the next snapshot
+    void mark_scene_dirty(); // Shared scene edited: every view rebuilds its records, the others redraw
+    void build_scene_records(); // GUI thread: rebuild records/cull objects from the current scene state
+    void upload_draw_records(); // Renderer: upload the records of the current snapshot
+    void ensure_indirect_capacity(GLuint command_count); // Grow the indirect buffer without shrinking it
+    void ensure_draw_id_capacity(GLuint count); // Grow the 0..N-1 draw_id table without shrinking it
+    void cull_on_gpu(const glm::mat4 &view_projection); // Dispatch the cull shader writing commands (and count) on the GPU
+    void sort_cull_objects(); // Upload the cull inputs in render-key order, so one slot per object keeps that order
+    void cull_on_cpu(const glm::mat4 &view_projection); // Cull, pick LODs, sort and pack on worker jobs, then upload the commands
+    void submit_culled_draws(); // Issue the triangle multi-draw produced by either culling path
+    [[nodiscard]] float lod_projection_scale() const; // Converts radius/distance into on-screen pixels
+    [[nodiscard]] GLuint select_lod(const CullObject &object) const; // Screen-size LOD rule shared with the compute shader
+    [[nodiscard]] glm::vec3 free_ground_position(float footprint) const; // GUI thread: first spot along +X clear of every object and cloud
+    bool load_mesh(const QString &file_path); // GUI thread: Assimp import, pool upload and placement of a mesh file
+    void bake_occlusion_in_background(std::uint64_t mesh_id, const QString &file_path, std::vector<MeshVertex> vertices,
+                                      std::vector<GLuint> indices); // GUI thread: cache lookup or bake on a worker thread
+    void on_occlusion_baked(std::uint64_t mesh_id, AmbientOcclusionBake bake); // GUI thread: fill the reserved stream of the mesh
+    [[nodiscard]] bool load_point_cloud(const QString &file_path); // GUI thread: build the octree of a faceless OBJ on a worker thread
+    void on_point_cloud_built(std::uint64_t generation, const QString &file_path, std::shared_ptr<const PointCloudOctree> octree); // GUI thread: place the cloud
+    void draw_point_clouds(const glm::mat4 &view_projection); // Renderer: select nodes within the point budget, stream missing ones, draw them
+    void release_point_pages(); // Renderer: drop the page cache (budget change, shutdown)
     void delete_imported_objects(); // Release GPU resources for all meshes
-    void delete_object(int index); // Remove a single imported object from the scene
+    void update_animation(); // GUI thread: pose the rigged objects at the current tick when the tick or the records changed
+    void advance_animation_clock(); // GUI thread: next tick after a presented frame (fixed step) or from the wall clock
+    void upload_bone_palette(); // Renderer: upload the bone matrices of the current snapshot
+    void delete_object(int index, std::int64_t input_ns = 0); // Remove a single imported object from the scene
     [[nodiscard]] bool compute_ray(const QPoint &position, glm::vec3 &origin, glm::vec3 &direction) const; // Build picking ray from screen point
     [[nodiscard]] bool intersect_ground_plane(const QPoint &position, glm::vec3 &hit_point) const; // Ray-test against ground plane
     [[nodiscard]] int pick_object(const QPoint &position) const; // Return index of mesh hit by ray
 
+    void request_frame(std::int64_t input_ns = 0); // GUI thread: state changed; input_ns stamps the input that caused it
+    void request_redraw(); // Renderer: draw again with the same snapshot (HUD catch-up, governor steps)
+    void publish_snapshot(); // GUI thread: copy the render-relevant state into the back buffer
+    void consume_snapshot(); // Renderer: swap in the latest snapshot and apply setting changes
+    void apply_render_settings(const RenderSettings &previous); // Renderer: side effects of changed options
+    void render_frame(); // Renderer: draw one frame into the widget framebuffer (GUI or render thread)
+    void start_render_thread(); // Create the render thread and hand frames to it
+    void stop_render_thread(); // Finish the frame in flight and return to GUI-thread rendering
+    void lock_renderer(bool need_context); // GUI thread: keep the renderer out (and the context home when asked)
+    void unlock_renderer(); // GUI thread: counterpart of lock_renderer()
+    void begin_gui_gl(); // GUI thread: make the context current for uploads, whichever thread renders
+    void end_gui_gl(); // GUI thread: release the context, publishing scene changes before the renderer resumes
+    void start_threaded_frame(); // GUI thread: queue a frame on the render thread unless one is pending
+    void on_frame_rendered(); // GUI thread: the render thread finished a frame
+    void on_frame_swapped(); // GUI thread: a frame reached the window; measure input latency
+
+    void initializeGL();   // Called once by the surface: load GL functions, create buffers/shaders, states
+    void resizeGL(int w, int h);   // Called by the surface on resize: update viewport/projection
+    void paintGL();    // Called by the surface to render a frame on the GUI thread
+    void render_software(QImage &image); // Software backend: rasterize the latest snapshot into image (framebuffer size)
+    void paint_software(QPainter &painter); // Called by the software surface: publish, rasterize, draw the image and the HUD
+
 protected: // Overridden event handlers
-    void initializeGL() override;   // Called once: load GL functions, create buffers/shaders, states
-    void resizeGL(int w, int h) override;   // Called on resize: update viewport/projection
-    void paintGL() override;    // Called to render a frame: bind VAO, set uniforms, draw
 
     void mousePressEvent(QMouseEvent*) override; // Handle mouse button press events
     void mouseReleaseEvent(QMouseEvent*) override; // Handle mouse button release events